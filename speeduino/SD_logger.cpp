@@ -12,6 +12,7 @@
 #include "logger.h"
 #include "rtc_common.h"
 #include "maths.h"
+#include "tooth_log_stream.h"
 #include <elapsedMillis.h>
 
 //List of logger field names. This must be in the same order and length as logger_updateLogdataCSV()
@@ -271,8 +272,11 @@ static_assert(sizeof(header_table) == (sizeof(char*) * SD_LOG_NUM_FIELDS), "Numb
 SdExFat sd;
 ExFile logFile;
 RingBuf<ExFile, RING_BUF_CAPACITY> rb;
+ExFile toothLogFile;
+RingBuf<ExFile, TOOTH_LOG_RING_BUF_CAPACITY> toothLogRb;
 uint8_t SD_status = SD_STATUS_OFF;
 uint16_t currentLogFileNumber;
+static uint8_t toothLogFilePart; //0 for the .tlg file, then 1 to TOOTH_LOG_MAX_FILE_PARTS
 bool manualLogActive = false;
 uint32_t logStartTime = 0; //In ms
 elapsedMillis msSinceLastSDSync;
@@ -344,6 +348,69 @@ bool createLogFile()
   return returnValue;
 }
 
+static void getToothLogFileName(char *filenameBuffer, uint16_t logFileNumber, uint8_t part)
+{
+  if(part == 0U) { snprintf(filenameBuffer, 13, "%s%04d.%s", LOG_FILE_PREFIX, logFileNumber, TOOTH_LOG_FILE_EXTENSION); }
+  else { snprintf(filenameBuffer, 13, "%s%04d.t%02u", LOG_FILE_PREFIX, logFileNumber, part); }
+}
+
+/** 
+ * Creates & pre-allocates one part of the tooth log file to go with the current csv log file. Must be called after createLogFile()
+ * 
+ * @param part 0 for the first part (.tlg), then 1 to TOOTH_LOG_MAX_FILE_PARTS
+ * @return true if the file is ready to write to. Otherwise it is closed
+ */
+static bool openToothLogFile(uint8_t part)
+{
+  char filenameBuffer[13]; //8 + 1 + 3 + 1
+  getToothLogFileName(filenameBuffer, currentLogFileNumber, part);
+
+  toothLogFile.close();
+  if (toothLogFile.open(filenameBuffer, O_RDWR | O_CREAT | O_TRUNC) && toothLogFile.preAllocate(TOOTH_LOG_FILE_SIZE))
+  {
+    toothLogFilePart = part;
+    toothLogRb.begin(&toothLogFile);
+    return true;
+  }
+  toothLogFile.close();
+  return false;
+}
+
+static void closeToothLogFile(void)
+{
+  if(toothLogFile.isOpen())
+  {
+    toothLogRb.sync();
+    toothLogFile.truncate();
+    toothLogFile.close();
+  }
+}
+
+/** 
+ * Copies the next tooth log block into the ring buffer, if there is one & there is room for it.
+ * 
+ * Each block is written as: uint16_t sequence, uint16_t count, uint16_t dropped (see @ref tooth_log_block_t), then
+ * count uint32_t times, then count uint8_t status bytes. All little endian.
+ * 
+ * @return true if a block was copied
+ */
+static bool bufferToothLogBlock(void)
+{
+  const tooth_log_block_t *pBlock = toothLogStreamNextBlock(ToothLogSink::SD);
+  if(pBlock == nullptr) { return false; }
+
+  uint16_t blockBytes = (3U * sizeof(uint16_t)) + (pBlock->count * (sizeof(pBlock->times[0]) + sizeof(pBlock->status[0])));
+  if(toothLogRb.bytesFree() < blockBytes) { return false; }
+
+  const uint16_t header[] = { pBlock->sequence, pBlock->count, pBlock->dropped };
+  //All boards with SD logging are little endian, so the arrays can be written as is
+  toothLogRb.write(header, sizeof(header));
+  toothLogRb.write(pBlock->times, pBlock->count * sizeof(pBlock->times[0]));
+  toothLogRb.write(pBlock->status, pBlock->count * sizeof(pBlock->status[0]));
+  toothLogStreamRelease(ToothLogSink::SD);
+  return true;
+}
+
 uint16_t getNextSDLogFileNumber()
 {
   uint16_t nextFileNumber = 1;
@@ -464,6 +531,12 @@ void beginSDLogging()
     //initialise the RingBuf.
     rb.begin(&logFile);
 
+    //The tooth log is optional, the csv log carries on without it. It can't start if the serial port is using the stream
+    if( (configPage13.onboard_log_tooth_stream == 1U) && startToothLogStream(ToothLogSink::SD) )
+    {
+      if(!openToothLogFile(0U)) { stopToothLogStream(ToothLogSink::SD); }
+    }
+
     //Write a header row
     writeSDLogHeader();
 
@@ -476,6 +549,17 @@ void endSDLogging()
 {
   if(SD_status == SD_STATUS_ACTIVE)
   {
+    stopToothLogStream(ToothLogSink::SD);
+    if(toothLogFile.isOpen())
+    {
+      //Write out the edges logged since the last drain. This blocks, as does closing the csv file below
+      while(toothLogStreamNextBlock(ToothLogSink::SD) != nullptr)
+      {
+        if(!bufferToothLogBlock() && !toothLogRb.sync()) { break; }
+      }
+      closeToothLogFile();
+    }
+
     // Write any RingBuf data to file.
     rb.sync();
     logFile.truncate();
@@ -564,6 +648,42 @@ void writeSDLogEntry()
   setTS_SD_status();
 }
 
+/** 
+ * Drains the tooth log stream into the tooth log file. Called every loop.
+ * 
+ * If the file can't keep up, blocks are left in the stream & the logger ISRs count the edges they drop.
+ * When a file part is full the log carries on in the next one (SPD_nnnn.tlg, then .t01, .t02 etc.). The block
+ * sequence numbers run on across the parts, so they can simply be joined back together.
+ */
+void writeSDToothLog()
+{
+  if( (SD_status != SD_STATUS_ACTIVE) || !toothLogFile.isOpen() ) { return; }
+
+  //Check whether the file is full (IE When there may not be room for the whole ring buffer)
+  if( (toothLogFile.dataLength() - toothLogFile.curPosition()) < TOOTH_LOG_RING_BUF_CAPACITY )
+  {
+    closeToothLogFile();
+    if( (toothLogFilePart >= TOOTH_LOG_MAX_FILE_PARTS) || !openToothLogFile(toothLogFilePart + 1U) )
+    {
+      //Out of parts or space: the tooth log stops, the csv log carries on
+      stopToothLogStream(ToothLogSink::SD);
+      return;
+    }
+  }
+
+  (void)bufferToothLogBlock();
+
+  //As per writeSDLogEntry(), only write whole sectors & never wait on the card
+  if( (toothLogRb.bytesUsed() >= SD_SECTOR_SIZE) && !toothLogFile.isBusy())
+  {
+    if (SD_SECTOR_SIZE != toothLogRb.writeOut(SD_SECTOR_SIZE)) 
+    {
+      SD_status = SD_STATUS_ERROR_WRITE_FAIL;
+      setTS_SD_status();
+    }
+  }
+}
+
 void writeSDLogHeader()
 {
   //Write header for Time field
@@ -779,6 +899,15 @@ void deleteLogFile(char log1, char log2, char log3, char log4)
   {
     sd.remove(logFileName);
   }
+
+  //And the matching tooth log parts, if there are any
+  uint16_t logFileNumber = (uint16_t)(((log1 - '0') * 1000) + ((log2 - '0') * 100) + ((log3 - '0') * 10) + (log4 - '0'));
+  for(uint8_t part = 0U; part <= TOOTH_LOG_MAX_FILE_PARTS; part++)
+  {
+    getToothLogFileName(logFileName, logFileNumber, part);
+    if(!sd.exists(logFileName)) { break; }
+    sd.remove(logFileName);
+  }
 }
 
 // Call back for file timestamps.  Only called for file create and sync().
@@ -43,8 +43,12 @@
 #define MAX_LOG_FILES     9999
 #define LOG_FILE_PREFIX "SPD_"
 #define LOG_FILE_EXTENSION "csv"
+#define TOOTH_LOG_FILE_EXTENSION "tlg" //Binary tooth/composite log, written alongside the csv file with the same number
+#define TOOTH_LOG_FILE_SIZE 2000000 //Default 2mb file size. When full, the log carries on in the next part
+#define TOOTH_LOG_MAX_FILE_PARTS 99 //The parts after the first are named .t01 to .t99
 #define SD_LOG_ENTRY_TOTAL_BYTES (SD_LOG_ENTRY_SIZE + SD_LOG_NUM_FIELDS + 1) //The total size of each SD log entry in bytes. This is the size of the data packet + 1 comma for each field + 1 for the newline character
 #define RING_BUF_CAPACITY (SD_LOG_ENTRY_TOTAL_BYTES * 10) //Allow for 10 entries in the ringbuffer. Will need tuning
+#define TOOTH_LOG_RING_BUF_CAPACITY (SD_SECTOR_SIZE * 4) //Must hold at least 1 full tooth log block (6 + 5 bytes per edge)
 #define SD_SYNC_RPM_THRESHOLD 1700 //SD log sync can take up to 8ms on slow SD cards. To prevent potential issues we only perform this if the RPM is under a safe speed so that there will always be sufficient time for a main loop to run. 
 #define SD_SYNC_MAX_TIME_PERIOD 20000 //The maximum time (in ms) that will be allowed before a sync will be forced. This is the longest amount of time that an SD log will potentially lose if the ECU is unexpectedly powered down. 
 
@@ -58,6 +62,8 @@ RingBuf<ExFile, RING_BUF_CAPACITY> rb;
 extern SdExFat sd;
 extern ExFile logFile;
 extern RingBuf<ExFile, RING_BUF_CAPACITY> rb;
+extern ExFile toothLogFile;
+extern RingBuf<ExFile, TOOTH_LOG_RING_BUF_CAPACITY> toothLogRb;
 
 extern uint8_t SD_status;
 extern uint16_t currentLogFileNumber;
@@ -66,6 +72,7 @@ extern elapsedMillis msSinceLastSDSync;
 
 void initSD();
 void writeSDLogEntry();
+void writeSDToothLog();
 void writetSDLogHeader();
 void beginSDLogging();
 void endSDLogging();
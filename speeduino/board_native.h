@@ -43,6 +43,7 @@ constexpr uint16_t TABLE_BLOCKING_FACTOR = 64;
 static inline bool pinIsReserved(uint8_t pin) { return pin==0U; } //Forbidden pins like USB on other boards
 
 #define PWM_FAN_AVAILABLE
+#define SENSOR_CALIBRATION_LUT //Expand the CLT, IAT & O2 calibration curves into 1024 entry lookup tables
 
 /*
 ***********************************************************************************************************
@@ -206,6 +206,10 @@ extern STM32RTC& rtc;
 
 #define RTC_LIB_H "STM32RTC.h"
 
+#if !defined(SMALL_FLASH_MODE)
+  #define SENSOR_CALIBRATION_LUT //Expand the CLT, IAT & O2 calibration curves into 1024 entry lookup tables
+#endif
+
 /*
 ***********************************************************************************************************
 * Schedules
@@ -71,6 +71,7 @@ static constexpr uint32_t ticksToMicros(COMPARE_TYPE ticks)
 #define SD_LOGGING //SD logging enabled by default for Teensy 4.1 as it has the slot built in
 #define RTC_LIB_H "TimeLib.h"
 #define SD_CONFIG  SdioConfig(FIFO_SDIO) //Set Teensy to use SDIO in FIFO mode. This is the fastest SD mode on Teensy as it offloads most of the writes
+#define SENSOR_CALIBRATION_LUT //Expand the CLT, IAT & O2 calibration curves into 1024 entry lookup tables
 constexpr uint16_t BLOCKING_FACTOR = 251;
 constexpr uint16_t TABLE_BLOCKING_FACTOR = 256;
 
@@ -30,6 +30,8 @@ A full copy of the license may be found in the projects root directory
 #include "sensors.h"
 #include "resetControl.h"
 #include "preprocessor.h"
+#include "loop_profiler.h"
+#include "tooth_log_stream.h"
 
 /** @defgroup group-serial-comms-impl Serial comms implementation
  * @{
@@ -441,6 +443,7 @@ static void loadO2CalibrationChunk(uint16_t offset, uint16_t chunkSize)
     //All chunks have been received (1024 values). Finalise the CRC and burn to EEPROM
     saveCalibrationCrc(SensorCalibrationTable::O2Sensor, calibrationCRC);
     saveCalibrationTable(SensorCalibrationTable::O2Sensor);
+    refreshCalibrationLut(SensorCalibrationTable::O2Sensor, calibrationCRC);
   }
 }
 
@@ -475,8 +478,10 @@ static void processTemperatureCalibrationTableUpdate(uint16_t calibrationLength,
       values[x] = toTemperature(serialPayload[(2U * x) + 7U], serialPayload[(2U * x) + 8U]);
       bins[x] = (x * 33U); // 0*33=0 to 31*33=1023
     }
-    saveCalibrationCrc(calibrationPage, CRC32_serial.crc32(&serialPayload[7], 64));
+    uint32_t calibrationCRC = CRC32_serial.crc32(&serialPayload[7], 64);
+    saveCalibrationCrc(calibrationPage, calibrationCRC);
     saveCalibrationTable(calibrationPage);
+    refreshCalibrationLut(calibrationPage, calibrationCRC);
     sendReturnCodeMsg(SERIAL_RC_OK);
   }
   else 
@@ -644,7 +649,7 @@ void processSerialCommand(void)
 
     case 'd': // Send a CRC32 hash of a given page
     {
-      uint32_t CRC32_val = reverse_bytes(calculatePageCRC32( serialPayload[2] ));
+      uint32_t CRC32_val = reverse_bytes(getPageCRC32( serialPayload[2] ));
 
       serialPayload[0] = SERIAL_RC_OK;
       (void)memcpy(&serialPayload[1], (byte*)&CRC32_val, sizeof(CRC32_val));
@@ -708,6 +713,56 @@ void processSerialCommand(void)
       break;
     }
 
+    case 'i': //Send the trigger ISR execution times. See serialiseIsrProfile() for the format
+    {
+      //2nd byte: 1 == clear the statistics once sent
+      bool resetAfterSend = serialPayload[2] == 1U;
+      serialPayload[0] = SERIAL_RC_OK;
+      uint16_t length = serialiseIsrProfile(currentStatus.decoder, &serialPayload[1], _countof(serialPayload)-1U);
+      sendSerialPayloadNonBlocking(length + 1U);
+      if (resetAfterSend) { resetIsrProfile(currentStatus.decoder); }
+      break;
+    }
+
+    case 'l': //Send a page of the main loop profiler statistics. See serialiseLoopProfile() for the format
+    {
+      //2nd byte: 1 == clear the statistics once the last page is sent
+      //3rd byte: first section in the page
+      bool resetAfterSend = serialPayload[2] == 1U;
+      uint8_t firstSection = serialPayload[3];
+      serialPayload[0] = SERIAL_RC_OK;
+      uint16_t length = serialiseLoopProfile(&serialPayload[1], _countof(serialPayload)-1U, firstSection);
+      sendSerialPayloadNonBlocking(length + 1U);
+      // Header: section count, bucket count, first section, sections in this page
+      bool isLastPage = ((uint16_t)serialPayload[3] + serialPayload[4]) >= serialPayload[1];
+      if (resetAfterSend && isLastPage) { resetLoopProfiler(); }
+      break;
+    }
+
+    case 'g': //Send the next chunk of the continuous tooth/composite log. See serialiseToothLogBlock() for the format
+    {
+      serialPayload[0] = SERIAL_RC_OK;
+      uint16_t length = serialiseToothLogBlock(&serialPayload[1], _countof(serialPayload)-1U);
+      sendSerialPayloadNonBlocking(length + 1U);
+      break;
+    }
+
+    case 'G': //Start or stop the continuous tooth/composite log for the 'g' command
+    {
+      //2nd byte: 1 == start, 0 == stop
+      if (serialPayload[2] == 1U)
+      {
+        //Busy if the SD card log is using the stream
+        sendReturnCodeMsg(startToothLogStream(ToothLogSink::Serial) ? SERIAL_RC_OK : SERIAL_RC_BUSY_ERR);
+      }
+      else
+      {
+        stopToothLogStream(ToothLogSink::Serial);
+        sendReturnCodeMsg(SERIAL_RC_OK);
+      }
+      break;
+    }
+
     case 'M':
     {
       //New write command
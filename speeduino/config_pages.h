@@ -320,7 +320,7 @@ struct config2 : public config_page_t {
   byte idleAdvVss;
   byte mapSwitchPoint;
 
-  byte unused1_126_1 : 1;
+  byte perToothFuel : 1; ///< Re-anchor pending injector open events on each tooth. See checkPerToothFuelTiming()
   byte unused1_126_2 : 1;
   byte canWBO : 2 ;
   byte vssAuxCh : 4;
@@ -880,7 +880,8 @@ struct config13 : public config_page_t {
   byte onboard_log_tr4_thr_on;        // "V",        0.1,   0.0,  0.0,  15.90,      2 ; * (  1 byte)    
   byte onboard_log_tr4_thr_off;       // "V",        0.1,   0.0,  0.0,  15.90,      2 ; * (  1 byte)   
   byte onboard_log_tr5_Epin_pin  :6;        // "pin",      0,    0, 0,  1,    255,        0 ;  
-  byte unused13_125_2            :2;
+  byte onboard_log_tooth_stream  :1;  // "Disabled", "Enabled" ;Stream the tooth/composite log to a .tlg file alongside the csv log
+  byte unused13_125_7            :1;
 
   byte hwTestIgnDuration;
   byte hwTestInjDuration;
@@ -928,7 +929,11 @@ struct config15 : public config_page_t {
   int8_t rollingProtRPMDelta[4]; // Signed RPM value representing how much below the RPM limit. Divided by 10
   byte rollingProtCutPercent[4];
   
-  //Bytes 106-255
-  byte Unused15_106_255[150];
+  //Tooth table decoder (DECODER_TOOTH_TABLE) wheel. See trigger_wheel_t
+  byte toothTableSlots;     ///< Number of equally spaced tooth positions on the wheel
+  byte toothTableTeeth[8];  ///< Bitmap of the positions with a tooth: bit (n%8) of byte n/8 is position n
+
+  //Bytes 115-255
+  byte Unused15_115_255[141];
 
 } __attribute__((packed,aligned(__alignof__(uint16_t)))); //The 32 bit systems require all structs to be fully packed, aligned to their largest member type 
@@ -7,7 +7,14 @@ All functions in the gamma file return
 
 void initialiseCorrections(void);
 uint16_t correctionsFuel(void);
-uint8_t calculateAfrTarget(table3d16RpmLoad &afrLookUpTable, const statuses &current, const config2 &page2, const config6 &page6);
+/** @brief Whether calculateAfrTarget() needs the AFR target table value. If not, the table needn't be looked up */
+bool isAfrTargetTableUsed(const config2 &page2, const config6 &page6);
+/**
+ * @brief Compute the AFR target
+ * 
+ * @param afrTableValue The AFR target table value at the current fuel load & RPM. Only read if isAfrTargetTableUsed()
+ */
+uint8_t calculateAfrTarget(uint8_t afrTableValue, const statuses &current, const config2 &page2, const config6 &page6);
 
 int8_t correctionsIgn(int8_t advance);
 int8_t correctionFixedTiming(int8_t advance);
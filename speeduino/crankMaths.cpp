@@ -1,15 +1,9 @@
+#include <type_traits>
 #include <avr-fast-shift.h>
 #include "globals.h"
 #include "crankMaths.h"
 #include "preprocessor.h"
-
-#define SECOND_DERIV_ENABLED                0          
-
-//These are only part of the experimental 2nd deriv calcs
-#if SECOND_DERIV_ENABLED!=0
-byte deltaToothCount = 0; //The last tooth that was used with the deltaV calc
-int rpmDelta;
-#endif
+#include "src/utils/seqlock.hpp"
 
 int16_t CRANK_ANGLE_MAX_IGN = 360;
 int16_t CRANK_ANGLE_MAX_INJ = 360; 
@@ -31,69 +25,270 @@ static constexpr uint8_t UQ1X15_Shift = 15U;
 static UQ1X15_t degreesPerMicro;
 static constexpr uint8_t degreesPerMicro_Shift = UQ1X15_Shift;
 
+typedef uint32_t UQ0X32_t;
+
+/** @brief RPM at the current revolution time.
+ * 
+ * Derived from the same reciprocal as degreesPerMicro, so the decoders getRPM() needn't divide again.
+ */
+static uint16_t revolutionRpm;
+
+typedef uint32_t UQ22X10_t;
+static constexpr uint8_t UQ22X10_Shift = 10U;
+
+/** @brief Timer ticks per degree at current RPM in UQ22.10 fixed point.
+ * 
+ * Calculated once per revolution time, so angleToTimerTicks() is a single multiply & shift.
+ * 10 fractional bits keep the error under 1 tick for 720° on the coarsest (native) timer
+ * without overflowing at MIN_RPM on the finest (Teensy 4.1).
+ */
+static UQ22X10_t timerTicksPerDegree;
+static constexpr uint8_t timerTicksPerDegree_Shift = UQ22X10_Shift;
+
+/// @cond
+// Timer ticks per µS, in UQ8.24 fixed point. Derived from the board's own µS->tick conversion
+// at a reference time that is exactly representable on all boards.
+static constexpr uint32_t TICKS_PER_MICRO_REFERENCE = 50000UL;
+static constexpr uint8_t TICKS_PER_MICRO_Shift = 24U;
+static constexpr uint32_t TICKS_PER_MICRO = (uint32_t)(((uint64_t)uS_TO_TIMER_COMPARE(TICKS_PER_MICRO_REFERENCE) << TICKS_PER_MICRO_Shift) / TICKS_PER_MICRO_REFERENCE);
+static_assert(uS_TO_TIMER_COMPARE(TICKS_PER_MICRO_REFERENCE) > 0U, "Timer ticks are too coarse for the reference time");
+/// @endcond
+
+// UQ24.8 * UQ8.24 => UQ22.10
+static constexpr uint8_t TICKS_PER_DEGREE_SHIFT = (microsPerDegree_Shift + TICKS_PER_MICRO_Shift) - timerTicksPerDegree_Shift;
+static constexpr uint32_t TICKS_PER_MICRO_MAX_SHIFTED = UINT32_C(1) << TICKS_PER_DEGREE_SHIFT;
+
+static constexpr bool isPowerOfTwo(uint32_t value) { return (value!=0U) && ((value & (value-1U))==0U); }
+static constexpr uint8_t integerLog2(uint32_t value) { return value<=1U ? 0U : (uint8_t)(1U + integerLog2(value>>1U)); }
+
+// Whole number of µS per tick (E.g. 4µS on AVR): the conversion is a shift (if anything), 
+// avoiding a slow 64-bit multiply on 8-bit boards.
+static inline UQ22X10_t toTimerTicks(UQ24X8_t micros, std::true_type) noexcept {
+  constexpr uint8_t shift = TICKS_PER_DEGREE_SHIFT - integerLog2(TICKS_PER_MICRO);
+  constexpr uint32_t half = shift==0U ? 0U : (UINT32_C(1) << (shift-1U));
+  return (micros + half) >> shift;
+}
+
+static inline UQ22X10_t toTimerTicks(UQ24X8_t micros, std::false_type) noexcept {
+  constexpr uint64_t half = UINT64_C(1) << (TICKS_PER_DEGREE_SHIFT-1U);
+  return (UQ22X10_t)((((uint64_t)micros * TICKS_PER_MICRO) + half) >> TICKS_PER_DEGREE_SHIFT);
+}
+
+/** @brief µS (UQ24.8) to timer ticks (UQ22.10). A shift or a multiply, depending on the board's timer resolution */
+static inline UQ22X10_t toTimerTicks(UQ24X8_t micros) noexcept {
+  return toTimerTicks(micros, std::integral_constant<bool, isPowerOfTwo(TICKS_PER_MICRO) && (TICKS_PER_MICRO<=TICKS_PER_MICRO_MAX_SHIFTED)>());
+}
+/// @endcond
+
+/// @cond
+// Crank acceleration model.
+//
+// Built by the decoder ISR on every tooth & published as a single snapshot: readers copy it
+// (see Seqlock) rather than reading the individual values, so never see a partially updated model.
+struct acceleration_model_t {
+  /** @brief uS per degree at the last tooth in UQ24.8 fixed point. Zero if the model isn't valid */
+  UQ24X8_t microsPerDegree;
+  /** @brief Rate of change of microsPerDegree per degree of rotation, Q23.8 fixed point. Negative when accelerating */
+  int32_t slope;
+  /** @brief Timer ticks per degree at the last tooth, UQ22.10 fixed point. I.e. microsPerDegree in timer ticks */
+  UQ22X10_t timerTicksPerDegree;
+};
+static Seqlock<acceleration_model_t> accelerationModel;
+
+// Owned by the decoder ISR
+static uint32_t previousToothGap;
+static uint8_t toothGapCount;
+
+// Set by setAngleConverterToothAngle(), outside of the ISR
+/** @brief 1/tooth angle in UQ9.23 fixed point, so the ISR can multiply instead of divide. Zero if the model is disabled */
+static uint32_t toothAngleReciprocal;
+static constexpr uint8_t toothAngleReciprocal_Shift = 23U;
+/** @brief Longest tooth gap the model is used for. Keeps the fixed point maths in range */
+static uint32_t maxToothGap;
+
+/** @brief The model is only used below this uS per degree (I.e. above ~500rpm) - it keeps the fixed point maths in range */
+static constexpr UQ24X8_t MODEL_MAX_MICROS_PER_DEGREE = (MICROS_PER_DEG_1_RPM / 500UL) << microsPerDegree_Shift;
+// gap < maxToothGap => gap * toothAngleReciprocal < 2^32
+static_assert(((uint64_t)MODEL_MAX_MICROS_PER_DEGREE << (toothAngleReciprocal_Shift-microsPerDegree_Shift)) < UINT32_MAX, "Tooth gap * reciprocal overflows");
+
+/** @brief The acceleration is extrapolated for this many degrees, after which constant speed is assumed. */
+static constexpr uint16_t MODEL_HORIZON_DEGREES = 90U;
+
+/** @brief Maximum angle the acceleration correction is applied to. Keeps the fixed point maths in range */
+static constexpr uint16_t MODEL_MAX_CORRECTION_DEGREES = 720U;
+
+/** @brief Maximum number of iterations timeToAngle() uses to invert the model */
+static constexpr uint8_t MODEL_INVERSE_ITERATIONS = 4U;
+/// @endcond
+
+void setAngleConverterToothAngle(uint16_t angle) noexcept {
+  uint32_t reciprocal = angle==0U ? 0U : fast_div_closest(UINT32_C(1) << toothAngleReciprocal_Shift, (uint32_t)angle);
+  ATOMIC() {
+    toothAngleReciprocal = reciprocal;
+    maxToothGap = rshift<microsPerDegree_Shift>(MODEL_MAX_MICROS_PER_DEGREE * (uint32_t)angle);
+    setAngleConverterToothTime(0U, false);
+  }
+}
+
+/** @brief gap/tooth angle in UQ24.8 fixed point. gap must be less than maxToothGap */
+static inline UQ24X8_t toothGapPerDegree(uint32_t gap) noexcept {
+  return rshift_round<toothAngleReciprocal_Shift-microsPerDegree_Shift>(gap * toothAngleReciprocal);
+}
+
+void setAngleConverterToothTime(uint32_t gap, bool isRegularGap) noexcept {
+  acceleration_model_t model = { 0U, 0, 0U };
+  // A change in tooth spacing (E.g. a missing tooth) breaks the sequence
+  if (isRegularGap && (toothAngleReciprocal!=0U)) {
+    if (toothGapCount<2U) { ++toothGapCount; }
+    if ((toothGapCount>=2U) && (gap<maxToothGap) && (previousToothGap<maxToothGap)) {
+      // Average speed over each tooth gap. I.e. the speed at the middle of the gap.
+      UQ24X8_t current = toothGapPerDegree(gap);
+      UQ24X8_t previous = toothGapPerDegree(previousToothGap);
+      int32_t delta = (int32_t)current - (int32_t)previous;
+      uint32_t absDelta = (uint32_t)abs(delta);
+      // More than 25% change in one tooth isn't acceleration, it's noise (or a missed tooth)
+      if (absDelta<(current>>2U)) {
+        // delta/tooth angle. absDelta < 2^15, so the reciprocal is reduced to keep the product in range
+        constexpr uint8_t slopeReciprocal_Shift = toothAngleReciprocal_Shift-8U;
+        int32_t slope = (int32_t)((absDelta * rshift<8U>(toothAngleReciprocal)) >> slopeReciprocal_Shift);
+        model.slope = delta<0 ? -slope : slope;
+        // Extrapolate from the middle of the last gap to the tooth
+        model.microsPerDegree = (UQ24X8_t)((int32_t)current + (delta/2));
+        model.timerTicksPerDegree = toTimerTicks(model.microsPerDegree);
+      }
+    }
+    previousToothGap = gap;
+  } else {
+    toothGapCount = 0U;
+  }
+  accelerationModel.write(model);
+}
+
+void resetAngleConverterToothTimes(void) noexcept {
+  ATOMIC() {
+    setAngleConverterToothTime(0U, false);
+  }
+}
+
+/**
+ * @brief Should the acceleration model be used?
+ * 
+ * Only if it's valid & agrees (within 25%) with the revolution time. The latter guards against 
+ * using a stale model (E.g. after a stall)
+ */
+static inline bool useAccelerationModel(const acceleration_model_t &model) noexcept {
+  return (model.microsPerDegree > (microsPerDegree - (microsPerDegree>>2U))) 
+      && (model.microsPerDegree < (microsPerDegree + (microsPerDegree>>2U)));
+}
+
+/**
+ * @brief The integral of the (normalised) speed change over an angle.
+ * 
+ * Speed changes linearly up to the horizon, then is constant.
+ */
+static inline uint32_t accelerationArea(uint16_t angle) noexcept {
+  uint32_t accelerating = (std::min)(angle, MODEL_HORIZON_DEGREES);
+  return ((accelerating * accelerating) / 2U) + (accelerating * (uint32_t)(angle - accelerating));
+}
+
+/**
+ * @brief value/revolution time, rounded. From the UQ0.32 reciprocal of the revolution time: a multiply instead of a division
+ * 
+ * Only the high 32 bits of the 64 bit product are needed, so it's built from 16x16 bit partial products. A 64 bit
+ * multiply is a library call on 8-bit boards (__muldi3 on AVR).
+ */
+static inline uint32_t mulReciprocal(UQ0X32_t reciprocal, uint32_t value) noexcept {
+  uint32_t lowLow = (uint32_t)(uint16_t)reciprocal * (uint16_t)value;
+  uint32_t highLow = (uint32_t)(uint16_t)(reciprocal >> 16U) * (uint16_t)value;
+  uint32_t lowHigh = (uint32_t)(uint16_t)reciprocal * (uint16_t)(value >> 16U);
+  uint32_t highHigh = (uint32_t)(uint16_t)(reciprocal >> 16U) * (uint16_t)(value >> 16U);
+  // Bits 16-47 of the product, less the carries out of the high halves. At most 3*(2^16-1), so can't overflow
+  uint32_t middle = (lowLow >> 16U) + (uint16_t)highLow + (uint16_t)lowHigh;
+  // Bit 31 of the product rounds the result
+  return highHigh + (highLow >> 16U) + (lowHigh >> 16U) + (middle >> 16U) + ((middle >> 15U) & 1U);
+}
+
 void setAngleConverterRevolutionTime(uint32_t revolutionTime) noexcept {
-  microsPerDegree = div360(lshift<microsPerDegree_Shift>(revolutionTime));
+  // Derive everything first: only the stores need interrupts off (the ISRs use these, E.g. for per tooth timing)
+  UQ24X8_t newMicrosPerDegree = div360(lshift<microsPerDegree_Shift>(revolutionTime));
+  // The only division per revolution time. The truncated reciprocal is out by less than
+  // MICROS_PER_MIN/2^32 (0.014) RPM, so the results are within 1 of (almost always equal to)
+  // a rounded division.
+  UQ0X32_t reciprocal = fast_div(UINT32_MAX, revolutionTime);
   constexpr uint32_t UQ1X15_360 = UINT32_C(360) << degreesPerMicro_Shift;
-  degreesPerMicro = (uint16_t)fast_div_closest(UQ1X15_360, revolutionTime);
+  UQ1X15_t newDegreesPerMicro = (UQ1X15_t)mulReciprocal(reciprocal, UQ1X15_360);
+  uint16_t newRpm = (uint16_t)(std::min)(mulReciprocal(reciprocal, MICROS_PER_MIN), (uint32_t)MAX_RPM);
+  UQ22X10_t newTimerTicksPerDegree = toTimerTicks(newMicrosPerDegree);
+  ATOMIC() {
+    microsPerDegree = newMicrosPerDegree;
+    degreesPerMicro = newDegreesPerMicro;
+    revolutionRpm = newRpm;
+    timerTicksPerDegree = newTimerTicksPerDegree;
+  }
+}
+
+uint16_t getAngleConverterRpm(void) noexcept {
+  return revolutionRpm;
+}
+
+/** @brief The acceleration model's correction to the constant speed time for an angle, in µS (Q23.8) */
+static inline int32_t accelerationCorrection(const acceleration_model_t &model, uint16_t angle) noexcept {
+  return model.slope * (int32_t)accelerationArea((std::min)(angle, MODEL_MAX_CORRECTION_DEGREES));
 }
 
 BEGIN_LTO_ALWAYS_INLINE(uint32_t) angleToTime(uint16_t angle) noexcept {
+  acceleration_model_t model = accelerationModel.read();
+  if (useAccelerationModel(model)) {
+    // t = p0*θ + k*θ²/2 (up to the horizon)
+    int32_t micros = (int32_t)((uint32_t)angle * model.microsPerDegree) + accelerationCorrection(model, angle);
+    return micros<0 ? 0U : rshift_round<microsPerDegree_Shift>((uint32_t)micros);
+  }
   UQ24X8_t micros = (uint32_t)angle * (uint32_t)microsPerDegree;
   return rshift_round<microsPerDegree_Shift>(micros);
 }
 END_LTO_INLINE()
 
 BEGIN_LTO_ALWAYS_INLINE(COMPARE_TYPE) angleToTimerTicks(uint16_t angle) noexcept {
-    uint32_t micros = angleToTime(angle);
-    return uS_TO_TIMER_COMPARE(micros);
+    acceleration_model_t model = accelerationModel.read();
+    if (useAccelerationModel(model)) {
+      // As angleToTime(), but in timer ticks: the correction is converted the same way as the ticks per degree
+      UQ22X10_t ticks = (uint32_t)angle * model.timerTicksPerDegree;
+      int32_t correction = accelerationCorrection(model, angle);
+      UQ22X10_t correctionTicks = toTimerTicks((UQ24X8_t)abs(correction));
+      if (correction>=0) {
+        ticks = ticks + correctionTicks;
+      } else {
+        ticks = ticks>correctionTicks ? ticks - correctionTicks : 0U;
+      }
+      return (COMPARE_TYPE)rshift_round<timerTicksPerDegree_Shift>(ticks);
+    }
+    return (COMPARE_TYPE)rshift_round<timerTicksPerDegree_Shift>((uint32_t)angle * timerTicksPerDegree);
 }
 END_LTO_INLINE()
 
 BEGIN_LTO_ALWAYS_INLINE(uint16_t) timeToAngle(uint32_t time) noexcept {
+    acceleration_model_t model = accelerationModel.read();
+    if (useAccelerationModel(model)) {
+      // Degrees per uS at the last tooth (UQ1.15) & slope/p0 (Q15.16). Derived here, in the main loop, to
+      // keep the division out of the ISR.
+      UQ1X15_t modelDegreesPerMicro = (UQ1X15_t)fast_div_closest(UINT32_C(1) << (degreesPerMicro_Shift+microsPerDegree_Shift), model.microsPerDegree);
+      int32_t modelSlopeRatio = (model.slope * (int32_t)modelDegreesPerMicro) / (INT32_C(1) << (degreesPerMicro_Shift+microsPerDegree_Shift-16U));
+      // Inverse of angleToTime() by fixed point iteration: θ = t/p0 - (k/p0)*area(θ)
+      // Starting from the constant speed angle, this converges quickly (the correction is small). 
+      // Short angles, the common case, usually need a single iteration.
+      int32_t constantSpeedDegrees = (int32_t)rshift_round<degreesPerMicro_Shift>(time * (uint32_t)modelDegreesPerMicro);
+      int32_t degrees = constantSpeedDegrees;
+      int32_t previousDegrees;
+      uint8_t iterations = MODEL_INVERSE_ITERATIONS;
+      do {
+        previousDegrees = degrees;
+        uint16_t correctionDegrees = (uint16_t)(std::max)((int32_t)0, (std::min)(degrees, (int32_t)MODEL_MAX_CORRECTION_DEGREES));
+        degrees = constantSpeedDegrees - ((modelSlopeRatio * (int32_t)accelerationArea(correctionDegrees)) / 65536L);
+        --iterations;
+      } while ((iterations>0U) && (degrees!=previousDegrees));
+      return degrees<0 ? 0U : (uint16_t)degrees;
+    }
     uint32_t degFixed = time * (uint32_t)degreesPerMicro;
     return rshift_round<degreesPerMicro_Shift>(degFixed);
 }
 END_LTO_INLINE()
-
-#if SECOND_DERIV_ENABLED!=0
-void doCrankSpeedCalcs(void)
-{
-     //********************************************************
-      //How fast are we going? Need to know how long (uS) it will take to get from one tooth to the next. We then use that to estimate how far we are between the last tooth and the next one
-      //We use a 1st Deriv acceleration prediction, but only when there is an even spacing between primary sensor teeth
-      //Any decoder that has uneven spacing has its triggerToothAngle set to 0
-      //THIS IS CURRENTLY DISABLED FOR ALL DECODERS! It needs more work. 
-      if( (getDecoder().getFeatures().supports2ndDeriv) && (toothHistoryIndex >= 3) && (currentStatus.RPM < 2000) ) //toothHistoryIndex must be greater than or equal to 3 as we need the last 3 entries. Currently this mode only runs below 3000 rpm
-      {
-        //Only recalculate deltaV if the tooth has changed since last time (DeltaV stays the same until the next tooth)
-        //if (deltaToothCount != toothCurrentCount)
-        {
-          deltaToothCount = toothCurrentCount;
-          int angle1, angle2; //These represent the crank angles that are travelled for the last 2 pulses
-          if(configPage4.TrigPattern == 4)
-          {
-            //Special case for 70/110 pattern on 4g63
-            angle2 = triggerToothAngle; //Angle 2 is the most recent
-            if (angle2 == 70) { angle1 = 110; }
-            else { angle1 = 70; }
-          }
-          else if(configPage4.TrigPattern == 0)
-          {
-            //Special case for missing tooth decoder where the missing tooth was one of the last 2 seen
-            if(toothCurrentCount == 1) { angle2 = 2*triggerToothAngle; angle1 = triggerToothAngle; }
-            else if(toothCurrentCount == 2) { angle1 = 2*triggerToothAngle; angle2 = triggerToothAngle; }
-            else { angle1 = triggerToothAngle; angle2 = triggerToothAngle; }
-          }
-          else { angle1 = triggerToothAngle; angle2 = triggerToothAngle; }
-
-          uint32_t toothDeltaV = (MICROS_PER_SEC * angle2 / toothHistory[toothHistoryIndex]) - (MICROS_PER_SEC * angle1 / toothHistory[toothHistoryIndex-1]);
-          uint32_t toothDeltaT = toothHistory[toothHistoryIndex];
-          //long timeToLastTooth = micros() - toothLastToothTime;
-
-          rpmDelta = lshift<10>(toothDeltaV) / (6 * toothDeltaT);
-        }
-
-          timePerDegreex16 = ldiv( 2666656L, currentStatus.RPM + rpmDelta).quot; //This gives accuracy down to 0.1 of a degree and can provide noticeably better timing results on low resolution triggers
-      }
-}
-#endif
\ No newline at end of file
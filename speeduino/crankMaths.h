@@ -62,6 +62,44 @@ static inline int16_t ignitionLimits(int16_t angle) {
  */
 void setAngleConverterRevolutionTime(uint32_t revolutionTime) noexcept;
 
+/**
+ * @brief The RPM at the revolution time last passed to setAngleConverterRevolutionTime()
+ * 
+ * That calculates it along with the angle conversion factors, from a single reciprocal
+ * of the revolution time. So this is just a read: no division.
+ * 
+ * @return RPM, limited to MAX_RPM
+ */
+uint16_t getAngleConverterRpm(void) noexcept;
+
+/**
+ * @brief Set the spacing of the teeth fed to setAngleConverterToothTime().
+ * 
+ * Call when the decoder is set up, outside of the tooth ISR: this is where the acceleration model's
+ * only division happens. Discards any previous tooth gaps.
+ * 
+ * @param angle Crank degrees between teeth. Zero disables the acceleration model.
+ */
+void setAngleConverterToothAngle(uint16_t angle) noexcept;
+
+/**
+ * @brief Feed the crank acceleration model with the latest tooth gap.
+ * 
+ * Called by decoders (from the tooth ISR) that have evenly spaced teeth & set decoder_features_t::supports2ndDeriv.
+ * When the model has 2 consecutive regular gaps, angleToTime() & timeToAngle() take the
+ * crank acceleration into account instead of assuming constant speed.
+ * 
+ * The model is rebuilt here, without any divisions, & published as a single snapshot.
+ * 
+ * @param gap Time since the previous tooth in µS
+ * @param isRegularGap true if the gap spans the angle passed to setAngleConverterToothAngle(); false otherwise
+ * (E.g. a missing tooth), which restarts the model.
+ */
+void setAngleConverterToothTime(uint32_t gap, bool isRegularGap) noexcept;
+
+/** @brief Discard all tooth gaps: angleToTime() & timeToAngle() revert to constant speed */
+void resetAngleConverterToothTimes(void) noexcept;
+
 /**
  * @brief Converts angular degrees to the time interval that amount of rotation
  * will take at current RPM.
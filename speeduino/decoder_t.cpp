@@ -1,5 +1,6 @@
 #include <Arduino.h>
 #include "decoder_t.h"
+#include "atomic.h"
 
 #pragma GCC optimize("Os")
 
@@ -17,7 +18,11 @@ uint8_t interrupt_t::attach(uint8_t pin)
     _pin.setPin(pin);
     if (isValid())
     {
+#if defined(ISR_PROFILER)
+        attachInterrupt(digitalPinToInterrupt(pin), profiler!=nullptr ? profiler : callback, edge);
+#else
         attachInterrupt(digitalPinToInterrupt(pin), callback, edge);
+#endif
         return pin;
     }
     return NOT_A_PIN;
@@ -38,4 +43,89 @@ bool interrupt_t::isTriggered(void) const
         || (edge==FALLING && !isPinHigh())
         || (edge==RISING && isPinHigh())
     );
-}
\ No newline at end of file
+}
+
+void isr_timing_t::record(uint16_t durationMicros)
+{
+    if (durationMicros > maximum) { maximum = durationMicros; }
+    if (count == UINT16_MAX)
+    {
+        count = count >> 1U;
+        total = total >> 1U;
+    }
+    ++count;
+    total = total + durationMicros;
+}
+
+uint16_t isr_timing_t::mean(void) const
+{
+    return count==0U ? 0U : (uint16_t)(total / count);
+}
+
+void isr_timing_t::reset(void)
+{
+    maximum = 0U;
+    count = 0U;
+    total = 0U;
+}
+
+#if defined(ISR_PROFILER)
+
+static uint8_t* writeU16(uint8_t *pBuffer, uint16_t value)
+{
+    pBuffer[0] = lowByte(value);
+    pBuffer[1] = highByte(value);
+    return pBuffer + 2U;
+}
+
+static uint8_t* writeTiming(uint8_t *pBuffer, const interrupt_t &input)
+{
+    isr_timing_t timing;
+    ATOMIC()
+    {
+        timing = input.timing;
+    }
+    pBuffer = writeU16(pBuffer, timing.maximum);
+    pBuffer = writeU16(pBuffer, timing.mean());
+    return writeU16(pBuffer, timing.count);
+}
+
+static constexpr uint8_t TRIGGER_INPUT_COUNT = 3U;
+
+uint16_t serialiseIsrProfile(const decoder_t &decoder, uint8_t *pBuffer, uint16_t bufferSize)
+{
+    constexpr uint16_t requiredSize = 1U + (TRIGGER_INPUT_COUNT * 3U * sizeof(uint16_t));
+    if (bufferSize < requiredSize) { return 0U; }
+
+    uint8_t *pNext = pBuffer;
+    *pNext++ = TRIGGER_INPUT_COUNT;
+    pNext = writeTiming(pNext, decoder.primary);
+    pNext = writeTiming(pNext, decoder.secondary);
+    pNext = writeTiming(pNext, decoder.tertiary);
+    return (uint16_t)(pNext - pBuffer);
+}
+
+void resetIsrProfile(decoder_t &decoder)
+{
+    ATOMIC()
+    {
+        decoder.primary.timing.reset();
+        decoder.secondary.timing.reset();
+        decoder.tertiary.timing.reset();
+    }
+}
+
+#else
+
+uint16_t serialiseIsrProfile(const decoder_t &, uint8_t *pBuffer, uint16_t bufferSize)
+{
+    if (bufferSize < 1U) { return 0U; }
+    pBuffer[0] = 0U;
+    return 1U;
+}
+
+void resetIsrProfile(decoder_t &)
+{
+}
+
+#endif
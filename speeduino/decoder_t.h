@@ -6,6 +6,28 @@
 /** @brief This constant represents no trigger edge */
 static constexpr uint8_t TRIGGER_EDGE_NONE = 99;
 
+/**
+ * @brief Execution time statistics for one trigger ISR
+ * 
+ * Only recorded if ISR_PROFILER is defined. It's opt in on all boards, since it adds 2 micros()
+ * calls to every trigger interrupt. A long trigger ISR delays every other interrupt, including
+ * the schedule timer compares, so the maximum is the worst case latency it adds to them.
+ */
+struct isr_timing_t {
+  uint16_t maximum = 0U;  ///< Longest execution time, µS
+  uint16_t count = 0U;    ///< Number of samples in total
+  uint32_t total = 0U;    ///< Sum of all execution times, µS
+
+  /** @brief Record one execution time. Ages the mean (halves count & total) instead of overflowing */
+  void record(uint16_t durationMicros);
+
+  /** @brief Mean execution time, µS */
+  uint16_t mean(void) const;
+
+  /** @brief Clear all statistics */
+  void reset(void);
+};
+
 /** @brief This structure represents a trigger interrupt */
 struct interrupt_t
 {
@@ -49,6 +71,13 @@ struct interrupt_t
   }
 
   boardInputPin_t _pin;
+
+#if defined(ISR_PROFILER)
+  /** @brief If set, attached to the pin in place of callback. It must run callback & record into timing */
+  callback_t profiler = nullptr;
+  /** @brief Execution time of callback when run from the pin interrupt */
+  isr_timing_t timing;
+#endif
 };
 
 /** \enum SyncStatus
@@ -160,3 +189,20 @@ struct decoder_t
   feature_fun_t getFeatures;
   /// @}  
 };
+
+/**
+ * @brief Serialise the trigger ISR execution times for TunerStudio (or other tools).
+ * 
+ * Format (all values little endian):
+ *  - uint8_t input count (0 if ISR_PROFILER isn't defined)
+ *  - For each input (primary, secondary, tertiary): max, mean, count (uint16_t each)
+ * 
+ * @param decoder The decoder whose interrupts are attached
+ * @param pBuffer Destination
+ * @param bufferSize Size of @p pBuffer
+ * @return Number of bytes written
+ */
+uint16_t serialiseIsrProfile(const decoder_t &decoder, uint8_t *pBuffer, uint16_t bufferSize);
+
+/** @brief Clear the trigger ISR execution times */
+void resetIsrProfile(decoder_t &decoder);
@@ -42,6 +42,32 @@ decoder_t triggerSetup_SuzukiK6A(void);
 decoder_t triggerSetup_FordTFI(void);
 /// @}
 
+/** @brief Maximum number of tooth positions on a trigger_wheel_t: the bits in config15::toothTableTeeth. Enough for a 60-2 wheel */
+static constexpr uint8_t TOOTH_TABLE_MAX_SLOTS = 64U;
+
+/**
+ * @brief An arbitrary single trigger wheel, for the tooth table decoder (DECODER_TOOTH_TABLE)
+ *
+ * The wheel is divided into equally spaced positions, each of which has a tooth or not. E.g. a 36-2-2-2
+ * wheel is 36 positions with 3 pairs of empty ones.
+ *
+ * There is no separate sync description: the sync point is derived from the spacing of the teeth.
+ * I.e. the wheel needs a unique gap pattern somewhere, like the gap on a missing tooth wheel.
+ */
+struct trigger_wheel_t {
+  const uint8_t *teeth;   ///< Bitmap of the positions with a tooth: bit (n%8) of byte n/8 is position n. Position 0 is at 0°
+  uint8_t slotCount;      ///< Number of positions. At most TOOTH_TABLE_MAX_SLOTS & must divide cycleDegrees exactly
+  uint16_t cycleDegrees;  ///< 360 for a crank wheel, 720 for a cam wheel
+};
+
+/**
+ * @brief Setup the table driven decoder for the wheel in the tune (config15::toothTableSlots & config15::toothTableTeeth)
+ *
+ * If the wheel cannot be decoded (E.g. the tooth spacing has no unique gap pattern) the decoder
+ * still runs, so the tooth logger works, but never gains sync.
+ */
+decoder_t triggerSetup_toothTable(void);
+
 // TODO: use same VVT scheme as other decoders
 int getCamAngle_Miata9905(void);
 
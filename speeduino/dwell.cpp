@@ -1,6 +1,11 @@
 #include "dwell.h"
 
-uint16_t computeDwell(const statuses &current, const config2 &page2, const config4 &page4, const table3d4RpmLoad &dwellTable)
+bool isDwellMapUsed(const config2 &page2)
+{
+    return page2.useDwellMap == true;
+}
+
+uint16_t computeDwell(const statuses &current, const config2 &page2, const config4 &page4, uint8_t dwellMapValue)
 {
     uint16_t dwell;
     if ( current.rotationStatus==EngineRotationStatus::Cranking )
@@ -9,9 +14,9 @@ uint16_t computeDwell(const statuses &current, const config2 &page2, const confi
     }
     else 
     {
-        if ( page2.useDwellMap == true )
+        if ( isDwellMapUsed(page2) )
         {
-            dwell = get3DTableValue(&dwellTable, current.ignLoad, current.RPM); //use running dwell from map
+            dwell = dwellMapValue; //use running dwell from map
         }
         else
         {
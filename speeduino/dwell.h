@@ -3,7 +3,11 @@
 #include <stdint.h>
 #include "statuses.h"
 #include "config_pages.h"
-#include "table3d.h"
+
+/**
+ * @brief Whether computeDwell() needs the dwell map value. If not, the map needn't be looked up
+ */
+bool isDwellMapUsed(const config2 &page2);
 
 /**
  * @brief Compute the ignition dwell
@@ -11,7 +15,7 @@
  * @param current Current system state
  * @param page2 Tune
  * @param page4 Tune
- * @param dwellTable Tune 
+ * @param dwellMapValue The dwell map value at the current ignition load & RPM. Only read if isDwellMapUsed()
  * @return uint16_t Dwell in µS
  */
-uint16_t computeDwell(const statuses &current, const config2 &page2, const config4 &page4, const table3d4RpmLoad &dwellTable);
\ No newline at end of file
+uint16_t computeDwell(const statuses &current, const config2 &page2, const config4 &page4, uint8_t dwellMapValue);
\ No newline at end of file
@@ -185,12 +185,11 @@ static inline uint32_t calcStageSecondaryPw(uint32_t totalPw, const config10 &pa
   return fast_div(totalPw, page10.stagedInjSizeSec);
 }
 
-static inline pulseWidths applyStagingModeTable(uint16_t primaryPW, uint16_t injOpenTime, const config10 &page10, const statuses &current) {
+static inline pulseWidths applyStagingModeTable(uint16_t primaryPW, uint16_t injOpenTime, uint8_t stagingSplit, const config10 &page10) {
   uint32_t totalPw = calcTotalStagePw(primaryPW, injOpenTime, page10);
   //Subtract the opening time from PW1 as it needs to be multiplied out again by the pri/sec req_fuel values below. It is added on again after that calculation. 
   uint32_t pwPrimaryStaged = calcStagePrimaryPw(totalPw, page10);
 
-  uint8_t stagingSplit = get3DTableValue(&stagingTable, current.fuelLoad, current.RPM);
   if(stagingSplit > 0U) 
   { 
     uint32_t pwSecondaryStaged = calcStageSecondaryPw(totalPw, page10);
@@ -224,12 +223,16 @@ static inline pulseWidths applyStagingModeAuto(uint16_t primaryPW, uint16_t pwLi
 }
 
 
-TESTABLE_INLINE_STATIC pulseWidths calculateSecondaryPw(uint16_t primaryPw, uint16_t pwLimit, uint16_t injOpenTime, const config2 &page2, const config10 &page10, const statuses &current) {
+bool isStagingTableUsed(const config2 &page2, const config10 &page10) {
+  return canApplyStaging(page2, page10) && (page10.stagingMode == STAGING_MODE_TABLE);
+}
+
+TESTABLE_INLINE_STATIC pulseWidths calculateSecondaryPw(uint16_t primaryPw, uint16_t pwLimit, uint16_t injOpenTime, uint8_t stagingSplit, const config2 &page2, const config10 &page10) {
   if(canApplyStaging(page2, page10) && (primaryPw!=0U) )
   {
     //Scale the 'full' pulsewidth by each of the injector capacities
     if(page10.stagingMode == STAGING_MODE_TABLE) {
-      return applyStagingModeTable(primaryPw, injOpenTime, page10, current);
+      return applyStagingModeTable(primaryPw, injOpenTime, stagingSplit, page10);
     }
     if(page10.stagingMode == STAGING_MODE_AUTO) {
       return applyStagingModeAuto(primaryPw, pwLimit, injOpenTime, page10);
@@ -244,7 +247,7 @@ TESTABLE_INLINE_STATIC uint16_t calculateOpenTime(const config2 &page2, const st
   return page2.injOpen * current.batCorrection; 
 }
 
-pulseWidths computePulseWidths(const config2 &page2, const config6 &page6, const config10 &page10, const statuses &current) {
+pulseWidths computePulseWidths(const config2 &page2, const config6 &page6, const config10 &page10, const statuses &current, uint8_t stagingSplit) {
   if (current.corrections!=0U) {
     uint16_t pwLimit = calculatePWLimit(page2, current);
     uint16_t injOpenTime = calculateOpenTime(page2, current);
@@ -256,7 +259,7 @@ pulseWidths computePulseWidths(const config2 &page2, const config6 &page6, const
                                         pwLimit,
                                         page10,
                                         current);
-    return calculateSecondaryPw(primaryPw, pwLimit, injOpenTime, page2, page10, current);  
+    return calculateSecondaryPw(primaryPw, pwLimit, injOpenTime, stagingSplit, page2, page10);  
   }
   return { 0U, 0U };
 }
\ No newline at end of file
@@ -31,6 +31,12 @@ struct pulseWidths {
  * @param page6 Tune settings
  * @param page10 Tune settings
  * @param current Current system state
+ * @param stagingSplit The staging table value at the current fuel load & RPM. Only read if isStagingTableUsed()
  * @return pulseWidths The primary and secondary injector pulse width in uS
  */
-pulseWidths computePulseWidths(const config2 &page2, const config6 &page6, const config10 &page10, const statuses &current);
+pulseWidths computePulseWidths(const config2 &page2, const config6 &page6, const config10 &page10, const statuses &current, uint8_t stagingSplit);
+
+/**
+ * @brief Whether computePulseWidths() needs the staging table value. If not, the table needn't be looked up
+ */
+bool isStagingTableUsed(const config2 &page2, const config10 &page10);
@@ -4,7 +4,11 @@
 #include "globals.h"
 #include "preprocessor.h"
 
+#if defined(TABLE3D_LARGE_TABLES)
+struct table3d24RpmLoad fuelTable; ///< 24x24 fuel map
+#else
 struct table3d16RpmLoad fuelTable; ///< 16x16 fuel map
+#endif
 struct table3d16RpmLoad fuelTable2; ///< 16x16 fuel map
 struct table3d16RpmLoad ignitionTable; ///< 16x16 ignition map
 struct table3d16RpmLoad ignitionTable2; ///< 16x16 ignition map
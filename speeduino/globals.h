@@ -38,7 +38,11 @@ constexpr uint8_t TOOTH_LOG_SIZE = 127U;
 constexpr uint8_t TOOTH_LOG_SIZE = 2U;
 #endif
 
+#if defined(TABLE3D_LARGE_TABLES)
+extern struct table3d24RpmLoad fuelTable; //24x24 fuel map
+#else
 extern struct table3d16RpmLoad fuelTable; //16x16 fuel map
+#endif
 extern struct table3d16RpmLoad fuelTable2; //16x16 fuel map
 extern struct table3d16RpmLoad ignitionTable; //16x16 ignition map
 extern struct table3d16RpmLoad ignitionTable2; //16x16 ignition map
@@ -130,6 +130,7 @@ void initialiseAll(void)
     loadAllPages();
     loadAllCalibrationTables(); 
     doUpdates(); //Check if any data items need updating (Occurs with firmware updates)
+    refreshAllCalibrationLuts(); //Must be after doUpdates(), which can alter the calibration curves
 #endif
 
     //Always start with a clean slate on the bootloader capabilities level
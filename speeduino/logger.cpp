@@ -6,6 +6,7 @@
 #include "preprocessor.h"
 #include "units.h"
 #include "board_definition.h" 
+#include "tooth_log_stream.h"
 #include "decoder_init.h"
 #include "scheduledIO_inj.h"
 #include "resetControl.h"
@@ -731,6 +732,59 @@ static inline void attachLoggerInterrupt(uint8_t pin, void (*loggerISR)(void))
   attachInterrupt( digitalPinToInterrupt(pin), loggerISR, CHANGE );
 }
 
+static inline void detachLoggerInterrupt(uint8_t pin, interrupt_t &decoderInterrupt)
+{
+  detachInterrupt( digitalPinToInterrupt(pin) );
+ (void)decoderInterrupt.attach(pin);
+}
+
+// The trigger inputs, as bits of the masks below
+static constexpr uint8_t LOGGER_INPUT_PRIMARY = 0U;
+static constexpr uint8_t LOGGER_INPUT_SECONDARY = 1U;
+static constexpr uint8_t LOGGER_INPUT_TERTIARY = 2U;
+
+// The TunerStudio loggers & the tooth log stream share the logger ISRs. Each tracks the inputs it needs,
+// so that stopping one doesn't disconnect an input the other is still logging.
+static uint8_t tsLoggerInputs = 0U;
+static uint8_t streamLoggerInputs = 0U;
+
+static void attachLoggerInputs(uint8_t inputs)
+{
+  if(BIT_CHECK(inputs, LOGGER_INPUT_PRIMARY)) { attachLoggerInterrupt( pinNumbers.pinTrigger, loggerPrimaryISR ); }
+  if(BIT_CHECK(inputs, LOGGER_INPUT_SECONDARY)) { attachLoggerInterrupt( pinNumbers.pinTrigger2, loggerSecondaryISR ); }
+  if(BIT_CHECK(inputs, LOGGER_INPUT_TERTIARY)) { attachLoggerInterrupt( pinNumbers.pinTrigger3, loggerTertiaryISR ); }
+}
+
+static void detachLoggerInputs(uint8_t inputs)
+{
+  //Disconnect the logger interrupts and attach the normal ones
+  if(BIT_CHECK(inputs, LOGGER_INPUT_PRIMARY)) { detachLoggerInterrupt( pinNumbers.pinTrigger, currentStatus.decoder.primary ); }
+  if(BIT_CHECK(inputs, LOGGER_INPUT_SECONDARY)) { detachLoggerInterrupt( pinNumbers.pinTrigger2, currentStatus.decoder.secondary ); }
+  if(BIT_CHECK(inputs, LOGGER_INPUT_TERTIARY)) { detachLoggerInterrupt( pinNumbers.pinTrigger3, currentStatus.decoder.tertiary ); }
+}
+
+/**
+ * @brief Switch one logger's inputs over to the logger ISRs
+ * 
+ * @param ownInputs The logger's current inputs. Updated to @p inputs
+ * @param inputs The inputs the logger now needs. 0 when stopping
+ * @param otherInputs The other logger's inputs: left alone
+ */
+static void setLoggerInputs(uint8_t &ownInputs, uint8_t inputs, uint8_t otherInputs)
+{
+  detachLoggerInputs(ownInputs & (uint8_t)~(inputs | otherInputs));
+  attachLoggerInputs(inputs & (uint8_t)~otherInputs);
+  ownInputs = inputs;
+}
+
+static inline uint8_t getCrankAndCamInputs(void)
+{
+  uint8_t inputs = 0U;
+  BIT_SET(inputs, LOGGER_INPUT_PRIMARY);
+  if( (VSS_USES_RPM2() != true) && (FLEX_USES_RPM2() != true) ) { BIT_SET(inputs, LOGGER_INPUT_SECONDARY); }
+  return inputs;
+}
+
 void startToothLogger(void)
 {
   currentStatus.toothLogEnabled = true;
@@ -739,31 +793,16 @@ void startToothLogger(void)
   toothHistoryIndex = 0U;
 
   //Disconnect the standard interrupt and add the logger version
-  attachLoggerInterrupt( pinNumbers.pinTrigger, loggerPrimaryISR );
-
-  if(VSS_USES_RPM2() != true)
-  {
-    attachLoggerInterrupt( pinNumbers.pinTrigger2, loggerSecondaryISR );
-  }
-}
-
-static inline void detachLoggerInterrupt(uint8_t pin, interrupt_t &decoderInterrupt)
-{
-  detachInterrupt( digitalPinToInterrupt(pin) );
- (void)decoderInterrupt.attach(pin);
+  uint8_t inputs = 0U;
+  BIT_SET(inputs, LOGGER_INPUT_PRIMARY);
+  if(VSS_USES_RPM2() != true) { BIT_SET(inputs, LOGGER_INPUT_SECONDARY); }
+  setLoggerInputs(tsLoggerInputs, inputs, streamLoggerInputs);
 }
 
 void stopToothLogger(void)
 {
   currentStatus.toothLogEnabled = false;
-
-  //Disconnect the logger interrupts and attach the normal ones
-  detachLoggerInterrupt( pinNumbers.pinTrigger, currentStatus.decoder.primary );
-
-  if(VSS_USES_RPM2() != true)
-  {
-    detachLoggerInterrupt( pinNumbers.pinTrigger2, currentStatus.decoder.secondary );
-  }
+  setLoggerInputs(tsLoggerInputs, 0U, streamLoggerInputs);
 }
 
 void startCompositeLogger(void)
@@ -774,25 +813,13 @@ void startCompositeLogger(void)
   toothHistoryIndex = 0U;
 
   //Disconnect the standard interrupt and add the logger version
-  attachLoggerInterrupt( pinNumbers.pinTrigger, loggerPrimaryISR );
-
-  if( (VSS_USES_RPM2() != true) && (FLEX_USES_RPM2() != true) )
-  {
-    attachLoggerInterrupt( pinNumbers.pinTrigger2, loggerSecondaryISR );
-  }
+  setLoggerInputs(tsLoggerInputs, getCrankAndCamInputs(), streamLoggerInputs);
 }
 
 void stopCompositeLogger(void)
 {
   currentStatus.compositeTriggerUsed = 0U;
-
-  //Disconnect the logger interrupts and attach the normal ones
-  detachLoggerInterrupt( pinNumbers.pinTrigger, currentStatus.decoder.primary );
-
-  if( (VSS_USES_RPM2() != true) && (FLEX_USES_RPM2() != true) )
-  {
-    detachLoggerInterrupt( pinNumbers.pinTrigger2, currentStatus.decoder.secondary );
-  }
+  setLoggerInputs(tsLoggerInputs, 0U, streamLoggerInputs);
 }
 
 void startCompositeLoggerTertiary(void)
@@ -803,17 +830,16 @@ void startCompositeLoggerTertiary(void)
   toothHistoryIndex = 0U;
 
   //Disconnect the standard interrupt and add the logger version
-  attachLoggerInterrupt( pinNumbers.pinTrigger, loggerPrimaryISR );
-  attachLoggerInterrupt( pinNumbers.pinTrigger3, loggerTertiaryISR );
+  uint8_t inputs = 0U;
+  BIT_SET(inputs, LOGGER_INPUT_PRIMARY);
+  BIT_SET(inputs, LOGGER_INPUT_TERTIARY);
+  setLoggerInputs(tsLoggerInputs, inputs, streamLoggerInputs);
 }
 
 void stopCompositeLoggerTertiary(void)
 {
   currentStatus.compositeTriggerUsed = 0;
-
-  //Disconnect the logger interrupts and attach the normal ones
-  detachLoggerInterrupt( pinNumbers.pinTrigger, currentStatus.decoder.primary );
-  detachLoggerInterrupt( pinNumbers.pinTrigger3, currentStatus.decoder.tertiary );
+  setLoggerInputs(tsLoggerInputs, 0U, streamLoggerInputs);
 }
 
 
@@ -825,23 +851,30 @@ void startCompositeLoggerCams(void)
   toothHistoryIndex = 0;
 
   //Disconnect the standard interrupt and add the logger version
-  if( (VSS_USES_RPM2() != true) && (FLEX_USES_RPM2() != true) )
-  {
-    attachLoggerInterrupt( pinNumbers.pinTrigger2, loggerSecondaryISR );
-  }
-
-  attachLoggerInterrupt( pinNumbers.pinTrigger3, loggerTertiaryISR );
+  uint8_t inputs = 0U;
+  if( (VSS_USES_RPM2() != true) && (FLEX_USES_RPM2() != true) ) { BIT_SET(inputs, LOGGER_INPUT_SECONDARY); }
+  BIT_SET(inputs, LOGGER_INPUT_TERTIARY);
+  setLoggerInputs(tsLoggerInputs, inputs, streamLoggerInputs);
 }
 
 void stopCompositeLoggerCams(void)
 {
   currentStatus.compositeTriggerUsed = false;
+  setLoggerInputs(tsLoggerInputs, 0U, streamLoggerInputs);
+}
 
-  //Disconnect the logger interrupts and attach the normal ones
-  if( (VSS_USES_RPM2() != true) && (FLEX_USES_RPM2() != true) )
-  {
-    detachLoggerInterrupt( pinNumbers.pinTrigger2, currentStatus.decoder.secondary );
-  }
+bool startToothLogStream(ToothLogSink sink)
+{
+  if(!toothLogStreamBegin(sink)) { return false; }
 
-  detachLoggerInterrupt( pinNumbers.pinTrigger3, currentStatus.decoder.tertiary );
+  //The crank, cam 1 &, if the decoder uses it, cam 2
+  uint8_t inputs = getCrankAndCamInputs();
+  if(currentStatus.decoder.tertiary.isValid()) { BIT_SET(inputs, LOGGER_INPUT_TERTIARY); }
+  setLoggerInputs(streamLoggerInputs, inputs, tsLoggerInputs);
+  return true;
+}
+
+void stopToothLogStream(ToothLogSink sink)
+{
+  if(toothLogStreamEnd(sink)) { setLoggerInputs(streamLoggerInputs, 0U, tsLoggerInputs); }
 }
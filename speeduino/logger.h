@@ -10,6 +10,7 @@
 #define LOGGER_H
 
 #include "statuses.h"
+#include "tooth_log_stream.h"
 
 constexpr uint8_t LOG_ENTRY_SIZE = 138; /**< The size of the live data packet. This MUST match ochBlockSize setting in the ini file */
 
@@ -31,6 +32,17 @@ void stopCompositeLoggerTertiary(void);
 void startCompositeLoggerCams(void);
 void stopCompositeLoggerCams(void);
 
+/**
+ * @brief Start the continuous tooth log stream (see tooth_log_stream.h), drained by @p sink
+ * 
+ * Independent of the TunerStudio tooth & composite loggers: either can be started & stopped while the other runs.
+ * @return false if another sink's capture is running (or the stream isn't built in)
+ */
+bool startToothLogStream(ToothLogSink sink);
+
+/** @brief Stop the stream started by startToothLogStream(). Does nothing if @p sink doesn't own it */
+void stopToothLogStream(ToothLogSink sink);
+
 /** @brief Build the TunerStudio engine status byte from the current status */
 byte buildEngineStatus(const statuses &current);
 
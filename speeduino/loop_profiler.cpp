@@ -0,0 +1,175 @@
+#include "loop_profiler.h"
+#include <string.h>
+#include <Arduino.h>
+
+void loop_section_stats_t::reset(void)
+{
+  minimum = UINT16_MAX;
+  maximum = 0U;
+  count = 0U;
+  memset(buckets, 0, sizeof(buckets));
+}
+
+uint8_t loopProfileBucket(uint16_t durationMicros)
+{
+  uint8_t bucket = 0U;
+  while ((durationMicros > 1U) && (bucket < (LOOP_PROFILE_BUCKETS-1U)))
+  {
+    durationMicros = durationMicros >> 1U;
+    ++bucket;
+  }
+  return bucket;
+}
+
+void loop_section_stats_t::record(uint16_t durationMicros)
+{
+  if ((count == 0U) || (durationMicros < minimum)) { minimum = durationMicros; }
+  if (durationMicros > maximum) { maximum = durationMicros; }
+
+  uint8_t bucket = loopProfileBucket(durationMicros);
+  if (buckets[bucket] == UINT16_MAX)
+  {
+    // Age the histogram rather than saturate: halving every bucket keeps the shape
+    // of the distribution (so the percentiles stay valid) & biases it to recent loops.
+    for (uint8_t index = 0U; index < LOOP_PROFILE_BUCKETS; ++index)
+    {
+      buckets[index] = buckets[index] >> 1U;
+    }
+    count = count >> 1U;
+  }
+  ++buckets[bucket];
+  if (count < UINT16_MAX) { ++count; }
+}
+
+uint16_t loop_section_stats_t::percentile(uint8_t percent) const
+{
+  uint32_t total = 0U;
+  for (uint8_t index = 0U; index < LOOP_PROFILE_BUCKETS; ++index)
+  {
+    total = total + buckets[index];
+  }
+  if (total == 0U) { return 0U; }
+
+  // Rank of the sample at the percentile, rounded up
+  uint32_t rank = ((total * percent) + 99U) / 100U;
+  uint32_t cumulative = 0U;
+  uint8_t bucket = 0U;
+  for (; bucket < LOOP_PROFILE_BUCKETS-1U; ++bucket)
+  {
+    cumulative = cumulative + buckets[bucket];
+    if (cumulative >= rank) { break; }
+  }
+  uint32_t upperBound = (2UL << bucket) - 1UL;
+  return upperBound > maximum ? maximum : (uint16_t)upperBound;
+}
+
+#if defined(LOOP_PROFILER)
+
+static loop_section_stats_t sectionStats[LOOP_SECTION_COUNT];
+static uint16_t sectionTime[LOOP_SECTION_COUNT]; // Time accumulated this loop pass, µS
+static uint16_t sectionsRun;                     // Bit mask of the sections marked this loop pass
+static uint32_t loopStartTime;
+static uint32_t lastMarkTime;
+
+static_assert(LOOP_SECTION_COUNT <= 16U, "sectionsRun is too small");
+
+static inline uint16_t clampToU16(uint32_t value)
+{
+  return value > UINT16_MAX ? UINT16_MAX : (uint16_t)value;
+}
+
+void loopProfilerStart(void)
+{
+  memset(sectionTime, 0, sizeof(sectionTime));
+  sectionsRun = 0U;
+  loopStartTime = micros();
+  lastMarkTime = loopStartTime;
+}
+
+void loopProfilerMark(LoopSection section)
+{
+  uint32_t now = micros();
+  uint8_t index = (uint8_t)section;
+  sectionTime[index] = clampToU16((uint32_t)sectionTime[index] + (now - lastMarkTime));
+  sectionsRun = sectionsRun | (uint16_t)(1U << index);
+  lastMarkTime = now;
+}
+
+void loopProfilerEnd(void)
+{
+  uint32_t now = micros();
+  for (uint8_t index = 0U; index < (uint8_t)LoopSection::Total; ++index)
+  {
+    if ((sectionsRun & (uint16_t)(1U << index)) != 0U)
+    {
+      sectionStats[index].record(sectionTime[index]);
+    }
+  }
+  sectionStats[(uint8_t)LoopSection::Total].record(clampToU16(now - loopStartTime));
+}
+
+const loop_section_stats_t& getLoopSectionStats(LoopSection section)
+{
+  return sectionStats[(uint8_t)section];
+}
+
+void resetLoopProfiler(void)
+{
+  for (uint8_t index = 0U; index < LOOP_SECTION_COUNT; ++index)
+  {
+    sectionStats[index].reset();
+  }
+}
+
+static uint8_t* writeU16(uint8_t *pBuffer, uint16_t value)
+{
+  pBuffer[0] = lowByte(value);
+  pBuffer[1] = highByte(value);
+  return pBuffer + 2U;
+}
+
+uint16_t serialiseLoopProfile(uint8_t *pBuffer, uint16_t bufferSize, uint8_t firstSection)
+{
+  if (bufferSize < (LOOP_PROFILE_HEADER_SIZE + LOOP_PROFILE_SECTION_SIZE)) { return 0U; }
+
+  uint8_t sectionCount = 0U;
+  if (firstSection < LOOP_SECTION_COUNT)
+  {
+    uint16_t fits = (bufferSize - LOOP_PROFILE_HEADER_SIZE) / LOOP_PROFILE_SECTION_SIZE;
+    uint8_t remaining = LOOP_SECTION_COUNT - firstSection;
+    sectionCount = fits < remaining ? (uint8_t)fits : remaining;
+  }
+
+  uint8_t *pNext = pBuffer;
+  *pNext++ = LOOP_SECTION_COUNT;
+  *pNext++ = LOOP_PROFILE_BUCKETS;
+  *pNext++ = firstSection;
+  *pNext++ = sectionCount;
+  for (uint8_t index = firstSection; index < (firstSection + sectionCount); ++index)
+  {
+    const loop_section_stats_t &stats = sectionStats[index];
+    pNext = writeU16(pNext, stats.count==0U ? 0U : stats.minimum);
+    pNext = writeU16(pNext, stats.maximum);
+    pNext = writeU16(pNext, stats.percentile(99U));
+    pNext = writeU16(pNext, stats.count);
+    for (uint8_t bucket = 0U; bucket < LOOP_PROFILE_BUCKETS; ++bucket)
+    {
+      pNext = writeU16(pNext, stats.buckets[bucket]);
+    }
+  }
+  return (uint16_t)(pNext - pBuffer);
+}
+
+#else
+
+uint16_t serialiseLoopProfile(uint8_t *pBuffer, uint16_t bufferSize, uint8_t firstSection)
+{
+  if (bufferSize < (LOOP_PROFILE_HEADER_SIZE + LOOP_PROFILE_SECTION_SIZE)) { return 0U; }
+  pBuffer[0] = 0U;
+  pBuffer[1] = LOOP_PROFILE_BUCKETS;
+  pBuffer[2] = firstSection;
+  pBuffer[3] = 0U;
+  return LOOP_PROFILE_HEADER_SIZE;
+}
+
+#endif
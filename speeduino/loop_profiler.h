@@ -0,0 +1,130 @@
+#pragma once
+
+/**
+ * @file
+ * @brief Main loop profiler: per subsystem execution time histograms.
+ *
+ * The main loop is split into sections (comms, sensors, table lookups etc.). Each call
+ * to loopProfilerMark() attributes the time since the previous mark to a section. At the
+ * end of the loop the accumulated time for each section that ran is recorded in that
+ * section's statistics: min, max & a log2 histogram from which percentiles are estimated.
+ *
+ * Only one micros() call per section boundary, so the overhead is a handful of µS per loop.
+ *
+ * Enabled by default on boards with spare RAM. On AVR it costs ~400 bytes of RAM, so must
+ * be turned on explicitly by defining LOOP_PROFILER.
+ */
+
+#include <stdint.h>
+#include "board_definition.h"
+
+#if !defined(CORE_AVR) && !defined(LOOP_PROFILER)
+#define LOOP_PROFILER
+#endif
+
+/** @brief The main loop sections that are timed */
+enum class LoopSection : uint8_t {
+  /** Serial, secondary serial & CAN */
+  Comms,
+  /** RPM & engine state from the decoder, plus polled sensor reads */
+  Sensors,
+  /** Timer driven auxiliary tasks: boost, VVT, CAN broadcast, programmable IO etc. */
+  Auxiliaries,
+  /** SD card log writes & syncs */
+  SdLogging,
+  /** Idle control */
+  Idle,
+  /** 3D table lookups: VE, spark, AFR target, secondary tables */
+  TableLookup,
+  /** Fuel, ignition & dwell corrections & pulse width calculations */
+  Corrections,
+  /** Fuel & ignition schedule setup */
+  Schedules,
+  /** The entire loop */
+  Total,
+};
+
+/** @brief Number of LoopSection values */
+static constexpr uint8_t LOOP_SECTION_COUNT = (uint8_t)LoopSection::Total + 1U;
+
+/** @brief Number of histogram buckets. Bucket N holds durations in [2^N, 2^(N+1)) µS (bucket 0 holds [0, 2)) */
+static constexpr uint8_t LOOP_PROFILE_BUCKETS = 16U;
+
+/** @brief Execution time statistics for one loop section */
+struct loop_section_stats_t {
+  uint16_t minimum;                         ///< Shortest duration, µS
+  uint16_t maximum;                         ///< Longest duration, µS
+  uint16_t count;                           ///< Number of samples (saturates)
+  uint16_t buckets[LOOP_PROFILE_BUCKETS];   ///< log2 histogram (each bucket saturates)
+
+  /** @brief Clear all statistics */
+  void reset(void);
+
+  /** @brief Record one duration */
+  void record(uint16_t durationMicros);
+
+  /**
+   * @brief Estimate a percentile from the histogram.
+   *
+   * @param percent Percentile required, E.g. 99
+   * @return Upper bound (µS) of the bucket containing the percentile, clamped to the maximum seen.
+   */
+  uint16_t percentile(uint8_t percent) const;
+};
+
+/** @brief Histogram bucket index for a duration */
+uint8_t loopProfileBucket(uint16_t durationMicros);
+
+#if defined(LOOP_PROFILER)
+
+/** @brief Begin profiling a main loop pass */
+void loopProfilerStart(void);
+
+/** @brief Attribute the time since the previous mark (or loop start) to @p section */
+void loopProfilerMark(LoopSection section);
+
+/** @brief End the current loop pass: record all sections that ran plus the total loop time */
+void loopProfilerEnd(void);
+
+/** @brief Get the statistics for a section */
+const loop_section_stats_t& getLoopSectionStats(LoopSection section);
+
+/** @brief Clear all statistics */
+void resetLoopProfiler(void);
+
+#else
+
+// Profiler compiled out: the calls in the main loop vanish.
+static inline void loopProfilerStart(void) { }
+static inline void loopProfilerMark(LoopSection) { }
+static inline void loopProfilerEnd(void) { }
+static inline void resetLoopProfiler(void) { }
+
+#endif
+
+/** @brief Size of the serialiseLoopProfile() header */
+static constexpr uint16_t LOOP_PROFILE_HEADER_SIZE = 4U;
+
+/** @brief Size of one section in the serialiseLoopProfile() output */
+static constexpr uint16_t LOOP_PROFILE_SECTION_SIZE = (4U + LOOP_PROFILE_BUCKETS) * sizeof(uint16_t);
+
+/**
+ * @brief Serialise the profiler statistics for TunerStudio (or other tools).
+ *
+ * All sections don't fit in the AVR serial buffer, so they are sent in pages: as many whole
+ * sections as fit, starting at @p firstSection. The caller requests the next page from
+ * firstSection + the number of sections sent, until all have been received.
+ *
+ * Format (all values little endian):
+ *  - uint8_t section count (0 if the profiler isn't compiled in)
+ *  - uint8_t bucket count
+ *  - uint8_t first section in this page
+ *  - uint8_t number of sections in this page
+ *  - For each section: min, max, p99, count (uint16_t each) then the histogram buckets (uint16_t each)
+ *
+ * @param pBuffer Destination
+ * @param bufferSize Size of @p pBuffer
+ * @param firstSection Index of the first section to send
+ * @return Number of bytes written: 0 if @p pBuffer can't hold the header plus one section
+ */
+uint16_t serialiseLoopProfile(uint8_t *pBuffer, uint16_t bufferSize, uint8_t firstSection);
@@ -1,6 +1,7 @@
 #include <FastCRC.h>
 #include "page_crc.h"
 #include "pages.h"
+#include "unit_testing.h"
 
 uint32_t __attribute__((optimize("Os"))) calculatePageCRC32(uint8_t pageNum)
 {
@@ -16,4 +17,133 @@ uint32_t __attribute__((optimize("Os"))) calculatePageCRC32(uint8_t pageNum)
     }
 
     return crc;
-}
\ No newline at end of file
+}
+
+// ========================= CRC cache  ===================
+
+/** @brief Maximum page bytes processed per call to updatePageCRC32Cache() */
+static constexpr uint16_t PAGE_CRC_CHUNK_SIZE = 32U;
+
+struct page_crc_cache_t {
+    uint32_t crc;
+    generation_t generation; // The page generation the CRC was calculated from
+    bool isValid;
+};
+static page_crc_cache_t pageCrcCache[MAX_PAGE_NUM];
+
+// The CRC calculation in progress. Only 1 page at a time.
+struct page_crc_calculation_t {
+    FastCRC32 crcCalc;
+    uint32_t crc;
+    uint16_t offset;
+    generation_t generation; // The page generation when the calculation started
+    uint8_t pageNum;         // 0 if there is no calculation in progress
+};
+static page_crc_calculation_t crcCalculation;
+
+// While the tune generation matches, no page CRC is stale
+static generation_t cacheTuneGeneration;
+static bool isCacheComplete = false;
+
+TESTABLE_INLINE_STATIC bool isPageCRC32Cached(uint8_t pageNum)
+{
+    return pageCrcCache[pageNum].isValid 
+        && (pageCrcCache[pageNum].generation==getPageGeneration(pageNum));
+}
+
+static void startCalculation(uint8_t pageNum)
+{
+    crcCalculation.pageNum = pageNum;
+    crcCalculation.offset = 0U;
+    crcCalculation.generation = getPageGeneration(pageNum);
+}
+
+// Add up to byteCount bytes of the page to the calculation
+static void __attribute__((optimize("Os"))) calculateChunk(uint16_t byteCount)
+{
+    // The page changed under us: start again
+    if (crcCalculation.generation!=getPageGeneration(crcCalculation.pageNum))
+    {
+        startCalculation(crcCalculation.pageNum);
+    }
+
+    const uint16_t pageSize = getPageSize(crcCalculation.pageNum);
+    const uint16_t end = (pageSize-crcCalculation.offset)>byteCount ? crcCalculation.offset+byteCount : pageSize;
+
+    // Iterate over the entities directly: much cheaper than mapping each offset via getPageValue()
+    page_iterator_t iter = page_begin(crcCalculation.pageNum);
+    byte buffer[16];
+    uint8_t bufferLength = 0U;
+    while (crcCalculation.offset<end)
+    {
+        while ((iter.entity.type!=EntityType::End) && !iter.entity.isPageAddressWithin(crcCalculation.offset))
+        {
+            iter = advance(iter);
+        }
+        // Past the last entity, getPageValue() pads the page with zeroes
+        buffer[bufferLength] = iter.entity.type==EntityType::End ? 0U : getEntityValue(iter.entity, crcCalculation.offset-iter.entity.start);
+        ++bufferLength;
+        ++crcCalculation.offset;
+
+        if ((bufferLength==sizeof(buffer)) || (crcCalculation.offset==end))
+        {
+            // The first byte of the page starts the CRC, same as calculatePageCRC32()
+            crcCalculation.crc = (crcCalculation.offset==bufferLength) 
+                ? crcCalculation.crcCalc.crc32(buffer, bufferLength) 
+                : crcCalculation.crcCalc.crc32_upd(buffer, bufferLength);
+            bufferLength = 0U;
+        }
+    }
+
+    if (crcCalculation.offset>=pageSize)
+    {
+        pageCrcCache[crcCalculation.pageNum] = { crcCalculation.crc, crcCalculation.generation, true };
+        crcCalculation.pageNum = 0U;
+    }
+}
+
+uint32_t getPageCRC32(uint8_t pageNum)
+{
+    if ((pageNum<MIN_PAGE_NUM) || (pageNum>=MAX_PAGE_NUM))
+    {
+        return calculatePageCRC32(pageNum);
+    }
+
+    if (!isPageCRC32Cached(pageNum))
+    {
+        // Pick up any calculation already in progress
+        if (crcCalculation.pageNum!=pageNum)
+        {
+            startCalculation(pageNum);
+        }
+        calculateChunk(UINT16_MAX);
+    }
+    return pageCrcCache[pageNum].crc;
+}
+
+void updatePageCRC32Cache(void)
+{
+    if (crcCalculation.pageNum==0U)
+    {
+        if (isCacheComplete && (cacheTuneGeneration==getTuneGeneration()))
+        {
+            return;
+        }
+
+        // Find the next stale page
+        uint8_t pageNum = MIN_PAGE_NUM;
+        while ((pageNum<MAX_PAGE_NUM) && isPageCRC32Cached(pageNum))
+        {
+            ++pageNum;
+        }
+        if (pageNum==MAX_PAGE_NUM)
+        {
+            cacheTuneGeneration = getTuneGeneration();
+            isCacheComplete = true;
+            return;
+        }
+        startCalculation(pageNum);
+    }
+
+    calculateChunk(PAGE_CRC_CHUNK_SIZE);
+}
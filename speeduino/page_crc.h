@@ -4,4 +4,22 @@
 /*
  * Calculates and returns the CRC32 value of a given page of memory
  */
-uint32_t calculatePageCRC32(uint8_t pageNum /**< [in] The page number to compute CRC for. */);
\ No newline at end of file
+uint32_t calculatePageCRC32(uint8_t pageNum /**< [in] The page number to compute CRC for. */);
+
+/**
+ * @brief Get the CRC32 value of a page, from a cache where possible.
+ * 
+ * Each page CRC is cached & only recalculated once the page changes (see getPageGeneration()). 
+ * updatePageCRC32Cache() recalculates stale CRCs in the background, so this normally returns
+ * immediately. If the CRC is stale, it's finished on the spot.
+ * 
+ * @return The same value as calculatePageCRC32()
+ */
+uint32_t getPageCRC32(uint8_t pageNum /**< [in] The page number to get the CRC for. */);
+
+/**
+ * @brief Recalculate a chunk of the next stale page CRC.
+ * 
+ * Call frequently (E.g. once per main loop): the work per call is bounded.
+ */
+void updatePageCRC32Cache(void);
@@ -92,6 +92,11 @@ public:
   // Setter
   inline offset_to_table &operator=( byte new_value )
   {
+    if (**this==new_value)
+    {
+      // No change, so keep the cache & generation
+      return *this;
+    }
     switch (get_table_location())
     {
       case table_location_values:
@@ -107,7 +112,7 @@ public:
         get_yaxis_value() = new_value;
         break; 
     }
-    invalidate_cache(&_pTable->get_value_cache);
+    notifyTableChanged(*_pTable);
     return *this;
   }  
 
@@ -426,6 +431,7 @@ struct setTableToEmpty_visitor {
       table.values.fill(0);
       table.axisX.fill(0);
       table.axisY.fill(0);
+      notifyTableChanged(table);
     }
 };
 static void setTableToEmpty(const page_iterator_t &iter)
@@ -461,6 +467,7 @@ void __attribute__((noinline)) setTuneToEmpty(void) {
       iter = advance(iter);
     }
   }
+  notifyAllPagesChanged();
 }
 
 uint16_t getPageSize(byte pageNum)
@@ -484,8 +491,15 @@ static inline uint16_t pageOffsetToEntityOffset(const page_iterator_t &iter, uin
 bool setPageValue(uint8_t pageNum, uint16_t pageOffset, byte value)
 {
   page_iterator_t iter = map_page_offset_to_entity(pageNum, pageOffset);
+  uint16_t entityOffset = pageOffsetToEntityOffset(iter, pageOffset);
 
-  return setEntityValue(iter.entity, pageOffsetToEntityOffset(iter, pageOffset), value);
+  bool isChanged = getEntityValue(iter.entity, entityOffset)!=value;
+  bool isSet = setEntityValue(iter.entity, entityOffset, value);
+  if (isSet && isChanged)
+  {
+    notifyPageChanged(pageNum);
+  }
+  return isSet;
 }
 
 byte getPageValue(uint8_t pageNum, uint16_t pageOffset)
@@ -495,6 +509,39 @@ byte getPageValue(uint8_t pageNum, uint16_t pageOffset)
   return getEntityValue(iter.entity, pageOffsetToEntityOffset(iter, pageOffset));
 }
 
+// ========================= Change tracking  ===================
+
+static generation_t pageGenerations[MAX_PAGE_NUM];
+static generation_t tuneGeneration;
+
+generation_t getPageGeneration(uint8_t pageNum)
+{
+  return pageNum<MAX_PAGE_NUM ? pageGenerations[pageNum] : 0U;
+}
+
+generation_t getTuneGeneration(void)
+{
+  return tuneGeneration;
+}
+
+void notifyPageChanged(uint8_t pageNum)
+{
+  if (pageNum<MAX_PAGE_NUM)
+  {
+    ++pageGenerations[pageNum];
+    ++tuneGeneration;
+  }
+}
+
+void notifyAllPagesChanged(void)
+{
+  for (uint8_t page=MIN_PAGE_NUM; page<MAX_PAGE_NUM; ++page)
+  {
+    ++pageGenerations[page];
+  }
+  ++tuneGeneration;
+}
+
 // LCOV_EXCL_START
 // No need to have coverage on simple wrappers
 
@@ -55,6 +55,9 @@ byte getPageValue(  uint8_t pageNum,       /**< [in] The page number to retrieve
 /** 
  * @brief Sets a single value from a page, with data aligned as per the ini file 
  * 
+ * If the value changes, the page generation (and the table generation, if the value
+ * is in a table) is incremented. Writing the existing value changes nothing.
+ * 
  * @returns true if value set, false otherwise
  */
 bool setPageValue(  uint8_t pageNum,        /**< [in] The page number to update. */
@@ -63,6 +66,25 @@ bool setPageValue(  uint8_t pageNum,        /**< [in] The page number to update.
                     );
 
 
+// ============================== Change tracking ==========================
+
+/** 
+ * @brief The generation of a page: changes whenever any value on the page changes.
+ * 
+ * Individual tables also have a generation (table3d::generation). @see generation_t 
+ */
+generation_t getPageGeneration(uint8_t pageNum /**< [in] The page number */ );
+
+/** @brief The generation of the whole tune: changes whenever any page changes. @see generation_t */
+generation_t getTuneGeneration(void);
+
+/** @brief Record that a page has changed. Only needed for changes not made via setPageValue() */
+void notifyPageChanged(uint8_t pageNum /**< [in] The page number */ );
+
+/** @brief Record that every page has changed. E.g. after loading the tune from storage */
+void notifyAllPagesChanged(void);
+
+
 // ============================== Page Iteration ==========================
 
 // A logical TS page is actually multiple in memory entities. Allow iteration
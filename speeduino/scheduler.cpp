@@ -52,6 +52,7 @@ void FuelSchedule::reset(void)
 {
     Schedule::reset();
     channelDegrees = 0;
+    openAngle = 0;
 }
 
 void __attribute__((optimize("Os"))) setCallbacks(Schedule &schedule, Schedule::callback pStartCallback, Schedule::callback pEndCallback) noexcept
@@ -72,42 +73,68 @@ static inline uint16_t clipDuration(uint16_t duration) {
   return duration;
 }
 
-static inline void setScheduleNext(Schedule &schedule, uint32_t delay, uint16_t duration) noexcept
+static inline void setScheduleNext(Schedule &schedule, COMPARE_TYPE delay, COMPARE_TYPE duration) noexcept
 {
-  //The duration of the pulsewidth cannot be longer than the maximum timer period. This is unlikely as pulse widths should never get that long, but it's here for safety
   //Duration can safely be set here as the schedule is already running at the previous duration value already used
-  schedule._duration = uS_TO_TIMER_COMPARE(clipDuration(duration));
-  schedule._nextStartCompare = schedule._counter + uS_TO_TIMER_COMPARE(delay);
+  schedule._duration = duration;
+  schedule._nextStartCompare = schedule._counter + delay;
   schedule._status = RUNNING_WITHNEXT;
 }
 
-static inline void setScheduleRunning(Schedule &schedule, uint32_t delay, uint16_t duration) noexcept
+static inline void setScheduleRunning(Schedule &schedule, COMPARE_TYPE delay, COMPARE_TYPE duration) noexcept
 {
   //The following must be enclosed in the noInterupts block to avoid contention caused if the relevant interrupt fires before the state is fully set
-  //The duration of the pulsewidth cannot be longer than the maximum timer period. This is unlikely as pulse widths should never get that long, but it's here for safety
-  schedule._duration = uS_TO_TIMER_COMPARE(clipDuration(duration));
-  SET_COMPARE(schedule._compare, schedule._counter + uS_TO_TIMER_COMPARE(delay));
+  schedule._duration = duration;
+  SET_COMPARE(schedule._compare, schedule._counter + delay);
   schedule._status = PENDING; //Turn this schedule on
 }
 
-void setSchedule(Schedule &schedule, uint32_t delay, uint16_t duration, bool allowQueuedSchedule)
+static inline void applyScheduleRequest(const schedule_request_t &request) noexcept
+{
+  //Check that we're not already part way through a schedule
+  if(!isRunning(*request.pSchedule)) 
+  { 
+    setScheduleRunning(*request.pSchedule, request.delay, request.duration);
+  }
+  // If the schedule is already running, we can queue up the next event.
+  else if(request.allowQueuedSchedule)
+  {
+    setScheduleNext(*request.pSchedule, request.delay, request.duration);
+  } else {
+    // Cannot schedule next event, as it would exceed the maximum future time
+  }
+}
+
+bool makeScheduleRequest(Schedule &schedule, uint32_t delay, uint16_t duration, bool allowQueuedSchedule, schedule_request_t &request) noexcept
 {
   if((delay>0U) && (delay < MAX_TIMER_PERIOD) && (duration > 0U))
+  {
+    //The duration of the pulsewidth cannot be longer than the maximum timer period. This is unlikely as pulse widths should never get that long, but it's here for safety
+    request = schedule_request_t { &schedule, (COMPARE_TYPE)uS_TO_TIMER_COMPARE(delay), (COMPARE_TYPE)uS_TO_TIMER_COMPARE(clipDuration(duration)), allowQueuedSchedule };
+    return true;
+  }
+  return false;
+}
+
+void applyScheduleRequests(const schedule_request_t *pRequests, uint8_t count) noexcept
+{
+  ATOMIC() 
+  {
+    for (uint8_t index=0U; index<count; ++index)
+    {
+      applyScheduleRequest(pRequests[index]);
+    }
+  }
+}
+
+void setSchedule(Schedule &schedule, uint32_t delay, uint16_t duration, bool allowQueuedSchedule)
+{
+  schedule_request_t request;
+  if (makeScheduleRequest(schedule, delay, duration, allowQueuedSchedule, request))
   {
     ATOMIC() 
     {
-      //Check that we're not already part way through a schedule
-      if(!isRunning(schedule)) 
-      { 
-        setScheduleRunning(schedule, delay, duration);
-      }
-      // If the schedule is already running, we can queue up the next event.
-      else if(allowQueuedSchedule)
-      {
-        setScheduleNext(schedule, delay, duration);
-      } else {
-        // Cannot schedule next event, as it would exceed the maximum future time
-      }
+      applyScheduleRequest(request);
     }
   }  
 }
@@ -185,9 +212,9 @@ void moveToNextState(IgnitionSchedule &schedule)  noexcept
 
 ///@}
 
-void adjustCrankAngle(const statuses &current, IgnitionSchedule &schedule, int16_t crankAngle) {
-  constexpr uint8_t MIN_CYCLES_FOR_CORRECTION = 6U;
+static constexpr uint8_t MIN_CYCLES_FOR_CORRECTION = 6U;
 
+void adjustCrankAngle(const statuses &current, IgnitionSchedule &schedule, int16_t crankAngle) {
   crankAngle = ignitionLimits(crankAngle);
   ATOMIC() { // Prevent race conditions with the timer interrupt.
     // We only want to adjust the crank angle if we are running and the coil is charging or we are waiting for the timer to fire.
@@ -211,3 +238,15 @@ void adjustCrankAngle(const statuses &current, IgnitionSchedule &schedule, int16
     }
   }
 }
+
+void adjustCrankAngle(const statuses &current, FuelSchedule &schedule, int16_t crankAngle) {
+  ATOMIC() { // Prevent race conditions with the timer interrupt.
+    // Once the injector is open, the pulse width determines the fuel delivered so leave it alone.
+    // Only move the open time if we are still waiting for the timer to fire.
+    if( (schedule._status==PENDING) 
+      && (current.startRevolutions > MIN_CYCLES_FOR_CORRECTION) 
+      && ((int16_t)schedule.openAngle>crankAngle) ) {
+      SET_COMPARE(schedule._compare, schedule._counter + angleToTimerTicks( (uint16_t)((int16_t)schedule.openAngle-crankAngle) )); 
+    }
+  }
+}
@@ -158,6 +158,78 @@ void setCallbacks(Schedule &schedule, Schedule::callback pStartCallback, Schedul
  */
 void setSchedule(Schedule &schedule, uint32_t delay, uint16_t duration, bool allowQueuedSchedule);
 
+/**
+ * @brief A setSchedule() request, validated & converted to timer ticks so it can be
+ * applied in as short a critical section as possible.
+ */
+struct schedule_request_t {
+  Schedule *pSchedule;
+  COMPARE_TYPE delay;         ///< Timer ticks until the action starts
+  COMPARE_TYPE duration;      ///< Action duration in timer ticks
+  bool allowQueuedSchedule;
+};
+
+/**
+ * @brief Validate a setSchedule() request & convert it to timer ticks. Does not modify the schedule.
+ *
+ * @param schedule Schedule to modify
+ * @param delay Delay until the action starts (µS)
+ * @param duration Action duration (µS)
+ * @param allowQueuedSchedule true to allow a schedule to be queued up if one is currently running; false otherwise
+ * @param request Receives the request
+ * @return true if the request is valid (setSchedule() would act on it), false otherwise
+ */
+bool makeScheduleRequest(Schedule &schedule, uint32_t delay, uint16_t duration, bool allowQueuedSchedule, schedule_request_t &request) noexcept;
+
+/**
+ * @brief Apply several schedule requests in a single critical section
+ *
+ * @param pRequests Requests created by makeScheduleRequest()
+ * @param count Number of requests
+ */
+void applyScheduleRequests(const schedule_request_t *pRequests, uint8_t count) noexcept;
+
+/**
+ * @brief A batch of schedule requests.
+ *
+ * Computing the schedule timing doesn't need interrupts disabled, only applying it does. So
+ * schedule timing for many channels is computed into a batch & then applied in one short
+ * critical section (see commitScheduleBatch()).
+ *
+ * @tparam Capacity Maximum number of requests
+ */
+template <uint8_t Capacity>
+struct schedule_batch_t {
+  schedule_request_t requests[Capacity];
+  uint8_t count = 0U;
+};
+
+/**
+ * @brief Batched equivalent of setSchedule(): add a request to the batch.
+ *
+ * Invalid requests (which setSchedule() would ignore) aren't added, so the batch
+ * only contains channels that will change.
+ *
+ * @return true if the request was added, false otherwise
+ */
+template <uint8_t Capacity>
+static inline bool addToScheduleBatch(schedule_batch_t<Capacity> &batch, Schedule &schedule, uint32_t delay, uint16_t duration, bool allowQueuedSchedule) noexcept {
+  if ((batch.count<Capacity) && makeScheduleRequest(schedule, delay, duration, allowQueuedSchedule, batch.requests[batch.count])) {
+    ++batch.count;
+    return true;
+  }
+  return false;
+}
+
+/** @brief Apply all requests in the batch, in one critical section, & empty the batch. */
+template <uint8_t Capacity>
+static inline void commitScheduleBatch(schedule_batch_t<Capacity> &batch) noexcept {
+  if (batch.count>0U) {
+    applyScheduleRequests(batch.requests, batch.count);
+    batch.count = 0U;
+  }
+}
+
 /** @brief An ignition schedule.
  *
  * Goal is to fire the spark as close to the requested angle as possible.
@@ -224,6 +296,7 @@ struct FuelSchedule : public Schedule {
 
   uint16_t channelDegrees = 0U;    ///< The number of crank degrees until cylinder is at TDC  
   uint16_t pw = 0U;                ///< Pulse width in uS
+  uint16_t openAngle = 0U;         ///< Crank angle the injector should open at. Used for per tooth timing adjustments
 
   void reset(void) override;
 };
@@ -236,6 +309,20 @@ struct FuelSchedule : public Schedule {
  */
 void moveToNextState(FuelSchedule &schedule) noexcept;
 
+/**
+ * @brief Adjust the crank angle used to originally set the fuel schedule.
+ * 
+ * The fuel equivalent of adjustCrankAngle(const statuses&, IgnitionSchedule&, int16_t). Only a
+ * pending schedule is adjusted: the injector open time is re-anchored to the new crank angle
+ * & the pulse width (I.e. the fuel quantity) is left unchanged.
+ * 
+ * @param current Current system status 
+ * @param schedule The schedule to modify 
+ * @param crankAngle The new crank angle in degrees, in the same domain as FuelSchedule::openAngle. 
+ * Can be negative if the open angle has wrapped around the end of the injection cycle.
+ */
+void adjustCrankAngle(const statuses &current, FuelSchedule &schedule, int16_t crankAngle);
+
 /// @cond
 static FORCE_INLINE uint32_t _calculateAngularTime(const Schedule &schedule, uint16_t eventAngle, uint16_t crankAngle, uint16_t maxAngle) {
   int16_t delta = eventAngle - crankAngle;
@@ -304,25 +304,43 @@ TESTABLE_INLINE_STATIC uint32_t calculateInjectorTimeout(const FuelSchedule &sch
   return angleToTime((uint16_t)delta);
 }
 
-TESTABLE_INLINE_STATIC void setFuelChannelSchedule(FuelSchedule &schedule, uint8_t channel, uint16_t crankAngle, byte injChannelMask, uint16_t injAngle, injectorAngleCalcCache *pCache) noexcept
+/** @brief Only queue up the next schedule if the maximum time between squirts (Based on CRANK_ANGLE_MAX_INJ) is less than the max timer period */
+static inline bool allowQueuedFuelSchedule(void)
+{
+  return angleToTime((uint16_t)CRANK_ANGLE_MAX_INJ) < MAX_TIMER_PERIOD;
+}
+
+template <uint8_t Capacity>
+static inline void addFuelChannelSchedule(schedule_batch_t<Capacity> &batch, FuelSchedule &schedule, uint8_t channel, uint16_t crankAngle, byte injChannelMask, uint16_t injAngle, bool allowQueued, injectorAngleCalcCache *pCache) noexcept
 {
   if( (schedule.pw != 0U) && (BIT_CHECK(injChannelMask, channel-1U)) )
   {
-    uint32_t timeOut = calculateInjectorTimeout(schedule, crankAngle, 
-                                                _calculateOpenAngle(schedule, updatePwAngleCache(schedule.pw, pCache), injAngle));
+    uint16_t openAngle = _calculateOpenAngle(schedule, updatePwAngleCache(schedule.pw, pCache), injAngle);
+    uint32_t timeOut = calculateInjectorTimeout(schedule, crankAngle, openAngle);
     if (timeOut>0U)
     {
-      // Only queue up the next schedule if the maximum time between squirts (Based on CRANK_ANGLE_MAX_INJ) is less than the max timer period
-      setSchedule(schedule, timeOut, schedule.pw, angleToTime((uint16_t)CRANK_ANGLE_MAX_INJ) < MAX_TIMER_PERIOD);
+      // Record the target angle so the decoder can re-anchor the open time as teeth arrive.
+      schedule.openAngle = openAngle;
+      (void)addToScheduleBatch(batch, schedule, timeOut, schedule.pw, allowQueued);
     }
   }
 }
 
+TESTABLE_INLINE_STATIC void setFuelChannelSchedule(FuelSchedule &schedule, uint8_t channel, uint16_t crankAngle, byte injChannelMask, uint16_t injAngle, injectorAngleCalcCache *pCache) noexcept
+{
+  schedule_batch_t<1U> batch;
+  addFuelChannelSchedule(batch, schedule, channel, crankAngle, injChannelMask, injAngle, allowQueuedFuelSchedule(), pCache);
+  commitScheduleBatch(batch);
+}
+
 TESTABLE_INLINE_STATIC uint16_t setFuelChannelSchedules(uint16_t crankAngle, byte injChannelMask, uint16_t injAngle)
 {
+  // Compute all channels first, then apply them with interrupts disabled just once
   injectorAngleCalcCache angleCalcCache;
+  schedule_batch_t<INJ_CHANNELS> batch;
+  const bool allowQueued = allowQueuedFuelSchedule();
 #define SET_FUEL_CHANNEL(channel) \
-  setFuelChannelSchedule(fuelSchedule ##channel, UINT8_C(channel), crankAngle, injChannelMask, injAngle, &angleCalcCache);
+  addFuelChannelSchedule(batch, fuelSchedule ##channel, UINT8_C(channel), crankAngle, injChannelMask, injAngle, allowQueued, &angleCalcCache);
 
   SET_FUEL_CHANNEL(1)
 #if INJ_CHANNELS >= 2
@@ -349,6 +367,8 @@ TESTABLE_INLINE_STATIC uint16_t setFuelChannelSchedules(uint16_t crankAngle, byt
 
 #undef SET_FUEL_CHANNEL
 
+  commitScheduleBatch(batch);
+
   return injAngle;
 }
 
@@ -674,10 +674,15 @@ BEGIN_LTO_ALWAYS_INLINE(void) __attribute__((flatten)) calculateIgnitionAngles(c
 }
 END_LTO_INLINE()
 
+/** @brief Only queue up the next schedule if the maximum time between sparks (Based on CRANK_ANGLE_MAX_IGN) is less than the max timer period */
+static inline bool allowQueuedIgnitionSchedule(void)
+{
+  return angleToTime((uint16_t)CRANK_ANGLE_MAX_IGN) < MAX_TIMER_PERIOD;
+}
+
 TESTABLE_INLINE_STATIC void setIgnitionScheduleDuration(IgnitionSchedule &schedule, uint32_t delay, uint16_t duration) 
 {
-  // Only queue up the next schedule if the maximum time between sparks (Based on CRANK_ANGLE_MAX_IGN) is less than the max timer period
-  setSchedule(schedule, delay, duration, angleToTime((uint16_t)CRANK_ANGLE_MAX_IGN) < MAX_TIMER_PERIOD);
+  setSchedule(schedule, delay, duration, allowQueuedIgnitionSchedule());
 }
 
 TESTABLE_INLINE_STATIC uint32_t _calculateIgnitionTimeout(const IgnitionSchedule &schedule, int16_t crankAngle)
@@ -685,16 +690,20 @@ TESTABLE_INLINE_STATIC uint32_t _calculateIgnitionTimeout(const IgnitionSchedule
   return _calculateAngularTime(schedule, schedule.channelDegrees, schedule.chargeAngle, crankAngle, CRANK_ANGLE_MAX_IGN);
 }
 
-static inline void setIgnitionChannel(IgnitionSchedule &schedule, uint16_t crankAngle, uint16_t dwellDuration, byte channelMask, uint8_t channelIdx)
+template <uint8_t Capacity>
+static inline void addIgnitionChannel(schedule_batch_t<Capacity> &batch, IgnitionSchedule &schedule, uint16_t crankAngle, uint16_t dwellDuration, byte channelMask, uint8_t channelIdx, bool allowQueued)
 {
   if (BIT_CHECK(channelMask, (channelIdx)-1U)) {
-    setIgnitionScheduleDuration(schedule, _calculateIgnitionTimeout(schedule, crankAngle), dwellDuration);
+    (void)addToScheduleBatch(batch, schedule, _calculateIgnitionTimeout(schedule, crankAngle), dwellDuration, allowQueued);
   }
 }
 
 BEGIN_LTO_ALWAYS_INLINE(void) __attribute__((flatten)) setIgnitionChannels(const statuses &current, uint16_t crankAngle, uint16_t dwellTime) {
+  // Compute all channels first, then apply them with interrupts disabled just once
   crankAngle = ignitionLimits(crankAngle);
-  #define SET_IGNITION_CHANNEL(channelIdx) setIgnitionChannel(ignitionSchedule ##channelIdx, crankAngle, dwellTime, current.schedulerCutState.ignitionChannels, channelIdx);
+  schedule_batch_t<IGN_CHANNELS> batch;
+  const bool allowQueued = allowQueuedIgnitionSchedule();
+  #define SET_IGNITION_CHANNEL(channelIdx) addIgnitionChannel(batch, ignitionSchedule ##channelIdx, crankAngle, dwellTime, current.schedulerCutState.ignitionChannels, channelIdx, allowQueued);
 
   SET_IGNITION_CHANNEL(1)
 #if IGN_CHANNELS >= 2
@@ -720,6 +729,8 @@ BEGIN_LTO_ALWAYS_INLINE(void) __attribute__((flatten)) setIgnitionChannels(const
 #endif
 
 #undef SET_IGNITION_CHANNEL
+
+  commitScheduleBatch(batch);
 }
 END_LTO_INLINE()
 
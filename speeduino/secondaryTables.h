@@ -5,5 +5,30 @@
 #include "config_pages.h"
 #include "table3d.h"
 
-void calculateSecondaryFuel(const config10 &page10, const table3d16RpmLoad &veLookupTable, statuses &current);
-void calculateSecondarySpark(const config2 &page2, const config10 &page10, const table3d16RpmLoad &sparkLookupTable, statuses &current);
+/**
+ * @brief Whether the secondary fuel table is in use this loop. If not, it needn't be looked up
+ * 
+ * The main loop stores the result in statuses::secondFuelTableActive for calculateSecondaryFuel()
+ */
+bool isSecondaryFuelTableActive(const config10 &page10, const statuses &current);
+
+/**
+ * @brief Combine the secondary fuel table value with VE1
+ * 
+ * @param ve2 The secondary fuel table value. Only read if statuses::secondFuelTableActive is set
+ */
+void calculateSecondaryFuel(const config10 &page10, uint8_t ve2, statuses &current);
+
+/**
+ * @brief Whether the secondary spark table is in use this loop. If not, it needn't be looked up
+ * 
+ * The main loop stores the result in statuses::secondSparkTableActive for calculateSecondarySpark()
+ */
+bool isSecondarySparkTableActive(const config2 &page2, const config10 &page10, const statuses &current);
+
+/**
+ * @brief Combine the secondary spark table value with advance1
+ * 
+ * @param spark2 The secondary spark table value. Only read if statuses::secondSparkTableActive is set
+ */
+void calculateSecondarySpark(const config10 &page10, table3d_value_t spark2, statuses &current);
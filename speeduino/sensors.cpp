@@ -52,6 +52,67 @@ static uint16_t o2Calibration_bins[32];
 static uint8_t o2Calibration_values[32];
 table2D_u16_u8_32 o2CalibrationTable(&o2Calibration_bins, &o2Calibration_values); 
 
+static table2D_u16_u8_32& getCalibrationTable(SensorCalibrationTable sensor)
+{
+  if (sensor==SensorCalibrationTable::CoolantSensor) { return cltCalibrationTable; }
+  if (sensor==SensorCalibrationTable::IntakeAirTempSensor) { return iatCalibrationTable; }
+  return o2CalibrationTable;
+}
+
+#if defined(SENSOR_CALIBRATION_LUT)
+/** @brief A calibration curve expanded to one value per 10-bit ADC reading */
+struct calibration_lut_t {
+  uint8_t values[1024];
+  /** @brief The CRC of the curve the values were built from */
+  uint32_t crc;
+  bool isValid;
+};
+// Indexed by SensorCalibrationTable
+static calibration_lut_t calibrationLuts[3];
+#endif
+
+void refreshCalibrationLut(SensorCalibrationTable sensor, uint32_t crc)
+{
+#if defined(SENSOR_CALIBRATION_LUT)
+  calibration_lut_t &lut = calibrationLuts[(uint8_t)sensor];
+  if (!lut.isValid || (lut.crc!=crc))
+  {
+    table2D_u16_u8_32 &table = getCalibrationTable(sensor);
+    for (uint16_t adc=0U; adc<_countof(lut.values); ++adc)
+    {
+      lut.values[adc] = table2D_getValue(&table, adc);
+    }
+    lut.crc = crc;
+    lut.isValid = true;
+  }
+#else
+  UNUSED(sensor);
+  UNUSED(crc);
+#endif
+}
+
+void refreshAllCalibrationLuts(void)
+{
+#if defined(SENSOR_CALIBRATION_LUT)
+  refreshCalibrationLut(SensorCalibrationTable::CoolantSensor, loadCalibrationCrc(SensorCalibrationTable::CoolantSensor));
+  refreshCalibrationLut(SensorCalibrationTable::IntakeAirTempSensor, loadCalibrationCrc(SensorCalibrationTable::IntakeAirTempSensor));
+  refreshCalibrationLut(SensorCalibrationTable::O2Sensor, loadCalibrationCrc(SensorCalibrationTable::O2Sensor));
+#endif
+}
+
+/** @brief Convert an ADC reading to a real world value using a sensor calibration curve */
+TESTABLE_INLINE_STATIC uint8_t getCalibratedValue(SensorCalibrationTable sensor, uint16_t adc)
+{
+#if defined(SENSOR_CALIBRATION_LUT)
+  const calibration_lut_t &lut = calibrationLuts[(uint8_t)sensor];
+  if (lut.isValid && (adc<_countof(lut.values)))
+  {
+    return lut.values[adc];
+  }
+#endif
+  return table2D_getValue(&getCalibrationTable(sensor), adc);
+}
+
 /**
  * @brief A specialist function to map a value in the range [0, 1023] (I.e. 10-bit) to a different range.
  * 
@@ -613,18 +674,18 @@ void initialiseTPS(void) {
 static inline void readCLT(void)
 {
   currentStatus.cltADC = LOW_PASS_FILTER(readAnalogSensor(pinNumbers.pinCLT), configPage4.ADCFILTER_CLT, currentStatus.cltADC);
-  currentStatus.coolant = temperatureRemoveOffset(table2D_getValue(&cltCalibrationTable, currentStatus.cltADC)); //Temperature calibration values are stored as positive bytes. We subtract 40 from them to allow for negative temperatures
+  currentStatus.coolant = temperatureRemoveOffset(getCalibratedValue(SensorCalibrationTable::CoolantSensor, currentStatus.cltADC)); //Temperature calibration values are stored as positive bytes. We subtract 40 from them to allow for negative temperatures
 }
 
 void initialiseCLT(void) {
   currentStatus.cltADC = readAnalogSensor(pinNumbers.pinCLT);
-  currentStatus.coolant = temperatureRemoveOffset(table2D_getValue(&cltCalibrationTable, currentStatus.cltADC)); //Temperature calibration values are stored as positive bytes. We subtract 40 from them to allow for negative temperatures
+  currentStatus.coolant = temperatureRemoveOffset(getCalibratedValue(SensorCalibrationTable::CoolantSensor, currentStatus.cltADC)); //Temperature calibration values are stored as positive bytes. We subtract 40 from them to allow for negative temperatures
 }
 
 static inline void readIAT(void)
 {
   currentStatus.iatADC = LOW_PASS_FILTER(readAnalogSensor(pinNumbers.pinIAT), configPage4.ADCFILTER_IAT, currentStatus.iatADC);
-  currentStatus.IAT = temperatureRemoveOffset(table2D_getValue(&iatCalibrationTable, currentStatus.iatADC));
+  currentStatus.IAT = temperatureRemoveOffset(getCalibratedValue(SensorCalibrationTable::IntakeAirTempSensor, currentStatus.iatADC));
 }
 
 // ========================================== Baro ==========================================
@@ -715,7 +776,7 @@ static inline void readO2_1(void)
   if(configPage6.egoType > 0U)
   {
     currentStatus.O2ADC = LOW_PASS_FILTER(readAnalogSensor(pinNumbers.pinO2), configPage4.ADCFILTER_O2, currentStatus.O2ADC);
-    currentStatus.O2 = table2D_getValue(&o2CalibrationTable, currentStatus.O2ADC);
+    currentStatus.O2 = getCalibratedValue(SensorCalibrationTable::O2Sensor, currentStatus.O2ADC);
   }
   else
   {
@@ -731,7 +792,7 @@ static inline void readO2_2(void)
   if (pinNumbers.pinO2_2!=0U)
   {
     currentStatus.O2_2ADC = LOW_PASS_FILTER(readAnalogSensor(pinNumbers.pinO2_2), configPage4.ADCFILTER_O2, currentStatus.O2_2ADC);
-    currentStatus.O2_2 = table2D_getValue(&o2CalibrationTable, currentStatus.O2_2ADC);
+    currentStatus.O2_2 = getCalibratedValue(SensorCalibrationTable::O2Sensor, currentStatus.O2_2ADC);
   }
 }
 
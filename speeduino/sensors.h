@@ -5,6 +5,7 @@
 #include "config_pages.h"
 #include "statuses.h"
 #include "table2d.h"
+#include "storage.h"
 
 // The following are alpha values for the ADC filters.
 // Their values are from 0 to 240, with 0 being no filtering and 240 being maximum
@@ -99,4 +100,19 @@ extern table2D_u16_u8_32 cltCalibrationTable;
 extern table2D_u16_u8_32 iatCalibrationTable;
 extern table2D_u16_u8_32 o2CalibrationTable; 
 
+/**
+ * @brief Rebuild the dense ADC lookup table for one sensor calibration curve
+ * 
+ * Only applies if SENSOR_CALIBRATION_LUT is defined: the curve is expanded to one value
+ * per 10-bit ADC reading, so converting a reading is a single array index. The lookup table
+ * is only rebuilt if the curve CRC differs from the one it was last built from.
+ * 
+ * @param sensor The calibration curve
+ * @param crc The CRC of the curve, as passed to saveCalibrationCrc()
+ */
+void refreshCalibrationLut(SensorCalibrationTable sensor, uint32_t crc);
+
+/** @brief Refresh the lookup tables for all sensors, using the CRCs in durable storage. See refreshCalibrationLut() */
+void refreshAllCalibrationLuts(void);
+
 #endif // SENSORS_H
@@ -58,6 +58,9 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #include "src/controllers/fuelPump/fuelPumpController.h"
 #include "scheduler_fuel_controller.h"
 #include "src/controllers/tsCommand/tsCommandController.h"
+#include "loop_profiler.h"
+#include "pages.h"
+#include "page_crc.h"
 #include "src/controllers/fan/fanController.h"
 #include "src/controllers/boost/boostController.h"
 #include "src/controllers/aircon/airconController.h"
@@ -75,26 +78,86 @@ void setup(void)
   initialiseAll();
 }
 
+/** @brief The values of the tables looked up with the fuel load. Tables that aren't in use read as zero */
+struct fuelTableValues {
+  uint8_t ve;
+  uint8_t afrTarget;    ///< For calculateAfrTarget()
+  uint8_t stagingSplit; ///< For computePulseWidths()
+};
+
 /** Lookup the current VE value from the primary 3D fuel map.
  * The Y axis value used for this lookup varies based on the fuel algorithm selected (speed density, alpha-n etc).
  * 
- * @return byte The current VE value
+ * The AFR target and staging tables use the same load, so are looked up here too: but only if they are in use.
+ * 
+ * @return The current VE value, plus the AFR target & staging table values
  */
-static inline uint8_t getVE1(void)
+static inline fuelTableValues getVE1(void)
 {
   currentStatus.fuelLoad = getLoad(configPage2.fuelAlgorithm, currentStatus);
-  return get3DTableValue(&fuelTable, currentStatus.fuelLoad, currentStatus.RPM); //Perform lookup into fuel map for RPM vs MAP value
+  fuelTableValues values = { 0U, 0U, 0U };
+  if (isAfrTargetTableUsed(configPage2, configPage6))
+  {
+    auto lookups = get3DTableValues(currentStatus.fuelLoad, currentStatus.RPM, &fuelTable, &afrTable);
+    values.ve = lookups[0];
+    values.afrTarget = lookups[1];
+  }
+  else
+  {
+    values.ve = get3DTableValue(&fuelTable, currentStatus.fuelLoad, currentStatus.RPM); //Perform lookup into fuel map for RPM vs MAP value
+  }
+  if (isStagingTableUsed(configPage2, configPage10))
+  {
+    // Shares the loop's axis context, so the RPM axis isn't searched again
+    values.stagingSplit = get3DTableValue(&stagingTable, currentStatus.fuelLoad, currentStatus.RPM);
+  }
+  return values;
 }
 
+/** @brief The values of the tables looked up with the ignition load. Tables that aren't in use read as zero */
+struct ignitionTableValues {
+  int8_t advance;
+  uint8_t dwell; ///< For computeDwell()
+};
+
 /** Lookup the ignition advance from 3D ignition table.
  * The values used to look this up will be RPM and whatever load source the user has configured.
  * 
- * @return byte The current target advance value in degrees
+ * As for getVE1(), the dwell map uses the same load so is looked up in the same pass if it is in use.
+ * 
+ * @return The current target advance value in degrees, plus the dwell map value
  */
-static inline int8_t getAdvance1(void)
+static inline ignitionTableValues getAdvance1(void)
 {
   currentStatus.ignLoad = getLoad(configPage2.ignAlgorithm, currentStatus);
-  return correctionsIgn(IGNITION_ADVANCE_LARGE.toUser(get3DTableValue(&ignitionTable, currentStatus.ignLoad, currentStatus.RPM))); //As above, but for ignition advance
+  if (isDwellMapUsed(configPage2))
+  {
+    auto lookups = get3DTableValues(currentStatus.ignLoad, currentStatus.RPM, &ignitionTable, &dwellTable);
+    return { correctionsIgn(IGNITION_ADVANCE_LARGE.toUser(lookups[0])), lookups[1] };
+  }
+  return { correctionsIgn(IGNITION_ADVANCE_LARGE.toUser(get3DTableValue(&ignitionTable, currentStatus.ignLoad, currentStatus.RPM))), 0U }; //As above, but for ignition advance
+}
+
+/** Lookup the secondary fuel table, if it is in use this loop. */
+static inline uint8_t getVE2(void)
+{
+  currentStatus.secondFuelTableActive = isSecondaryFuelTableActive(configPage10, currentStatus);
+  if (currentStatus.secondFuelTableActive)
+  {
+    return get3DTableValue(&fuelTable2, getLoad(configPage10.fuel2Algorithm, currentStatus), currentStatus.RPM);
+  }
+  return 0U;
+}
+
+/** Lookup the secondary spark table, if it is in use this loop. */
+static inline table3d_value_t getAdvance2(void)
+{
+  currentStatus.secondSparkTableActive = isSecondarySparkTableActive(configPage2, configPage10, currentStatus);
+  if (currentStatus.secondSparkTableActive)
+  {
+    return get3DTableValue(&ignitionTable2, getLoad(configPage10.spark2Algorithm, currentStatus), currentStatus.RPM);
+  }
+  return 0U;
 }
 
 static inline bool haveSwitchedToBatteryPower(uint8_t originalBatteryVoltage, const statuses &current)
@@ -132,7 +195,7 @@ static void onPowerSourceSwitch(uint8_t originalBatteryVoltage, const statuses &
  * - Read sensors
  * - get VE for fuel calcs and spark advance for ignition
  * - Check crank/cam/tooth/timing sync (skip remaining ops if out-of-sync)
- * - execute doCrankSpeedCalcs()
+ * - Calculate fuel & ignition schedule timing
  * 
  * single byte variable @ref statuses.LOOP_TIMER plays a big part here as:
  * - it contains expire-bits for interval based frequency driven events (e.g. 15Hz, 4Hz, 1Hz)
@@ -149,6 +212,7 @@ static void onPowerSourceSwitch(uint8_t originalBatteryVoltage, const statuses &
 BEGIN_LTO_ALWAYS_INLINE(void) loop(void)
 {
   uint8_t originalBatteryVoltage = currentStatus.battery10;
+  loopProfilerStart();
 
       if(mainLoopCount < UINT16_MAX) { mainLoopCount++; }
       currentStatus.LOOP_TIMER = getAndClearTimerMask();
@@ -184,6 +248,16 @@ BEGIN_LTO_ALWAYS_INLINE(void) loop(void)
           }
         }   
       #endif
+    loopProfilerMark(LoopSection::Comms);
+    //Comms may have changed the table axes: if so, start sharing axis resolutions afresh
+    static generation_t axisContextGeneration = 0U;
+    if (axisContextGeneration!=getTuneGeneration())
+    {
+      resetAxisContext(tableAxisContext);
+      axisContextGeneration = getTuneGeneration();
+    }
+    //Keep the page CRCs up to date, so TS CRC requests don't block
+    updatePageCRC32Cache();
           
     currentLoopTime = micros();
     if ( currentStatus.decoder.isEngineRunning(currentLoopTime) )
@@ -231,6 +305,7 @@ BEGIN_LTO_ALWAYS_INLINE(void) loop(void)
     //***Perform sensor reads***
     //-----------------------------------------------------------------------------------------------------
     readPolledSensors(currentStatus.LOOP_TIMER);
+    loopProfilerMark(LoopSection::Sensors);
 
     if(BIT_CHECK(currentStatus.LOOP_TIMER, BIT_TIMER_50HZ)) //50 hertz
     {
@@ -252,7 +327,12 @@ BEGIN_LTO_ALWAYS_INLINE(void) loop(void)
       #endif
 
       #ifdef SD_LOGGING
-        if(configPage13.onboard_log_file_rate == SD_LOGGER_RATE_30HZ) { writeSDLogEntry(); }
+        if(configPage13.onboard_log_file_rate == SD_LOGGER_RATE_30HZ)
+        {
+          loopProfilerMark(LoopSection::Auxiliaries);
+          writeSDLogEntry();
+          loopProfilerMark(LoopSection::SdLogging);
+        }
       #endif
 
       //AVR units process secondary serial requests at a fixed 30Hz
@@ -289,7 +369,12 @@ BEGIN_LTO_ALWAYS_INLINE(void) loop(void)
       #endif
 
       #ifdef SD_LOGGING
-        if(configPage13.onboard_log_file_rate == SD_LOGGER_RATE_10HZ) { writeSDLogEntry(); }
+        if(configPage13.onboard_log_file_rate == SD_LOGGER_RATE_10HZ)
+        {
+          loopProfilerMark(LoopSection::Auxiliaries);
+          writeSDLogEntry();
+          loopProfilerMark(LoopSection::SdLogging);
+        }
       #endif
     }
     if (BIT_CHECK(currentStatus.LOOP_TIMER, BIT_TIMER_4HZ))
@@ -304,7 +389,12 @@ BEGIN_LTO_ALWAYS_INLINE(void) loop(void)
       }
 
       #ifdef SD_LOGGING
-        if(configPage13.onboard_log_file_rate == SD_LOGGER_RATE_4HZ) { writeSDLogEntry(); }
+        if(configPage13.onboard_log_file_rate == SD_LOGGER_RATE_4HZ)
+        {
+          loopProfilerMark(LoopSection::Auxiliaries);
+          writeSDLogEntry();
+          loopProfilerMark(LoopSection::SdLogging);
+        }
       #endif  
            
       if(BIT_CHECK(statusSensors, BIT_SENSORS_AUX_ENBL))
@@ -383,12 +473,19 @@ BEGIN_LTO_ALWAYS_INLINE(void) loop(void)
       }
 
       #ifdef SD_LOGGING
-        if(configPage13.onboard_log_file_rate == SD_LOGGER_RATE_1HZ) { writeSDLogEntry(); }
+        if(configPage13.onboard_log_file_rate == SD_LOGGER_RATE_1HZ)
+        {
+          loopProfilerMark(LoopSection::Auxiliaries);
+          writeSDLogEntry();
+          loopProfilerMark(LoopSection::SdLogging);
+        }
         //SD log sync can take up to 8ms on slow SD cards. To prevent potential issues we only perform this if the RPM is under a safe speed so that there will always be sufficient time for a main loop to run. 
         //A sync will be forced if it hasn't taken place within a max period
         if( (currentStatus.RPM < SD_SYNC_RPM_THRESHOLD) || (msSinceLastSDSync > SD_SYNC_MAX_TIME_PERIOD) )
         { 
+          loopProfilerMark(LoopSection::Auxiliaries);
           if(syncSDLog()) { msSinceLastSDSync = 0; } //Run SD sync and reset  
+          loopProfilerMark(LoopSection::SdLogging);
         }
       #endif
 
@@ -399,18 +496,30 @@ BEGIN_LTO_ALWAYS_INLINE(void) loop(void)
     // ...or to be run at 10Hz to align with the idle taper resolution of 0.1s
     || BIT_CHECK(currentStatus.LOOP_TIMER, BIT_TIMER_10HZ))
     {
+      loopProfilerMark(LoopSection::Auxiliaries);
       idleControl(); 
+      loopProfilerMark(LoopSection::Idle);
     }
+    #ifdef SD_LOGGING
+      //Tooth log blocks fill at engine speed, so they are drained every loop rather than at the log rate
+      loopProfilerMark(LoopSection::Auxiliaries);
+      writeSDToothLog();
+      loopProfilerMark(LoopSection::SdLogging);
+    #endif
+    loopProfilerMark(LoopSection::Auxiliaries);
 
     //VE and advance calculation were moved outside the sync/RPM check so that the fuel and ignition load value will be accurately shown when RPM=0
-    currentStatus.VE1 = getVE1();
+    const fuelTableValues fuelValues = getVE1();
+    currentStatus.VE1 = fuelValues.ve;
     currentStatus.VE = currentStatus.VE1; //Set the final VE value to be VE 1 as a default. This may be changed in the section below
 
-    currentStatus.advance1 = getAdvance1();
+    const ignitionTableValues ignitionValues = getAdvance1();
+    currentStatus.advance1 = ignitionValues.advance;
     currentStatus.advance = currentStatus.advance1; //Set the final advance value to be advance 1 as a default. This may be changed in the section below
 
-    calculateSecondaryFuel(configPage10, fuelTable2, currentStatus);
-    calculateSecondarySpark(configPage2, configPage10, ignitionTable2, currentStatus);
+    calculateSecondaryFuel(configPage10, getVE2(), currentStatus);
+    calculateSecondarySpark(configPage10, getAdvance2(), currentStatus);
+    loopProfilerMark(LoopSection::TableLookup);
 
     //Always check for sync
     //Main loop runs within this clause
@@ -450,14 +559,17 @@ BEGIN_LTO_ALWAYS_INLINE(void) loop(void)
       
       //Check that the duty cycle of the chosen pulsewidth isn't too high.
       //Calculate an injector pulsewidth from the VE
-      currentStatus.afrTarget = calculateAfrTarget(afrTable, currentStatus, configPage2, configPage6);
+      loopProfilerMark(LoopSection::Corrections);
+      currentStatus.afrTarget = calculateAfrTarget(fuelValues.afrTarget, currentStatus, configPage2, configPage6);
+      loopProfilerMark(LoopSection::TableLookup);
       currentStatus.corrections = correctionsFuel();
 
       pulseWidths pulse_widths = computePulseWidths(
                                     configPage2,
                                     configPage6,
                                     configPage10, 
-                                    currentStatus);
+                                    currentStatus,
+                                    fuelValues.stagingSplit);
       currentStatus.stagingActive = pulse_widths.secondary!=0U;
 
       applyPwToInjectorChannels(pulse_widths, configPage2, configPage4, configPage6, currentStatus);
@@ -466,10 +578,11 @@ BEGIN_LTO_ALWAYS_INLINE(void) loop(void)
       //| BEGIN IGNITION CALCULATIONS
 
       //Set dwell
-      currentStatus.dwell = correctionsDwell(computeDwell(currentStatus, configPage2, configPage4, dwellTable));
+      currentStatus.dwell = correctionsDwell(computeDwell(currentStatus, configPage2, configPage4, ignitionValues.dwell));
 
       // Convert the dwell time to dwell angle based on the current engine speed
       calculateIgnitionAngles(configPage2, configPage4, configPage13, currentStatus);
+      loopProfilerMark(LoopSection::Corrections);
 
       //***********************************************************************************************
       //| BEGIN FUEL SCHEDULES
@@ -540,11 +653,14 @@ BEGIN_LTO_ALWAYS_INLINE(void) loop(void)
       else { fixedCrankingOverride = 0; }
 
       setIgnitionChannels(currentStatus, currentStatus.decoder.getCrankAngle(), currentStatus.dwell + fixedCrankingOverride);
+      loopProfilerMark(LoopSection::Schedules);
 
     } //Has sync and RPM
     matchResetControlToEngineState(currentStatus);
     pulsedCommandController(currentStatus, configPage13);
     onPowerSourceSwitch(originalBatteryVoltage, currentStatus, configPage2, configPage6);
+    loopProfilerMark(LoopSection::Auxiliaries);
+    loopProfilerEnd();
 } //loop()
 END_LTO_INLINE()
 
@@ -0,0 +1,129 @@
+#include "decoder_shared.h"
+
+/** 36-2-1 / Mistsubishi 4B11 - A crank based trigger with a nominal 36 teeth, but with 1 single and 1 double missing tooth.
+* @defgroup dec_36_2_1 36-2-1 For Mistsubishi 4B11
+* @{
+*/
+static void triggerPri_ThirtySixMinus21(void)
+{
+   uint32_t curTime = micros();
+   curGap = curTime - toothLastToothTime;
+   if ( curGap >= triggerFilterTime ) //Pulses should never be less than triggerFilterTime, so if they are it means a false trigger. (A 36-1 wheel at 8000pm will have triggers approx. every 200uS)
+   {
+     toothCurrentCount++; //Increment the tooth counter
+     decoderStatus.validTrigger = true; //Flag this pulse as being a valid trigger (ie that it passed filters)
+
+     //Begin the missing tooth detection
+     //If the time between the current tooth and the last is greater than 2x the time between the last tooth and the tooth before that, we make the assertion that we must be at the first tooth after a gap
+    
+     targetGap2 = (3 * (toothLastToothTime - toothLastMinusOneToothTime)) ; //Multiply by 3 (Checks for a gap 3x greater than the last one)
+     targetGap = targetGap2 >> 1;  //Multiply by 1.5 (Checks for a gap 1.5x greater than the last one) (Uses bitshift to divide by 2 as in the missing tooth decoder)
+
+     if( (toothLastToothTime == 0) || (toothLastMinusOneToothTime == 0) ) { curGap = 0; }
+
+     if ( (curGap > targetGap) )
+     {
+      if ( (curGap < targetGap2))
+       {
+           //we are at the tooth after the single gap
+           toothCurrentCount = 20; //it's either 19 or 20, need to clarify engine direction!
+           decoderStatus.syncStatus = SyncStatus::Full;
+        }
+        else 
+        {
+          //we are at the tooth after the double gap
+          toothCurrentCount = 1; 
+          decoderStatus.syncStatus = SyncStatus::Full;
+        }
+ 
+         decoderStatus.toothAngleIsCorrect = false; //The tooth angle is double at this point
+         triggerFilterTime = 0; //This is used to prevent a condition where serious intermittent signals (Eg someone furiously plugging the sensor wire in and out) can leave the filter in an unrecoverable state
+       }
+     }
+     else
+     {
+       if(  (toothCurrentCount > 36) || ( toothCurrentCount==1)  )
+       {
+         //Means a complete rotation has occurred.
+         toothCurrentCount = 1;
+         revolutionOne = !revolutionOne; //Flip sequential revolution tracker
+         toothOneMinusOneTime = toothOneTime;
+         toothOneTime = curTime;
+         currentStatus.startRevolutions++; //Counter
+
+       }
+
+       //Filter can only be recalculated for the regular teeth, not the missing one.
+       setFilter(curGap);
+
+       decoderStatus.toothAngleIsCorrect = true;
+
+     }
+
+     toothLastMinusOneToothTime = toothLastToothTime;
+     toothLastToothTime = curTime;
+     publishToothEvent();
+
+     //EXPERIMENTAL!
+     if(isPerToothTimingEnabled())
+     {
+       int16_t crankAngle = ( (toothCurrentCount-1) * triggerToothAngle ) + configPage4.triggerAngle;
+       checkPerToothTiming(crankAngle, toothCurrentCount);
+     }
+
+   
+}
+
+static uint16_t getRPM_ThirtySixMinus21(void)
+{
+  uint16_t tempRPM = 0;
+  if( currentStatus.RPM < currentStatus.crankRPM)
+  {
+    if( (toothCurrentCount != 20) && (decoderStatus.toothAngleIsCorrect) )
+    {
+      tempRPM = crankingGetRPM(36, CRANK_SPEED);
+    }
+    else { tempRPM = currentStatus.RPM; } //Can't do per tooth RPM if we're at tooth #1 as the missing tooth messes the calculation
+  }
+  else
+  {
+    tempRPM = stdGetRPM(CRANK_SPEED);
+  }
+  return tempRPM;
+}
+
+static void triggerSetEndTeeth_ThirtySixMinus21(void)
+{
+  ignitionEndTeeth[0] = 10; 
+  ignitionEndTeeth[1] = 28; // Arbitrarily picked  at 180°.
+}
+
+decoder_t  __attribute__((optimize("Os"))) triggerSetup_ThirtySixMinus21(void)
+{
+  decoderFeatures = decoder_features_t();
+	sharedDecoderReset();
+  triggerToothAngle = 10; //The number of degrees that passes from tooth to tooth
+  triggerActualTeeth = 33; //The number of physical teeth on the wheel. Doing this here saves us a calculation each time in the interrupt. Not Used
+  triggerFilterTime = (MICROS_PER_SEC / (MAX_RPM / 60U * 36)); //Trigger filter time is the shortest possible time (in uS) that there can be between crank teeth (ie at max RPM). Any pulses that occur faster than this time will be discarded as noise
+  decoderFeatures.supportsPerToothIgnition = true;
+  checkSyncToothCount = (configPage4.triggerTeeth) >> 1; //50% of the total teeth.
+  toothLastMinusOneToothTime = 0;
+  toothCurrentCount = 0;
+  toothOneTime = 0;
+  toothOneMinusOneTime = 0;
+  MAX_STALL_TIME = ((MICROS_PER_DEG_1_RPM/50U) * triggerToothAngle * 2U ); //Minimum 50rpm. (3333uS is the time per degree at 50rpm)
+
+  return decoder_builder_t()
+                  .setPrimaryTrigger(triggerPri_ThirtySixMinus21, getConfigPriTriggerEdge(configPage4))
+                  .setSecondaryTrigger(triggerSec_missingTooth, getConfigSecTriggerEdge(configPage4))
+                  .setGetRPM(getRPM_ThirtySixMinus21)
+                  .setGetCrankAngle(getCrankAngle_missingTooth) //This uses the same function as the missing tooth decoder, so no need to duplicate code
+                  .setSetEndTeeth(triggerSetEndTeeth_ThirtySixMinus21)
+                  .setReset(sharedDecoderReset)
+                  .setIsEngineRunning(sharedEngineIsRunning)
+                  .setGetStatus(sharedGetStatus)
+                  .setGetFeatures(sharedGetDecoderFeatures)
+                  .build();
+}
+
+/** @} */
@@ -0,0 +1,126 @@
+#include "decoder_shared.h"
+
+/** Audi with 135 teeth on the crank and 1 tooth on the cam.
+* This is very similar to the dual wheel decoder, however due to the 135 teeth not dividing evenly into 360,
+* only every 3rd crank tooth is used in calculating the crank angle. This effectively makes it a 45 tooth dual wheel setup.
+* @defgroup dec_audi135 Audi 135
+* @{
+*/
+static void triggerPri_Audi135(void)
+{
+   uint32_t curTime = micros();
+   curGap = curTime - toothSystemLastToothTime;
+   if ( (curGap > triggerFilterTime) || (currentStatus.startRevolutions == 0) )
+   {
+     toothSystemCount++;
+
+     if ( decoderStatus.syncStatus!=SyncStatus::Full ) { toothLastToothTime = curTime; }
+     else
+     {
+       if ( toothSystemCount >= 3 )
+       {
+         //We only proceed for every third tooth
+
+         decoderStatus.validTrigger = true; //Flag this pulse as being a valid trigger (ie that it passed filters)
+         toothSystemLastToothTime = curTime;
+         toothSystemCount = 0;
+         toothCurrentCount++; //Increment the tooth counter
+
+         if ( (toothCurrentCount == 1) || (toothCurrentCount > 45) )
+         {
+           toothCurrentCount = 1;
+           toothOneMinusOneTime = toothOneTime;
+           toothOneTime = curTime;
+           revolutionOne = !revolutionOne;
+           currentStatus.startRevolutions++; //Counter
+         }
+
+         setFilter(curGap); //Recalc the new filter value
+
+         toothLastMinusOneToothTime = toothLastToothTime;
+         toothLastToothTime = curTime;
+       } //3rd tooth check
+     } // Sync check
+   } // Trigger filter
+}
+
+static void triggerSec_Audi135(void)
+{
+  /*
+  uint32_t curTime2 = micros();
+  curGap2 = curTime2 - toothLastSecToothTime;
+  if ( curGap2 < triggerSecFilterTime ) { return; }
+  toothLastSecToothTime = curTime2;
+  */
+
+  if( decoderStatus.syncStatus!=SyncStatus::Full )
+  {
+    toothCurrentCount = 0;
+    decoderStatus.syncStatus = SyncStatus::Full;
+    toothSystemCount = 3; //Need to set this to 3 so that the next primary tooth is counted
+  }
+  else if (configPage4.useResync == 1) { toothCurrentCount = 0; toothSystemCount = 3; }
+  else if ( (currentStatus.startRevolutions < 100) && (toothCurrentCount != 45) ) { toothCurrentCount = 0; }
+  revolutionOne = 1; //Sequential revolution reset
+}
+
+static uint16_t getRPM_Audi135(void)
+{
+   return stdGetRPM(CRANK_SPEED);
+}
+
+static int16_t getCrankAngle_Audi135(uint32_t currMicros)
+{
+    //This is the current angle ATDC the engine is at. This is the last known position based on what tooth was last 'seen'. It is only accurate to the resolution of the trigger wheel (Eg 36-1 is 10 degrees)
+    unsigned long tempToothLastToothTime;
+    int tempToothCurrentCount;
+    bool tempRevolutionOne;
+    //Grab some variables that are used in the trigger code and assign them to temp variables.
+    noInterrupts();
+    tempToothCurrentCount = toothCurrentCount;
+    tempToothLastToothTime = toothLastToothTime;
+    tempRevolutionOne = revolutionOne;
+    interrupts();
+
+    //Handle case where the secondary tooth was the last one seen
+    if(tempToothCurrentCount == 0) { tempToothCurrentCount = 45; }
+
+    int crankAngle = ((tempToothCurrentCount - 1) * triggerToothAngle) + configPage4.triggerAngle; //Number of teeth that have passed since tooth 1, multiplied by the angle each tooth represents, plus the angle that tooth 1 is ATDC. This gives accuracy only to the nearest tooth.
+    
+    //Estimate the number of degrees travelled since the last tooth}
+    crankAngle += timeToAngle(currMicros - tempToothLastToothTime);
+
+    //Sequential check (simply sets whether we're on the first or 2nd revolution of the cycle)
+    if (tempRevolutionOne) { crankAngle += 360; }
+
+    if (crankAngle >= 720) { crankAngle -= 720; }
+    if (crankAngle < 0) { crankAngle += CRANK_ANGLE_MAX; }
+
+    return crankAngle;
+}
+
+decoder_t  __attribute__((optimize("Os"))) triggerSetup_Audi135(void)
+{
+  decoderFeatures = decoder_features_t();
+	sharedDecoderReset();
+  triggerToothAngle = 8; //135/3 = 45, 360/45 = 8 degrees every 3 teeth
+  toothCurrentCount = UINT8_MAX; //Default value
+  triggerFilterTime = (unsigned long)(MICROS_PER_SEC / (MAX_RPM / 60U * 135UL)); //Trigger filter time is the shortest possible time (in uS) that there can be between crank teeth (ie at max RPM). Any pulses that occur faster than this time will be discarded as noise
+  triggerSecFilterTime = (int)(MICROS_PER_SEC / (MAX_RPM / 60U * 2U)) / 2U; //Same as above, but fixed at 2 teeth on the secondary input and divided by 2 (for cam speed)
+  MAX_STALL_TIME = ((MICROS_PER_DEG_1_RPM/50U) * triggerToothAngle); //Minimum 50rpm. (3333uS is the time per degree at 50rpm)
+  decoderFeatures.supportsSequential = true;
+  decoderStatus.toothAngleIsCorrect = true;
+  
+  return decoder_builder_t()
+                  .setPrimaryTrigger(triggerPri_Audi135, getConfigPriTriggerEdge(configPage4))
+                  .setSecondaryTrigger(triggerSec_Audi135, RISING)
+                  .setGetRPM(getRPM_Audi135)
+                  .setGetCrankAngle(getCrankAngle_Audi135)
+                  .setReset(sharedDecoderReset)
+                  .setIsEngineRunning(sharedEngineIsRunning)
+                  .setGetStatus(sharedGetStatus)
+                  .setGetFeatures(sharedGetDecoderFeatures)
+                  .build();
+}
+
+/** @} */
@@ -0,0 +1,208 @@
+#include "decoder_shared.h"
+
+/** Basic Distributor where tooth count is equal to the number of cylinders and teeth are evenly spaced on the cam.
+* No position sensing (Distributor is retained) so crank angle is
+* a made up figure based purely on the first teeth to be seen.
+* Note: This is a very simple decoder. See http://www.megamanual.com/ms2/GM_7pinHEI.htm
+* @defgroup dec_dist Basic Distributor
+* @{
+*/
+static void triggerPri_BasicDistributor(void)
+{
+  uint32_t curTime = micros();
+  curGap = curTime - toothLastToothTime;
+  if ( (curGap >= triggerFilterTime) )
+  {
+    if(decoderStatus.syncStatus==SyncStatus::Full) { setFilter(curGap); } //Recalc the new filter value
+    else { triggerFilterTime = 0; } //If we don't yet have sync, ensure that the filter won't prevent future valid pulses from being ignored. 
+    
+    if( (toothCurrentCount == triggerActualTeeth) || (decoderStatus.syncStatus!=SyncStatus::Full) ) //Check if we're back to the beginning of a revolution
+    {
+      toothCurrentCount = 1; //Reset the counter
+      toothOneMinusOneTime = toothOneTime;
+      toothOneTime = curTime;
+      decoderStatus.syncStatus = SyncStatus::Full;
+      currentStatus.startRevolutions++; //Counter
+    }
+    else
+    {
+      if( (toothCurrentCount < triggerActualTeeth) ) { toothCurrentCount++; } //Increment the tooth counter
+      else
+      {
+        //This means toothCurrentCount is greater than triggerActualTeeth, which is bad.
+        //If we have sync here then there's a problem. Throw a sync loss
+        if( decoderStatus.syncStatus==SyncStatus::Full ) 
+        { 
+          currentStatus.syncLossCounter++;
+          decoderStatus.syncStatus = SyncStatus::None;
+        }
+      }
+      
+    }
+
+    decoderStatus.validTrigger = true; //Flag this pulse as being a valid trigger (ie that it passed filters)
+
+    if ( configPage4.ignCranklock && (currentStatus.rotationStatus==EngineRotationStatus::Cranking) )
+    {
+      stopAllCoilsCharging();
+    }
+
+    if(isPerToothTimingEnabled())
+    {
+      int16_t crankAngle = ( (toothCurrentCount-1) * triggerToothAngle ) + configPage4.triggerAngle;
+      uint16_t currentTooth = toothCurrentCount;
+      if(toothCurrentCount > (triggerActualTeeth/2) ) { currentTooth = (toothCurrentCount - (triggerActualTeeth/2)); }
+      checkPerToothTiming(crankAngle, currentTooth);
+    }
+
+    toothLastMinusOneToothTime = toothLastToothTime;
+    toothLastToothTime = curTime;
+  } //Trigger filter
+}
+
+static uint16_t getRPM_BasicDistributor(void)
+{
+  uint16_t tempRPM;
+  uint8_t distributorSpeed = CAM_SPEED; //Default to cam speed
+  if(configPage2.strokes == TWO_STROKE) { distributorSpeed = CRANK_SPEED; } //For 2 stroke distributors, the tooth rate is based on crank speed, not 'cam'
+
+  if( currentStatus.RPM < currentStatus.crankRPM || currentStatus.RPM < 1500)
+  { 
+    tempRPM = crankingGetRPM(triggerActualTeeth, distributorSpeed);
+  } 
+  else { tempRPM = stdGetRPM(distributorSpeed); }
+
+  MAX_STALL_TIME = currentStatus.revolutionTime << 1; //Set the stall time to be twice the current RPM. This is a safe figure as there should be no single revolution where this changes more than this
+  if(triggerActualTeeth == 1) { MAX_STALL_TIME = currentStatus.revolutionTime << 1; } //Special case for 1 cylinder engines that only get 1 pulse every 720 degrees
+  if(MAX_STALL_TIME < 366667UL) { MAX_STALL_TIME = 366667UL; } //Check for 50rpm minimum
+
+  return tempRPM;
+
+}
+static int16_t getCrankAngle_BasicDistributor(uint32_t currMicros)
+{
+    //This is the current angle ATDC the engine is at. This is the last known position based on what tooth was last 'seen'. It is only accurate to the resolution of the trigger wheel (Eg 36-1 is 10 degrees)
+    unsigned long tempToothLastToothTime;
+    int tempToothCurrentCount;
+    //Grab some variables that are used in the trigger code and assign them to temp variables.
+    noInterrupts();
+    tempToothCurrentCount = toothCurrentCount;
+    tempToothLastToothTime = toothLastToothTime;
+    interrupts();
+
+    int crankAngle = ((tempToothCurrentCount - 1) * triggerToothAngle) + configPage4.triggerAngle; //Number of teeth that have passed since tooth 1, multiplied by the angle each tooth represents, plus the angle that tooth 1 is ATDC. This gives accuracy only to the nearest tooth.
+    
+    //Estimate the number of degrees travelled since the last tooth}
+    crankAngle += timeToAngleIntervalTooth(currMicros - tempToothLastToothTime);
+    
+
+    if (crankAngle >= 720) { crankAngle -= 720; }
+    if (crankAngle < 0) { crankAngle += CRANK_ANGLE_MAX; }
+
+    return crankAngle;
+}
+
+static void triggerSetEndTeeth_BasicDistributor(void)
+{
+
+  int tempEndAngle = (ignitionSchedule1.dischargeAngle - configPage4.triggerAngle);
+  tempEndAngle = ignitionLimits((tempEndAngle));
+
+  switch(configPage2.nCylinders)
+  {
+    case 4:
+      if( (tempEndAngle > 180) || (tempEndAngle <= 0) )
+      {
+        ignitionEndTeeth[0] = 2;
+        ignitionEndTeeth[1] = 1;
+      }
+      else
+      {
+        ignitionEndTeeth[0] = 1;
+        ignitionEndTeeth[1] = 2;
+      }
+      break;
+    case 3: //Shared with 6 cylinder
+    case 6:
+      if( (tempEndAngle > 120) && (tempEndAngle <= 240) )
+      {
+        ignitionEndTeeth[0] = 2;
+        ignitionEndTeeth[1] = 3;
+        ignitionEndTeeth[2] = 1;
+      }
+      else if( (tempEndAngle > 240) || (tempEndAngle <= 0) )
+      {
+        ignitionEndTeeth[0] = 3;
+        ignitionEndTeeth[1] = 1;
+        ignitionEndTeeth[2] = 2;
+      }
+      else
+      {
+        ignitionEndTeeth[0] = 1;
+        ignitionEndTeeth[1] = 2;
+        ignitionEndTeeth[2] = 3;
+      }
+      break;
+    case 8:
+      if( (tempEndAngle > 90) && (tempEndAngle <= 180) )
+      {
+        ignitionEndTeeth[0] = 2;
+        ignitionEndTeeth[1] = 3;
+        ignitionEndTeeth[2] = 4;
+        ignitionEndTeeth[3] = 1;
+      }
+      else if( (tempEndAngle > 180) && (tempEndAngle <= 270) )
+      {
+        ignitionEndTeeth[0] = 3;
+        ignitionEndTeeth[1] = 4;
+        ignitionEndTeeth[2] = 1;
+        ignitionEndTeeth[3] = 2;
+      }
+      else if( (tempEndAngle > 270) || (tempEndAngle <= 0) )
+      {
+        ignitionEndTeeth[0] = 4;
+        ignitionEndTeeth[1] = 1;
+        ignitionEndTeeth[2] = 2;
+        ignitionEndTeeth[3] = 3;
+      }
+      else
+      {
+        ignitionEndTeeth[0] = 1;
+        ignitionEndTeeth[1] = 2;
+        ignitionEndTeeth[2] = 3;
+        ignitionEndTeeth[3] = 4;
+      }
+      break;
+  }
+}
+
+decoder_t  __attribute__((optimize("Os"))) triggerSetup_BasicDistributor(void)
+{
+  decoderFeatures = decoder_features_t();
+	sharedDecoderReset();
+  triggerActualTeeth = configPage2.nCylinders;
+  if(triggerActualTeeth == 0) { triggerActualTeeth = 1; }
+
+  //The number of degrees that passes from tooth to tooth. Depends on number of cylinders and whether 4 or 2 stroke
+  if(configPage2.strokes == FOUR_STROKE) { triggerToothAngle = 720U / triggerActualTeeth; }
+  else { triggerToothAngle = 360U / triggerActualTeeth; }
+
+  toothCurrentCount = 0; //Default value
+  decoderFeatures.hasFixedCrankingTiming = true;
+  decoderStatus.toothAngleIsCorrect = true;
+  decoderFeatures.supportsPerToothIgnition = true;
+  if(configPage2.nCylinders <= 4U) { MAX_STALL_TIME = ((MICROS_PER_DEG_1_RPM/90U) * triggerToothAngle); }//Minimum 90rpm. (1851uS is the time per degree at 90rpm). This uses 90rpm rather than 50rpm due to the potentially very high stall time on a 4 cylinder if we wait that long.
+  else { MAX_STALL_TIME = ((MICROS_PER_DEG_1_RPM/50U) * triggerToothAngle); } //Minimum 50rpm. (3200uS is the time per degree at 50rpm).
+
+  return decoder_builder_t()
+                .setPrimaryTrigger(triggerPri_BasicDistributor, getConfigPriTriggerEdge(configPage4))
+                .setGetRPM(getRPM_BasicDistributor)
+                .setGetCrankAngle(getCrankAngle_BasicDistributor)
+                .setSetEndTeeth(triggerSetEndTeeth_BasicDistributor)
+                .setReset(sharedDecoderReset)
+                .setIsEngineRunning(sharedEngineIsRunning)
+                .setGetStatus(sharedGetStatus)
+                .setGetFeatures(sharedGetDecoderFeatures)
+                .build();
+}
+/** @} */
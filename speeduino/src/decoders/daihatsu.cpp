@@ -0,0 +1,169 @@
+#include "decoder_shared.h"
+
+/** Daihatsu +1 trigger for 3 and 4 cylinder engines.
+* Tooth equal to the number of cylinders are evenly spaced on the cam. No position sensing (Distributor is retained),
+* so crank angle is a made up figure based purely on the first teeth to be seen.
+* Note: This is a very simple decoder. See http://www.megamanual.com/ms2/GM_7pinHEI.htm
+* @defgroup dec_daihatsu Daihatsu (3  and 4 cyl.)
+* @{
+*/
+static void triggerPri_Daihatsu(void)
+{
+  uint32_t curTime = micros();
+  curGap = curTime - toothLastToothTime;
+
+  //if ( curGap >= triggerFilterTime || (currentStatus.startRevolutions == 0 )
+  {
+    toothSystemCount++;
+    decoderStatus.validTrigger = true; //Flag this pulse as being a valid trigger (ie that it passed filters)
+
+    if (decoderStatus.syncStatus==SyncStatus::Full)
+    {
+      if( (toothCurrentCount == triggerActualTeeth) ) //Check if we're back to the beginning of a revolution
+      {
+         toothCurrentCount = 1; //Reset the counter
+         toothOneMinusOneTime = toothOneTime;
+         toothOneTime = curTime;
+         decoderStatus.syncStatus = SyncStatus::Full;
+         currentStatus.startRevolutions++; //Counter
+
+         //Need to set a special filter time for the next tooth
+         triggerFilterTime = 20; //Fix this later
+      }
+      else
+      {
+        toothCurrentCount++; //Increment the tooth counter
+        setFilter(curGap); //Recalc the new filter value
+      }
+
+      if ( configPage4.ignCranklock && (currentStatus.rotationStatus==EngineRotationStatus::Cranking) )
+      {
+        //This locks the cranking timing to 0 degrees BTDC (All the triggers allow for)
+        if(toothCurrentCount == 1) { endCoilCharge(1U); }
+        else if(toothCurrentCount == 2) { endCoilCharge(2U); }
+        else if(toothCurrentCount == 3) { endCoilCharge(3U); }
+        else if(toothCurrentCount == 4) { endCoilCharge(4U); }
+      }
+    }
+    else //NO SYNC
+    {
+      //
+      if(toothSystemCount >= 3) //Need to have seen at least 3 teeth to determine SYNC
+      {
+        unsigned long targetTime;
+        //We need to try and find the extra tooth (#2) which is located 30 degrees after tooth #1
+        //Aim for tooth times less than about 60 degrees
+        if(configPage2.nCylinders == 3)
+        {
+          targetTime = (toothLastToothTime -  toothLastMinusOneToothTime) / 4; //Teeth are 240 degrees apart for 3 cylinder. 240/4 = 60
+        }
+        else
+        {
+          targetTime = ((toothLastToothTime -  toothLastMinusOneToothTime) * 3) / 8; //Teeth are 180 degrees apart for 4 cylinder. (180*3)/8 = 67
+        }
+        if(curGap < targetTime)
+        {
+          //Means we're on the extra tooth here
+          toothCurrentCount = 2; //Reset the counter
+          decoderStatus.syncStatus = SyncStatus::Full;
+          triggerFilterTime = targetTime; //Lazy, but it works
+        }
+      }
+    }
+
+    toothLastMinusOneToothTime = toothLastToothTime;
+    toothLastToothTime = curTime;
+  } //Trigger filter
+}
+
+static uint16_t getRPM_Daihatsu(void)
+{
+  uint16_t tempRPM = 0;
+  if( (currentStatus.RPM < currentStatus.crankRPM) && false) //Disable special cranking processing for now
+  {
+    //Can't use standard cranking RPM function due to extra tooth
+    if( decoderStatus.syncStatus==SyncStatus::Full )
+    {
+      if(toothCurrentCount == 2) { tempRPM = currentStatus.RPM; }
+      else if (toothCurrentCount == 3) { tempRPM = currentStatus.RPM; }
+      else
+      {
+        noInterrupts();
+        unsigned long toothTime = (toothLastToothTime - toothLastMinusOneToothTime);
+        interrupts();
+        SetRevolutionTime(toothTime * (triggerActualTeeth-1));
+        tempRPM = getAngleConverterRpm();
+      } //is tooth #2
+    }
+    else { tempRPM = 0; } //No sync
+  }
+  else
+  { tempRPM = stdGetRPM(CAM_SPEED); } //Tracking over 2 crank revolutions
+
+  return tempRPM;
+
+}
+static int16_t getCrankAngle_Daihatsu(uint32_t currMicros)
+{
+    //This is the current angle ATDC the engine is at. This is the last known position based on what tooth was last 'seen'. It is only accurate to the resolution of the trigger wheel (Eg 36-1 is 10 degrees)
+    unsigned long tempToothLastToothTime;
+    int tempToothCurrentCount;
+    int crankAngle;
+    //Grab some variables that are used in the trigger code and assign them to temp variables.
+    noInterrupts();
+    tempToothCurrentCount = toothCurrentCount;
+    tempToothLastToothTime = toothLastToothTime;
+    interrupts();
+
+    crankAngle = toothAngles[tempToothCurrentCount-1] + configPage4.triggerAngle; //Crank angle of the last tooth seen
+
+    //Estimate the number of degrees travelled since the last tooth}
+    crankAngle += timeToAngle(currMicros - tempToothLastToothTime);
+
+    if (crankAngle >= 720) { crankAngle -= 720; }
+    if (crankAngle < 0) { crankAngle += CRANK_ANGLE_MAX; }
+
+    return crankAngle;
+}
+
+decoder_t  __attribute__((optimize("Os"))) triggerSetup_Daihatsu(void)
+{
+  decoderFeatures = decoder_features_t();
+	sharedDecoderReset();
+  triggerActualTeeth = configPage2.nCylinders + 1;
+  triggerToothAngle = 720 / triggerActualTeeth; //The number of degrees that passes from tooth to tooth
+  triggerFilterTime = MICROS_PER_MIN / MAX_RPM / configPage2.nCylinders; // Minimum time required between teeth
+  triggerFilterTime = triggerFilterTime / 2; //Safety margin
+  decoderFeatures.supportsSequential = true;
+
+  MAX_STALL_TIME = ((MICROS_PER_DEG_1_RPM/90U) * triggerToothAngle)*4U;//Minimum 90rpm. (1851uS is the time per degree at 90rpm). This uses 90rpm rather than 50rpm due to the potentially very high stall time on a 4 cylinder if we wait that long.
+
+  if(configPage2.nCylinders == 3)
+  {
+    toothAngles[0] = 0; //tooth #1
+    toothAngles[1] = 30; //tooth #2 (Extra tooth)
+    toothAngles[2] = 240; //tooth #3
+    toothAngles[3] = 480; //tooth #4
+  }
+  else
+  {
+    //Should be 4 cylinders here
+    toothAngles[0] = 0; //tooth #1
+    toothAngles[1] = 30; //tooth #2 (Extra tooth)
+    toothAngles[2] = 180; //tooth #3
+    toothAngles[3] = 360; //tooth #4
+    toothAngles[4] = 540; //tooth #5
+  }
+
+  return decoder_builder_t()
+                  .setPrimaryTrigger(triggerPri_Daihatsu, getConfigPriTriggerEdge(configPage4))
+                  .setGetRPM(getRPM_Daihatsu)
+                  .setGetCrankAngle(getCrankAngle_Daihatsu)
+                  .setReset(sharedDecoderReset)
+                  .setIsEngineRunning(sharedEngineIsRunning)
+                  .setGetStatus(sharedGetStatus)
+                  .setGetFeatures(sharedGetDecoderFeatures)
+                  .build();
+}
+
+/** @} */
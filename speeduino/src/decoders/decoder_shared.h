@@ -0,0 +1,485 @@
+/** @file
+ *
+ * State & routines shared between the crank and cam decoders.
+ *
+ * Each decoder is in its own translation unit in this folder, so that a build with the decoder pinned at compile
+ * time (see SMALL_FLASH_DECODER in decoder_init.cpp) only links in the one that is referenced. The shared routines
+ * called from the ISRs & getRPM() are static inline below, so splitting the decoders doesn't add a call to them.
+ * The rest are in decoders.cpp.
+ *
+ * This is internal to the decoders: everything else should use decoders.h & decoder_t.
+ */
+#pragma once
+
+#include <limits.h>
+#include "../../globals.h"
+#include "../../decoders.h"
+#include "../../elapsed_time.h"
+#include "../../scheduler.h"
+#include "../../crankMaths.h"
+#include "../../timers.h"
+#include "../../unit_testing.h"
+#include "../../atomic.h"
+#include "../../decoder_init.h"
+#include "../../decoder_builder.h"
+#include "../../scheduledIO_ign.h"
+#include "../pins/boardInputPin.h"
+#include "../../scheduler_ignition_controller.h"
+#include "../../scheduler_fuel_controller.h"
+#include "../utils/seqlock.hpp"
+#ifdef USE_LIBDIVIDE
+#include <libdivide.h>
+#endif
+
+#define CRANK_ANGLE_MAX ((std::max)(CRANK_ANGLE_MAX_IGN, CRANK_ANGLE_MAX_INJ))
+
+/** @name Shared decoder state
+ * Defined in decoders.cpp. See there for descriptions.
+ * @{
+ */
+extern volatile unsigned long curGap;
+extern volatile unsigned long curGap2;
+extern volatile unsigned long curGap3;
+extern volatile unsigned long lastGap;
+extern volatile unsigned long targetGap;
+extern volatile unsigned long targetGap2;
+
+extern unsigned long MAX_STALL_TIME;
+extern uint16_t toothCurrentCount;
+extern volatile byte toothSystemCount;
+extern volatile unsigned long toothSystemLastToothTime;
+extern volatile unsigned long toothLastToothTime;
+extern volatile unsigned long toothLastSecToothTime;
+extern volatile unsigned long toothLastThirdToothTime;
+extern volatile unsigned long toothLastMinusOneToothTime;
+extern volatile unsigned long toothLastMinusOneSecToothTime;
+extern volatile unsigned long toothLastToothRisingTime;
+extern volatile unsigned long toothLastSecToothRisingTime;
+extern volatile unsigned long toothOneTime;
+extern volatile unsigned long toothOneMinusOneTime;
+extern volatile bool revolutionOne;
+
+extern volatile unsigned int secondaryToothCount;
+
+extern uint16_t triggerActualTeeth;
+extern volatile unsigned long triggerFilterTime;
+extern volatile unsigned long triggerSecFilterTime;
+
+extern volatile uint16_t triggerToothAngle;
+extern byte checkSyncToothCount;
+
+extern uint16_t ignitionEndTeeth[IGN_CHANNELS];
+
+extern int16_t toothAngles[24];
+
+extern decoder_status_t decoderStatus;
+extern decoder_features_t decoderFeatures;
+
+#ifdef USE_LIBDIVIDE
+extern libdivide::libdivide_s16_t divTriggerToothAngle;
+#endif
+/** @} */
+
+/**
+ * @brief A snapshot of the trigger state, published by the trigger ISRs after each tooth
+ *
+ * The main loop reads this instead of the individual volatile decoder variables, without disabling
+ * interrupts. Only the most recent snapshot is kept: the readers (RPM, crank angle) only need the
+ * current state.
+ */
+struct tooth_event_t {
+  uint32_t time;            ///< toothLastToothTime
+  uint32_t toothGap;        ///< toothLastToothTime - toothLastMinusOneToothTime. Zero if not known
+  uint32_t revolutionTime;  ///< toothOneTime - toothOneMinusOneTime. Zero if not known
+  uint16_t tooth;           ///< toothCurrentCount
+  SyncStatus syncStatus;
+  bool revolutionOne;
+};
+
+/** @name Tooth event state
+ * Defined in decoders.cpp, so sharedDecoderReset() can clear it.
+ * @{
+ */
+// The readers only ever want the current tooth state, so a single snapshot is enough: there is no queue of events.
+// The trigger ISRs are the writers. They don't nest, so only one can be writing at a time.
+extern Seqlock<tooth_event_t> latestToothEvent;
+extern volatile bool isToothEventPublished; // False until the first tooth after a reset
+/** @} */
+
+/** @name Shared decoder routines
+ * Defined in decoders.cpp. See there for descriptions.
+ * @{
+ */
+decoder_status_t sharedGetStatus(void) noexcept;
+uint16_t timeToAngleIntervalTooth(uint32_t time);
+bool sharedEngineIsRunning(uint32_t curTime);
+decoder_features_t sharedGetDecoderFeatures(void);
+void sharedDecoderReset(void);
+uint8_t getConfigPriTriggerEdge(const config4 &page4);
+uint8_t getConfigSecTriggerEdge(const config4 &page4);
+uint8_t getConfigTerTriggerEdge(const config10 &page10);
+/** @} */
+
+/** @name Shared decoder routines called from the ISRs & getRPM()
+ * @{
+ */
+static inline bool IsCranking(const statuses &status) {
+  return (status.RPM < status.crankRPM) && (status.startRevolutions == 0U);
+}
+
+static inline uint32_t positiveTimeDelta(uint32_t later, uint32_t earlier) {
+  return ((earlier!=0UL) && (later>earlier)) ? (later - earlier) : 0UL;
+}
+
+static inline tooth_event_t captureToothEvent(void) {
+  return {
+    (uint32_t)toothLastToothTime,
+    positiveTimeDelta(toothLastToothTime, toothLastMinusOneToothTime),
+    positiveTimeDelta(toothOneTime, toothOneMinusOneTime),
+    toothCurrentCount,
+    decoderStatus.syncStatus,
+    revolutionOne,
+  };
+}
+
+/**
+ * @brief Publish the current tooth state to the main loop.
+ * 
+ * Call from the primary trigger ISR, once all the tooth variables have been updated. Also call
+ * from any secondary trigger ISR that changes them (E.g. revolutionOne), so the snapshot isn't
+ * stale until the next primary tooth.
+ */
+static inline void publishToothEvent(void) {
+  latestToothEvent.write(captureToothEvent());
+  isToothEventPublished = true;
+}
+
+/**
+ * @brief The most recent tooth state, without disabling interrupts.
+ * 
+ * Before the first tooth is published (E.g. engine stopped), this falls back to reading the decoder
+ * variables directly.
+ */
+static inline tooth_event_t getLatestToothEvent(void) {
+  tooth_event_t event;
+  if (isToothEventPublished) {
+    event = latestToothEvent.read();
+  } else {
+    noInterrupts();
+    event = captureToothEvent();
+    interrupts();
+  }
+  return event;
+}
+
+/**
+ * @brief Set currentStatus.revolutionTime & the angle converter from it. Returns true if it changed
+ * 
+ * Call with interrupts enabled: copy the tooth times in a critical section & derive the revolution time
+ * after it. The angle converter's division then runs with interrupts on.
+ */
+static inline bool SetRevolutionTime(uint32_t revTime)
+{
+  if (revTime!=currentStatus.revolutionTime) {
+    currentStatus.revolutionTime = revTime;
+    setAngleConverterRevolutionTime(revTime);
+    return true;
+  } 
+  return false;
+}
+
+static inline bool UpdateRevolutionTimeFromTeeth(bool isCamTeeth) {
+  noInterrupts();
+  SyncStatus syncStatus = decoderStatus.syncStatus;
+  uint32_t oneTime = toothOneTime;
+  uint32_t oneMinusOneTime = toothOneMinusOneTime;
+  interrupts();
+
+  return syncStatus!=SyncStatus::None 
+    && !IsCranking(currentStatus)
+    && (oneMinusOneTime!=UINT32_C(0))
+    && (oneTime>oneMinusOneTime) 
+    //The time in uS that one revolution would take at current speed (The time tooth 1 was last seen, minus the time it was seen prior to that)
+    && SetRevolutionTime((oneTime - oneMinusOneTime) >> (isCamTeeth ? 1U : 0U)); 
+}
+
+// As nearly all the decoders use a common method of determining RPM (The time the last full revolution took) A common function is simpler.
+static inline uint16_t stdGetRPM(bool isCamTeeth)
+{
+  if (UpdateRevolutionTimeFromTeeth(isCamTeeth)) {
+    return getAngleConverterRpm();
+  }
+
+  return currentStatus.RPM;
+}
+
+#define TRIGGER_FILTER_OFF              0
+#define TRIGGER_FILTER_LITE             1
+#define TRIGGER_FILTER_MEDIUM           2
+#define TRIGGER_FILTER_AGGRESSIVE       3
+
+/**
+ * Sets the new filter time based on the current settings.
+ * This ONLY works for even spaced decoders.
+ */
+static inline void setFilter(unsigned long curGap)
+{
+  /*
+  if(configPage4.triggerFilter == 0) { triggerFilterTime = 0; } //trigger filter is turned off.
+  else if(configPage4.triggerFilter == 1) { triggerFilterTime = curGap >> 2; } //Lite filter level is 25% of previous gap
+  else if(configPage4.triggerFilter == 2) { triggerFilterTime = curGap >> 1; } //Medium filter level is 50% of previous gap
+  else if (configPage4.triggerFilter == 3) { triggerFilterTime = (curGap * 3) >> 2; } //Aggressive filter level is 75% of previous gap
+  else { triggerFilterTime = 0; } //trigger filter is turned off.
+  */
+
+  switch(configPage4.triggerFilter)
+  {
+    case TRIGGER_FILTER_OFF: 
+      triggerFilterTime = 0;
+      break;
+    case TRIGGER_FILTER_LITE: 
+      triggerFilterTime = curGap >> 2;
+      break;
+    case TRIGGER_FILTER_MEDIUM: 
+      triggerFilterTime = curGap >> 1;
+      break;
+    case TRIGGER_FILTER_AGGRESSIVE: 
+      triggerFilterTime = (curGap * 3) >> 2;
+      break;
+    default:
+      triggerFilterTime = 0;
+      break;
+  }
+}
+
+/**
+This is a special case of RPM measure that is based on the time between the last 2 teeth rather than the time of the last full revolution.
+This gives much more volatile reading, but is quite useful during cranking, particularly on low resolution patterns.
+It can only be used on patterns where the teeth are evenly spaced.
+It takes an argument of the full (COMPLETE) number of teeth per revolution.
+For a missing tooth wheel, this is the number if the tooth had NOT been missing (Eg 36-1 = 36)
+*/
+static inline int crankingGetRPM(byte totalTeeth, bool isCamTeeth)
+{
+  if( (currentStatus.startRevolutions >= configPage4.StgCycles) && (decoderStatus.syncStatus!=SyncStatus::None) )
+  {
+    noInterrupts();
+    uint32_t lastToothTime = toothLastToothTime;
+    uint32_t lastMinusOneToothTime = toothLastMinusOneToothTime;
+    interrupts();
+    if( (lastMinusOneToothTime > 0) && (lastToothTime > lastMinusOneToothTime)
+      && SetRevolutionTime(((lastToothTime - lastMinusOneToothTime) * totalTeeth) >> (isCamTeeth ? 1U : 0U)) )
+    {
+      return getAngleConverterRpm();
+    }
+  }
+
+  return currentStatus.RPM;
+}
+
+/** @brief As stdGetRPM(), but using a tooth event rather than the live decoder variables */
+static inline uint16_t stdGetRPM(const tooth_event_t &tooth, bool isCamTeeth)
+{
+  if ( (tooth.syncStatus!=SyncStatus::None)
+    && !IsCranking(currentStatus)
+    && (tooth.revolutionTime!=0UL)
+    && SetRevolutionTime(tooth.revolutionTime >> (isCamTeeth ? 1U : 0U)) ) {
+    return getAngleConverterRpm();
+  }
+
+  return currentStatus.RPM;
+}
+
+/** @brief As crankingGetRPM(), but using a tooth event rather than the live decoder variables */
+static inline uint16_t crankingGetRPM(const tooth_event_t &tooth, byte totalTeeth, bool isCamTeeth)
+{
+  if ( (currentStatus.startRevolutions >= configPage4.StgCycles)
+    && (tooth.syncStatus!=SyncStatus::None)
+    && (tooth.toothGap!=0UL)
+    && SetRevolutionTime((tooth.toothGap * totalTeeth) >> (isCamTeeth ? 1U : 0U)) ) {
+    return getAngleConverterRpm();
+  }
+
+  return currentStatus.RPM;
+}
+/** @} */
+
+/** @brief Minimum number of (evenly spaced) teeth per revolution for the acceleration model to be useful */
+static constexpr uint8_t MIN_TEETH_FOR_2ND_DERIV = 12U;
+
+/**
+ * @brief Feed the crank acceleration model (see setAngleConverterToothTime()) with the current tooth gap.
+ *
+ * Call on every primary tooth.
+ *
+ * @param gap Time since the previous tooth in µS
+ * @param isRegularGap true if the gap spans triggerToothAngle; false otherwise (E.g. the missing tooth)
+ */
+static inline void updateCrankAcceleration(uint32_t gap, bool isRegularGap) {
+  if (decoderFeatures.supports2ndDeriv) {
+    setAngleConverterToothTime(gap, isRegularGap);
+  }
+}
+
+/**
+ * @brief Set up the crank acceleration model for the decoder. 
+ * 
+ * Call from the decoder setup, once triggerToothAngle & decoderFeatures.supports2ndDeriv are set.
+ */
+static inline void setupCrankAcceleration(void) {
+  setAngleConverterToothAngle(decoderFeatures.supports2ndDeriv ? triggerToothAngle : 0U);
+}
+
+/** @brief Whether either per tooth timing option is enabled, I.e. whether the decoder should call checkPerToothTiming() */
+static inline bool isPerToothTimingEnabled(void)
+{
+  return (configPage2.perToothIgn == true) || (configPage2.perToothFuel == true);
+}
+
+/**
+Fuel equivalent of the ignition per tooth timing below. There are no per-decoder fuel end teeth, so instead each
+pending injector open event is re-anchored on the last tooth before it opens. I.e. when the open angle is less than
+one tooth gap ahead of the current crank angle.
+
+The supplied crank angle is in the ignition domain, so this is only possible if that covers the full injection cycle.
+E.g. sequential fuel with wasted spark cannot tell which revolution the tooth is in.
+*/
+static inline void checkPerToothFuelTiming(int16_t crankAngle)
+{
+  if (CRANK_ANGLE_MAX_INJ <= CRANK_ANGLE_MAX_IGN)
+  {
+    while (crankAngle >= CRANK_ANGLE_MAX_INJ) { crankAngle = crankAngle - CRANK_ANGLE_MAX_INJ; }
+    while (crankAngle < 0) { crankAngle = crankAngle + CRANK_ANGLE_MAX_INJ; }
+    int16_t toothAngle = (int16_t)triggerToothAngle;
+
+#define ADJUST_FUEL_CHANNEL(channel) \
+    { \
+      int16_t delta = (int16_t)fuelSchedule ##channel.openAngle - crankAngle; \
+      if (delta < 0) { delta = delta + CRANK_ANGLE_MAX_INJ; } \
+      if ( (delta > 0) && (delta <= toothAngle) ) \
+      { \
+        adjustCrankAngle(currentStatus, fuelSchedule ##channel, (int16_t)fuelSchedule ##channel.openAngle - delta); \
+      } \
+    }
+
+    ADJUST_FUEL_CHANNEL(1)
+#if INJ_CHANNELS >= 2
+    ADJUST_FUEL_CHANNEL(2)
+#endif
+#if INJ_CHANNELS >= 3
+    ADJUST_FUEL_CHANNEL(3)
+#endif
+#if INJ_CHANNELS >= 4
+    ADJUST_FUEL_CHANNEL(4)
+#endif
+#if INJ_CHANNELS >= 5
+    ADJUST_FUEL_CHANNEL(5)
+#endif
+#if INJ_CHANNELS >= 6
+    ADJUST_FUEL_CHANNEL(6)
+#endif
+#if INJ_CHANNELS >= 7
+    ADJUST_FUEL_CHANNEL(7)
+#endif
+#if INJ_CHANNELS >= 8
+    ADJUST_FUEL_CHANNEL(8)
+#endif
+
+#undef ADJUST_FUEL_CHANNEL
+  }
+}
+
+/**
+On decoders that are enabled for per tooth based timing adjustments, this function performs the timer compare changes on the schedules themselves
+For each ignition channel, a check is made whether we're at the relevant tooth and whether that ignition schedule is currently running
+Only if both these conditions are met will the schedule be updated with the latest timing information.
+If it's the correct tooth, but the schedule is not yet started, calculate and an end compare value (This situation occurs when both the start and end of the ignition pulse happen after the end tooth, but before the next tooth)
+*/
+static inline void checkPerToothTiming(int16_t crankAngle, uint16_t currentTooth)
+{
+  if ( (fixedCrankingOverride == 0) && (currentStatus.RPM > 0) )
+  {
+    if (configPage2.perToothIgn == true)
+    {
+      if ( (currentTooth == ignitionEndTeeth[0]) )
+      {
+        adjustCrankAngle(currentStatus, ignitionSchedule1, crankAngle);
+      }
+#if IGN_CHANNELS >= 2
+      else if ( (currentTooth == ignitionEndTeeth[1]) )
+      {
+        adjustCrankAngle(currentStatus, ignitionSchedule2, crankAngle);
+      }
+#endif
+#if IGN_CHANNELS >= 3
+      else if ( (currentTooth == ignitionEndTeeth[2]) )
+      {
+        adjustCrankAngle(currentStatus, ignitionSchedule3, crankAngle);
+      }
+#endif
+#if IGN_CHANNELS >= 4
+      else if ( (currentTooth == ignitionEndTeeth[3]) )
+      {
+        adjustCrankAngle(currentStatus, ignitionSchedule4, crankAngle);
+      }
+#endif
+#if IGN_CHANNELS >= 5
+      else if ( (currentTooth == ignitionEndTeeth[4]) )
+      {
+        adjustCrankAngle(currentStatus, ignitionSchedule5, crankAngle);
+      }
+#endif
+#if IGN_CHANNELS >= 6
+      else if ( (currentTooth == ignitionEndTeeth[5]) )
+      {
+        adjustCrankAngle(currentStatus, ignitionSchedule6, crankAngle);
+      }
+#endif
+#if IGN_CHANNELS >= 7
+      else if ( (currentTooth == ignitionEndTeeth[6]) )
+      {
+        adjustCrankAngle(currentStatus, ignitionSchedule7, crankAngle);
+      }
+#endif
+#if IGN_CHANNELS >= 8
+      else if ( (currentTooth == ignitionEndTeeth[7]) )
+      {
+        adjustCrankAngle(currentStatus, ignitionSchedule8, crankAngle);
+      }
+#endif
+    }
+
+    if (configPage2.perToothFuel == true) { checkPerToothFuelTiming(crankAngle); }
+  }
+}
+
+/** @name Missing tooth routines reused by other decoders
+ * Defined in missing_tooth.cpp
+ * @{
+ */
+void triggerPri_missingTooth(void);
+void triggerSec_missingTooth(void);
+uint16_t getRPM_missingTooth(void);
+int16_t getCrankAngle_missingTooth(uint32_t currMicros);
+
+static inline uint16_t clampToToothCount(int16_t toothNum, uint8_t toothAdder) {
+  int16_t toothRange = (int16_t)configPage4.triggerTeeth + (int16_t)toothAdder;
+  return (uint16_t)nudge(1, toothRange, toothNum, toothRange);
+}
+
+static inline uint16_t clampToActualTeeth(uint16_t toothNum, uint8_t toothAdder) {
+  if(toothNum > triggerActualTeeth && toothNum <= configPage4.triggerTeeth) { toothNum = triggerActualTeeth; }
+  return (std::min)(toothNum, (uint16_t)(triggerActualTeeth + toothAdder));
+}
+/** @} */
+
+/** @name Dual wheel routines reused by other decoders
+ * Defined in dual_wheel.cpp
+ * @{
+ */
+void triggerPri_DualWheel(void);
+void triggerSec_DualWheel(void);
+uint16_t getRPM_DualWheel(void);
+int16_t getCrankAngle_DualWheel(uint32_t currMicros);
+void triggerSetEndTeeth_DualWheel(void);
+/** @} */
@@ -0,0 +1,60 @@
+#include "decoder_shared.h"
+
+/** Suzuki DRZ400 - a single cam tooth for sync, with the dual wheel decoder on the crank.
+* @defgroup dec_drz400 Suzuki DRZ400
+* @{
+*/
+static void triggerSec_DRZ400(void)
+{
+  uint32_t curTime2 = micros();
+  curGap2 = curTime2 - toothLastSecToothTime;
+  if ( curGap2 >= triggerSecFilterTime )
+  {
+    toothLastSecToothTime = curTime2;
+
+    if(decoderStatus.syncStatus!=SyncStatus::Full)
+    {
+      toothLastToothTime = micros();
+      toothLastMinusOneToothTime = micros() - ((MICROS_PER_MIN/10U) / configPage4.triggerTeeth); //Fixes RPM at 10rpm until a full revolution has taken place
+      toothCurrentCount = configPage4.triggerTeeth;
+      currentStatus.syncLossCounter++;
+      decoderStatus.syncStatus = SyncStatus::Full;
+    }
+    else 
+    {
+      // have rotation, set tooth to six so next tooth is 1 & duel wheel rotation code kicks in 
+      toothCurrentCount = 6;
+    }
+  }
+
+  triggerSecFilterTime = (toothOneTime - toothOneMinusOneTime) >> 1; //Set filter at 50% of the current crank speed. 
+}
+
+decoder_t  __attribute__((optimize("Os"))) triggerSetup_DRZ400(void)
+{
+  decoderFeatures = decoder_features_t();
+	sharedDecoderReset();
+  triggerToothAngle = 360 / configPage4.triggerTeeth; //The number of degrees that passes from tooth to tooth
+  if(configPage4.TrigSpeed == 1) { triggerToothAngle = 720 / configPage4.triggerTeeth; } //Account for cam speed
+  toothCurrentCount = UINT8_MAX; //Default value
+  triggerFilterTime = (MICROS_PER_SEC / (MAX_RPM / 60U * configPage4.triggerTeeth)); //Trigger filter time is the shortest possible time (in uS) that there can be between crank teeth (ie at max RPM). Any pulses that occur faster than this time will be discarded as noise
+  triggerSecFilterTime = (MICROS_PER_SEC / (MAX_RPM / 60U * 2U)); //Same as above, but fixed at 2 teeth on the secondary input
+  decoderFeatures.supportsSequential = true;
+  decoderStatus.toothAngleIsCorrect = true; //This is always true for this pattern
+  decoderFeatures.supportsPerToothIgnition = true;  
+  MAX_STALL_TIME = ((MICROS_PER_DEG_1_RPM/50U) * triggerToothAngle); //Minimum 50rpm. (3333uS is the time per degree at 50rpm)
+
+  return decoder_builder_t()
+                  .setPrimaryTrigger(triggerPri_DualWheel, getConfigPriTriggerEdge(configPage4))
+                  .setSecondaryTrigger(triggerSec_DRZ400, getConfigSecTriggerEdge(configPage4))
+                  .setGetRPM(getRPM_DualWheel)
+                  .setGetCrankAngle(getCrankAngle_DualWheel)
+                  .setSetEndTeeth(triggerSetEndTeeth_DualWheel)
+                  .setReset(sharedDecoderReset)
+                  .setIsEngineRunning(sharedEngineIsRunning)
+                  .setGetStatus(sharedGetStatus)
+                  .setGetFeatures(sharedGetDecoderFeatures)
+                  .build();
+}
+
+/** @} */
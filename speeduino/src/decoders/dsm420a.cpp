@@ -0,0 +1,191 @@
+#include "decoder_shared.h"
+
+/** DSM 420a, For the DSM Eclipse with 16 teeth total on the crank.
+* Tracks the falling side of the signal.
+* Sync is determined by watching for a falling edge on the secondary signal and checking if the primary signal is high then.
+* https://github.com/noisymime/speeduino/issues/133
+* @defgroup dec_dsm_420a DSM 420a, For the DSM Eclipse
+* @{
+*/
+static void triggerPri_420a(void)
+{
+  uint32_t curTime = micros();
+  curGap = curTime - toothLastToothTime;
+  if ( curGap >= triggerFilterTime ) //Pulses should never be less than triggerFilterTime, so if they are it means a false trigger. (A 36-1 wheel at 8000pm will have triggers approx. every 200uS)
+  {
+    toothCurrentCount++; //Increment the tooth counter
+    decoderStatus.validTrigger = true; //Flag this pulse as being a valid trigger (ie that it passed filters)
+
+    if( (toothLastToothTime == 0) || (toothLastMinusOneToothTime == 0) ) { curGap = 0; }
+
+    if( (toothCurrentCount > 16) && (decoderStatus.syncStatus==SyncStatus::Full) )
+    {
+      //Means a complete rotation has occurred.
+      toothCurrentCount = 1;
+      toothOneMinusOneTime = toothOneTime;
+      toothOneTime = curTime;
+      currentStatus.startRevolutions++; //Counter
+    }
+
+    //Filter can only be recalculated for the regular teeth, not the missing one.
+    //setFilter(curGap);
+    triggerFilterTime = 0;
+
+    decoderStatus.toothAngleIsCorrect = false;
+
+    toothLastMinusOneToothTime = toothLastToothTime;
+    toothLastToothTime = curTime;
+
+    //EXPERIMENTAL!
+    if(isPerToothTimingEnabled())
+    {
+      int16_t crankAngle = ( toothAngles[(toothCurrentCount-1)] ) + configPage4.triggerAngle;
+      checkPerToothTiming(crankAngle, toothCurrentCount);
+    }
+  }
+}
+
+static void triggerSec_420a(void)
+{
+  //Secondary trigger is only on falling edge
+
+  if(currentStatus.decoder.primary.isPinHigh())
+  {
+    //Secondary signal is falling and primary signal is HIGH
+    if( decoderStatus.syncStatus!=SyncStatus::Full )
+    {
+      //If we don't have sync, then assume the signal is good
+      toothCurrentCount = 13;
+      decoderStatus.syncStatus = SyncStatus::Full;
+    }
+    else
+    {
+      //If we DO have sync, then check that the tooth count matches what we expect
+      if(toothCurrentCount != 13)
+      {
+        currentStatus.syncLossCounter++;
+        toothCurrentCount = 13;
+      }
+    }
+
+  }
+  else
+  {
+    //Secondary signal is falling and primary signal is LOW
+    if( decoderStatus.syncStatus!=SyncStatus::Full )
+    {
+      //If we don't have sync, then assume the signal is good
+      toothCurrentCount = 5;
+      decoderStatus.syncStatus = SyncStatus::Full;
+    }
+    else
+    {
+      //If we DO have sync, then check that the tooth count matches what we expect
+      if(toothCurrentCount != 5)
+      {
+        currentStatus.syncLossCounter++;
+        toothCurrentCount = 5;
+      }
+    }
+  }
+}
+
+static uint16_t getRPM_420a(void)
+{
+  uint16_t tempRPM = 0;
+  if( currentStatus.RPM < currentStatus.crankRPM)
+  {
+    //Possibly look at doing special handling for cranking in the future, but for now just use the standard method
+    tempRPM = stdGetRPM(CAM_SPEED);
+  }
+  else
+  {
+    tempRPM = stdGetRPM(CAM_SPEED);
+  }
+  return tempRPM;
+}
+
+static int16_t getCrankAngle_420a(uint32_t currMicros)
+{
+  //This is the current angle ATDC the engine is at. This is the last known position based on what tooth was last 'seen'. It is only accurate to the resolution of the trigger wheel (Eg 36-1 is 10 degrees)
+  unsigned long tempToothLastToothTime;
+  int tempToothCurrentCount;
+  //Grab some variables that are used in the trigger code and assign them to temp variables.
+  noInterrupts();
+  tempToothCurrentCount = toothCurrentCount;
+  tempToothLastToothTime = toothLastToothTime;
+  interrupts();
+
+  int crankAngle;
+  crankAngle = toothAngles[(tempToothCurrentCount - 1)] + configPage4.triggerAngle; //Perform a lookup of the fixed toothAngles array to find what the angle of the last tooth passed was.
+
+  //Estimate the number of degrees travelled since the last tooth}
+  crankAngle += timeToAngle(currMicros - tempToothLastToothTime);
+
+  if (crankAngle >= 720) { crankAngle -= 720; }
+  if (crankAngle < 0) { crankAngle += 360; }
+
+  return crankAngle;
+}
+
+static void triggerSetEndTeeth_420a(void)
+{
+  if(currentStatus.advance < 9)
+  {
+    ignitionEndTeeth[0] = 1;
+    ignitionEndTeeth[1] = 5;
+    ignitionEndTeeth[2] = 9;
+    ignitionEndTeeth[3] = 13;  
+  }
+  else
+  {
+    ignitionEndTeeth[0] = 16;
+    ignitionEndTeeth[1] = 4;
+    ignitionEndTeeth[2] = 8;
+    ignitionEndTeeth[3] = 12;  
+  }
+}
+
+decoder_t  __attribute__((optimize("Os"))) triggerSetup_420a(void)
+{
+  decoderFeatures = decoder_features_t();
+	sharedDecoderReset();
+  triggerFilterTime = (MICROS_PER_SEC / (MAX_RPM / 60U * 360UL)); //Trigger filter time is the shortest possible time (in uS) that there can be between crank teeth (ie at max RPM). Any pulses that occur faster than this time will be discarded as noise
+  triggerSecFilterTime = 0;
+  decoderFeatures.supportsSequential = true;
+  decoderFeatures.supportsPerToothIgnition = true;
+  toothCurrentCount = 1;
+  triggerToothAngle = 20; //Is only correct for the 4 short pulses before each TDC
+  decoderStatus.toothAngleIsCorrect = false;
+  MAX_STALL_TIME = ((MICROS_PER_DEG_1_RPM/50U) * 93U); //Minimum 50rpm. (3333uS is the time per degree at 50rpm)
+
+  toothAngles[0] = 711; //tooth #1, just before #1 TDC
+  toothAngles[1] = 111;
+  toothAngles[2] = 131;
+  toothAngles[3] = 151;
+  toothAngles[4] = 171; //Just before #3 TDC
+  toothAngles[5] = toothAngles[1] + 180;
+  toothAngles[6] = toothAngles[2] + 180;
+  toothAngles[7] = toothAngles[3] + 180;
+  toothAngles[8] = toothAngles[4] + 180; //Just before #4 TDC
+  toothAngles[9]  = toothAngles[1] + 360;
+  toothAngles[10] = toothAngles[2] + 360;
+  toothAngles[11] = toothAngles[3] + 360;
+  toothAngles[12] = toothAngles[4] + 360; //Just before #2 TDC
+  toothAngles[13] = toothAngles[1] + 540;
+  toothAngles[14] = toothAngles[2] + 540;
+  toothAngles[15] = toothAngles[3] + 540;
+
+  return decoder_builder_t()
+                  .setPrimaryTrigger(triggerPri_420a, getConfigPriTriggerEdge(configPage4))
+                  .setSecondaryTrigger(triggerSec_420a, FALLING) //Always falling edge
+                  .setGetRPM(getRPM_420a)
+                  .setGetCrankAngle(getCrankAngle_420a)
+                  .setSetEndTeeth(triggerSetEndTeeth_420a)
+                  .setReset(sharedDecoderReset)
+                  .setIsEngineRunning(sharedEngineIsRunning)
+                  .setGetStatus(sharedGetStatus)
+                  .setGetFeatures(sharedGetDecoderFeatures)
+                  .build();
+}
+/** @} */
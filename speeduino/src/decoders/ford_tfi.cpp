@@ -0,0 +1,288 @@
+#include "decoder_shared.h"
+
+/** Ford TFI - Distributor mounted signal tooth wheel. Same number of teeth as cylinders.
+Evenly spaced rising edge triggers, Cylinder 1 has a narrow teeth and will have a signature falling edge
+
+* @defgroup Ford_TFI Ford TFI
+* @{
+*/
+static volatile unsigned long targetGap3;
+static volatile unsigned long lastSyncRevolution = 0; // the revolution value of last valid sync
+
+/** Ford TFI Primary (Rising Edge).
+ * 
+ * */
+static void triggerPri_FordTFI(void)
+{
+  uint32_t curTime = micros(); // Get current time and gap duration with micros rollover
+  if (curTime >= toothLastToothTime) 
+    { curGap = curTime - toothLastToothTime; } 
+  else
+    { curGap = (4294967296 - toothLastToothTime + curTime); }
+ 
+  if ( curGap >= triggerFilterTime )
+  {
+    if(decoderStatus.syncStatus==SyncStatus::Full) { setFilter(curGap); } //Recalc the new filter value
+    else { triggerFilterTime = 0; } //If we don't yet have sync, ensure that the filter won't prevent future valid pulses from being ignored
+    
+    toothCurrentCount++; //Increment the tooth counter
+    
+    if(toothCurrentCount > triggerActualTeeth)//Check if we're back to the beginning of a revolution
+    {
+      if ( (decoderStatus.syncStatus==SyncStatus::Full)  && ( (lastSyncRevolution) + 3  < currentStatus.startRevolutions)) // Revolution count when signature tooth was detected, Allow up to 4 cam revolution without sync signal detected
+      {
+        decoderStatus.syncStatus = SyncStatus::None;
+        currentStatus.syncLossCounter++;
+      }
+      toothCurrentCount = 1; //Reset the counter
+      toothOneMinusOneTime = toothOneTime;
+      toothOneTime = curTime;
+      currentStatus.startRevolutions++; //Counter
+    }
+
+    decoderStatus.validTrigger = true; //Flag this pulse as being a valid trigger (ie that it passed filters)
+
+    if(isPerToothTimingEnabled())
+    {
+      int16_t crankAngle = ( (toothCurrentCount-1) * triggerToothAngle ) + configPage4.triggerAngle;
+      uint16_t currentTooth = toothCurrentCount;
+      if(toothCurrentCount > (triggerActualTeeth/2) ) { currentTooth = (toothCurrentCount - (triggerActualTeeth/2)); }
+      checkPerToothTiming(crankAngle, currentTooth);
+    }
+        
+    toothLastMinusOneToothTime = toothLastToothTime;
+    toothLastToothTime = curTime;
+
+   } //Trigger filter
+}
+
+/** Ford TFI Secondary (Falling Edge).
+ * 
+ * */
+static void triggerSec_FordTFI(void)
+{
+  uint32_t curTime2 = micros();
+  if (curTime2 >= toothLastSecToothTime) 
+    { curGap2 = curTime2 - toothLastSecToothTime; } 
+  else
+    { curGap2 = (4294967296 - toothLastSecToothTime + curTime2); }
+  
+ 
+  //Safety check for initial startup
+  if( (toothLastSecToothTime == 0) )
+  { 
+    curGap2 = 0; 
+    toothLastSecToothTime = curTime2;
+  }
+  
+
+  if ( curGap2 >= triggerSecFilterTime ) // Valid tooth falling edge
+  {     
+    if ((curGap > 0) && (curGap < 20000000)) // Limit to prevent overflow
+    {  
+      targetGap2 = percentage(110, curGap); // Wide last teeth gap min
+      targetGap3 = percentage(90, curGap); // Narrow last teeth minus one gap max
+    }
+    else 
+    {
+    targetGap2 = 0;
+    targetGap3 = 0;
+    }
+    if ( (curGap2 > targetGap2) && (curGap3 < targetGap3) && (lastGap < targetGap2) && (lastGap > targetGap3) ) // Signature Tooth detected
+    {
+      if( (decoderStatus.syncStatus!=SyncStatus::Full) || (currentStatus.startRevolutions <= configPage4.StgCycles) )
+      {
+        toothCurrentCount = 2; // Last primary tooth was #2
+        triggerFilterTime = 0; //Need to turn the filter off here otherwise the first primary tooth after achieving sync is ignored
+        decoderStatus.syncStatus = SyncStatus::Full;
+      }
+      else 
+      {
+        if ( (toothCurrentCount != 2) && (currentStatus.startRevolutions > 2)) 
+        { 
+          currentStatus.syncLossCounter++;
+        } //Indicates likely sync loss.
+        if (configPage4.useResync == 1) 
+        { 
+          toothCurrentCount = 2;
+          decoderStatus.syncStatus = SyncStatus::Full;  
+        }
+      }
+      lastSyncRevolution = currentStatus.startRevolutions ; // Revolution count when signature tooth was detected
+
+    }
+
+  toothLastSecToothTime = curTime2; // 
+  lastGap = curGap3; // Minus two Gap
+  curGap3 = curGap2; // Minus one Gap
+
+  } //Trigger filter
+  //else { currentStatus.syncLossCounter = 0; }
+  triggerSecFilterTime = curGap >> 1; //Set filter at 50 % speed of last primary gap
+}
+
+/** Ford TFI - Get RPM.
+ * 
+ * */
+static uint16_t getRPM_FordTFI(void)
+{
+  uint16_t tempRPM;
+  uint8_t distributorSpeed = CAM_SPEED; //Default to cam speed
+  
+  if( currentStatus.RPM < currentStatus.crankRPM || currentStatus.RPM < 1500)
+  { 
+    tempRPM = crankingGetRPM(triggerActualTeeth, distributorSpeed);
+  } 
+  else { tempRPM = stdGetRPM(distributorSpeed); }
+
+  MAX_STALL_TIME = currentStatus.revolutionTime << 1; //Set the stall time to be twice the current RPM. This is a safe figure as there should be no single revolution where this changes more than this
+  if(MAX_STALL_TIME < 366667UL) { MAX_STALL_TIME = 366667UL; } //Check for 50rpm minimum
+
+  return tempRPM;
+  
+}
+
+/** Ford TFI - Get Crank angle.
+ * 
+ * */
+static int16_t getCrankAngle_FordTFI(uint32_t currMicros)
+{
+    //This is the current angle ATDC the engine is at. This is the last known position based on what tooth was last 'seen'. It is only accurate to the resolution of the trigger wheel (Eg 36-1 is 10 degrees)
+    unsigned long tempToothLastToothTime;
+    int tempToothCurrentCount;
+    //Grab some variables that are used in the trigger code and assign them to temp variables.
+    noInterrupts();
+    tempToothCurrentCount = toothCurrentCount;
+    tempToothLastToothTime = toothLastToothTime;
+    interrupts();
+
+    //Handle case where the secondary tooth was the last one seen
+    if(tempToothCurrentCount == 0) { tempToothCurrentCount = 2; } 
+
+    int crankAngle = ((tempToothCurrentCount - 1) * triggerToothAngle) + configPage4.triggerAngle; //Number of teeth that have passed since tooth 1, multiplied by the angle each tooth represents, plus the angle that tooth 1 is ATDC. This gives accuracy only to the nearest tooth.
+
+    uint32_t elapsedTime = 0;
+    if (currMicros >= tempToothLastToothTime) 
+      { elapsedTime = (currMicros - tempToothLastToothTime); } 
+    else
+      { elapsedTime = (4294967296 - tempToothLastToothTime + currMicros); } 
+    crankAngle += timeToAngle(elapsedTime);
+
+    if (crankAngle >= 720) { crankAngle -= 720; }
+    if (crankAngle < 0) { crankAngle += CRANK_ANGLE_MAX; }
+
+    return crankAngle;
+
+}
+/** Ford TFI - Set End Teeth.
+ * 
+ * */
+static void triggerSetEndTeeth_FordTFI(void)
+{
+  int tempEndAngle = (ignitionSchedule1.dischargeAngle - configPage4.triggerAngle);
+  tempEndAngle = ignitionLimits((tempEndAngle));
+
+  switch(configPage2.nCylinders)
+  {
+    case 4:
+      if( (tempEndAngle > 180) || (tempEndAngle <= 0) )
+      {
+        ignitionEndTeeth[0] = 2;
+        ignitionEndTeeth[1] = 1;
+      }
+      else
+      {
+        ignitionEndTeeth[0] = 1;
+        ignitionEndTeeth[1] = 2;
+      }
+      break;
+    case 6:
+      if( (tempEndAngle > 120) && (tempEndAngle <= 240) )
+      {
+        ignitionEndTeeth[0] = 2;
+        ignitionEndTeeth[1] = 3;
+        ignitionEndTeeth[2] = 1;
+      }
+      else if( (tempEndAngle > 240) || (tempEndAngle <= 0) )
+      {
+        ignitionEndTeeth[0] = 3;
+        ignitionEndTeeth[1] = 1;
+        ignitionEndTeeth[2] = 2;
+      }
+      else
+      {
+        ignitionEndTeeth[0] = 1;
+        ignitionEndTeeth[1] = 2;
+        ignitionEndTeeth[2] = 3;
+      }
+      break;
+    case 8:
+      if( (tempEndAngle > 90) && (tempEndAngle <= 180) )
+      {
+        ignitionEndTeeth[0] = 2;
+        ignitionEndTeeth[1] = 3;
+        ignitionEndTeeth[2] = 4;
+        ignitionEndTeeth[3] = 1;
+      }
+      else if( (tempEndAngle > 180) && (tempEndAngle <= 270) )
+      {
+        ignitionEndTeeth[0] = 3;
+        ignitionEndTeeth[1] = 4;
+        ignitionEndTeeth[2] = 1;
+        ignitionEndTeeth[3] = 2;
+      }
+      else if( (tempEndAngle > 270) || (tempEndAngle <= 0) )
+      {
+        ignitionEndTeeth[0] = 4;
+        ignitionEndTeeth[1] = 1;
+        ignitionEndTeeth[2] = 2;
+        ignitionEndTeeth[3] = 3;
+      }
+      else
+      {
+        ignitionEndTeeth[0] = 1;
+        ignitionEndTeeth[1] = 2;
+        ignitionEndTeeth[2] = 3;
+        ignitionEndTeeth[3] = 4;
+      }
+      break;
+  }
+}
+
+/** Ford TFI Setup.
+ * 
+ * */
+decoder_t  __attribute__((optimize("Os"))) triggerSetup_FordTFI(void)
+{
+  decoderFeatures = decoder_features_t();
+	sharedDecoderReset();
+  triggerActualTeeth = configPage2.nCylinders;
+  if(triggerActualTeeth == 0) { triggerActualTeeth = 1; }
+
+  triggerToothAngle = 720U / triggerActualTeeth; //The number of degrees that passes from tooth to tooth, half cylinder count
+  toothCurrentCount = 0; //Default value
+  triggerFilterTime = (MICROS_PER_SEC / (MAX_RPM / 30U * configPage2.nCylinders)); //Trigger filter time is the shortest possible time (in uS) that there can be between crank teeth (ie at max RPM). Any pulses that occur faster than this time will be discarded as noise
+  triggerSecFilterTime = triggerFilterTime * 4U /5u; //Same as above, but slightly about lower due to signature trigger (about 80%)
+  lastSyncRevolution = 0;
+  decoderFeatures.supportsSequential = true;
+  decoderStatus.toothAngleIsCorrect = true; //This is always true for this pattern
+  decoderFeatures.supportsPerToothIgnition = true;
+  if(configPage2.nCylinders <= 4U) { MAX_STALL_TIME = ((MICROS_PER_DEG_1_RPM/90U) * triggerToothAngle); }//Minimum 90rpm. (1851uS is the time per degree at 90rpm). This uses 90rpm rather than 50rpm due to the potentially very high stall time on a 4 cylinder if we wait that long.
+  else { MAX_STALL_TIME = ((MICROS_PER_DEG_1_RPM/50U) * triggerToothAngle); } //Minimum 50rpm. (3200uS is the time per degree at 50rpm).
+#ifdef USE_LIBDIVIDE
+  divTriggerToothAngle = libdivide::libdivide_s16_gen(triggerToothAngle);
+#endif
+
+  return decoder_builder_t()
+                  .setPrimaryTrigger(triggerPri_FordTFI, getConfigPriTriggerEdge(configPage4))
+                  .setSecondaryTrigger(triggerSec_FordTFI, getConfigSecTriggerEdge(configPage4))
+                  .setGetRPM(getRPM_FordTFI)
+                  .setGetCrankAngle(getCrankAngle_FordTFI)
+                  .setSetEndTeeth(triggerSetEndTeeth_FordTFI)
+                  .setReset(sharedDecoderReset)
+                  .setIsEngineRunning(sharedEngineIsRunning)
+                  .setGetStatus(sharedGetStatus)
+                  .setGetFeatures(sharedGetDecoderFeatures)
+                  .build();
+}
+/** @} */
@@ -0,0 +1,128 @@
+#include "decoder_shared.h"
+
+/** GM 24X Decoder (eg early LS1 1996-2005).
+Note: Useful references:
+* 
+- www.vems.hu/wiki/index.php?page=MembersPage%2FJorgenKarlsson%2FTwentyFourX
+
+Provided that the cam signal is used, this decoder simply counts the teeth and then looks their angles up against a lookup table. The cam signal is used to determine tooth #1
+* @defgroup dec_gm GM 24X
+* @{
+*/
+static void triggerPri_24X(void)
+{
+  if(toothCurrentCount == 25) { decoderStatus.syncStatus = SyncStatus::None; } //Indicates sync has not been achieved (Still waiting for 1 revolution of the crank to take place)
+  else
+  {
+    uint32_t curTime = micros();
+    curGap = curTime - toothLastToothTime;
+
+    if(toothCurrentCount == 0)
+    {
+       toothCurrentCount = 1; //Reset the counter
+       toothOneMinusOneTime = toothOneTime;
+       toothOneTime = curTime;
+       revolutionOne = !revolutionOne; //Sequential revolution flip
+       decoderStatus.syncStatus = SyncStatus::Full;
+       currentStatus.startRevolutions++; //Counter
+       triggerToothAngle = 15; //Always 15 degrees for tooth #15
+    }
+    else
+    {
+      toothCurrentCount++; //Increment the tooth counter
+      triggerToothAngle = toothAngles[(toothCurrentCount-1)] - toothAngles[(toothCurrentCount-2)]; //Calculate the last tooth gap in degrees
+    }
+
+    decoderStatus.validTrigger = true; //Flag this pulse as being a valid trigger (ie that it passed filters)
+
+    toothLastToothTime = curTime;
+  }
+}
+
+static void triggerSec_24X(void)
+{
+  toothCurrentCount = 0; //All we need to do is reset the tooth count back to zero, indicating that we're at the beginning of a new revolution
+  revolutionOne = 1; //Sequential revolution reset
+}
+
+static uint16_t getRPM_24X(void)
+{
+   return stdGetRPM(CRANK_SPEED);
+}
+
+static int16_t getCrankAngle_24X(uint32_t currMicros)
+{
+    //This is the current angle ATDC the engine is at. This is the last known position based on what tooth was last 'seen'. It is only accurate to the resolution of the trigger wheel (Eg 36-1 is 10 degrees)
+    unsigned long tempToothLastToothTime;
+    int tempToothCurrentCount, tempRevolutionOne;
+    //Grab some variables that are used in the trigger code and assign them to temp variables.
+    noInterrupts();
+    tempToothCurrentCount = toothCurrentCount;
+    tempToothLastToothTime = toothLastToothTime;
+    tempRevolutionOne = revolutionOne;
+    interrupts();
+
+    int crankAngle;
+    if (tempToothCurrentCount == 0) { crankAngle = 0 + configPage4.triggerAngle; } //This is the special case to handle when the 'last tooth' seen was the cam tooth. 0 is the angle at which the crank tooth goes high (Within 360 degrees).
+    else { crankAngle = toothAngles[(tempToothCurrentCount - 1)] + configPage4.triggerAngle;} //Perform a lookup of the fixed toothAngles array to find what the angle of the last tooth passed was.
+
+    //Estimate the number of degrees travelled since the last tooth}
+    crankAngle += timeToAngle(currMicros - tempToothLastToothTime);
+
+    //Sequential check (simply sets whether we're on the first or 2nd revolution of the cycle)
+    if (tempRevolutionOne == 1) { crankAngle += 360; }
+
+    if (crankAngle >= 720) { crankAngle -= 720; }
+    if (crankAngle < 0) { crankAngle += 360; }
+
+    return crankAngle;
+}
+
+decoder_t  __attribute__((optimize("Os"))) triggerSetup_24X(void)
+{
+  decoderFeatures = decoder_features_t();
+	sharedDecoderReset();
+  triggerToothAngle = 15; //The number of degrees that passes from tooth to tooth (primary)
+  toothAngles[0] = 12;
+  toothAngles[1] = 18;
+  toothAngles[2] = 33;
+  toothAngles[3] = 48;
+  toothAngles[4] = 63;
+  toothAngles[5] = 78;
+  toothAngles[6] = 102;
+  toothAngles[7] = 108;
+  toothAngles[8] = 123;
+  toothAngles[9] = 138;
+  toothAngles[10] = 162;
+  toothAngles[11] = 177;
+  toothAngles[12] = 183;
+  toothAngles[13] = 198;
+  toothAngles[14] = 222;
+  toothAngles[15] = 237;
+  toothAngles[16] = 252;
+  toothAngles[17] = 258;
+  toothAngles[18] = 282;
+  toothAngles[19] = 288;
+  toothAngles[20] = 312;
+  toothAngles[21] = 327;
+  toothAngles[22] = 342;
+  toothAngles[23] = 357;
+
+  MAX_STALL_TIME = ((MICROS_PER_DEG_1_RPM/50U) * triggerToothAngle); //Minimum 50rpm. (3333uS is the time per degree at 50rpm)
+  if(currentStatus.initialisationComplete == false) { toothCurrentCount = 25; toothLastToothTime = micros(); } //Set a startup value here to avoid filter errors when starting. This MUST have the init check to prevent the fuel pump just staying on all the time
+  decoderFeatures.supportsSequential = true;
+  decoderStatus.toothAngleIsCorrect = true;
+
+  return decoder_builder_t()
+                  .setPrimaryTrigger(triggerPri_24X, getConfigPriTriggerEdge(configPage4))
+                  .setSecondaryTrigger(triggerSec_24X, CHANGE)
+                  .setGetRPM(getRPM_24X)
+                  .setGetCrankAngle(getCrankAngle_24X)
+                  .setReset(sharedDecoderReset)
+                  .setIsEngineRunning(sharedEngineIsRunning)
+                  .setGetStatus(sharedGetStatus)
+                  .setGetFeatures(sharedGetDecoderFeatures)
+                  .build();
+}
+
+/** @} */
@@ -0,0 +1,144 @@
+#include "decoder_shared.h"
+
+/** Decode GM 7X trigger wheel with six equally spaced teeth and a seventh tooth for cylinder identification.
+* Note: Within the decoder code pf GM7X, the sync tooth is referred to as tooth #3 rather than tooth #7. This makes for simpler angle calculations
+* (See: http://www.speeduino.com/forum/download/file.php?id=4743 ).
+* @defgroup dec_gm7x GM7X
+* @{
+*/
+static void triggerPri_GM7X(void)
+{
+    lastGap = curGap;
+    uint32_t curTime = micros();
+    curGap = curTime - toothLastToothTime;
+    toothCurrentCount++; //Increment the tooth counter
+    decoderStatus.validTrigger = true; //Flag this pulse as being a valid trigger (ie that it passed filters)
+
+    if( (toothLastToothTime > 0) && (toothLastMinusOneToothTime > 0) )
+    {
+      if( toothCurrentCount > 7 )
+      {
+        toothCurrentCount = 1;
+        toothOneMinusOneTime = toothOneTime;
+        toothOneTime = curTime;
+
+        decoderStatus.toothAngleIsCorrect = true;
+      }
+      else
+      {
+        targetGap = (lastGap) >> 1; //The target gap is set at half the last tooth gap
+        if ( curGap < targetGap ) //If the gap between this tooth and the last one is less than half of the previous gap, then we are very likely at the magical 3rd tooth
+        {
+          toothCurrentCount = 3;
+          decoderStatus.syncStatus = SyncStatus::Full;
+          decoderStatus.toothAngleIsCorrect = false; //The tooth angle is double at this point
+          currentStatus.startRevolutions++; //Counter
+        }
+        else
+        {
+          decoderStatus.toothAngleIsCorrect = true;
+        }
+      }
+    }
+
+    //New ignition mode!
+    if(isPerToothTimingEnabled())
+    {
+      if(toothCurrentCount != 3) //Never do the check on the extra tooth. It's not needed anyway
+      {
+        //configPage4.triggerAngle must currently be below 48 and above -81
+        int16_t crankAngle;
+        if( toothCurrentCount < 3 )
+        {
+          crankAngle = ((toothCurrentCount - 1) * triggerToothAngle) + 42 + configPage4.triggerAngle; //Number of teeth that have passed since tooth 1, multiplied by the angle each tooth represents, plus the angle that tooth 1 is ATDC. This gives accuracy only to the nearest tooth.
+        }
+        else
+        {
+          crankAngle = ((toothCurrentCount - 2) * triggerToothAngle) + 42 + configPage4.triggerAngle; //Number of teeth that have passed since tooth 1, multiplied by the angle each tooth represents, plus the angle that tooth 1 is ATDC. This gives accuracy only to the nearest tooth.
+        }
+        checkPerToothTiming(crankAngle, toothCurrentCount);
+      } 
+    }
+
+    toothLastMinusOneToothTime = toothLastToothTime;
+    toothLastToothTime = curTime;
+
+
+}
+
+static uint16_t getRPM_GM7X(void)
+{
+   return stdGetRPM(CRANK_SPEED);
+}
+static int16_t getCrankAngle_GM7X(uint32_t currMicros)
+{
+    //This is the current angle ATDC the engine is at. This is the last known position based on what tooth was last 'seen'. It is only accurate to the resolution of the trigger wheel (Eg 36-1 is 10 degrees)
+    unsigned long tempToothLastToothTime;
+    int tempToothCurrentCount;
+    //Grab some variables that are used in the trigger code and assign them to temp variables.
+    noInterrupts();
+    tempToothCurrentCount = toothCurrentCount;
+    tempToothLastToothTime = toothLastToothTime;
+    interrupts();
+
+    //Check if the last tooth seen was the reference tooth (Number 3). All others can be calculated, but tooth 3 has a unique angle
+    int crankAngle;
+    if( tempToothCurrentCount < 3 )
+    {
+      crankAngle = ((tempToothCurrentCount - 1) * triggerToothAngle) + 42 + configPage4.triggerAngle; //Number of teeth that have passed since tooth 1, multiplied by the angle each tooth represents, plus the angle that tooth 1 is ATDC. This gives accuracy only to the nearest tooth.
+    }
+    else if( tempToothCurrentCount == 3 )
+    {
+      crankAngle = 112;
+    }
+    else
+    {
+      crankAngle = ((tempToothCurrentCount - 2) * triggerToothAngle) + 42 + configPage4.triggerAngle; //Number of teeth that have passed since tooth 1, multiplied by the angle each tooth represents, plus the angle that tooth 1 is ATDC. This gives accuracy only to the nearest tooth.
+    }
+
+    //Estimate the number of degrees travelled since the last tooth}
+    crankAngle += timeToAngle(currMicros - tempToothLastToothTime);
+
+    if (crankAngle >= 720) { crankAngle -= 720; }
+    if (crankAngle < 0) { crankAngle += 360; }
+
+    return crankAngle;
+}
+
+static void triggerSetEndTeeth_GM7X(void)
+{
+  if(currentStatus.advance < 18 ) 
+  { 
+    ignitionEndTeeth[0] = 7;
+    ignitionEndTeeth[1] = 2;
+    ignitionEndTeeth[2] = 5;
+  }
+  else 
+  { 
+    ignitionEndTeeth[0] = 6;
+    ignitionEndTeeth[1] = 1;
+    ignitionEndTeeth[2] = 4;
+  }
+}
+
+decoder_t  __attribute__((optimize("Os"))) triggerSetup_GM7X(void)
+{
+  decoderFeatures = decoder_features_t();
+	sharedDecoderReset();
+  triggerToothAngle = 360 / 6; //The number of degrees that passes from tooth to tooth
+  decoderFeatures.supportsPerToothIgnition = true;
+  MAX_STALL_TIME = ((MICROS_PER_DEG_1_RPM/50U) * triggerToothAngle); //Minimum 50rpm. (3333uS is the time per degree at 50rpm)
+
+  return decoder_builder_t()
+                  .setPrimaryTrigger(triggerPri_GM7X, getConfigPriTriggerEdge(configPage4))
+                  .setGetRPM(getRPM_GM7X)
+                  .setGetCrankAngle(getCrankAngle_GM7X)
+                  .setSetEndTeeth(triggerSetEndTeeth_GM7X)
+                  .setReset(sharedDecoderReset)
+                  .setIsEngineRunning(sharedEngineIsRunning)
+                  .setGetStatus(sharedGetStatus)
+                  .setGetFeatures(sharedGetDecoderFeatures)
+                  .build();
+}
+
+/** @} */
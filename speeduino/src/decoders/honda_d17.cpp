@@ -0,0 +1,104 @@
+#include "decoder_shared.h"
+
+/** Honda D17 (1.7 liter 4 cyl SOHC).
+* 
+* @defgroup dec_honda_d17 Honda D17
+* @{
+*/
+static void triggerPri_HondaD17(void)
+{
+   lastGap = curGap;
+   uint32_t curTime = micros();
+   curGap = curTime - toothLastToothTime;
+   toothCurrentCount++; //Increment the tooth counter
+
+   decoderStatus.validTrigger = true; //Flag this pulse as being a valid trigger (ie that it passed filters)
+
+   //
+   if( (toothCurrentCount == 13) && (decoderStatus.syncStatus==SyncStatus::Full) )
+   {
+     toothCurrentCount = 0;
+   }
+   else if( (toothCurrentCount == 1) && (decoderStatus.syncStatus==SyncStatus::Full) )
+   {
+     toothOneMinusOneTime = toothOneTime;
+     toothOneTime = curTime;
+     currentStatus.startRevolutions++; //Counter
+
+     toothLastMinusOneToothTime = toothLastToothTime;
+     toothLastToothTime = curTime;
+   }
+   else
+   {
+     //13th tooth
+     targetGap = (lastGap) >> 1; //The target gap is set at half the last tooth gap
+     if ( curGap < targetGap) //If the gap between this tooth and the last one is less than half of the previous gap, then we are very likely at the magical 13th tooth
+     {
+       toothCurrentCount = 0;
+       decoderStatus.syncStatus = SyncStatus::Full;
+     }
+     else
+     {
+       //The tooth times below don't get set on tooth 13(The magical 13th tooth should not be considered for any calculations that use those times)
+       toothLastMinusOneToothTime = toothLastToothTime;
+       toothLastToothTime = curTime;
+     }
+   }
+
+}
+
+static uint16_t getRPM_HondaD17(void)
+{
+   return stdGetRPM(CRANK_SPEED);
+}
+
+static int16_t getCrankAngle_HondaD17(uint32_t currMicros)
+{
+    //This is the current angle ATDC the engine is at. This is the last known position based on what tooth was last 'seen'. It is only accurate to the resolution of the trigger wheel (Eg 36-1 is 10 degrees)
+    unsigned long tempToothLastToothTime;
+    int tempToothCurrentCount;
+    //Grab some variables that are used in the trigger code and assign them to temp variables.
+    noInterrupts();
+    tempToothCurrentCount = toothCurrentCount;
+    tempToothLastToothTime = toothLastToothTime;
+    interrupts();
+
+    //Check if the last tooth seen was the reference tooth 13 (Number 0 here). All others can be calculated, but tooth 3 has a unique angle
+    int crankAngle;
+    if( tempToothCurrentCount == 0 )
+    {
+      crankAngle = (11 * triggerToothAngle) + configPage4.triggerAngle; //if temptoothCurrentCount is 0, the last tooth seen was the 13th one. Based on this, ignore the 13th tooth and use the 12th one as the last reference.
+    }
+    else
+    {
+      crankAngle = ((tempToothCurrentCount - 1) * triggerToothAngle) + configPage4.triggerAngle; //Number of teeth that have passed since tooth 1, multiplied by the angle each tooth represents, plus the angle that tooth 1 is ATDC. This gives accuracy only to the nearest tooth.
+    }
+
+    //Estimate the number of degrees travelled since the last tooth}
+    crankAngle += timeToAngle(currMicros - tempToothLastToothTime);
+
+    if (crankAngle >= 720) { crankAngle -= 720; }
+    if (crankAngle < 0) { crankAngle += 360; }
+
+    return crankAngle;
+}
+
+decoder_t  __attribute__((optimize("Os"))) triggerSetup_HondaD17(void)
+{
+  decoderFeatures = decoder_features_t();
+	sharedDecoderReset();
+  triggerToothAngle = 360 / 12; //The number of degrees that passes from tooth to tooth
+  MAX_STALL_TIME = ((MICROS_PER_DEG_1_RPM/50U) * triggerToothAngle); //Minimum 50rpm. (3333uS is the time per degree at 50rpm)
+  
+  return decoder_builder_t()
+                  .setPrimaryTrigger(triggerPri_HondaD17, getConfigPriTriggerEdge(configPage4))
+                  .setGetRPM(getRPM_HondaD17)
+                  .setGetCrankAngle(getCrankAngle_HondaD17)
+                  .setReset(sharedDecoderReset)
+                  .setIsEngineRunning(sharedEngineIsRunning)
+                  .setGetStatus(sharedGetStatus)
+                  .setGetFeatures(sharedGetDecoderFeatures)
+                  .build();
+}
+
+/** @} */
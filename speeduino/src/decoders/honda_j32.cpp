@@ -0,0 +1,144 @@
+#include "decoder_shared.h"
+
+/** Honda J 32 (3.2 liter 6 cyl SOHC).
+*  The Honda J32a4 (and all J series I'm aware of) has a crank trigger with nominal 24 teeth (22 teeth actually present). 
+*  It has one missing tooth, then 7 teeth, then another missing tooth, then 15 teeth.
+*  The tooth rising edges all have uniform spacing between them, except for teeth 14 and 22, which measure about
+*  18 degrees between rising edges, rather than 15 degrees as the other teeth do.  These slightly larger
+*  teeth are immediately before a gap, and the extra 3 degrees is made up for in the gap, the gap being about
+*  3 degrees smaller than might be nominally expected, such that the expected rotational angle is restored immediately after
+*  the gap (missing tooth) passes.  
+*  Teeth are represented as 0V at the ECU, no teeth are represented as 5V.
+*  Top dead center of cylinder number 1 occurs as we lose sight of (just pass) the first tooth in the string of 15 teeth
+*  (this is a rising edge).
+*  The second tooth in the string of 15 teeth is designated as tooth 1 in this code. This means that
+*  when the interrupt for tooth 1 fires (as we just pass tooth 1), crank angle = 360/24 = 15 degrees.
+*  It follows that the first tooth in the string of 7 teeth is tooth 16. 
+* @defgroup dec_honda_j_32 Honda J 32
+* @{
+*/ 
+static void triggerPri_HondaJ32(void)
+{
+  // This function is called only on rising edges, which occur as we lose sight of a tooth.
+  // This function sets the following state variables for use in other functions:
+  // toothLastToothTime, toothOneTime, revolutionOne (just toggles - not correct)
+  uint32_t curTime = micros();
+  curGap = curTime - toothLastToothTime;
+  toothLastToothTime = curTime;
+
+  decoderStatus.validTrigger = true; //Flag this pulse as being a valid trigger (ie that it passed filters)
+  
+  if (decoderStatus.syncStatus==SyncStatus::Full) // We have sync
+  {
+    toothCurrentCount++;
+
+    if (toothCurrentCount == 25) { // handle rollover.  Normal sized tooth here
+      toothCurrentCount = 1;
+      toothOneMinusOneTime = toothOneTime;
+      toothOneTime = curTime;
+      currentStatus.startRevolutions++;
+      SetRevolutionTime(toothOneTime - toothOneMinusOneTime);
+    }
+    else if (toothCurrentCount == 23 || toothCurrentCount == 15) // This is the first tooth after a missing tooth
+    {
+      toothCurrentCount++; // account for missing tooth
+      if (curGap < (lastGap >> 1) * 3) // This should be a big gap, if we find it's not actually big, we lost sync
+      {
+        decoderStatus.syncStatus = SyncStatus::None;
+        toothCurrentCount=1;
+      }
+    }
+    else if (toothCurrentCount != 14 && toothCurrentCount != 22)
+    {
+      // Teeth 14 and 22 are about 18 rather than 15 degrees so don't update last_gap with this unusual spacing
+      lastGap = curGap;
+    }
+    // else toothCurrentCount == 14 or 22.  Take no further action. 
+  }
+  else // we do not have sync yet. While syncing, treat tooth 14 and 22 as normal teeth
+  {
+    if (curGap < (lastGap >> 1) * 3 || lastGap == 0){ // Regular tooth, lastGap == 0 at startup
+      toothCurrentCount++;  // Increment teeth between gaps
+      lastGap = curGap;
+    }
+    else { // First tooth after the missing tooth
+      if (toothCurrentCount == 15) {  // 15 teeth since the gap before this, meaning we just passed the second gap and are synced
+        decoderStatus.syncStatus = SyncStatus::Full;
+        toothCurrentCount = 16;  // This so happens to be the tooth number of the first tooth in the string of 7 (where we are now)
+        toothOneTime = curTime - (15 * lastGap); // Initialize tooth 1 times based on last gap width.
+        toothOneMinusOneTime = toothOneTime - (24 * lastGap);
+      }
+      else{ // Unclear which gap we just passed. reset counter
+        toothCurrentCount = 1;
+      }
+    }
+  }
+}
+
+static uint16_t getRPM_HondaJ32(void)
+{
+  // currentStatus.revolutionTime set by SetRevolutionTime(). Sync is gained part way through the first revolution, before it's known
+  if (currentStatus.revolutionTime == 0UL) { return 0U; }
+  return getAngleConverterRpm();
+}
+
+static int16_t getCrankAngle_HondaJ32(uint32_t currMicros)
+{
+  // Returns values from 0 to 360.
+  // Tooth 1 time occurs 360/24 degrees after TDC.
+  // Teeth 14 and 22 are unusually sized (18 degrees), but the missing tooth is smaller (12 degrees), so this oddity only applies when toothCurrentCount = 14 || 22
+  int crankAngle;
+  uint16_t tempToothCurrentCount;
+  noInterrupts();
+    tempToothCurrentCount = toothCurrentCount;
+  uint32_t elapsedTime = currMicros - toothLastToothTime;
+  interrupts();
+
+  if (tempToothCurrentCount == 14)
+  {
+    crankAngle = 213; // 13 teeth * 15 degrees/tooth + 18 degrees
+  }
+  else if (tempToothCurrentCount == 22)
+  {
+    crankAngle = 333; // 21 teeth * 15 degrees/tooth + 18 degrees
+  }
+  else
+  {
+    crankAngle = triggerToothAngle * tempToothCurrentCount;
+  }
+  crankAngle += timeToAngle(elapsedTime) + configPage4.triggerAngle;
+
+  if (crankAngle >= 720) { crankAngle -= 720; }
+  if (crankAngle > CRANK_ANGLE_MAX) { crankAngle -= CRANK_ANGLE_MAX; }
+  if (crankAngle < 0) { crankAngle += 360; }
+
+  return crankAngle;
+}
+
+decoder_t  __attribute__((optimize("Os"))) triggerSetup_HondaJ32(void)
+{
+  decoderFeatures = decoder_features_t();
+	sharedDecoderReset();
+  triggerToothAngle = 360 / 24; //The number of degrees that passes from tooth to tooth
+  MAX_STALL_TIME = ((MICROS_PER_DEG_1_RPM/10U) * triggerToothAngle); //Minimum 50rpm. (3333uS is the time per degree at 50rpm)
+  
+  // Filter (ignore) triggers that are faster than this.
+  triggerFilterTime = (MICROS_PER_SEC / (MAX_RPM / 60 * 24));
+  toothCurrentCount = 0;
+  toothOneTime = 0;
+  toothOneMinusOneTime = 0;
+  lastGap = 0;
+  revolutionOne = 0;
+
+  return decoder_builder_t()
+                  .setPrimaryTrigger(triggerPri_HondaJ32, RISING) // Don't honor the config, always use rising edge
+                  .setGetRPM(getRPM_HondaJ32)
+                  .setGetCrankAngle(getCrankAngle_HondaJ32)
+                  .setReset(sharedDecoderReset)
+                  .setIsEngineRunning(sharedEngineIsRunning)
+                  .setGetStatus(sharedGetStatus)
+                  .setGetFeatures(sharedGetDecoderFeatures)
+                  .build();
+}
+
+/** @} */
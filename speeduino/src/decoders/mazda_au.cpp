@@ -0,0 +1,157 @@
+#include "decoder_shared.h"
+
+/** Mazda AU version.
+Tooth #2 is defined as the next crank tooth after the single cam tooth.
+Tooth number one is at 348* ATDC.
+* @defgroup mazda_au Mazda AU
+* @{
+*/
+static void triggerPri_MazdaAU(void)
+{
+  uint32_t curTime = micros();
+  curGap = curTime - toothLastToothTime;
+  if ( curGap >= triggerFilterTime )
+  {
+    decoderStatus.validTrigger = true; //Flag this pulse as being a valid trigger (ie that it passed filters)
+
+    toothCurrentCount++;
+    if( (toothCurrentCount == 1) || (toothCurrentCount == 5) ) //Trigger is on CHANGE, hence 4 pulses = 1 crank rev
+    {
+       toothCurrentCount = 1; //Reset the counter
+       toothOneMinusOneTime = toothOneTime;
+       toothOneTime = curTime;
+       decoderStatus.syncStatus = SyncStatus::Full;
+       currentStatus.startRevolutions++; //Counter
+    }
+
+    if (decoderStatus.syncStatus==SyncStatus::Full)
+    {
+      // Locked cranking timing is available, fixed at 12* BTDC
+      if ( (currentStatus.rotationStatus==EngineRotationStatus::Cranking) && configPage4.ignCranklock )
+      {
+        if( toothCurrentCount == 1 ) { endCoilCharge(1U); }
+        else if( toothCurrentCount == 3 ) { endCoilCharge(2U); }
+      }
+
+      //Whilst this is an uneven tooth pattern, if the specific angle between the last 2 teeth is specified, 1st deriv prediction can be used
+      if( (toothCurrentCount == 1) || (toothCurrentCount == 3) ) { triggerToothAngle = 72; triggerFilterTime = curGap; } //Trigger filter is set to whatever time it took to do 72 degrees (Next trigger is 108 degrees away)
+      else { triggerToothAngle = 108; triggerFilterTime = rshift<3>((uint32_t)(curGap * 3UL)); } //Trigger filter is set to (108*3)/8=40 degrees (Next trigger is 70 degrees away).
+
+      toothLastMinusOneToothTime = toothLastToothTime;
+      toothLastToothTime = curTime;
+    } //Has sync
+  } //Filter time
+}
+
+static void triggerSec_MazdaAU(void)
+{
+  uint32_t curTime2 = micros();
+  lastGap = curGap2;
+  curGap2 = curTime2 - toothLastSecToothTime;
+  //if ( curGap2 < triggerSecFilterTime ) { return; }
+  toothLastSecToothTime = curTime2;
+
+  if(decoderStatus.syncStatus!=SyncStatus::Full)
+  {
+    //we find sync by looking for the 2 teeth that are close together. The next crank tooth after that is the one we're looking for.
+    //For the sake of this decoder, the lone cam tooth will be designated #1
+    if(secondaryToothCount == 2)
+    {
+      toothCurrentCount = 1;
+      decoderStatus.syncStatus = SyncStatus::Full;
+    }
+    else
+    {
+      triggerFilterTime = 1500; //In case the engine has been running and then lost sync.
+      targetGap = (lastGap) >> 1; //The target gap is set at half the last tooth gap
+      if ( curGap2 < targetGap) //If the gap between this tooth and the last one is less than half of the previous gap, then we are very likely at the extra (3rd) tooth on the cam). This tooth is located at 421 crank degrees (aka 61 degrees) and therefore the last crank tooth seen was number 1 (At 350 degrees)
+      {
+        secondaryToothCount = 2;
+      }
+    }
+    secondaryToothCount++;
+  }
+}
+
+
+static uint16_t getRPM_MazdaAU(void)
+{
+  uint16_t tempRPM = 0;
+
+  if (decoderStatus.syncStatus==SyncStatus::Full)
+  {
+    //During cranking, RPM is calculated 4 times per revolution, once for each tooth on the crank signal.
+    //Because these signals aren't even (Alternating 108 and 72 degrees), this needs a special function
+    if(currentStatus.RPM < currentStatus.crankRPM)
+    {
+      int tempToothAngle;
+      unsigned long toothTime;
+      noInterrupts();
+      tempToothAngle = triggerToothAngle;
+      toothTime = (toothLastToothTime - toothLastMinusOneToothTime);
+      interrupts();
+      SetRevolutionTime(36*toothTime); //Note that trigger tooth angle changes between 72 and 108 depending on the last tooth that was seen
+      tempRPM = (tempToothAngle * MICROS_PER_MIN) / currentStatus.revolutionTime;
+    }
+    else { tempRPM = stdGetRPM(CRANK_SPEED); }
+  }
+  return tempRPM;
+}
+
+static int16_t getCrankAngle_MazdaAU(uint32_t currMicros)
+{
+    int crankAngle = 0;
+    if(decoderStatus.syncStatus==SyncStatus::Full)
+    {
+      //This is the current angle ATDC the engine is at. This is the last known position based on what tooth was last 'seen'. It is only accurate to the resolution of the trigger wheel (Eg 36-1 is 10 degrees)
+      unsigned long tempToothLastToothTime;
+      int tempToothCurrentCount;
+      //Grab some variables that are used in the trigger code and assign them to temp variables.
+      noInterrupts();
+      tempToothCurrentCount = toothCurrentCount;
+      tempToothLastToothTime = toothLastToothTime;
+      interrupts();
+
+      crankAngle = toothAngles[(tempToothCurrentCount - 1)] + configPage4.triggerAngle; //Perform a lookup of the fixed toothAngles array to find what the angle of the last tooth passed was.
+
+      //Estimate the number of degrees travelled since the last tooth}
+      crankAngle += timeToAngle(currMicros - tempToothLastToothTime);
+
+      if (crankAngle >= 720) { crankAngle -= 720; }
+      if (crankAngle < 0) { crankAngle += 360; }
+    }
+
+    return crankAngle;
+}
+
+decoder_t  __attribute__((optimize("Os"))) triggerSetup_MazdaAU(void)
+{
+  decoderFeatures = decoder_features_t();
+	sharedDecoderReset();
+  triggerToothAngle = 108; //The number of degrees that passes from tooth to tooth (primary). This is the maximum gap
+  toothCurrentCount = 99; //Fake tooth count represents no sync
+  decoderFeatures.supportsSequential = true;
+
+  toothAngles[0] = 348; //tooth #1
+  toothAngles[1] = 96; //tooth #2
+  toothAngles[2] = 168; //tooth #3
+  toothAngles[3] = 276; //tooth #4
+
+  MAX_STALL_TIME = ((MICROS_PER_DEG_1_RPM/50U) * triggerToothAngle); //Minimum 50rpm. (3333uS is the time per degree at 50rpm)
+  triggerFilterTime = 1500; //10000 rpm, assuming we're triggering on both edges off the crank tooth.
+  triggerSecFilterTime = (int)(MICROS_PER_SEC / (MAX_RPM / 60U * 2U)) / 2U; //Same as above, but fixed at 2 teeth on the secondary input and divided by 2 (for cam speed)
+  decoderFeatures.hasFixedCrankingTiming = true;
+
+  return decoder_builder_t()
+                  .setPrimaryTrigger(triggerPri_MazdaAU, getConfigPriTriggerEdge(configPage4))
+                  .setSecondaryTrigger(triggerSec_MazdaAU, FALLING)
+                  .setGetRPM(getRPM_MazdaAU)
+                  .setGetCrankAngle(getCrankAngle_MazdaAU)
+                  .setReset(sharedDecoderReset)
+                  .setIsEngineRunning(sharedEngineIsRunning)
+                  .setGetStatus(sharedGetStatus)
+                  .setGetFeatures(sharedGetDecoderFeatures)
+                  .build();
+}
+
+/** @} */
@@ -0,0 +1,374 @@
+#include "decoder_shared.h"
+
+/** A (single) multi-tooth wheel with one of more 'missing' teeth.
+* The first tooth after the missing one is considered number 1 and is the basis for the trigger angle.
+* Optionally a cam signal can be added to provide a sequential reference. 
+* @defgroup dec_miss Missing tooth wheel
+* @{
+*/
+static volatile unsigned long triggerThirdFilterTime; // The shortest time (in uS) that pulses will be accepted (Used for debounce filtering) for the Third input
+
+static inline void triggerRecordVVT1Angle (void);
+
+void triggerPri_missingTooth(void)
+{
+   uint32_t curTime = micros();
+   curGap = curTime - toothLastToothTime;
+   if ( curGap >= triggerFilterTime ) //Pulses should never be less than triggerFilterTime, so if they are it means a false trigger. (A 36-1 wheel at 8000pm will have triggers approx. every 200uS)
+   {
+     toothCurrentCount++; //Increment the tooth counter
+     decoderStatus.validTrigger = true; //Flag this pulse as being a valid trigger (ie that it passed filters)
+
+      if( (toothLastToothTime > 0) && (toothLastMinusOneToothTime > 0) )
+      {
+        bool isMissingTooth = false;
+
+        /*
+        Performance Optimisation:
+        Only need to try and detect the missing tooth if:
+        1. WE don't have sync yet
+        2. We have sync and are in the final 1/4 of the wheel (Missing tooth will/should never occur in the first 3/4)
+        3. RPM is under 2000. This is to ensure that we don't interfere with strange timing when cranking or idling. Optimisation not really required at these speeds anyway
+        */
+        if( (decoderStatus.syncStatus!=SyncStatus::Full) || (currentStatus.RPM < 2000) || (toothCurrentCount >= (3 * triggerActualTeeth >> 2)) )
+        {
+          //Begin the missing tooth detection
+          //If the time between the current tooth and the last is greater than 1.5x the time between the last tooth and the tooth before that, we make the assertion that we must be at the first tooth after the gap
+          if(configPage4.triggerMissingTeeth == 1) { targetGap = (3 * (toothLastToothTime - toothLastMinusOneToothTime)) >> 1; } //Multiply by 1.5 (Checks for a gap 1.5x greater than the last one) (Uses bitshift to multiply by 3 then divide by 2. Much faster than multiplying by 1.5)
+          else { targetGap = ((toothLastToothTime - toothLastMinusOneToothTime)) * configPage4.triggerMissingTeeth; } //Multiply by 2 (Checks for a gap 2x greater than the last one)
+
+          if( (toothLastToothTime == 0) || (toothLastMinusOneToothTime == 0) ) { curGap = 0; }
+
+          if ( (curGap > targetGap) || (toothCurrentCount > triggerActualTeeth) )
+          {
+            //Missing tooth detected
+            isMissingTooth = true;
+            if( (toothCurrentCount < triggerActualTeeth) && (decoderStatus.syncStatus==SyncStatus::Full) ) 
+            { 
+                //This occurs when we're at tooth #1, but haven't seen all the other teeth. This indicates a signal issue so we flag lost sync so this will attempt to resync on the next revolution.
+                decoderStatus.syncStatus = SyncStatus::None;
+                currentStatus.syncLossCounter++;
+            }
+            //This is to handle a special case on startup where sync can be obtained and the system immediately thinks the revs have jumped:
+            else
+            {
+                if(decoderStatus.syncStatus!=SyncStatus::None)
+                {
+                  currentStatus.startRevolutions++; //Counter
+                  if ( configPage4.TrigSpeed == CAM_SPEED ) { currentStatus.startRevolutions++; } //Add an extra revolution count if we're running at cam speed
+                }
+                else { currentStatus.startRevolutions = 0; }
+                
+                toothCurrentCount = 1;
+                if (configPage4.trigPatternSec == SEC_TRIGGER_POLL) // at tooth one check if the cam sensor is high or low in poll level mode
+                {
+                  if (configPage4.PollLevelPolarity == currentStatus.decoder.secondary.isPinHigh()) { revolutionOne = 1; }
+                  else { revolutionOne = 0; }
+                }
+                else {revolutionOne = !revolutionOne;} //Flip sequential revolution tracker if poll level is not used
+                toothOneMinusOneTime = toothOneTime;
+                toothOneTime = curTime;
+
+                //if Sequential fuel or ignition is in use, further checks are needed before determining sync
+                if( (configPage4.sparkMode == IGN_MODE_SEQUENTIAL) || (configPage2.injLayout == INJ_SEQUENTIAL) )
+                {
+                  //If either fuel or ignition is sequential, only declare sync if the cam tooth has been seen OR if the missing wheel is on the cam
+                  if( (secondaryToothCount > 0) || (configPage4.TrigSpeed == CAM_SPEED) || (configPage4.trigPatternSec == SEC_TRIGGER_POLL) || (configPage2.strokes == TWO_STROKE) )
+                  {
+                    decoderStatus.syncStatus = SyncStatus::Full; //the engine is fully synced so clear the Half Sync bit                    
+                  }
+                  else if(decoderStatus.syncStatus!=SyncStatus::Full) { decoderStatus.syncStatus = SyncStatus::Partial; } //If there is primary trigger but no secondary we only have half sync.
+                }
+                else { decoderStatus.syncStatus = SyncStatus::Full; } //If nothing is using sequential, we have sync and also clear half sync bit
+                if(configPage4.trigPatternSec == SEC_TRIGGER_SINGLE || configPage4.trigPatternSec == SEC_TRIGGER_TOYOTA_3) //Reset the secondary tooth counter to prevent it overflowing, done outside of sequental as v6 & v8 engines could be batch firing with VVT that needs the cam resetting
+                { 
+                  secondaryToothCount = 0; 
+                } 
+
+                triggerFilterTime = 0; //This is used to prevent a condition where serious intermittent signals (Eg someone furiously plugging the sensor wire in and out) can leave the filter in an unrecoverable state
+                toothLastMinusOneToothTime = toothLastToothTime;
+                toothLastToothTime = curTime;
+                decoderStatus.toothAngleIsCorrect = false; //The tooth angle is double at this point
+            }
+          }
+        }
+        
+        if(isMissingTooth == false)
+        {
+          //Regular (non-missing) tooth
+          setFilter(curGap);
+          toothLastMinusOneToothTime = toothLastToothTime;
+          toothLastToothTime = curTime;
+          decoderStatus.toothAngleIsCorrect = true;
+        }
+        updateCrankAcceleration(curGap, !isMissingTooth);
+      }
+      else
+      {
+        //We fall here on initial startup when enough teeth have not yet been seen
+        toothLastMinusOneToothTime = toothLastToothTime;
+        toothLastToothTime = curTime;
+      }
+      publishToothEvent();
+
+      //NEW IGNITION MODE
+      if( (isPerToothTimingEnabled()) && (currentStatus.rotationStatus!=EngineRotationStatus::Cranking) ) 
+      {
+        int16_t crankAngle = ( (toothCurrentCount-1) * triggerToothAngle ) + configPage4.triggerAngle;
+        if( (configPage4.sparkMode == IGN_MODE_SEQUENTIAL) && (revolutionOne == true) && (configPage4.TrigSpeed == CRANK_SPEED) && (configPage2.strokes == FOUR_STROKE) )
+        {
+          crankAngle += 360;
+          checkPerToothTiming(crankAngle, (configPage4.triggerTeeth + toothCurrentCount)); 
+        }
+        else{ checkPerToothTiming(crankAngle, toothCurrentCount); }
+      }
+   }
+}
+
+void triggerSec_missingTooth(void)
+{
+  uint32_t curTime2 = micros();
+  curGap2 = curTime2 - toothLastSecToothTime;
+
+  //Safety check for initial startup
+  if( (toothLastSecToothTime == 0) )
+  { 
+    curGap2 = 0; 
+    toothLastSecToothTime = curTime2;
+  }
+
+  if ( curGap2 >= triggerSecFilterTime )
+  {
+    switch (configPage4.trigPatternSec)
+    {
+      case SEC_TRIGGER_4_1:
+        targetGap2 = (3 * (toothLastSecToothTime - toothLastMinusOneSecToothTime)) >> 1; //If the time between the current tooth and the last is greater than 1.5x the time between the last tooth and the tooth before that, we make the assertion that we must be at the first tooth after the gap
+        toothLastMinusOneSecToothTime = toothLastSecToothTime;
+        if ( (curGap2 >= targetGap2) || (secondaryToothCount > 3) )
+        {
+          secondaryToothCount = 1;
+          revolutionOne = 1; //Sequential revolution reset
+          triggerSecFilterTime = 0; //This is used to prevent a condition where serious intermittent signals (Eg someone furiously plugging the sensor wire in and out) can leave the filter in an unrecoverable state
+          triggerRecordVVT1Angle();
+        }
+        else
+        {
+          triggerSecFilterTime = curGap2 >> 2; //Set filter at 25% of the current speed. Filter can only be recalc'd for the regular teeth, not the missing one.
+          secondaryToothCount++;
+        }
+        break;
+
+      case SEC_TRIGGER_POLL:
+        //Poll is effectively the same as SEC_TRIGGER_SINGLE, however we do not reset revolutionOne
+        //We do still need to record the angle for VVT though
+        triggerSecFilterTime = curGap2 >> 1; //Next secondary filter is half the current gap
+        triggerRecordVVT1Angle();
+        break;
+
+      case SEC_TRIGGER_SINGLE:
+        //Standard single tooth cam trigger
+        revolutionOne = 1; //Sequential revolution reset
+        triggerSecFilterTime = curGap2 >> 1; //Next secondary filter is half the current gap
+        secondaryToothCount++;
+        triggerRecordVVT1Angle();
+        break;
+
+      case SEC_TRIGGER_TOYOTA_3:
+        // designed for Toyota VVTI (2JZ) engine - 3 triggers on the cam. 
+        // the 2 teeth for this are within 1 rotation (1 tooth first 360, 2 teeth second 360)
+        secondaryToothCount++;
+        if(secondaryToothCount == 2)
+        { 
+          revolutionOne = 1; // sequential revolution reset
+          triggerRecordVVT1Angle();         
+        }        
+        //Next secondary filter is 25% the current gap, done here so we don't get a great big gap for the 1st tooth
+        triggerSecFilterTime = curGap2 >> 2; 
+        break;
+    }
+    toothLastSecToothTime = curTime2;
+    publishToothEvent(); //revolutionOne may have changed
+  } //Trigger filter
+}
+
+static inline void triggerRecordVVT1Angle (void)
+{
+  //Record the VVT Angle
+  if( (configPage6.vvtEnabled > 0) && (revolutionOne == 1) )
+  {
+    int16_t curAngle;
+    curAngle = currentStatus.decoder.getCrankAngle();
+    while(curAngle > 360) { curAngle -= 360; }
+    curAngle -= configPage4.triggerAngle; //Value at TDC
+    if( configPage6.vvtMode == VVT_MODE_CLOSED_LOOP ) { curAngle -= configPage10.vvtCL0DutyAng; }
+
+    currentStatus.vvt1Angle = LOW_PASS_FILTER( (curAngle << 1), configPage4.ANGLEFILTER_VVT, currentStatus.vvt1Angle);
+  }
+}
+
+static void triggerThird_missingTooth(void)
+{
+//Record the VVT2 Angle (the only purpose of the third trigger)
+//NB no filtering of this signal with current implementation unlike Cam (VVT1)
+
+  int16_t curAngle;
+  uint32_t curTime3 = micros();
+  curGap3 = curTime3 - toothLastThirdToothTime;
+
+  //Safety check for initial startup
+  if( (toothLastThirdToothTime == 0) )
+  { 
+    curGap3 = 0; 
+    toothLastThirdToothTime = curTime3;
+  }
+
+  if ( curGap3 >= triggerThirdFilterTime )
+  {
+    triggerThirdFilterTime = curGap3 >> 2; //Next third filter is 25% the current gap
+    
+    curAngle = currentStatus.decoder.getCrankAngle();
+    while(curAngle > 360) { curAngle -= 360; }
+    curAngle -= configPage4.triggerAngle; //Value at TDC
+    if( configPage6.vvtMode == VVT_MODE_CLOSED_LOOP ) { curAngle -= configPage4.vvt2CL0DutyAng; }
+    //currentStatus.vvt2Angle = int8_t (curAngle); //vvt1Angle is only int8, but +/-127 degrees is enough for VVT control
+    currentStatus.vvt2Angle = LOW_PASS_FILTER( (curAngle << 1), configPage4.ANGLEFILTER_VVT, currentStatus.vvt2Angle);    
+
+    toothLastThirdToothTime = curTime3;
+  } //Trigger filter
+}
+
+uint16_t getRPM_missingTooth(void)
+{
+  uint16_t tempRPM = 0;
+  tooth_event_t tooth = getLatestToothEvent();
+  if( currentStatus.RPM < currentStatus.crankRPM )
+  {
+    if(tooth.tooth != 1)
+    {
+      tempRPM = crankingGetRPM(tooth, configPage4.triggerTeeth, configPage4.TrigSpeed==CAM_SPEED); //Account for cam speed
+    }
+    else { tempRPM = currentStatus.RPM; } //Can't do per tooth RPM if we're at tooth #1 as the missing tooth messes the calculation
+  }
+  else
+  {
+    tempRPM = stdGetRPM(tooth, configPage4.TrigSpeed==CAM_SPEED); //Account for cam speed
+  }
+  return tempRPM;
+}
+
+int16_t getCrankAngle_missingTooth(uint32_t currMicros)
+{
+    //This is the current angle ATDC the engine is at. This is the last known position based on what tooth was last 'seen'. It is only accurate to the resolution of the trigger wheel (Eg 36-1 is 10 degrees)
+    tooth_event_t tooth = getLatestToothEvent();
+
+    int crankAngle = (((int)tooth.tooth - 1) * triggerToothAngle) + configPage4.triggerAngle; //Number of teeth that have passed since tooth 1, multiplied by the angle each tooth represents, plus the angle that tooth 1 is ATDC. This gives accuracy only to the nearest tooth.
+    
+    //Sequential check (simply sets whether we're on the first or 2nd revolution of the cycle)
+    if ( (tooth.revolutionOne == true) && (configPage4.TrigSpeed == CRANK_SPEED) ) { crankAngle += 360; }
+
+    crankAngle += timeToAngle(currMicros - tooth.time);
+
+    if (crankAngle >= 720) { crankAngle -= 720; }
+    if (crankAngle < 0) { crankAngle += CRANK_ANGLE_MAX; }
+
+    return crankAngle;
+}
+
+static uint16_t __attribute__((noinline)) calcEndTeeth_missingTooth(const IgnitionSchedule &schedule, uint8_t toothAdder) {
+  //Temp variable used here to avoid potential issues if a trigger interrupt occurs part way through this function
+  int16_t tempEndTooth;
+#ifdef USE_LIBDIVIDE  
+  tempEndTooth = libdivide::libdivide_s16_do(schedule.dischargeAngle - configPage4.triggerAngle, &divTriggerToothAngle);
+#else
+  tempEndTooth = (schedule.dischargeAngle - (int16_t)configPage4.triggerAngle) / (int16_t)triggerToothAngle;
+#endif
+  //For higher tooth count triggers, add a 1 tooth margin to allow for calculation time. 
+  if(configPage4.triggerTeeth > 12U) { tempEndTooth = tempEndTooth - 1; }
+  
+  // Clamp to tooth count
+  return clampToActualTeeth(clampToToothCount(tempEndTooth, toothAdder), toothAdder);
+}
+
+static void triggerSetEndTeeth_missingTooth(void)
+{
+  uint8_t toothAdder = 0;
+  if( ((configPage4.sparkMode == IGN_MODE_SEQUENTIAL) || (configPage4.sparkMode == IGN_MODE_SINGLE)) && (configPage4.TrigSpeed == CRANK_SPEED) && (configPage2.strokes == FOUR_STROKE) ) { toothAdder = configPage4.triggerTeeth; }
+
+  ignitionEndTeeth[0] = calcEndTeeth_missingTooth(ignitionSchedule1, toothAdder);
+#if (IGN_CHANNELS >= 2)
+  ignitionEndTeeth[1] = calcEndTeeth_missingTooth(ignitionSchedule2, toothAdder);
+#endif
+#if (IGN_CHANNELS >= 3)
+  ignitionEndTeeth[2] = calcEndTeeth_missingTooth(ignitionSchedule3, toothAdder);
+#endif
+#if (IGN_CHANNELS >= 4)
+  ignitionEndTeeth[3] = calcEndTeeth_missingTooth(ignitionSchedule4, toothAdder);
+#endif
+#if IGN_CHANNELS >= 5
+  ignitionEndTeeth[4] = calcEndTeeth_missingTooth(ignitionSchedule5, toothAdder);
+#endif
+#if IGN_CHANNELS >= 6
+  ignitionEndTeeth[5] = calcEndTeeth_missingTooth(ignitionSchedule6, toothAdder);
+#endif
+#if IGN_CHANNELS >= 7
+  ignitionEndTeeth[6] = calcEndTeeth_missingTooth(ignitionSchedule7, toothAdder);
+#endif
+#if IGN_CHANNELS >= 8
+  ignitionEndTeeth[7] = calcEndTeeth_missingTooth(ignitionSchedule8, toothAdder);
+#endif
+}
+
+decoder_t __attribute__((optimize("Os"))) triggerSetup_missingTooth(void)
+{
+  decoderFeatures = decoder_features_t();
+	sharedDecoderReset();
+  decoderFeatures.supportsPerToothIgnition = true;
+  decoderFeatures.supports2ndDeriv = configPage4.triggerTeeth >= MIN_TEETH_FOR_2ND_DERIV;
+  triggerToothAngle = 360 / configPage4.triggerTeeth; //The number of degrees that passes from tooth to tooth
+  if(configPage4.TrigSpeed == CAM_SPEED) 
+  { 
+    //Account for cam speed missing tooth
+    triggerToothAngle = 720 / configPage4.triggerTeeth; 
+    decoderFeatures.supportsSequential = true;
+  } 
+  triggerActualTeeth = configPage4.triggerTeeth - configPage4.triggerMissingTeeth; //The number of physical teeth on the wheel. Doing this here saves us a calculation each time in the interrupt
+  setupCrankAcceleration();
+  triggerFilterTime = (MICROS_PER_SEC / (MAX_RPM / 60U * configPage4.triggerTeeth)); //Trigger filter time is the shortest possible time (in uS) that there can be between crank teeth (ie at max RPM). Any pulses that occur faster than this time will be discarded as noise
+  if (configPage4.trigPatternSec == SEC_TRIGGER_4_1)
+  {
+    triggerSecFilterTime = MICROS_PER_MIN / MAX_RPM / 4U / 2U;
+  }
+  else 
+  {
+    triggerSecFilterTime = (MICROS_PER_SEC / (MAX_RPM / 60U));
+  }
+  checkSyncToothCount = (configPage4.triggerTeeth) >> 1; //50% of the total teeth.
+  toothLastMinusOneToothTime = 0;
+  toothCurrentCount = 0; 
+  toothOneTime = 0;
+  toothOneMinusOneTime = 0;
+  MAX_STALL_TIME = ((MICROS_PER_DEG_1_RPM/50U) * triggerToothAngle * (configPage4.triggerMissingTeeth + 1U)); //Minimum 50rpm. (3333uS is the time per degree at 50rpm)
+
+  bool hasSecondary =  (configPage4.TrigSpeed == CRANK_SPEED) 
+                    && ( (configPage4.sparkMode == IGN_MODE_SEQUENTIAL) 
+                      || (configPage2.injLayout == INJ_SEQUENTIAL) 
+                      || (configPage6.vvtEnabled > 0) );
+#ifdef USE_LIBDIVIDE
+  divTriggerToothAngle = libdivide::libdivide_s16_gen(triggerToothAngle);
+#endif
+
+  return decoder_builder_t()
+                  .setPrimaryTrigger(triggerPri_missingTooth, getConfigPriTriggerEdge(configPage4))
+                  .setSecondaryTrigger(triggerSec_missingTooth, hasSecondary ? getConfigSecTriggerEdge(configPage4) : TRIGGER_EDGE_NONE)
+                  .setTertiaryTrigger(triggerThird_missingTooth, configPage10.vvt2Enabled ? getConfigTerTriggerEdge(configPage10) : TRIGGER_EDGE_NONE)
+                  .setGetRPM(getRPM_missingTooth)
+                  .setGetCrankAngle(getCrankAngle_missingTooth)
+                  .setSetEndTeeth(triggerSetEndTeeth_missingTooth)
+                  .setReset(sharedDecoderReset)
+                  .setIsEngineRunning(sharedEngineIsRunning)
+                  .setGetStatus(sharedGetStatus)
+                  .setGetFeatures(sharedGetDecoderFeatures)
+                  .build();
+}
+
+/** @} */
@@ -0,0 +1,248 @@
+#include "decoder_shared.h"
+
+/** Nissan 360 tooth on cam (Optical trigger disc inside distributor housing).
+See http://wiki.r31skylineclub.com/index.php/Crank_Angle_Sensor .
+* @defgroup dec_nissan360 Nissan 360 tooth on cam
+* @{
+*/
+static void triggerPri_Nissan360(void)
+{
+   uint32_t curTime = micros();
+   curGap = curTime - toothLastToothTime;
+   if ( curGap < triggerFilterTime ) { return; }
+   
+   toothCurrentCount++; //Increment the tooth counter
+   decoderStatus.validTrigger = true; //Flag this pulse as being a valid trigger (ie that it passed filters)
+
+   toothLastMinusOneToothTime = toothLastToothTime;
+   toothLastToothTime = curTime;
+
+   if ( decoderStatus.syncStatus==SyncStatus::Full )
+   {
+     if ( toothCurrentCount == 361 ) //2 complete crank revolutions
+     {
+       toothCurrentCount = 1;
+       toothOneMinusOneTime = toothOneTime;
+       toothOneTime = curTime;
+       currentStatus.startRevolutions++; //Counter
+     }
+     //Recalc the new filter value
+     setFilter(curGap);
+
+     //EXPERIMENTAL!
+     if(isPerToothTimingEnabled())
+     {
+        int16_t crankAngle = ( (toothCurrentCount-1) * 2 ) + configPage4.triggerAngle;
+        if(crankAngle > CRANK_ANGLE_MAX_IGN) 
+        { 
+          crankAngle -= CRANK_ANGLE_MAX_IGN;
+          checkPerToothTiming(crankAngle, (toothCurrentCount/2) );
+        }
+        else
+        {
+          checkPerToothTiming(crankAngle, toothCurrentCount);
+        }
+       
+     }
+   }
+}
+
+static void triggerSec_Nissan360(void)
+{
+  uint32_t curTime2 = micros();
+  curGap2 = curTime2 - toothLastSecToothTime;
+  //if ( curGap2 < triggerSecFilterTime ) { return; }
+  toothLastSecToothTime = curTime2;
+  //OPTIONAL: Set filter at 25% of the current speed
+  //triggerSecFilterTime = curGap2 >> 2;
+
+
+  //Calculate number of primary teeth that this window has been active for
+  if( (secondaryToothCount == 0) || (currentStatus.decoder.secondary.isTriggered()) ) { secondaryToothCount = toothCurrentCount; } //This occurs on the first rotation upon powerup OR the start of a secondary window
+  else
+  {
+    //If we reach here, we are at the end of a secondary window
+    byte secondaryDuration = toothCurrentCount - secondaryToothCount; //How many primary teeth have passed during the duration of this secondary window
+
+    if(decoderStatus.syncStatus!=SyncStatus::Full)
+    {
+      if(configPage2.nCylinders == 4)
+      {
+        //Supported pattern is where all the inner windows as a different size (Most SR engines)
+        //These equate to 4,8,12,16 teeth spacings
+        if( (secondaryDuration >= 15) && (secondaryDuration <= 17) ) //Duration of window = 16 primary teeth
+        {
+          toothCurrentCount = 16; //End of first window (The longest) occurs 16 teeth after TDC
+          decoderStatus.syncStatus = SyncStatus::Full;
+        }
+        else if( (secondaryDuration >= 11) && (secondaryDuration <= 13) ) //Duration of window = 12 primary teeth
+        {
+          toothCurrentCount = 102; //End of second window is after 90+12 primary teeth
+          decoderStatus.syncStatus = SyncStatus::Full;
+        }
+        else if( (secondaryDuration >= 7) && (secondaryDuration <= 9) ) //Duration of window = 8 primary teeth
+        {
+          toothCurrentCount = 188; //End of third window is after 90+90+8 primary teeth
+          decoderStatus.syncStatus = SyncStatus::Full;
+        }
+        else if( (secondaryDuration >= 3) && (secondaryDuration <= 5) ) //Duration of window = 4 primary teeth
+        {
+          toothCurrentCount = 274; //End of fourth window is after 90+90+90+4 primary teeth
+          decoderStatus.syncStatus = SyncStatus::Full;
+        }
+        else { decoderStatus.syncStatus = SyncStatus::None; currentStatus.syncLossCounter++; } //This should really never happen
+      }
+      else if(configPage2.nCylinders == 6)
+      {
+        //Pattern on the 6 cylinders is 4-8-12-16-20-24
+        if( (secondaryDuration >= 3) && (secondaryDuration <= 5) ) //Duration of window = 4 primary teeth
+        {
+          toothCurrentCount = 124; //End of smallest window is after 60+60+4 primary teeth
+          decoderStatus.syncStatus = SyncStatus::Full;
+        }
+      }
+      else if(configPage2.nCylinders == 8)
+      {
+        //V8 Optispark
+        //Pattern on the 8 cylinders is the same as the 6 cylinder 4-8-12-16-20-24
+        if( (secondaryDuration >= 6) && (secondaryDuration <= 8) ) //Duration of window = 16 primary teeth
+        {
+          toothCurrentCount = 56; //End of the shortest of the individual windows. Occurs at 102 crank degrees. 
+          decoderStatus.syncStatus = SyncStatus::Full;
+        }
+      }
+      else { decoderStatus.syncStatus = SyncStatus::None; } //This should really never happen (Only 4, 6 and 8 cylinder engines for this pattern)
+    }
+    else
+    {
+      if (configPage4.useResync == true)
+      {
+        //Already have sync, but do a verify every 720 degrees.
+        if(configPage2.nCylinders == 4)
+        {
+          if( (secondaryDuration >= 15) && (secondaryDuration <= 17) ) //Duration of window = 16 primary teeth
+          {
+            toothCurrentCount = 16; //End of first window (The longest) occurs 16 teeth after TDC
+          }
+        }
+        else if(configPage2.nCylinders == 6)
+        {
+          if( (secondaryDuration >= 3) && (secondaryDuration <= 5) ) //Duration of window = 4 primary teeth
+          {
+            toothCurrentCount = 124; //End of smallest window is after 60+60+4 primary teeth
+          }
+        } //Cylinder count
+      } //use resync
+    } //Has sync
+  } //First getting sync or not
+}
+
+static uint16_t getRPM_Nissan360(void)
+{
+  //Can't use stdGetRPM as there is no separate cranking RPM calc (stdGetRPM returns 0 if cranking)
+  uint16_t tempRPM;
+  if( (decoderStatus.syncStatus==SyncStatus::Full) && (toothLastToothTime != 0) && (toothLastMinusOneToothTime != 0) )
+  {
+    unsigned long revolutionTime;
+    if(currentStatus.startRevolutions < 2)
+    {
+      noInterrupts();
+      revolutionTime = (toothLastToothTime - toothLastMinusOneToothTime) * 180; //Each tooth covers 2 crank degrees, so multiply by 180 to get a full revolution time. 
+      interrupts();
+    }
+    else
+    {
+      noInterrupts();
+      revolutionTime = (toothOneTime - toothOneMinusOneTime) >> 1; //The time in uS that one revolution would take at current speed (The time tooth 1 was last seen, minus the time it was seen prior to that)
+      interrupts();
+    }
+    SetRevolutionTime(revolutionTime);
+    tempRPM = getAngleConverterRpm(); //Calc RPM based on last full revolution time
+    MAX_STALL_TIME = currentStatus.revolutionTime << 1; //Set the stall time to be twice the current RPM. This is a safe figure as there should be no single revolution where this changes more than this
+  }
+  else { tempRPM = 0; }
+
+  return tempRPM;
+}
+
+static int16_t getCrankAngle_Nissan360(uint32_t currMicros)
+{
+  //As each tooth represents 2 crank degrees, we only need to determine whether we're more or less than halfway between teeth to know whether to add another 1 degrees
+  int crankAngle = 0;
+  int tempToothLastToothTime;
+  int tempToothLastMinusOneToothTime;
+  int tempToothCurrentCount;
+
+  noInterrupts();
+  tempToothLastToothTime = toothLastToothTime;
+  tempToothLastMinusOneToothTime = toothLastMinusOneToothTime;
+  tempToothCurrentCount = toothCurrentCount;
+  interrupts();
+
+  crankAngle = ( (tempToothCurrentCount - 1) * 2) + configPage4.triggerAngle;
+  unsigned long halfTooth = (tempToothLastToothTime - tempToothLastMinusOneToothTime) / 2;
+  uint32_t elapsedTime = (currMicros- tempToothLastToothTime);
+  if (elapsedTime > halfTooth)
+  {
+    //Means we're over halfway to the next tooth, so add on 1 degree
+    crankAngle += 1;
+  }
+
+  if (crankAngle >= 720) { crankAngle -= 720; }
+  if (crankAngle < 0) { crankAngle += 360; }
+
+  return crankAngle;
+}
+
+static uint16_t __attribute__((noinline)) calcEndTooth_Nissan360(const IgnitionSchedule &schedule) {
+  //This uses 4 prior teeth, just to ensure there is sufficient time to set the schedule etc
+  static constexpr uint8_t offset_teeth = 4;
+  if(((int16_t)schedule.dischargeAngle - offset_teeth) > configPage4.triggerAngle) {
+     return ( (schedule.dischargeAngle - configPage4.triggerAngle) / 2 ) - offset_teeth; 
+  }
+  else { 
+    return ( (schedule.dischargeAngle + 720 - configPage4.triggerAngle) / 2 ) - offset_teeth; 
+  }
+}
+
+void triggerSetEndTeeth_Nissan360(void)
+{
+  ignitionEndTeeth[0] = calcEndTooth_Nissan360(ignitionSchedule1);
+#if (IGN_CHANNELS >= 2)
+  ignitionEndTeeth[1] = calcEndTooth_Nissan360(ignitionSchedule2);
+#endif
+#if (IGN_CHANNELS >= 3)
+  ignitionEndTeeth[2] = calcEndTooth_Nissan360(ignitionSchedule3);
+#endif
+#if (IGN_CHANNELS >= 4)
+  ignitionEndTeeth[3] = calcEndTooth_Nissan360(ignitionSchedule4);
+#endif
+}
+
+decoder_t  __attribute__((optimize("Os"))) triggerSetup_Nissan360(void)
+{
+	sharedDecoderReset();
+  decoderFeatures = decoder_features_t();
+  triggerFilterTime = (MICROS_PER_SEC / (MAX_RPM / 60U * 360UL)); //Trigger filter time is the shortest possible time (in uS) that there can be between crank teeth (ie at max RPM). Any pulses that occur faster than this time will be discarded as noise
+  triggerSecFilterTime = (int)(MICROS_PER_SEC / (MAX_RPM / 60U * 2U)) / 2U; //Same as above, but fixed at 2 teeth on the secondary input and divided by 2 (for cam speed)
+  secondaryToothCount = 0; //Initially set to 0 prior to calculating the secondary window duration
+  decoderFeatures.supportsSequential = true;
+  decoderFeatures.supportsPerToothIgnition = true;
+  toothCurrentCount = 1;
+  triggerToothAngle = 2;
+  MAX_STALL_TIME = ((MICROS_PER_DEG_1_RPM/50U) * triggerToothAngle); //Minimum 50rpm. (3333uS is the time per degree at 50rpm)
+
+  return decoder_builder_t()
+                  .setPrimaryTrigger(triggerPri_Nissan360, getConfigPriTriggerEdge(configPage4))
+                  .setSecondaryTrigger(triggerSec_Nissan360, CHANGE)
+                  .setGetRPM(getRPM_Nissan360)
+                  .setGetCrankAngle(getCrankAngle_Nissan360)
+                  .setSetEndTeeth(triggerSetEndTeeth_Nissan360)
+                  .setReset(sharedDecoderReset)
+                  .setIsEngineRunning(sharedEngineIsRunning)
+                  .setGetStatus(sharedGetStatus)
+                  .setGetFeatures(sharedGetDecoderFeatures)
+                  .build();
+}
+
+/** @} */
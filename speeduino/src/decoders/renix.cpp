@@ -0,0 +1,179 @@
+#include "decoder_shared.h"
+
+/** Renix 44-2-2  and 66-2-2-2 decoder.  
+* Renix trigger wheel doesn't decode into 360 degrees nicely (360/44 = 8.18 degrees or 360/66 = 5.454545). Speeduino can't handle any teeth that have a decimal point.
+* Solution is to count teeth, every 11 teeth = a proper angle. For 66 tooth decoder its 60 degrees per 11 teeth, for 44 tooth decoder its 90 degrees per 11 teeth.
+* This means the system sees 4 teeth on the 44 tooth wheel and 6 teeth on the 66 tooth wheel.
+* Double missing tooth in the pattern is actually a large tooth and a large gap. If the trigger is set to rising you'll see the start of the large tooth
+* then the gap. If its not set to rising the code won't work due to seeing two gaps
+*
+*
+* @defgroup dec_renix Renix decoder 
+* @{
+*/
+
+// variables used to help calculate gap on the physical 44 or 66 teeth we're pretending don't exist in most of the speeduino code
+// reusing existing variables to save storage space as these aren't used in the code for their original purpose.
+#define renixSystemLastToothTime         toothLastToothRisingTime
+#define renixSystemLastMinusOneToothTime toothLastSecToothRisingTime
+
+static void triggerPri_Renix(void)
+{
+  uint32_t curTime = micros();
+  curGap = curTime - renixSystemLastToothTime;
+
+  if ( curGap >= triggerFilterTime )   
+  {
+       
+    toothSystemCount++;
+
+    if( renixSystemLastToothTime != 0 && renixSystemLastMinusOneToothTime != 0)
+    { targetGap = (2 * (renixSystemLastToothTime - renixSystemLastMinusOneToothTime));}  // in real world the physical 2 tooth gap is bigger than 2 teeth - more like 2.5
+    else 
+    { targetGap = 100000000L; } // random large number to stop system thinking we have a gap for the first few teeth on start up
+
+    if( curGap >= targetGap )
+    { 
+      /* add two teeth to account for the gap we've just seen */      
+      toothSystemCount++;
+      toothSystemCount++;
+   
+      if( toothSystemCount != 12) // if not 12 (the first tooth after the gap) then we've lost sync
+      {
+        // lost sync
+        decoderStatus.syncStatus = SyncStatus::None;
+        currentStatus.syncLossCounter++;            
+        toothSystemCount = 1; // first tooth after gap is always 1
+        toothCurrentCount = 1; // Reset as we've lost sync
+      }
+    }
+    else
+    { 
+      //Recalc the new filter value, only do this on the single gap tooth 
+      setFilter(curGap);  
+    }
+    renixSystemLastMinusOneToothTime = renixSystemLastToothTime; // needed for target gap calculation
+    renixSystemLastToothTime = curTime;
+
+    if( toothSystemCount == 12  || toothLastToothTime == 0) // toothLastToothTime used to ensure we set the value so the code that handles the fuel pump in speeduino.ini has a value to use once the engine is running.
+    {
+      toothCurrentCount++;
+
+      if( (configPage2.nCylinders == 6 && toothCurrentCount == 7) ||    // 6 Pretend teeth on the 66 tooth wheel, if get to severn rotate round back to first tooth
+          (configPage2.nCylinders == 4 && toothCurrentCount == 5 ) )    // 4 Pretend teeth on the 44 tooth wheel, if get to five rotate round back to first tooth
+      {
+        toothOneMinusOneTime = toothOneTime;
+        toothOneTime = curTime;
+        decoderStatus.syncStatus = SyncStatus::Full;
+        currentStatus.startRevolutions++; //Counter               
+        revolutionOne = !revolutionOne;
+        toothCurrentCount = 1;  
+      }
+
+      toothSystemCount = 1;
+      toothLastMinusOneToothTime = toothLastToothTime;
+      toothLastToothTime = curTime; 
+      publishToothEvent();
+
+      //NEW IGNITION MODE
+      if( (isPerToothTimingEnabled()) && (currentStatus.rotationStatus!=EngineRotationStatus::Cranking) ) 
+      {
+        int16_t crankAngle = ( (toothCurrentCount - 1) * triggerToothAngle ) + configPage4.triggerAngle;
+        if( (configPage4.sparkMode == IGN_MODE_SEQUENTIAL) && (revolutionOne == true) && (configPage4.TrigSpeed == CRANK_SPEED) )
+        {
+          crankAngle += 360;
+          checkPerToothTiming(crankAngle, (configPage4.triggerTeeth + toothCurrentCount)); 
+        }
+        else{ checkPerToothTiming(crankAngle, toothCurrentCount); }
+      }
+    }
+  } 
+}
+
+static uint16_t __attribute__((noinline)) calcEndTeeth_Renix(const IgnitionSchedule &schedule, uint8_t toothAdder) {
+  int16_t tempEndTooth = schedule.dischargeAngle - configPage4.triggerAngle;
+#ifdef USE_LIBDIVIDE
+  tempEndTooth = libdivide::libdivide_s16_do(tempEndTooth, &divTriggerToothAngle);
+#else
+  tempEndTooth = tempEndTooth / (int16_t)triggerToothAngle;
+#endif  
+  tempEndTooth = tempEndTooth - 1;
+  // Clamp to tooth count
+  return clampToActualTeeth(clampToToothCount(tempEndTooth, toothAdder), toothAdder);
+}
+
+static void triggerSetEndTeeth_Renix(void)
+{
+  byte toothAdder = 0;
+  if( (configPage4.sparkMode == IGN_MODE_SEQUENTIAL) && (configPage4.TrigSpeed == CRANK_SPEED) ) { toothAdder = configPage4.triggerTeeth; }
+
+  //Temp variables are used here to avoid potential issues if a trigger interrupt occurs part way through this function
+
+  ignitionEndTeeth[0] = calcEndTeeth_Renix(ignitionSchedule1, toothAdder);
+#if (IGN_CHANNELS >= 2)
+  ignitionEndTeeth[1] = calcEndTeeth_Renix(ignitionSchedule2, toothAdder);
+  currentStatus.canin[1] = ignitionEndTeeth[1];
+#endif
+#if (IGN_CHANNELS >= 3)
+  ignitionEndTeeth[2] = calcEndTeeth_Renix(ignitionSchedule3, toothAdder);
+#endif
+#if (IGN_CHANNELS >= 4)
+  ignitionEndTeeth[3] = calcEndTeeth_Renix(ignitionSchedule4, toothAdder);
+#endif
+#if IGN_CHANNELS >= 5
+  ignitionEndTeeth[4] = calcEndTeeth_Renix(ignitionSchedule5, toothAdder);
+#endif
+#if IGN_CHANNELS >= 6
+  ignitionEndTeeth[5] = calcEndTeeth_Renix(ignitionSchedule6, toothAdder);
+#endif
+#if IGN_CHANNELS >= 7
+  ignitionEndTeeth[6] = calcEndTeeth_Renix(ignitionSchedule7, toothAdder);
+#endif
+#if IGN_CHANNELS >= 8
+  ignitionEndTeeth[7] = calcEndTeeth_Renix(ignitionSchedule8, toothAdder);
+#endif
+}
+
+decoder_t  __attribute__((optimize("Os"))) triggerSetup_Renix(void)
+{
+  decoderFeatures = decoder_features_t();
+	sharedDecoderReset();
+  if( configPage2.nCylinders == 4)
+  {
+    triggerToothAngle = 90; //The number of degrees that passes from tooth to tooth (primary) this changes between 41 and 49 degrees
+    configPage4.triggerTeeth = 4; // wheel has 44 teeth but we use these to work out which tooth angle to use, therefore speeduino thinks we only have 8 teeth.
+    configPage4.triggerMissingTeeth = 0;
+    triggerActualTeeth = 4; //The number of teeth we're pretending physically existing on the wheel.
+    triggerFilterTime = (MICROS_PER_SEC / (MAX_RPM / 60U * 44U)); //Trigger filter time is the shortest possible time (in uS) that there can be between crank teeth (ie at max RPM). Any pulses that occur faster than this time will be discarded as noise
+  }
+  else if (configPage2.nCylinders == 6)
+  {
+    triggerToothAngle = 60;
+    configPage4.triggerTeeth = 6; // wheel has 44 teeth but we use these to work out which tooth angle to use, therefore speeduino thinks we only have 6 teeth.
+    configPage4.triggerMissingTeeth = 0;
+    triggerActualTeeth = 6; //The number of teeth we're pretending physically existing on the wheel.
+    triggerFilterTime = (MICROS_PER_SEC / (MAX_RPM / 60U * 66U)); //Trigger filter time is the shortest possible time (in uS) that there can be between crank teeth (ie at max RPM). Any pulses that occur faster than this time will be discarded as noise
+  }
+
+  MAX_STALL_TIME = ((MICROS_PER_DEG_1_RPM/50U) * triggerToothAngle); //Minimum 50rpm. (3333uS is the time per degree at 50rpm). Largest gap between teeth is 90 or 60 degrees depending on decoder.
+  decoderFeatures.supportsPerToothIgnition = true;
+
+  toothSystemCount = 1;
+  toothCurrentCount = 1;
+#ifdef USE_LIBDIVIDE
+  divTriggerToothAngle = libdivide::libdivide_s16_gen(triggerToothAngle);
+#endif  
+
+  return decoder_builder_t()
+                  .setPrimaryTrigger(triggerPri_Renix, getConfigPriTriggerEdge(configPage4))
+                  .setGetRPM(getRPM_missingTooth)
+                  .setGetCrankAngle(getCrankAngle_missingTooth)
+                  .setSetEndTeeth(triggerSetEndTeeth_Renix)
+                  .setReset(sharedDecoderReset)
+                  .setIsEngineRunning(sharedEngineIsRunning)
+                  .setGetStatus(sharedGetStatus)
+                  .setGetFeatures(sharedGetDecoderFeatures)
+                  .build();
+}
+
+/** @} */
@@ -0,0 +1,379 @@
+#include "decoder_shared.h"
+
+/*****************************************************************
+ * Rover MEMS decoder
+ * Covers multiple trigger wheels used interchanbably over the range of MEMS units
+ * Specifically covers teeth patterns on the primary trigger (crank)
+ * 3 gap 14 gap 2 gap 13 gap
+ * 11 gap 5 gap 12 gap 4 gap 
+ * 2 gap 14 gap 3 gap 13 gap 
+ * 17 gap 17 gap 
+ *
+ * Support no cam, single tooth Cam (or half moon cam), and multi tooth (5-3-2 teeth)
+ *
+ * @defgroup dec_rover_mems Rover MEMS all versions including T Series, O Series, Mini and K Series
+ * @{
+ */
+#define ID_TOOTH_PATTERN 0 // have we identified teeth to skip for calculating RPM?
+#define SKIP_TOOTH1 1
+#define SKIP_TOOTH2 2
+#define SKIP_TOOTH3 3
+#define SKIP_TOOTH4 4
+
+volatile uint32_t roverMEMSTeethSeen = 0; // used for flywheel gap pattern matching. The patterns are 32 bits (unsigned long is 64 bits on some hosts)
+
+static void triggerRoverMEMSCommon(uint32_t curTime)
+{
+  // pattern 1 isn't unique & if we don't have a cam we need special code to identify if we're tooth 18 or 36 - this allows batch injection but not spark to run
+  // as we have to be greater than 18 teeth when using the cam this code also works for that.
+  if( toothCurrentCount > 18) 
+  {
+    toothCurrentCount = 1;
+    toothOneMinusOneTime = toothOneTime;
+    toothOneTime = curTime;
+    revolutionOne = !revolutionOne; //Flip sequential revolution tracker   
+  }
+
+  if( (configPage4.sparkMode == IGN_MODE_SEQUENTIAL) || (configPage2.injLayout == INJ_SEQUENTIAL) )
+  {
+    //If either fuel or ignition is sequential, only declare sync if the cam tooth has been seen OR if the missing wheel is on the cam
+    if( (secondaryToothCount > 0) || (configPage4.TrigSpeed == CAM_SPEED) )
+    {
+      decoderStatus.syncStatus = SyncStatus::Full; //the engine is fully synced so clear the Half Sync bit
+      if(configPage4.trigPatternSec == SEC_TRIGGER_SINGLE) { secondaryToothCount = 0; } //Reset the secondary tooth counter to prevent it overflowing
+    }
+    else if(decoderStatus.syncStatus!=SyncStatus::Full) 
+    { decoderStatus.syncStatus = SyncStatus::Partial; } //If there is primary trigger but no secondary we only have half sync.
+  }
+  else { decoderStatus.syncStatus = SyncStatus::Partial; } //If nothing is using sequential, we  set half sync bit
+
+  currentStatus.startRevolutions++;  
+}
+
+static void triggerPri_RoverMEMS(void)
+{
+  uint32_t curTime = micros();
+  curGap = curTime - toothLastToothTime;      
+
+  if ( curGap >= triggerFilterTime ) //Pulses should never be less than triggerFilterTime, so if they are it means a false trigger. (A 36-1 wheel at 8000pm will have triggers approx. every 200uS)
+  {
+    if( (toothLastToothTime > 0) && (toothLastMinusOneToothTime > 0) ) // have we seen more than 1 tooth so we start processing
+    {   
+      //Begin the missing tooth detection
+      targetGap = (3 * (toothLastToothTime - toothLastMinusOneToothTime)) >> 1;  //Multiply by 1.5 (Checks for a gap 1.5x greater than the last one) (Uses bitshift to multiply by 3 then divide by 2. Much faster than multiplying by 1.5)
+
+      if ( curGap > targetGap) // we've found a gap
+      {
+        roverMEMSTeethSeen = roverMEMSTeethSeen << 2; // add the space for the gap and the tooth we've just seen so shift 2 bits
+        roverMEMSTeethSeen++; // add the tooth seen to the variable
+        toothCurrentCount++; // Increment the tooth counter on the wheel (used to spot a revolution and trigger igition timing)
+
+        // the missing tooth gap messing up timing as it appears in different parts of the cycle. Don't update setFilter as it would be wrong with the gap
+        toothCurrentCount++;
+      }
+      else //Regular (non-missing) tooth so update things
+      {    
+        roverMEMSTeethSeen = roverMEMSTeethSeen << 1; // make a space, shift the bits 1 place to the left
+        roverMEMSTeethSeen++; // add the tooth seen
+        toothCurrentCount++; //Increment the tooth counter on the wheel (used to spot a revolution)
+        setFilter(curGap);
+      }
+
+      // reduce checks to minimise cpu load when looking for key point to identify where we are on the wheel
+      if( toothCurrentCount >= triggerActualTeeth )
+      {                           //12345678901234567890123456789012 
+        if( roverMEMSTeethSeen == 0b11111101111111011111111110111111) // Binary pattern for trigger pattern 9-7-10-6- (#5)
+        {
+          if(toothAngles[ID_TOOTH_PATTERN] != 5)
+          {
+            //teeth to skip when calculating RPM as they've just had a gap
+            toothAngles[SKIP_TOOTH1] = 1;
+            toothAngles[SKIP_TOOTH2] = 11;
+            toothAngles[SKIP_TOOTH3] = 19;
+            toothAngles[SKIP_TOOTH4] = 30;
+            toothAngles[ID_TOOTH_PATTERN] = 5;
+            configPage4.triggerMissingTeeth = 4; // this could be read in from the config file, but people could adjust it.
+            triggerActualTeeth = 36; // should be 32 if not hacking toothcounter 
+          }  
+          triggerRoverMEMSCommon(curTime);                         
+        }                             //123456789012345678901234567890123456
+        else if( roverMEMSTeethSeen == 0b11011101111111111111101101111111) // Binary pattern for trigger pattern 3-14-2-13- (#4)
+        {
+          if(toothAngles[ID_TOOTH_PATTERN] != 4)
+          {
+            //teeth to skip when calculating RPM as they've just had a gap
+            toothAngles[SKIP_TOOTH1] = 8;
+            toothAngles[SKIP_TOOTH2] = 11;
+            toothAngles[SKIP_TOOTH3] = 25;
+            toothAngles[SKIP_TOOTH4] = 27;
+            toothAngles[ID_TOOTH_PATTERN] = 4;
+            configPage4.triggerMissingTeeth = 4; // this could be read in from the config file, but people could adjust it.
+            triggerActualTeeth = 36; // should be 32 if not hacking toothcounter 
+          }  
+          triggerRoverMEMSCommon(curTime);                         
+        }                             //123456789012345678901234567890123456
+        else if(roverMEMSTeethSeen == 0b11011011111111111111011101111111) // Binary pattern for trigger pattern 2-14-3-13- (#3)
+        {
+          if(toothAngles[ID_TOOTH_PATTERN] != 3)
+          {
+            //teeth to skip when calculating RPM as they've just had a gap
+            toothAngles[SKIP_TOOTH1] = 8;
+            toothAngles[SKIP_TOOTH2] = 10;
+            toothAngles[SKIP_TOOTH3] = 24;
+            toothAngles[SKIP_TOOTH4] = 27;
+            toothAngles[ID_TOOTH_PATTERN] = 3;
+            configPage4.triggerMissingTeeth = 4; // this could be read in from the config file, but people could adjust it.
+            triggerActualTeeth = 36; // should be 32 if not hacking toothcounter 
+          } 
+          triggerRoverMEMSCommon(curTime);                           
+        }                             //12345678901234567890123456789012
+        else if(roverMEMSTeethSeen == 0b11111101111101111111111110111101) // Binary pattern for trigger pattern 11-5-12-4- (#2)
+        {
+          if(toothAngles[ID_TOOTH_PATTERN] != 2)
+          {
+            //teeth to skip when calculating RPM as they've just had a gap
+            toothAngles[SKIP_TOOTH1] = 1;
+            toothAngles[SKIP_TOOTH2] = 12;
+            toothAngles[SKIP_TOOTH3] = 17;
+            toothAngles[SKIP_TOOTH4] = 29;
+            toothAngles[ID_TOOTH_PATTERN] = 2;
+            configPage4.triggerMissingTeeth = 4; // this could be read in from the config file, but people could adjust it.
+            triggerActualTeeth = 36; // should be 32 if not hacking toothcounter 
+          }  
+          triggerRoverMEMSCommon(curTime);  
+        }                             //12345678901234567890123456789012
+        else if(roverMEMSTeethSeen == 0b11111111111101111111111111111101) // Binary pattern for trigger pattern 17-17- (#1)
+        {
+          if(toothAngles[ID_TOOTH_PATTERN] != 1)
+          {
+            //teeth to skip when calculating RPM as they've just had a gap
+            toothAngles[SKIP_TOOTH1] = 1;
+            toothAngles[SKIP_TOOTH2] = 18;
+            toothAngles[ID_TOOTH_PATTERN] = 1;
+            configPage4.triggerMissingTeeth = 2; // this should be read in from the config file, but people could adjust it.            
+            triggerActualTeeth = 36; // should be 34 if not hacking toothcounter 
+          }
+          triggerRoverMEMSCommon(curTime); 
+        }
+        else if(toothCurrentCount > triggerActualTeeth+1) // no patterns match after a rotation when we only need 32 teeth to match, we've lost sync
+        {
+          decoderStatus.syncStatus = SyncStatus::None;
+          currentStatus.syncLossCounter++;              
+        }
+      }
+    }
+    
+    toothLastMinusOneToothTime = toothLastToothTime;
+    toothLastToothTime = curTime;
+    publishToothEvent();
+
+    //NEW IGNITION MODE
+    if( (isPerToothTimingEnabled()) && (currentStatus.rotationStatus!=EngineRotationStatus::Cranking) ) 
+    {  
+      int16_t crankAngle = ( (toothCurrentCount-1) * triggerToothAngle ) + configPage4.triggerAngle;
+      if( (configPage4.sparkMode == IGN_MODE_SEQUENTIAL) && (revolutionOne == true))
+      { crankAngle += 360; checkPerToothTiming(crankAngle, (configPage4.triggerTeeth + toothCurrentCount)); }
+      else
+      { checkPerToothTiming(crankAngle, toothCurrentCount); }
+    }     
+  }
+
+}
+
+static void triggerSec_RoverMEMS(void) 
+{
+  uint32_t curTime2 = micros();
+  curGap2 = curTime2 - toothLastSecToothTime;
+
+  //Safety check for initial startup
+  if( (toothLastSecToothTime == 0) )
+  { 
+    targetGap2 = curGap * 2;
+    curGap2 = 0; 
+    toothLastSecToothTime = curTime2;
+  }
+  
+  if ( curGap2 >= triggerSecFilterTime )
+  {
+    secondaryToothCount++;
+    toothLastSecToothTime = curTime2;
+    
+
+    //Record the VVT Angle
+    if( configPage6.vvtEnabled > 0 &&
+        ( (configPage4.trigPatternSec == SEC_TRIGGER_SINGLE) || 
+          (configPage4.trigPatternSec == SEC_TRIGGER_5_3_2 && secondaryToothCount == 6 ) ) )
+    {
+      int16_t curAngle;
+      curAngle = currentStatus.decoder.getCrankAngle();
+      while(curAngle > 360) { curAngle -= 360; }
+      curAngle -= configPage4.triggerAngle; //Value at TDC
+      if( configPage6.vvtMode == VVT_MODE_CLOSED_LOOP ) { curAngle -= configPage10.vvtCLMinAng; }
+
+      currentStatus.vvt1Angle = curAngle;
+    }
+
+    if(configPage4.trigPatternSec == SEC_TRIGGER_SINGLE)
+    {
+      //Standard single tooth cam trigger
+      revolutionOne = true;
+      triggerSecFilterTime = curGap2 >> 1; //Next secondary filter is half the current gap        
+    }
+    else if (configPage4.trigPatternSec == SEC_TRIGGER_5_3_2) // multi tooth cam 
+    {
+      if (curGap2 < targetGap2) // ie normal tooth sized gap, not a single or double gap
+      {
+        triggerSecFilterTime = curGap2 >> 1; //Next secondary filter is half the current gap        
+        targetGap2 = (3 * (curGap2)) >> 1;  //Multiply by 1.5 (Checks for a gap 1.5x greater than the last one) (Uses bitshift to multiply by 3 then divide by 2. Much faster than multiplying by 1.5)        
+      }
+      else
+      {  
+        // gap either single or double - nb remember we've got the tooth after the gap, so on the 5 tooth pattern we'll see here tooth 6
+        if(secondaryToothCount == 6)
+        {
+          // if we've got the tooth after the gap from reading 5 teeth we're on cycle 360-720 & tooth 18-36
+          revolutionOne = false;
+          if(toothCurrentCount < 19)
+          {
+            toothCurrentCount += 18;
+          }
+        }
+        else if (secondaryToothCount == 4)
+        {
+          // we've got the tooth after the gap from reading 3 teeth we're on cycle 0-360 & tooth 1-18
+          revolutionOne = true;
+          if(toothCurrentCount > 17)
+          {
+            toothCurrentCount -= 18;
+          }
+        }
+        else if (secondaryToothCount == 3)
+        {
+          // if we've got the tooth after the gap from reading 2 teeth we're on cycle 0-360 & tooth 18-36
+          revolutionOne = true;
+          if(toothCurrentCount < 19)
+          {
+            toothCurrentCount += 18;
+          }
+        }
+        secondaryToothCount = 1; // as we've had a gap we need to reset to this being the first tooth after the gap
+      }
+    }
+    publishToothEvent(); //revolutionOne & toothCurrentCount may have changed
+  } //Trigger filter
+}
+
+static uint16_t getRPM_RoverMEMS(void) 
+{
+  uint16_t tempRPM = 0;
+
+  if( currentStatus.RPM < currentStatus.crankRPM)
+  {
+    if( (toothCurrentCount != (unsigned int) toothAngles[SKIP_TOOTH1]) && 
+        (toothCurrentCount != (unsigned int) toothAngles[SKIP_TOOTH2]) && 
+        (toothCurrentCount != (unsigned int) toothAngles[SKIP_TOOTH3]) && 
+        (toothCurrentCount != (unsigned int) toothAngles[SKIP_TOOTH4]) )
+    { tempRPM = crankingGetRPM(36, CRANK_SPEED); }
+    else
+    { tempRPM = currentStatus.RPM; } //Can't do per tooth RPM as the missing tooth messes the calculation
+  }
+  else
+  { tempRPM = stdGetRPM(CRANK_SPEED); }
+  return tempRPM;
+}
+
+static int16_t __attribute__((noinline)) calcEndTooth_RoverMEMS(const IgnitionSchedule &schedule, uint8_t toothAdder) {
+  int16_t channelToothAdder = 36 + (int16_t)toothAdder;
+  int16_t tempIgnitionEndTooth = ( (schedule.dischargeAngle - configPage4.triggerAngle) / (int16_t)(10) ) - 1;
+  if(tempIgnitionEndTooth > channelToothAdder) { tempIgnitionEndTooth -= channelToothAdder; }
+  if(tempIgnitionEndTooth <= 0) { tempIgnitionEndTooth += channelToothAdder; }
+  if(tempIgnitionEndTooth > channelToothAdder) { tempIgnitionEndTooth = channelToothAdder; }
+ return tempIgnitionEndTooth;
+}
+
+static void triggerSetEndTeeth_RoverMEMS(void)
+{
+  //Temp variables are used here to avoid potential issues if a trigger interrupt occurs part way through this function
+  int16_t tempIgnitionEndTooth[5]; // cheating with the array - location 1 is spark 1, location 0 not used.   
+  int16_t toothAdder = 0;
+
+  if( (configPage4.sparkMode == IGN_MODE_SEQUENTIAL) && (configPage4.TrigSpeed == CRANK_SPEED) ) { toothAdder = 36; }
+
+  tempIgnitionEndTooth[1] = calcEndTooth_RoverMEMS(ignitionSchedule1, toothAdder);
+#if (IGN_CHANNELS >= 2)
+  tempIgnitionEndTooth[2] = calcEndTooth_RoverMEMS(ignitionSchedule2, toothAdder);
+#endif
+#if (IGN_CHANNELS >= 3)
+  tempIgnitionEndTooth[3] = calcEndTooth_RoverMEMS(ignitionSchedule3, toothAdder);
+#endif
+#if (IGN_CHANNELS >= 4)
+  tempIgnitionEndTooth[4] = calcEndTooth_RoverMEMS(ignitionSchedule4, toothAdder);
+#endif
+
+  // take into account the missing teeth on the Rover flywheels
+  int tempCount=0;
+ 
+  if(configPage4.sparkMode == IGN_MODE_SEQUENTIAL)
+  {
+    // check the calculated trigger tooth exists, if it doesn't use the previous tooth
+    // nb the toothAngles[x] holds the tooth after the gap, hence the '-1' to see if it matches a gap
+ 
+    for(tempCount=1;tempCount <5;tempCount++)
+    {
+      if(tempIgnitionEndTooth[tempCount] == (toothAngles[1]) || tempIgnitionEndTooth[tempCount] == (toothAngles[2]) ||
+         tempIgnitionEndTooth[tempCount] == (toothAngles[3]) || tempIgnitionEndTooth[tempCount] == (toothAngles[4]) ||
+         tempIgnitionEndTooth[tempCount] == (36 + toothAngles[1]) || tempIgnitionEndTooth[tempCount] == (36 + toothAngles[2]) ||
+         tempIgnitionEndTooth[tempCount] == (36 + toothAngles[3]) || tempIgnitionEndTooth[tempCount] == (36 + toothAngles[4])  )
+      { tempIgnitionEndTooth[tempCount]--; }
+    }
+  }
+  else
+  {
+    for(tempCount=1;tempCount<5;tempCount++)
+    {
+      if(tempIgnitionEndTooth[tempCount] == (toothAngles[1]) || tempIgnitionEndTooth[tempCount] == (toothAngles[2]) )
+      { tempIgnitionEndTooth[tempCount]--; }  
+    }
+  }
+  
+  
+  ignitionEndTeeth[0] = tempIgnitionEndTooth[1];  
+  ignitionEndTeeth[1] = tempIgnitionEndTooth[2];
+  ignitionEndTeeth[2] = tempIgnitionEndTooth[3];
+  ignitionEndTeeth[3] = tempIgnitionEndTooth[4];
+}
+
+decoder_t  __attribute__((optimize("Os"))) triggerSetup_RoverMEMS(void)
+{
+  decoderFeatures = decoder_features_t();
+  for(toothOneTime = 0; toothOneTime < 10; toothOneTime++)   // repurpose variable temporarily to help clear ToothAngles.
+    { toothAngles[toothOneTime] = 0; }// Repurpose ToothAngles to store data needed for this implementation.
+ 
+  triggerFilterTime = (MICROS_PER_SEC / (MAX_RPM / 60U * 36U)); //Trigger filter time is the shortest possible time (in uS) that there can be between crank teeth (ie at max RPM). Any pulses that occur faster than this time will be discarded as noise
+  triggerSecFilterTime = (MICROS_PER_SEC / (MAX_RPM / 60U)); // only 1 tooth on the wheel not 36
+
+  configPage4.triggerTeeth = 36;
+  triggerToothAngle = 360 / configPage4.triggerTeeth; //The number of degrees that passes from tooth to tooth 360 / 36 theortical teeth
+  triggerActualTeeth = 36; //The number of physical teeth on the wheel. Need to fix now so we can identify the wheel on the first rotation and not risk a  type 1 wheel not being spotted
+  toothLastMinusOneToothTime = 0;
+  toothCurrentCount = 0; // current tooth
+  toothOneTime = 0;
+  toothOneMinusOneTime = 0;
+  revolutionOne=0;
+
+  MAX_STALL_TIME = ((MICROS_PER_DEG_1_RPM/50U) * triggerToothAngle * 2U); //Minimum 50rpm. (3333uS is the time per degree at 50rpm)
+  decoderFeatures.supportsPerToothIgnition = true;
+
+  return decoder_builder_t()
+                  .setPrimaryTrigger(triggerPri_RoverMEMS, getConfigPriTriggerEdge(configPage4))
+                  .setSecondaryTrigger(triggerSec_RoverMEMS, getConfigSecTriggerEdge(configPage4)) 
+                  .setGetRPM(getRPM_RoverMEMS)
+                  .setSetEndTeeth(triggerSetEndTeeth_RoverMEMS)
+                  .setGetCrankAngle(getCrankAngle_missingTooth)   
+                  .setReset(sharedDecoderReset)
+                  .setIsEngineRunning(sharedEngineIsRunning)
+                  .setGetStatus(sharedGetStatus)
+                  .setGetFeatures(sharedGetDecoderFeatures)
+                  .build();
+}
+/** @} */
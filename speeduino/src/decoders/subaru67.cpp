@@ -0,0 +1,281 @@
+#include "decoder_shared.h"
+
+/** Subaru 6/7 Trigger pattern decoder for 6 tooth (irregularly spaced) crank and 7 tooth (also fairly irregular) cam wheels (eg late 90's Impreza 2.2).
+This seems to be present in late 90's Subaru. In 2001 Subaru moved to 36-2-2-2 (See: http://www.vems.hu/wiki/index.php?page=InputTrigger%2FSubaruTrigger ).
+* @defgroup dec_subaru_6_7 Subaru 6/7
+* @{
+*/
+static void triggerPri_Subaru67(void)
+{
+  uint32_t curTime = micros();
+  curGap = curTime - toothLastToothTime;
+  if ( curGap < triggerFilterTime ) 
+  { return; }
+
+  toothCurrentCount++; //Increment the tooth counter
+  toothSystemCount++; //Used to count the number of primary pulses that have occurred since the last secondary. Is part of the noise filtering system.
+  decoderStatus.validTrigger = true; //Flag this pulse as being a valid trigger (ie that it passed filters)
+
+  toothLastMinusOneToothTime = toothLastToothTime;
+  toothLastToothTime = curTime;
+
+ 
+  if(toothCurrentCount > 13) //can't have more than 12 teeth so have lost sync 
+  {
+    toothCurrentCount = 0; 
+    decoderStatus.syncStatus = SyncStatus::None; 
+    currentStatus.syncLossCounter++;
+  } 
+
+  //Sync is determined by counting the number of cam teeth that have passed between the crank teeth
+  switch(secondaryToothCount)
+  {
+    case 0:
+      //If no teeth have passed, we can't do anything
+      break;
+
+    case 1:
+      //Can't do anything with a single pulse from the cam either (We need either 2 or 3 pulses)
+      if(toothCurrentCount == 5 || toothCurrentCount == 11)
+      { decoderStatus.syncStatus = SyncStatus::Full; }
+      else
+      { 
+        decoderStatus.syncStatus = SyncStatus::None; 
+        currentStatus.syncLossCounter++;     
+        toothCurrentCount = 5; // we don't know if its 5 or 11, but we'll be right 50% of the time and speed up getting sync 50%
+      }
+      secondaryToothCount = 0;
+      break;
+
+    case 2:
+      if (toothCurrentCount == 8)  
+      {  decoderStatus.syncStatus = SyncStatus::Full; }
+      else
+      { 
+        decoderStatus.syncStatus = SyncStatus::None;
+        currentStatus.syncLossCounter++;
+        toothCurrentCount = 8;
+      }          
+      secondaryToothCount = 0;
+      break;
+
+    case 3:      
+      if( toothCurrentCount == 2)
+      {  decoderStatus.syncStatus = SyncStatus::Full; }
+      else
+      {  
+        decoderStatus.syncStatus = SyncStatus::None; 
+        currentStatus.syncLossCounter++;
+        toothCurrentCount = 2;
+      }
+      secondaryToothCount = 0;
+      break;
+
+    default:
+      //Almost certainly due to noise or cranking stop/start
+      decoderStatus.syncStatus = SyncStatus::None;
+      decoderStatus.toothAngleIsCorrect = false;
+      currentStatus.syncLossCounter++;
+      secondaryToothCount = 0;
+      break;
+  }
+
+  //Check sync again
+  if ( decoderStatus.syncStatus==SyncStatus::Full )
+  {
+    //Locked timing during cranking. This is fixed at 10* BTDC.
+    if ( (currentStatus.rotationStatus==EngineRotationStatus::Cranking) && configPage4.ignCranklock)
+    {
+      if( (toothCurrentCount == 1) || (toothCurrentCount == 7) ) { endCoilCharge(1U); endCoilCharge(3U); }
+      else if( (toothCurrentCount == 4) || (toothCurrentCount == 10) ) { endCoilCharge(2U); endCoilCharge(4U); }
+    }
+
+    if ( toothCurrentCount > 12 ) // done 720 degrees so increment rotation
+    {
+      toothCurrentCount = 1;
+      toothOneMinusOneTime = toothOneTime;
+      toothOneTime = curTime;
+      currentStatus.startRevolutions++; //Counter
+    }
+
+    //Set the last angle between teeth for better calc accuracy
+    if(toothCurrentCount == 1) { triggerToothAngle = 55; } //Special case for tooth 1
+    else if(toothCurrentCount == 2) { triggerToothAngle = 93; } //Special case for tooth 2
+    else { triggerToothAngle = toothAngles[(toothCurrentCount-1)] - toothAngles[(toothCurrentCount-2)]; }
+    decoderStatus.toothAngleIsCorrect = true;
+
+
+    //NEW IGNITION MODE
+    if( (isPerToothTimingEnabled()) && (currentStatus.rotationStatus!=EngineRotationStatus::Cranking) ) 
+    {
+      int16_t crankAngle = toothAngles[(toothCurrentCount - 1)] + configPage4.triggerAngle;
+      if( (configPage4.sparkMode != IGN_MODE_SEQUENTIAL) )
+      {
+        crankAngle = toothAngles[(toothCurrentCount-1)];
+
+        //Handle non-sequential tooth counts 
+        if( (configPage4.sparkMode != IGN_MODE_SEQUENTIAL) && (toothCurrentCount > 6) ) { checkPerToothTiming(crankAngle, (toothCurrentCount-6) ); }
+        else { checkPerToothTiming(crankAngle, toothCurrentCount); }
+      }
+      else{ checkPerToothTiming(crankAngle, toothCurrentCount); }
+    }
+  //Recalc the new filter value
+  //setFilter(curGap);
+  }
+ }
+
+static void triggerSec_Subaru67(void)
+{
+  if( ((toothSystemCount == 0) || (toothSystemCount == 3)) )
+  {
+    uint32_t curTime2 = micros();
+    curGap2 = curTime2 - toothLastSecToothTime;
+    
+    if ( curGap2 > triggerSecFilterTime ) 
+    {
+      toothLastSecToothTime = curTime2;
+      secondaryToothCount++;
+      toothSystemCount = 0;
+      
+      if(secondaryToothCount > 1)
+      {
+        //Set filter at 25% of the current speed
+        //Note that this can only be set on the 2nd or 3rd cam tooth in each set. 
+        triggerSecFilterTime = curGap2 >> 2;
+      }
+      else { triggerSecFilterTime = 0; } //Filter disabled  
+
+    }
+  }
+  else
+  {
+    //Sanity check
+    if(toothSystemCount > 3)
+    { 
+      toothSystemCount = 0; 
+      secondaryToothCount = 1;
+      decoderStatus.syncStatus = SyncStatus::None; // impossible to have more than 3 crank teeth between cam teeth - must have noise but can't have sync
+      currentStatus.syncLossCounter++;
+    }
+    secondaryToothCount = 0;
+  }
+
+}
+
+static uint16_t getRPM_Subaru67(void)
+{
+  //if(currentStatus.RPM < currentStatus.crankRPM) { return crankingGetRPM(configPage4.triggerTeeth); }
+
+  uint16_t tempRPM = 0;
+  if(currentStatus.startRevolutions > 0)
+  {
+    //As the tooth count is over 720 degrees
+    tempRPM = stdGetRPM(CAM_SPEED);
+  }
+  return tempRPM;
+}
+
+static int16_t getCrankAngle_Subaru67(uint32_t currMicros)
+{
+  int crankAngle = 0;
+  if( decoderStatus.syncStatus==SyncStatus::Full )
+  {
+    //This is the current angle ATDC the engine is at. This is the last known position based on what tooth was last 'seen'. It is only accurate to the resolution of the trigger wheel (Eg 36-1 is 10 degrees)
+    unsigned long tempToothLastToothTime;
+    int tempToothCurrentCount;
+    //Grab some variables that are used in the trigger code and assign them to temp variables.
+    noInterrupts();
+    tempToothCurrentCount = toothCurrentCount;
+    tempToothLastToothTime = toothLastToothTime;
+    interrupts();
+
+    crankAngle = toothAngles[(tempToothCurrentCount - 1)] + configPage4.triggerAngle; //Perform a lookup of the fixed toothAngles array to find what the angle of the last tooth passed was.
+
+    //Estimate the number of degrees travelled since the last tooth}
+    crankAngle += timeToAngleIntervalTooth(currMicros - tempToothLastToothTime);
+
+    if (crankAngle >= 720) { crankAngle -= 720; }
+    if (crankAngle < 0) { crankAngle += 360; }
+  }
+
+  return crankAngle;
+}
+
+static void triggerSetEndTeeth_Subaru67(void)
+{
+  if(configPage4.sparkMode == IGN_MODE_SEQUENTIAL)
+  {
+    if(currentStatus.advance >= 10 ) 
+    { 
+      ignitionEndTeeth[0] = 12;
+      ignitionEndTeeth[1] = 3;
+      ignitionEndTeeth[2] = 6;
+      ignitionEndTeeth[3] = 9;
+    }
+    else 
+    { 
+      ignitionEndTeeth[0] = 1;
+      ignitionEndTeeth[1] = 4;
+      ignitionEndTeeth[2] = 7;
+      ignitionEndTeeth[3] = 10;
+    }
+  }
+  else    
+  {
+    if(currentStatus.advance >= 10 ) 
+    { 
+      ignitionEndTeeth[0] = 6;
+      ignitionEndTeeth[1] = 3;
+      //ignitionEndTeeth[2] = 6;
+      //ignitionEndTeeth[3] = 9;
+    }
+    else 
+    { 
+      ignitionEndTeeth[0] = 1;
+      ignitionEndTeeth[1] = 4;
+      //ignitionEndTeeth[2] = 7;
+      //ignitionEndTeeth[3] = 10;
+    }
+  }
+}
+
+decoder_t  __attribute__((optimize("Os"))) triggerSetup_Subaru67(void)
+{
+  decoderFeatures = decoder_features_t();
+	sharedDecoderReset();
+  triggerFilterTime = (MICROS_PER_SEC / (MAX_RPM / 60U * 360UL)); //Trigger filter time is the shortest possible time (in uS) that there can be between crank teeth (ie at max RPM). Any pulses that occur faster than this time will be discarded as noise
+  triggerSecFilterTime = 0;
+  decoderFeatures.supportsSequential = true;
+  decoderFeatures.supportsPerToothIgnition = true;
+  toothCurrentCount = 1;
+  triggerToothAngle = 2;
+  decoderStatus.toothAngleIsCorrect = false;
+  MAX_STALL_TIME = ((MICROS_PER_DEG_1_RPM/50U) * 93U); //Minimum 50rpm. (3333uS is the time per degree at 50rpm)
+
+  toothAngles[0] = 710; //tooth #1
+  toothAngles[1] = 83; //tooth #2
+  toothAngles[2] = 115; //tooth #3
+  toothAngles[3] = 170; //tooth #4
+  toothAngles[4] = toothAngles[1] + 180;
+  toothAngles[5] = toothAngles[2] + 180;
+  toothAngles[6] = toothAngles[3] + 180;
+  toothAngles[7] = toothAngles[1] + 360;
+  toothAngles[8] = toothAngles[2] + 360;
+  toothAngles[9] = toothAngles[3] + 360;
+  toothAngles[10] = toothAngles[1] + 540;
+  toothAngles[11] = toothAngles[2] + 540;
+
+  return decoder_builder_t()
+                  .setPrimaryTrigger(triggerPri_Subaru67, getConfigPriTriggerEdge(configPage4))
+                  .setSecondaryTrigger(triggerSec_Subaru67, FALLING)
+                  .setGetRPM(getRPM_Subaru67)
+                  .setGetCrankAngle(getCrankAngle_Subaru67)
+                  .setSetEndTeeth(triggerSetEndTeeth_Subaru67)
+                  .setReset(sharedDecoderReset)
+                  .setIsEngineRunning(sharedEngineIsRunning)
+                  .setGetStatus(sharedGetStatus)
+                  .setGetFeatures(sharedGetDecoderFeatures)
+                  .build();
+}
+
+/** @} */
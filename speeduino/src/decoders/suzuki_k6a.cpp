@@ -0,0 +1,334 @@
+#include "decoder_shared.h"
+
+/** Suzuki K6A 3 cylinder engine
+
+* (See: https://www.msextra.com/forums/viewtopic.php?t=74614)
+* @defgroup Suzuki_K6A Suzuki K6A 
+* @{
+*/
+static void triggerPri_SuzukiK6A(void)
+{
+  uint32_t curTime = micros();  
+  curGap = curTime - toothLastToothTime;
+  if ( (curGap >= triggerFilterTime) || (currentStatus.startRevolutions == 0U) )
+  {    
+    toothCurrentCount++;
+    decoderStatus.validTrigger = true; //Flag this pulse as being a valid trigger (ie that it passed filters)
+
+    toothLastMinusOneToothTime = toothLastToothTime;
+    toothLastToothTime = curTime;
+
+    // now to figure out if its a normal tooth or the extra sync tooth
+    // pattern is normally small tooth, big tooth, small tooth, big tooth. The extra tooth breaks the pattern go it goes, big tooth (curGap3), small tooth(curGap2), small tooth(curGap)
+    // reuse curGap2 and curGap3 (from secondary and Tertiary decoders) to store previous tooth sizes as not needed in this decoder.
+    
+    if ( (  curGap <= curGap2 ) && 
+         ( curGap2 <= curGap3 ) )
+    {
+      // cur Gap is smaller than last gap & last gap is smaller than gap before that - means we must be on sync tooth
+      toothCurrentCount = 6; // set tooth counter to correct tooth
+      decoderStatus.syncStatus = SyncStatus::Full;
+    }
+    
+    curGap3 = curGap2; // update values for next time we're in the loop
+    curGap2 = curGap;
+    
+    
+    if( (toothCurrentCount == (triggerActualTeeth + 1U)) && decoderStatus.syncStatus==SyncStatus::Full  )
+    {
+      // seen enough teeth to have a revolution of the crank
+      toothCurrentCount = 1; //Reset the counter
+      toothOneMinusOneTime = toothOneTime;
+      toothOneTime = curTime;
+      currentStatus.startRevolutions = currentStatus.startRevolutions + 2U; // increment for 2 revs as we do 720 degrees on the the crank       
+    }
+    else if (toothCurrentCount > (triggerActualTeeth + 1U))
+    {
+      // Lost sync
+      decoderStatus.syncStatus = SyncStatus::None; 
+      currentStatus.syncLossCounter++;
+      triggerFilterTime = 0;
+      toothCurrentCount=0;
+    } else {
+      // We have sync, but are part way through a revolution
+      // Nothing to do but keep MISRA happy.
+    }
+
+    // check gaps match with tooth to check we have sync 
+    // so if we *think* we've seen tooth 3 whose gap should be smaller than the previous tooth & it isn't, 
+    // then we've lost sync
+    switch (toothCurrentCount)
+    {
+      case 1:
+      case 3:      
+      case 5:      
+      case 6:
+        // current tooth gap is bigger than previous tooth gap = syncloss
+        // eg tooth 3 should be smaller than tooth 2 gap, if its not then we've lost sync and the tooth 3 we've just seen isn't really tooth 3
+        if (curGap > curGap2)
+        { 
+          decoderStatus.syncStatus = SyncStatus::None; 
+          currentStatus.syncLossCounter++;
+          triggerFilterTime = 0;
+          toothCurrentCount=2;
+        }          
+        break;
+
+      case 2:
+      case 4:
+      case 7:
+      default:
+        // current tooth gap is smaller than the previous tooth gap = syncloss
+        // eg tooth 2 should be bigger than tooth 1, if its not then we've got syncloss
+        if (curGap < curGap2)
+        { 
+          decoderStatus.syncStatus = SyncStatus::None; 
+          currentStatus.syncLossCounter++;
+          triggerFilterTime = 0;
+          toothCurrentCount=1;
+        }
+        break;
+    }
+
+    // Setup data to allow other areas of the system to work due to odd sized teeth - this could be merged with sync checking above, left separate to keep code clearer as its doing only one function at once
+    // % of filter are not based on previous tooth size but expected next tooth size
+    // triggerToothAngle is the size of the previous tooth not the future tooth
+    if (decoderStatus.syncStatus==SyncStatus::Full )
+    {
+      switch (toothCurrentCount) // Set tooth angle based on previous gap and triggerFilterTime based on previous gap and next gap
+      {
+        case 2:
+        case 4:
+          // equivalent of tooth 1 except we've not done rotation code yet so its 8
+          // 170 degree tooth, next tooth is 70
+          switch (configPage4.triggerFilter)
+          {
+            case 1: // 25 % 17 degrees
+              triggerFilterTime = rshift<3>((uint32_t)curGap);
+              break;
+            case 2: // 50 % 35 degrees
+              triggerFilterTime = rshift<3>((uint32_t)curGap) + rshift<4>((uint32_t)curGap);
+              break;
+            case 3: // 75 % 52 degrees
+              triggerFilterTime = rshift<2>((uint32_t)curGap) + rshift<4>((uint32_t)curGap);
+              break;
+            default:
+              triggerFilterTime = 0;
+              break;
+          }          
+          break;
+
+        case 5:
+          // 70 degrees, next tooth is 35
+          switch (configPage4.triggerFilter)
+          {
+            case 1: // 25 % 8 degrees
+              triggerFilterTime = rshift<3>((uint32_t)curGap);
+              break;
+            case 2: // 50 % 17 degrees
+              triggerFilterTime = rshift<2>((uint32_t)curGap);
+              break;
+            case 3: // 75 % 25 degrees
+              triggerFilterTime = rshift<2>((uint32_t)curGap) + rshift<3>((uint32_t)curGap);
+              break;
+            default:
+              triggerFilterTime = 0;
+              break;
+          }
+          break;
+
+        case 6:
+          // sync tooth, next tooth is 135
+          switch (configPage4.triggerFilter)
+          {
+            case 1: // 25 % 33 degrees
+              triggerFilterTime = curGap;
+              break;
+            case 2: // 50 % 67 degrees
+              triggerFilterTime = curGap * 2U;
+              break;
+            case 3: // 75 % 100 degrees
+              triggerFilterTime = curGap * 3U;
+              break;
+            default:
+              triggerFilterTime = 0;
+              break;
+          }
+          break;
+
+        case 7:
+          // 135 degre tooth, next tooth is 70
+          switch (configPage4.triggerFilter)
+          {
+            case 1: // 25 % 17 degrees
+              triggerFilterTime = rshift<3>((uint32_t)curGap);
+              break;
+            case 2: // 50 % 35 degrees
+              triggerFilterTime = rshift<2>((uint32_t)curGap);
+              break;
+            case 3: // 75 % 52 degrees
+              triggerFilterTime = rshift<2>((uint32_t)curGap) + rshift<3>((uint32_t)curGap);
+              break;
+            default:
+              triggerFilterTime = 0;
+              break;
+          }          
+          break;
+
+        case 1:
+        case 3:
+          // 70 degree tooth, next tooth is 170
+          switch (configPage4.triggerFilter)
+          {
+            case 1: // 25 % 42 degrees
+              triggerFilterTime = rshift<1>((uint32_t)curGap) + rshift<3>((uint32_t)curGap);
+              break;
+            case 2: // 50 % 85 degrees
+              triggerFilterTime = curGap + rshift<2>((uint32_t)curGap);
+              break;
+            case 3: // 75 % 127 degrees
+              triggerFilterTime = curGap + rshift<1>((uint32_t)curGap) + rshift<2>((uint32_t)curGap);
+              break;
+            default:
+              triggerFilterTime = 0;
+              break;
+          }
+          break;
+
+        default:
+          triggerFilterTime = 0;
+          break;
+      }
+      
+      //NEW IGNITION MODE
+      if( (isPerToothTimingEnabled()) ) 
+      {  
+        int16_t crankAngle = toothAngles[toothCurrentCount] + configPage4.triggerAngle;
+        checkPerToothTiming(crankAngle, toothCurrentCount);
+      }     
+
+    } // has sync
+
+  } //Trigger filter
+}
+
+static uint16_t getRPM_SuzukiK6A(void)
+{
+  //Cranking code needs working out. 
+
+  uint16_t tempRPM = stdGetRPM(CAM_SPEED);
+
+  MAX_STALL_TIME = currentStatus.revolutionTime << 1; //Set the stall time to be twice the current RPM. This is a safe figure as there should be no single revolution where this changes more than this
+  if(MAX_STALL_TIME < 366667UL) { MAX_STALL_TIME = 366667UL; } //Check for 50rpm minimum
+
+  return tempRPM;
+}
+
+static int16_t getCrankAngle_SuzukiK6A(uint32_t currMicros)
+{
+  //Grab some variables that are used in the trigger code and assign them to temp variables.
+  noInterrupts();
+  uint16_t tempToothCurrentCount = toothCurrentCount;
+  unsigned long tempToothLastToothTime = toothLastToothTime;
+  interrupts();
+
+  if (tempToothCurrentCount>0U) {
+    triggerToothAngle = (uint16_t)toothAngles[tempToothCurrentCount] - (uint16_t)toothAngles[tempToothCurrentCount-1U];
+  }
+  
+  //Estimate the number of degrees travelled since the last tooth}
+  int crankAngle = toothAngles[tempToothCurrentCount] + configPage4.triggerAngle; //Perform a lookup of the fixed toothAngles array to find what the angle of the last tooth passed was.
+  crankAngle += (int)timeToAngle(currMicros - tempToothLastToothTime);
+  if (crankAngle >= 720) { crankAngle -= 720; }
+  if (crankAngle < 0) { crankAngle += 720; }   
+
+  return crankAngle;
+}
+
+// Assumes no advance greater than 48 degrees. Triggers on the tooth before the ignition event
+static uint16_t __attribute__((noinline)) calcEndTeeth_SuzukiK6A(const IgnitionSchedule &schedule) {
+  //Temp variables are used here to avoid potential issues if a trigger interrupt occurs part way through this function
+  const int16_t tempIgnitionEndTooth = ignitionLimits(schedule.dischargeAngle - configPage4.triggerAngle);
+
+  uint8_t nCount=1U;
+  while ((nCount<8U) && (tempIgnitionEndTooth > toothAngles[nCount])) {
+    ++nCount;
+  }
+  if(nCount==1U || nCount==8U) {
+    // didn't find a match, use tooth 7 as it must be greater than 7 but less than 1.  
+    return 7U;
+  } 
+
+  // The tooth we want is the tooth prior to this one.     
+  return nCount-1U;
+}
+
+static void triggerSetEndTeeth_SuzukiK6A(void)
+{
+  ignitionEndTeeth[0] = calcEndTeeth_SuzukiK6A(ignitionSchedule1);
+#if (IGN_CHANNELS >= 2)
+  ignitionEndTeeth[1] = calcEndTeeth_SuzukiK6A(ignitionSchedule2);
+#endif
+#if (IGN_CHANNELS >= 3)
+  ignitionEndTeeth[2] = calcEndTeeth_SuzukiK6A(ignitionSchedule3);
+#endif
+}
+
+decoder_t  __attribute__((optimize("Os"))) triggerSetup_SuzukiK6A(void)
+{
+  decoderFeatures = decoder_features_t();
+	sharedDecoderReset();
+  triggerToothAngle = 90; //The number of degrees that passes from tooth to tooth (primary) - set to a value, needs to be set per tooth
+  toothCurrentCount = 99; //Fake tooth count represents no sync
+
+  configPage4.TrigSpeed = CAM_SPEED;
+  triggerActualTeeth = 7;
+  toothCurrentCount = 1;
+  curGap = curGap2 = curGap3 = 0;
+
+  if(currentStatus.initialisationComplete == false) { toothLastToothTime = micros(); } //Set a startup value here to avoid filter errors when starting. This MUST have the initial check to prevent the fuel pump just staying on all the time
+  else { toothLastToothTime = 0; }
+  toothLastMinusOneToothTime = 0;
+
+  // based on data in msextra page linked to above we can deduce,
+  // gap between rising and falling edge of a normal 70 degree tooth is 48 degrees, this means the gap is 70 degrees - 48 degrees = 22 degrees.
+  // assume this is constant for all similar sized gaps and teeth
+  // sync tooth is 35 degrees - eyeball looks like the tooth is 50% tooth and 50% gap so guess its 17 degrees and 18 degrees.
+
+  // coded every tooth here in case you want to try "change" setting on the trigger setup (this is defined in init.ino and what i've set it to, otherwise you need code to select rising or falling in init.ino (steal it from another trigger)). 
+  // If you don't want change then drop the 'falling' edges listed below and half the number of edges + reduce the triggerActualTeeth
+  // nb as you can edit the trigger offset using rising or falling edge setup below is irrelevant as you can adjust via the trigger offset to cover the difference.
+
+  // not using toothAngles[0] as i'm hoping it makes logic easier
+
+  toothAngles[0] = -70;                 // Wrap around to 650, 
+  toothAngles[1] = 0;                   // 0 TDC cylinder 1, 
+  toothAngles[2] = 170;                 // 170 - end of cylinder 1, start of cylinder 3, trigger ignition for cylinder 3 on this tooth
+  toothAngles[3] = 240;                 // 70 TDC cylinder 3
+  toothAngles[4] = 410;                 // 170  - end of cylinder 3, start of cylinder2, trigger ignition for cylinder 2 on this tooth
+  toothAngles[5] = 480;                 // 70 TDC cylinder 2 
+  toothAngles[6] = 515;                 // 35 Additional sync tooth
+  toothAngles[7] = 650;                 // 135 end of cylinder 2, start of cylinder 1, trigger ignition for cylinder 1 on this tooth
+  toothAngles[8] = 720;                 // 70 - gap to rotation to TDC1. array item 1 and 8 are the same, code never gets here its for reference only
+
+  
+  MAX_STALL_TIME = (3333UL * triggerToothAngle); //Minimum 50rpm. (3333uS is the time per degree at 50rpm)
+  triggerFilterTime = 1500; //10000 rpm, assuming we're triggering on both edges off the crank tooth.
+  triggerSecFilterTime = 0; //Need to figure out something better for this
+  decoderStatus.toothAngleIsCorrect = false;
+  decoderFeatures.supportsSequential = true;
+  decoderFeatures.supportsPerToothIgnition = true;
+
+  return decoder_builder_t()
+                  .setPrimaryTrigger(triggerPri_SuzukiK6A, getConfigPriTriggerEdge(configPage4)) // only primary, no secondary, trigger pattern is over 720 degrees
+                  .setGetRPM(getRPM_SuzukiK6A)
+                  .setGetCrankAngle(getCrankAngle_SuzukiK6A)
+                  .setSetEndTeeth(triggerSetEndTeeth_SuzukiK6A)
+                  .setReset(sharedDecoderReset)
+                  .setIsEngineRunning(sharedEngineIsRunning)
+                  .setGetStatus(sharedGetStatus)
+                  .setGetFeatures(sharedGetDecoderFeatures)
+                  .build();
+}
+
+/** @} */
@@ -0,0 +1,292 @@
+#include "decoder_shared.h"
+
+/** A table driven decoder for an arbitrary single wheel, on either the crank or the cam (see trigger_wheel_t).
+* The wheel comes from the tune as a bitmap of equally spaced tooth positions (config15::toothTableSlots & toothTableTeeth).
+* At setup the bitmap is checked & the shortest run of gap shapes (a gap being very long, long, short or the same as
+* the gap before it) that only occurs at one place on the wheel is found.
+* That run is the sync signature: E.g. on a 36-1 wheel it is the long gap before tooth #1.
+* The ISR classifies each gap against the previous one, which is a shift into a small history, & checks it against
+* the gap to the next tooth in the bitmap. Like the missing tooth decoder, the tooth number is the wheel position (+1)
+* so the angle is a multiply: no per tooth table is kept.
+* There is no secondary input, so a crank wheel only provides half sync for sequential operation.
+* @defgroup dec_tooth_table Tooth table
+* @{
+*/
+
+/** @brief The shape of a tooth gap compared to the gap before it */
+enum class ToothGap : uint8_t {
+  Same = 0U,
+  Short = 1U,     ///< Less than 2/3 of the previous gap
+  Long = 2U,      ///< More than 1.5x the previous gap
+  VeryLong = 3U,  ///< More than 2.5x the previous gap. E.g. 2 missing teeth
+};
+static constexpr uint8_t TOOTH_GAP_BITS = 2U;
+/** @brief Maximum gap shapes in the sync signature: limited by the bits in toothTableHistory */
+static constexpr uint8_t TOOTH_TABLE_MAX_SIGNATURE = 16U / TOOTH_GAP_BITS;
+
+static_assert(sizeof(config15::toothTableTeeth)*8U >= TOOTH_TABLE_MAX_SLOTS, "config15::toothTableTeeth is too small for TOOTH_TABLE_MAX_SLOTS");
+
+static uint8_t toothTableTeeth[TOOTH_TABLE_MAX_SLOTS/8U]; //Copy of the bitmap, so a tune change cannot alter the wheel while running
+static uint8_t toothTableSlots;
+static uint8_t toothTableSlotAngle;       //Crank degrees between positions
+static uint16_t toothTableCycle;
+static uint8_t toothTableFirstSlot;       //Position of tooth #1, the first tooth on the wheel
+static uint8_t toothTableSyncSlot;        //The position that completes the sync signature
+static uint8_t toothTableSyncGap;         //The gap (in positions) that ends at toothTableSyncSlot
+static uint8_t toothTableMinGap;          //Shortest & longest gaps on the wheel, in positions
+static uint8_t toothTableMaxGap;
+static uint16_t toothTableSyncSignature;
+static uint16_t toothTableSyncMask;
+static uint8_t toothTableSyncLength;
+static uint8_t toothTableLastGap;         //The gap (in positions) that ended at the last tooth
+static uint16_t toothTableHistory;        //The most recent gap shapes, newest in the low bits
+static uint8_t toothTableHistoryLength;   //Number of valid gap shapes in toothTableHistory
+
+TESTABLE_INLINE_STATIC uint8_t classifyToothGap(uint32_t gap, uint32_t previousGap)
+{
+  if ( (gap * 2U) > (previousGap * 5U) ) { return (uint8_t)ToothGap::VeryLong; }
+  if ( (gap * 2U) > (previousGap * 3U) ) { return (uint8_t)ToothGap::Long; }
+  if ( (gap * 3U) < (previousGap * 2U) ) { return (uint8_t)ToothGap::Short; }
+  return (uint8_t)ToothGap::Same;
+}
+
+static inline bool toothTableHasTooth(uint8_t slot)
+{
+  return BIT_CHECK(toothTableTeeth[slot >> 3U], slot & 7U);
+}
+
+/** @brief Positions from slot to the next tooth. The wheel must have a tooth somewhere, so this is bounded by the widest gap */
+static inline uint8_t toothTableGapAfter(uint8_t slot)
+{
+  uint8_t gap = 0U;
+  do
+  {
+    ++gap;
+    slot = (slot >= toothTableSlots - 1U) ? 0U : slot + 1U;
+  } while (!toothTableHasTooth(slot));
+  return gap;
+}
+
+static inline uint8_t toothTableAdvance(uint8_t slot, uint8_t gap)
+{
+  uint16_t next = (uint16_t)slot + gap;
+  return (uint8_t)((next >= toothTableSlots) ? next - toothTableSlots : next);
+}
+
+/** @brief The gap shapes of the length teeth ending at tooth (an index into gapShapes), oldest in the high bits */
+static uint16_t getToothTableSignature(const uint8_t *gapShapes, uint8_t toothCount, uint8_t tooth, uint8_t length)
+{
+  uint16_t signature = 0U;
+  for (uint8_t offset=length; offset>0U; --offset)
+  {
+    uint8_t index = (uint8_t)((tooth + ((uint16_t)toothCount * TOOTH_TABLE_MAX_SIGNATURE) + 1U - offset) % toothCount);
+    signature = (uint16_t)((signature << TOOTH_GAP_BITS) | gapShapes[index]);
+  }
+  return signature;
+}
+
+/**
+ * @brief Check a wheel & find its sync signature
+ *
+ * @return false if the wheel is malformed, a gap shape is too close to the long/short thresholds to be
+ * reliably detected or there is no unique run of gap shapes short enough to act as the sync signature.
+ */
+TESTABLE_STATIC bool compileToothTable(const trigger_wheel_t &wheel)
+{
+  toothTableSyncLength = UINT8_MAX; //Longer than toothTableHistory can hold, so a wheel that fails to compile never syncs
+  toothTableSlots = 0U;
+  toothTableCycle = wheel.cycleDegrees;
+  if ( (wheel.teeth==nullptr) || (wheel.slotCount<2U) || (wheel.slotCount>TOOTH_TABLE_MAX_SLOTS) ) { return false; }
+  if ( ((wheel.cycleDegrees % wheel.slotCount)!=0U) || ((wheel.cycleDegrees / wheel.slotCount)>UINT8_MAX) ) { return false; }
+  toothTableSlots = wheel.slotCount;
+  toothTableSlotAngle = (uint8_t)(wheel.cycleDegrees / wheel.slotCount);
+  memset(toothTableTeeth, 0, sizeof(toothTableTeeth));
+  for (uint8_t slot=0U; slot<toothTableSlots; ++slot)
+  {
+    if (BIT_CHECK(wheel.teeth[slot >> 3U], slot & 7U)) { BIT_SET(toothTableTeeth[slot >> 3U], slot & 7U); }
+  }
+
+  //Per tooth positions & gaps are only needed to find the signature, so live on the stack for the duration of setup
+  uint8_t toothSlots[TOOTH_TABLE_MAX_SLOTS];
+  uint8_t gapShapes[TOOTH_TABLE_MAX_SLOTS];
+  uint8_t toothCount = 0U;
+  for (uint8_t slot=0U; slot<toothTableSlots; ++slot)
+  {
+    if (toothTableHasTooth(slot)) { toothSlots[toothCount++] = slot; }
+  }
+  if (toothCount<2U) { return false; }
+  toothTableFirstSlot = toothSlots[0];
+
+  toothTableMinGap = UINT8_MAX;
+  toothTableMaxGap = 0U;
+  for (uint8_t tooth=0U; tooth<toothCount; ++tooth)
+  {
+    uint8_t previousTooth = (tooth==0U) ? toothCount-1U : tooth-1U;
+    uint8_t gap = toothTableGapAfter(toothSlots[previousTooth]);
+    uint8_t previousGap = toothTableGapAfter(toothSlots[(previousTooth==0U) ? toothCount-1U : previousTooth-1U]);
+    uint8_t gapShape = classifyToothGap(gap, previousGap);
+    //The shape must not change if the engine speed changes by 15% from one tooth to the next
+    if ( (classifyToothGap(gap * 100U, previousGap * 115U)!=gapShape) || (classifyToothGap(gap * 100U, previousGap * 85U)!=gapShape) ) { return false; }
+    gapShapes[tooth] = gapShape;
+    toothTableMinGap = (std::min)(toothTableMinGap, gap);
+    toothTableMaxGap = (std::max)(toothTableMaxGap, gap);
+  }
+
+  for (uint8_t length=1U; length<=TOOTH_TABLE_MAX_SIGNATURE; ++length)
+  {
+    for (uint8_t tooth=0U; tooth<toothCount; ++tooth)
+    {
+      uint16_t signature = getToothTableSignature(gapShapes, toothCount, tooth, length);
+      bool isUnique = true;
+      for (uint8_t other=0U; (other<toothCount) && isUnique; ++other)
+      {
+        isUnique = (other==tooth) || (getToothTableSignature(gapShapes, toothCount, other, length)!=signature);
+      }
+      if (isUnique)
+      {
+        toothTableSyncSlot = toothSlots[tooth];
+        toothTableSyncGap = toothTableGapAfter(toothSlots[(tooth==0U) ? toothCount-1U : tooth-1U]);
+        toothTableSyncLength = length;
+        toothTableSyncSignature = signature;
+        toothTableSyncMask = (uint16_t)((1UL << (length * TOOTH_GAP_BITS)) - 1UL);
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+static void triggerPri_toothTable(void)
+{
+  uint32_t curTime = micros();
+  curGap = curTime - toothLastToothTime;
+  if ( curGap >= triggerFilterTime ) //Pulses should never be less than triggerFilterTime, so if they are it means a false trigger.
+  {
+    decoderStatus.validTrigger = true; //Flag this pulse as being a valid trigger (ie that it passed filters)
+
+    if( (toothLastToothTime > 0) && (toothLastMinusOneToothTime > 0) )
+    {
+      uint8_t gapShape = classifyToothGap(curGap, toothLastToothTime - toothLastMinusOneToothTime);
+      toothTableHistory = (uint16_t)((toothTableHistory << TOOTH_GAP_BITS) | gapShape);
+      if (toothTableHistoryLength < TOOTH_TABLE_MAX_SIGNATURE) { toothTableHistoryLength++; }
+
+      if (decoderStatus.syncStatus != SyncStatus::None)
+      {
+        uint8_t slot = (uint8_t)(toothCurrentCount - 1U);
+        uint8_t gap = toothTableGapAfter(slot);
+        if (classifyToothGap(gap, toothTableLastGap) != gapShape)
+        {
+          //The gap isn't the one expected at this tooth: either a tooth was missed or a noise pulse got through the filter
+          decoderStatus.syncStatus = SyncStatus::None;
+          currentStatus.syncLossCounter++;
+        }
+        else
+        {
+          slot = toothTableAdvance(slot, gap);
+          toothCurrentCount = slot + 1U;
+          toothTableLastGap = gap;
+          if (slot == toothTableFirstSlot)
+          {
+            currentStatus.startRevolutions++; //Counter
+            if (toothTableCycle == 720U) { currentStatus.startRevolutions++; } //Add an extra revolution count if we're running at cam speed
+            revolutionOne = !revolutionOne; //Flip sequential revolution tracker
+            toothOneMinusOneTime = toothOneTime;
+            toothOneTime = curTime;
+          }
+        }
+      }
+
+      if ( (decoderStatus.syncStatus == SyncStatus::None)
+        && (toothTableHistoryLength >= toothTableSyncLength)
+        && ((toothTableHistory & toothTableSyncMask) == toothTableSyncSignature) )
+      {
+        toothCurrentCount = toothTableSyncSlot + 1U;
+        toothTableLastGap = toothTableSyncGap;
+        currentStatus.startRevolutions = 0;
+        //Any earlier tooth #1 time is from before sync was gained, so cannot be used for the revolution time
+        toothOneMinusOneTime = 0;
+        toothOneTime = (toothTableSyncSlot == toothTableFirstSlot) ? curTime : 0U;
+        //A crank wheel cannot tell the 2 revolutions apart, so only has half sync if sequential is in use
+        if( (toothTableCycle == 720U) || ((configPage4.sparkMode != IGN_MODE_SEQUENTIAL) && (configPage2.injLayout != INJ_SEQUENTIAL)) ) { decoderStatus.syncStatus = SyncStatus::Full; }
+        else { decoderStatus.syncStatus = SyncStatus::Partial; }
+      }
+    }
+
+    if (decoderStatus.syncStatus != SyncStatus::None)
+    {
+      triggerToothAngle = (uint16_t)toothTableLastGap * toothTableSlotAngle; //The angle of the gap just finished
+      decoderStatus.toothAngleIsCorrect = true;
+    }
+    else { decoderStatus.toothAngleIsCorrect = false; }
+
+    toothLastMinusOneToothTime = toothLastToothTime;
+    toothLastToothTime = curTime;
+    publishToothEvent();
+  }
+}
+
+static uint16_t getRPM_toothTable(void)
+{
+  return stdGetRPM(getLatestToothEvent(), toothTableCycle == 720U);
+}
+
+static int16_t getCrankAngle_toothTable(uint32_t currMicros)
+{
+    //This is the current angle ATDC the engine is at. This is the last known position based on what tooth was last 'seen'. It is only accurate to the resolution of the trigger wheel
+    tooth_event_t tooth = getLatestToothEvent();
+
+    int crankAngle = configPage4.triggerAngle;
+    if ( (tooth.tooth > 0U) && (tooth.tooth <= toothTableSlots) ) { crankAngle += (int)(tooth.tooth - 1U) * toothTableSlotAngle; } //The tooth number is the wheel position, so the angle of the last tooth passed is a multiply
+
+    //Sequential check (simply sets whether we're on the first or 2nd revolution of the cycle)
+    if ( (tooth.revolutionOne == true) && (toothTableCycle == 360U) ) { crankAngle += 360; }
+
+    crankAngle += timeToAngle(currMicros - tooth.time);
+
+    if (crankAngle >= 720) { crankAngle -= 720; }
+    if (crankAngle < 0) { crankAngle += CRANK_ANGLE_MAX; }
+
+    return crankAngle;
+}
+
+static void triggerReset_toothTable(void)
+{
+  sharedDecoderReset();
+  toothCurrentCount = 0;
+  toothTableHistoryLength = 0;
+}
+
+decoder_t __attribute__((optimize("Os"))) triggerSetup_toothTable(void)
+{
+  decoderFeatures = decoder_features_t();
+  triggerReset_toothTable();
+  trigger_wheel_t wheel = { configPage15.toothTableTeeth, configPage15.toothTableSlots, (uint16_t)((configPage4.TrigSpeed == CAM_SPEED) ? 720U : 360U) };
+  if (compileToothTable(wheel))
+  {
+    triggerToothAngle = (uint16_t)toothTableMinGap * toothTableSlotAngle;
+    triggerFilterTime = (MICROS_PER_DEG_1_RPM / MAX_RPM) * triggerToothAngle; //Trigger filter time is the shortest possible time (in uS) that there can be between teeth (ie at max RPM). Any pulses that occur faster than this time will be discarded as noise
+    MAX_STALL_TIME = ((MICROS_PER_DEG_1_RPM/50U) * ((uint16_t)toothTableMaxGap * toothTableSlotAngle)); //Minimum 50rpm. (3333uS is the time per degree at 50rpm)
+  }
+  else
+  {
+    //The wheel cannot be decoded. The input is still attached, so the tooth logger shows what the wheel actually looks like, but it never syncs
+    triggerToothAngle = toothTableCycle;
+    triggerFilterTime = 0;
+    MAX_STALL_TIME = ((MICROS_PER_DEG_1_RPM/50U) * toothTableCycle);
+  }
+  toothLastMinusOneToothTime = 0;
+  toothOneTime = 0;
+  toothOneMinusOneTime = 0;
+  decoderFeatures.supportsSequential = (toothTableCycle == 720U);
+
+  return decoder_builder_t()
+                  .setPrimaryTrigger(triggerPri_toothTable, getConfigPriTriggerEdge(configPage4))
+                  .setGetRPM(getRPM_toothTable)
+                  .setGetCrankAngle(getCrankAngle_toothTable)
+                  .setReset(triggerReset_toothTable)
+                  .setIsEngineRunning(sharedEngineIsRunning)
+                  .setGetStatus(sharedGetStatus)
+                  .setGetFeatures(sharedGetDecoderFeatures)
+                  .build();
+}
+/** @} */
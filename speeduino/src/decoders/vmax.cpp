@@ -0,0 +1,193 @@
+#include "decoder_shared.h"
+
+/** Yamaha Vmax 1990+ with 6 uneven teeth, triggering on the wide lobe.
+Within the decoder code, the sync tooth is referred to as tooth #1. Derived from Harley and made to work on the Yamah Vmax.
+Trigger is based on 'CHANGE' so we get a signal on the up and downward edges of the lobe. This is required to identify the wide lobe.
+* @defgroup dec_vmax Yamaha Vmax
+* @{
+*/
+//curGap = microseconds between primary triggers
+//curGap2 = microseconds between secondary triggers
+//toothCurrentCount = the current number for the end of a lobe
+//secondaryToothCount = the current number of the beginning of a lobe
+//We measure the width of a lobe so on the end of a lobe, but want to trigger on the beginning. Variable toothCurrentCount tracks the downward events, and secondaryToothCount updates on the upward events. Ideally, it should be the other way round but the engine stall routine resets secondaryToothCount, so it would not sync again after an engine stall.
+static void triggerPri_Vmax(void)
+{
+  uint32_t curTime = micros();
+  if(currentStatus.decoder.primary.isTriggered()){// Forwarded from the config page to setup the primary trigger edge (rising or falling). Inverting VR-conditioners require FALLING, non-inverting VR-conditioners require RISING in the Trigger edge setup.
+    curGap2 = curTime;
+    curGap = curTime - toothLastToothTime;
+    if ( (curGap >= triggerFilterTime) ){
+      decoderStatus.validTrigger = true; //Flag this pulse as being a valid trigger (ie that it passed filters)
+      if (toothCurrentCount > 0) // We have sync based on the tooth width.
+      {
+          decoderStatus.validTrigger = true; //Flag this pulse as being a valid trigger (ie that it passed filters)
+          if (toothCurrentCount==1)
+          {
+            secondaryToothCount = 1;
+            triggerToothAngle = 70;// Has to be equal to Angle Routine, and describe the delta between two teeth.
+            toothOneMinusOneTime = toothOneTime;
+            toothOneTime = curTime;
+            decoderStatus.syncStatus = SyncStatus::Full;
+            //setFilter((curGap/1.75));//Angle to this tooth is 70, next is in 40, compensating.
+            setFilter( ((curGap*4)/7) );//Angle to this tooth is 70, next is in 40, compensating.
+            currentStatus.startRevolutions++; //Counter
+          }
+          else if (toothCurrentCount==2)
+          {
+            secondaryToothCount = 2;
+            triggerToothAngle = 40;
+            //setFilter((curGap*1.75));//Angle to this tooth is 40, next is in 70, compensating.
+            setFilter( ((curGap*7)/4) );//Angle to this tooth is 40, next is in 70, compensating.
+          }
+          else if (toothCurrentCount==3)
+          {
+            secondaryToothCount = 3;
+            triggerToothAngle = 70;
+            setFilter(curGap);//Angle to this tooth is 70, next is in 70. No need to compensate.
+          }
+          else if (toothCurrentCount==4)
+          {
+            secondaryToothCount = 4;
+            triggerToothAngle = 70;
+            //setFilter((curGap/1.75));//Angle to this tooth is 70, next is in 40, compensating.
+            setFilter( ((curGap*4)/7) );//Angle to this tooth is 70, next is in 40, compensating.
+          }
+          else if (toothCurrentCount==5)
+          {
+            secondaryToothCount = 5;
+            triggerToothAngle = 40;
+            //setFilter((curGap*1.75));//Angle to this tooth is 40, next is in 70, compensating.
+            setFilter( ((curGap*7)/4) );//Angle to this tooth is 40, next is in 70, compensating.
+          }
+          else if (toothCurrentCount==6)
+          {
+            secondaryToothCount = 6;
+            triggerToothAngle = 70;
+            setFilter(curGap);//Angle to this tooth is 70, next is in 70. No need to compensate.
+          }
+          toothLastMinusOneToothTime = toothLastToothTime;
+          toothLastToothTime = curTime;
+          if (triggerFilterTime > 50000){//The first pulse seen 
+            triggerFilterTime = 0;
+          }
+      }
+      else{
+        triggerFilterTime = 0;
+        return;//Zero, no sync yet.
+      }
+    }
+    else{
+      decoderStatus.validTrigger = false; //Flag this pulse as being an invalid trigger
+    }
+  }
+  else if( decoderStatus.validTrigger ) // Inverted due to vr conditioner. So this is the falling lobe. We only process if there was a valid trigger.
+  {
+    unsigned long curGapLocal = curTime - curGap2;
+    if (curGapLocal > (lastGap * 2)){// Small lobe is 5 degrees, big lobe is 45 degrees. So this should be the wide lobe.
+        if (toothCurrentCount == 0 || toothCurrentCount == 6){//Wide should be seen with toothCurrentCount = 0, when there is no sync yet, or toothCurrentCount = 6 when we have done a full revolution. 
+          decoderStatus.syncStatus = SyncStatus::Full;
+        }
+        else{//Wide lobe seen where it shouldn't, adding a sync error.
+          currentStatus.syncLossCounter++;
+        }
+        toothCurrentCount = 1;
+    }
+    else if(toothCurrentCount == 6){//The 6th lobe should be wide, adding a sync error.
+        toothCurrentCount = 1;
+        currentStatus.syncLossCounter++;
+    }
+    else{// Small lobe, just add 1 to the toothCurrentCount.
+      toothCurrentCount++;
+    }
+    lastGap = curGapLocal;
+    return;
+  }
+  else if( decoderStatus.validTrigger == false)
+  {
+    decoderStatus.validTrigger = true; //We reset this every time to ensure we only filter when needed.
+  }
+}
+
+static uint16_t getRPM_Vmax(void)
+{
+  uint16_t tempRPM = 0;
+  if (decoderStatus.syncStatus==SyncStatus::Full)
+  {
+    if ( currentStatus.RPM < (unsigned int)(configPage4.crankRPM * 100) )
+    {
+      int tempToothAngle;
+      unsigned long toothTime;
+      if ( (toothLastToothTime == 0) || (toothLastMinusOneToothTime == 0) ) { tempRPM = 0; }
+      else
+      {
+        noInterrupts();
+        tempToothAngle = triggerToothAngle;
+        unsigned long revolutionTime = (toothOneTime - toothOneMinusOneTime); //The time in uS that one revolution would take at current speed (The time tooth 1 was last seen, minus the time it was seen prior to that)
+        toothTime = (toothLastToothTime - toothLastMinusOneToothTime); 
+        interrupts();
+        SetRevolutionTime(revolutionTime);
+        toothTime = toothTime * 36;
+        tempRPM = ((unsigned long)tempToothAngle * (MICROS_PER_MIN/10U)) / toothTime;
+      }
+    }
+    else {
+      tempRPM = stdGetRPM(CRANK_SPEED);
+    }
+  }
+  return tempRPM;
+}
+
+
+static int16_t getCrankAngle_Vmax(uint32_t currMicros)
+{
+  //This is the current angle ATDC the engine is at. This is the last known position based on what tooth was last 'seen'. It is only accurate to the resolution of the trigger wheel (Eg 36-1 is 10 degrees)
+  unsigned long tempToothLastToothTime;
+  int tempsecondaryToothCount;
+  //Grab some variables that are used in the trigger code and assign them to temp variables.
+  noInterrupts();
+  tempsecondaryToothCount = secondaryToothCount;
+  tempToothLastToothTime = toothLastToothTime;
+  interrupts();
+
+  //Check if the last tooth seen was the reference tooth (Number 3). All others can be calculated, but tooth 3 has a unique angle
+  int crankAngle;
+  crankAngle=toothAngles[tempsecondaryToothCount] + configPage4.triggerAngle;
+  
+  //Estimate the number of degrees travelled since the last tooth}
+  crankAngle += timeToAngle(currMicros - tempToothLastToothTime);
+
+  if (crankAngle >= 720) { crankAngle -= 720; }
+  if (crankAngle < 0) { crankAngle += 360; }
+
+  return crankAngle;
+}
+
+decoder_t  __attribute__((optimize("Os"))) triggerSetup_Vmax(void)
+{
+  decoderFeatures = decoder_features_t();
+	sharedDecoderReset();
+  triggerToothAngle = 0; // The number of degrees that passes from tooth to tooth, ev. 0. It alternates uneven
+  MAX_STALL_TIME = ((MICROS_PER_DEG_1_RPM/50U) * 60U); //Minimum 50rpm. (3333uS is the time per degree at 50rpm)
+  if(currentStatus.initialisationComplete == false) { toothLastToothTime = micros(); } //Set a startup value here to avoid filter errors when starting. This MUST have the initi check to prevent the fuel pump just staying on all the time
+  triggerFilterTime = 1500;
+  decoderStatus.validTrigger = true; // We must start with a valid trigger or we cannot start measuring the lobe width. We only have a false trigger on the lobe up event when it doesn't pass the filter. Then, the lobe width will also not be beasured.
+  toothAngles[1] = 0;      //tooth #1, these are the absolute tooth positions
+  toothAngles[2] = 40;     //tooth #2
+  toothAngles[3] = 110;    //tooth #3
+  toothAngles[4] = 180;    //tooth #4
+  toothAngles[5] = 220;    //tooth #5
+  toothAngles[6] = 290;    //tooth #6
+
+  return decoder_builder_t()
+                  .setPrimaryTrigger(triggerPri_Vmax, CHANGE)
+                  .setGetRPM(getRPM_Vmax)
+                  .setGetCrankAngle(getCrankAngle_Vmax)
+                  .setReset(sharedDecoderReset)
+                  .setIsEngineRunning(sharedEngineIsRunning)
+                  .setGetStatus(sharedGetStatus)
+                  .setGetFeatures(sharedGetDecoderFeatures)
+                  .build();
+}
+
+/** @} */
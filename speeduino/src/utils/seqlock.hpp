@@ -0,0 +1,59 @@
+#pragma once
+
+/**
+ * @file seqlock.hpp
+ * @brief A lock free snapshot of a value, written by an ISR & read by the main loop
+ *
+ * The writer bumps a sequence number before & after updating the value, so the sequence is odd while
+ * a write is in progress. Readers copy the value between two reads of the sequence & retry if it
+ * changed (I.e. the writer ran during the copy). Neither side disables interrupts & the writer never
+ * waits.
+ *
+ * @note This relies on the writer & readers running on the same core (I.e. an ISR & the main loop), so
+ * only the compiler needs to be stopped from reordering memory accesses. A reader must not be able to
+ * interrupt the writer: it would spin forever on the odd sequence number.
+ */
+
+#include <stdint.h>
+
+/** @brief Stop the compiler moving memory accesses across this point */
+#define SEQLOCK_BARRIER() __asm__ __volatile__("" ::: "memory")
+
+/**
+ * @brief The snapshot
+ *
+ * @tparam T Value type. Copied by value, so should be small
+ */
+template <typename T>
+class Seqlock {
+public:
+  /** @brief Replace the value. Writer only. */
+  void write(const T &value) noexcept {
+    uint8_t sequence = _sequence;
+    _sequence = (uint8_t)(sequence + 1U);
+    SEQLOCK_BARRIER();
+    _value = value;
+    SEQLOCK_BARRIER();
+    _sequence = (uint8_t)(sequence + 2U);
+  }
+
+  /** @brief Copy the value. Safe from the writer's own context or any context the writer can interrupt. */
+  T read(void) const noexcept {
+    T value;
+    uint8_t sequence;
+    do {
+      sequence = _sequence;
+      SEQLOCK_BARRIER();
+      value = _value;
+      SEQLOCK_BARRIER();
+    } while (((sequence & 1U)!=0U) || (sequence!=_sequence));
+    return value;
+  }
+
+  /** @brief Incremented by 2 on every write. Lets a reader cheaply check for a new value */
+  uint8_t sequence(void) const noexcept { return _sequence; }
+
+private:
+  T _value = {};
+  volatile uint8_t _sequence = 0U;
+};
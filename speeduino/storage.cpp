@@ -65,7 +65,13 @@ constexpr uint16_t EEPROM_CALIBRATION_O2_VALUES = EEPROM_CALIBRATION_IAT_BINS-ge
 constexpr uint16_t EEPROM_CALIBRATION_O2_BINS =   EEPROM_CALIBRATION_O2_VALUES-getCalibrationElementSize(SensorCalibrationTable::O2Sensor, SensorCalibrationTableElement::Bins);
 constexpr uint16_t EEPROM_LAST_BARO = (EEPROM_CALIBRATION_O2_BINS-(uint16_t)1);
 
+#if defined(TABLE3D_LARGE_TABLES)
+// The 24x24 VE table doesn't fit in the 4K layout, so it goes after it. Its old
+// slot (address 3) is unused. See upgradeV28toV29()
+constexpr uint16_t EEPROM_CONFIG1_MAP    = STORAGE_END+1U;
+#else
 constexpr uint16_t EEPROM_CONFIG1_MAP    = 3;
+#endif
 constexpr uint16_t EEPROM_CONFIG2_START  = 291;
 constexpr uint16_t EEPROM_CONFIG3_MAP    = 421;
 constexpr uint16_t EEPROM_CONFIG4_START  = 709;
@@ -292,7 +298,7 @@ void savePage(uint8_t pageNum)
     case veMapPage:
       /*---------------------------------------------------
       | Fuel table (See storage.h for data layout) - Page 1
-      | 16x16 table itself + the 16 values along each of the axis
+      | 16x16 (24x24 with TABLE3D_LARGE_TABLES) table itself + the values along each of the axis
       -----------------------------------------------------*/
       writesRemaining = writeTable(fuelTable, EEPROM_CONFIG1_MAP, writesRemaining);
       break;
@@ -475,6 +481,7 @@ static inline uint16_t load_range(Iter pStart, Iter pEnd, uint16_t address)
 template <typename TTable>
 static inline uint16_t loadTable(TTable &table, uint16_t address)
 {
+  notifyTableChanged(table);
   return load_range(table.axisY.rbegin(), table.axisY.rend(), // NOTE: Y-axis is reversed for reasons that no longer apply, but we preserve that for backwards compatibility
             load_range(table.axisX.begin(), table.axisX.end(), 
               load_range(table.values.begin(), table.values.end(), address)));
@@ -566,6 +573,7 @@ void loadAllPages(void)
   (void)load_range(EEPROM_CONFIG15_START, (byte *)&configPage15, (byte *)&configPage15+sizeof(configPage15));  
 
   //*********************************************************************************************************************************************************************************
+  notifyAllPagesChanged();
 }
 
 void loadAllCalibrationTables(void)
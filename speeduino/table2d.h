@@ -6,6 +6,7 @@ This file is used for everything related to maps/tables including their definiti
 
 #include "src/utils/nominmax.h"
 #include <algorithm>
+#include <type_traits>
 #include <stdint.h>
 #include <Arduino.h>
 #include "preprocessor.h"
@@ -85,6 +86,122 @@ static inline uint8_t findBinUpperIndex(TIter pStart, TIter pEnd, const TValue &
   return std::distance(pStart, pEnd)-1U;
 }
 
+/** @brief How searchBinUpperIndex() finds the axis bin */
+enum class BinSearch : uint8_t {
+  /** Scan from the start of the axis: fastest for short axes */
+  Linear,
+  /** Branchless binary search: a fixed number of iterations */
+  Binary,
+  /** Compute the bin, assuming an evenly spaced axis. Falls back to a binary search if the axis isn't evenly spaced. */
+  DirectIndex,
+};
+
+/** @brief Axes up to this length are searched linearly */
+static constexpr uint8_t BIN_SEARCH_LINEAR_MAX = 10U;
+
+/** @brief Select the bin search strategy for an axis
+ * 
+ * The long 16-bit axes are the ADC sensor calibration tables, which are evenly spaced (see comms.cpp).
+ * Direct indexing needs a division, so is only used on boards with hardware divide.
+ */
+template <typename TValue, uint8_t sizeT>
+static constexpr BinSearch defaultBinSearch(void) {
+#if defined(__AVR__)
+  return sizeT<=BIN_SEARCH_LINEAR_MAX ? BinSearch::Linear : BinSearch::Binary;
+#else
+  return sizeT<=BIN_SEARCH_LINEAR_MAX ? BinSearch::Linear 
+       : std::is_same<TValue, uint16_t>::value ? BinSearch::DirectIndex 
+       : BinSearch::Binary;
+#endif
+}
+
+template <uint8_t sizeT, typename TValue>
+static inline uint8_t linearSearchBinUpperIndex(const TValue *pAxis, const TValue &value) 
+{
+  uint8_t index = 1U;
+  while ((index<sizeT-1U) && (pAxis[index]<value))
+  {
+    ++index;
+  }
+  return index;
+}
+
+template <uint8_t sizeT, typename TValue>
+static inline uint8_t binarySearchBinUpperIndex(const TValue *pAxis, const TValue &value) 
+{
+  // A lower bound search, but with no data dependent branches: the compiler can 
+  // use conditional moves & (for a fixed size) unroll the loop.
+  const TValue *pBase = pAxis;
+  uint8_t length = sizeT;
+  while (length>1U)
+  {
+    const uint8_t half = length/2U;
+    pBase = (pBase[half]<value) ? pBase+half : pBase;
+    length = length-half;
+  }
+  uint8_t index = (uint8_t)(pBase-pAxis) + (uint8_t)(*pBase<value);
+  // Same clamping as findBinUpperIndex()
+  if (index==0U) { return 1U; }
+  if (index>=sizeT) { return sizeT-1U; }
+  return index;
+}
+
+template <uint8_t sizeT, typename TValue>
+static inline uint8_t directIndexBinUpperIndex(const TValue *pAxis, const TValue &value) 
+{
+  if ((value>pAxis[0]) && (pAxis[1]>pAxis[0]))
+  {
+    // If the axis is evenly spaced, this is the bin
+    const uint16_t guess = 1U + (uint16_t)((uint16_t)(value-pAxis[0]-1) / (uint16_t)(pAxis[1]-pAxis[0]));
+    if ((guess<sizeT) && Bin<TValue>::withinBin(value, pAxis[guess-1U], pAxis[guess]))
+    {
+      return (uint8_t)guess;
+    }
+  }
+  return binarySearchBinUpperIndex<sizeT>(pAxis, value);
+}
+
+/**
+ * @brief Find the upper index of the axis bin containing a value, using a search strategy selected at compile time.
+ * 
+ * Same result as findBinUpperIndex()
+ */
+template <uint8_t sizeT, typename TValue, BinSearch strategy = defaultBinSearch<TValue, sizeT>()>
+static inline uint8_t searchBinUpperIndex(const TValue *pAxis, const TValue &value) 
+{
+  static_assert(sizeT>=2U, "An axis must have at least one bin");
+  return strategy==BinSearch::Linear ? linearSearchBinUpperIndex<sizeT>(pAxis, value)
+       : strategy==BinSearch::DirectIndex ? directIndexBinUpperIndex<sizeT>(pAxis, value)
+       : binarySearchBinUpperIndex<sizeT>(pAxis, value);
+}
+
+template <typename TValue>
+static inline bool isCachedBin(uint8_t cachedUpperIndex, const TValue *pAxis, const TValue &value)  
+{
+  // Ignore the cache during tests
+#if !defined(UNIT_TEST)
+  // LCOV_EXCL_START
+  return Bin<TValue>::withinBin(value, pAxis[cachedUpperIndex-1U], pAxis[cachedUpperIndex]);
+  // LCOV_EXCL_STOP
+#else
+  UNUSED(cachedUpperIndex);
+  UNUSED(pAxis);
+  UNUSED(value);
+  return false;
+#endif
+}
+
+/** @brief Find the axis bin containing a value: the cached bin if it still matches, otherwise search. */
+template <uint8_t sizeT, typename TValue>
+static inline Bin<TValue> findCachedBin(uint8_t cachedUpperIndex, const TValue *pAxis, const TValue &value)  
+{
+  if (isCachedBin(cachedUpperIndex, pAxis, value))
+  {
+    return Bin<TValue>(pAxis, cachedUpperIndex);  
+  }
+  return Bin<TValue>(pAxis, searchBinUpperIndex<sizeT>(pAxis, value));
+}
+
 template <typename TIter, typename TValue>
 static inline Bin<TValue> findCachedBin(uint8_t cachedUpperIndex, TIter pStart, TIter pEnd, const TValue &value)  
 {
@@ -177,7 +294,7 @@ struct table2D
     else 
     {
       // None of the cached or last values match, so we need to find the new value
-      auto xBin = _table2d_detail::findCachedBin(cache.lastBinUpperIndex, axis, axis+sizeT, axisValue);
+      auto xBin = _table2d_detail::findCachedBin<sizeT>(cache.lastBinUpperIndex, axis, axisValue);
 
       // We are exactly at the bin upper bound, so no need to interpolate
       if (axisValue==xBin.upperValue()) 
@@ -79,6 +79,15 @@ struct table3d_t
 {
 };
 
+/**
+ * @brief A change counter: incremented each time the data it tracks changes.
+ * 
+ * Derived data (caches, lookup tables, CRCs etc.) can record the generation it was
+ * built from and cheaply check whether it is stale. Only compare for (in)equality:
+ * the counter wraps.
+ */
+using generation_t = uint16_t;
+
 // Generate the 3D table types
 #define TABLE3D_GEN_TYPE_INNER(size, xDom, yDom, typeName) \
     /** @brief A 3D table with size x size dimensions, xDom x-axis and yDom y-axis */ \
@@ -90,6 +99,8 @@ struct table3d_t
         static constexpr AxisDomain YDomain = AxisDomain::yDom; \
         \
         mutable table3DGetValueCache get_value_cache; \
+        /* Incremented whenever a value or axis changes. See notifyTableChanged() */ \
+        generation_t generation; \
         std::array<table3d_axis_t, (size)*(size)> values; \
         std::array<table3d_axis_t, (size)> axisX; \
         std::array<table3d_axis_t, (size)> axisY; \
@@ -102,16 +113,70 @@ TABLE3D_GENERATOR(TABLE3D_GEN_TYPE)
 
 // =============================== Table function calls =========================
 
+/**
+ * @brief Record that a table's values or axes have changed.
+ * 
+ * Discards the cached lookup & increments the table generation, so any data derived
+ * from the table can detect that it is stale.
+ */
 template <typename TTable>
+static inline void notifyTableChanged(TTable &table)
+{
+    invalidate_cache(&table.get_value_cache);
+    ++table.generation;
+}
+
+/** @brief Get a value from a 3D table, sharing axis resolutions via \p context. @see table3d_axis_context_t */
+template <bool useCache = TABLE3D_CACHE_DEFAULT, typename TTable>
+static inline table3d_value_t get3DTableValue(table3d_axis_context_t &context, const TTable *pTable, const uint16_t y, const uint16_t x) 
+{ 
+    constexpr uint16_t xFactor = getConversionFactor(TTable::XDomain);
+    constexpr uint16_t yFactor = getConversionFactor(TTable::YDomain);
+    return get3DTableValue<xFactor, yFactor, useCache>( context,
+                            &pTable->get_value_cache,
+                            pTable->values,
+                            pTable->axisX,
+                            pTable->axisY,
+                            { x, y });
+} 
+
+template <bool useCache = TABLE3D_CACHE_DEFAULT, typename TTable>
 static inline table3d_value_t get3DTableValue(const TTable *pTable, const uint16_t y, const uint16_t x) 
 { 
+#if !defined(UNIT_TEST) // No axis sharing during unit testing: tests change table axes without resetting the context
+    return get3DTableValue<useCache>(tableAxisContext, pTable, y, x);
+#else
     constexpr uint16_t xFactor = getConversionFactor(TTable::XDomain);
     constexpr uint16_t yFactor = getConversionFactor(TTable::YDomain);
-    return get3DTableValue<xFactor, yFactor>( &pTable->get_value_cache,
+    return get3DTableValue<xFactor, yFactor, useCache>( &pTable->get_value_cache,
                             pTable->values,
                             pTable->axisX,
                             pTable->axisY,
                             { x, y });
+#endif
 } 
 
+/**
+ * @brief Look up several tables with the same X & Y values in one pass.
+ * 
+ * E.g. the VE & AFR target tables are both looked up with RPM & fuel load. The tables share an
+ * axis context (see table3d_axis_context_t), so identical axes are resolved once. Each table's value
+ * cache is updated as normal, so a later single lookup of one of the tables with the same values
+ * is a cache hit.
+ * 
+ * @return The table values, in the same order as \p pTables
+ */
+template <bool useCache = TABLE3D_CACHE_DEFAULT, typename... TTables>
+static inline std::array<table3d_value_t, sizeof...(TTables)> get3DTableValues(const uint16_t y, const uint16_t x, const TTables *...pTables)
+{
+#if !defined(UNIT_TEST)
+    table3d_axis_context_t &context = tableAxisContext;
+#else
+    // The tables can't change during the batch, so a local context is safe
+    table3d_axis_context_t context;
+#endif
+    // Braced initialisation guarantees the tables are looked up in order
+    return {{ get3DTableValue<useCache>(context, pTables, y, x)... }};
+}
+
 /** @} */
@@ -2,6 +2,8 @@
 #include "maths.h"
 #include "unit_testing.h"
 #include "table2d.h"
+#include "table3d_axes.h"
+#include <string.h>
 
 /**
  * @file
@@ -100,13 +102,13 @@ TESTABLE_INLINE_STATIC QU1X8_t compute_bin_position(const uint16_t &value, const
 /** @brief Get the top right corner of the *value* coordinates in a 3D table, based on x/y axis coords. */
 TESTABLE_INLINE_STATIC row_col2d toTopRight(const table3d_bin_t &xBin, const table3d_bin_t &yBin, const table3d_dim_t &axisSize)
 {
-  return { (table3d_dim_t)(axisSize*yBin.upperIndex), xBin.upperIndex };
+  return { (uint16_t)((uint16_t)axisSize*yBin.upperIndex), xBin.upperIndex };
 }
 
 /** @brief Get the bottom left corner of the *value* coordinates in a 3D table, based on top right corner. */
 static inline row_col2d toBottomLeft(const row_col2d &topRight, const table3d_dim_t &axisSize)
 {
-  return { (table3d_dim_t)(topRight.row - axisSize), (table3d_dim_t)(topRight.col - UINT8_C(1)) };
+  return { (uint16_t)(topRight.row - axisSize), (table3d_dim_t)(topRight.col - UINT8_C(1)) };
 }
 
 /**
@@ -147,27 +149,24 @@ TESTABLE_INLINE_STATIC table3d_value_t bilinear_interpolation( const table3d_val
   return fromQU1X8( (tl * m) + (tr * n) + (bl * o) + (br * r) );
 }
 
-/**
- * @brief Interpolate a table value from axis bins & values.
- * 
- * @param lookUpValues The x & y axis values we are interpolating
- * @param axisSize The length of an axis
- * @param pValues The interpolation source values
- * @param xBin The x-axis bin containing lookUpValues.x
- * @param xMultiplier The x-axis multiplier
- * @param yBin The y-axis bin containing lookUpValues.y
- * @param yMultiplier The y-axis multiplier
- * @return table3d_value_t 
- */
- table3d_value_t interpolate_3d_value(const xy_pair_t &lookUpValues, 
-                    const table3d_dim_t &axisSize,
-                    const table3d_value_t *pValues,
-                    const table3d_bin_t &xBin,
-                    const uint16_t xMultiplier,
-                    const table3d_bin_t &yBin,
-                    const uint16_t yMultiplier)
+/** @brief Get the QU1X8_t position of an axis lookup value within its bin, computing it on first use. */
+template <uint16_t factor>
+static inline QU1X8_t getBinPosition(const table3d_axis_resolution_t &axis)
 {
-  /*
+  if (axis.binPosition==UINT16_MAX)
+  {
+    axis.binPosition = compute_bin_position(axis.lookupValue, axis.bin, factor);
+  }
+  return axis.binPosition;
+}
+
+/** @brief Load the 4 table values surrounding the lookup point: top left, top right, bottom left, bottom right. */
+template <table3d_dim_t axisSize>
+static inline void load_corners(table3d_value_t corners[4],
+                    const table3d_value_t *pValues,
+                    const table3d_axis_resolution_t &xAxis,
+                    const table3d_axis_resolution_t &yAxis)
+{  /*
   3D Tables have an origin (0,0) in the top left hand corner. Vertical axis is expressed first.
   Eg: 2x2 table
   -----
@@ -180,7 +179,7 @@ TESTABLE_INLINE_STATIC table3d_value_t bilinear_interpolation( const table3d_val
   (1,0) = 1
   (1,1) = 4
   */  
-  row_col2d tr = toTopRight(xBin, yBin, axisSize);
+  row_col2d tr = toTopRight(xAxis.bin, yAxis.bin, axisSize);
   row_col2d bl = toBottomLeft(tr, axisSize);
 
   /*
@@ -196,24 +195,186 @@ TESTABLE_INLINE_STATIC table3d_value_t bilinear_interpolation( const table3d_val
   Note that the values are stored in a 1D array, so we need to calculate the indices 
   appropriately based on the array layout.
   */
-  table3d_value_t A = pValues[tr.row + bl.col];
-  table3d_value_t B = pValues[tr.row + tr.col];
-  table3d_value_t C = pValues[bl.row + bl.col];
-  table3d_value_t D = pValues[bl.row + tr.col];  
-  
+  corners[0] = pValues[tr.row + bl.col]; // A
+  corners[1] = pValues[tr.row + tr.col]; // B
+  corners[2] = pValues[bl.row + bl.col]; // C
+  corners[3] = pValues[bl.row + tr.col]; // D
+}
+
+/** @brief Interpolate between the 4 corner values, as loaded by load_corners() */
+template <uint16_t xFactor, uint16_t yFactor>
+static inline table3d_value_t blend_corners(const table3d_value_t corners[4],
+                    const table3d_axis_resolution_t &xAxis,
+                    const table3d_axis_resolution_t &yAxis)
+{
   //Check that all values aren't just the same (This regularly happens with things like the fuel trim maps)
-  if( (A == B) && (A == C) && (A == D) ) 
+  if( (corners[0] == corners[1]) && (corners[0] == corners[2]) && (corners[0] == corners[3]) ) 
   { 
-    return A;
+    return corners[0];
+  }
+  //Create some normalised position values
+  //These are essentially percentages (between 0 and 1) of where the desired value falls between the nearest bins on each axis
+  const QU1X8_t p = getBinPosition<xFactor>(xAxis);
+  const QU1X8_t q = getBinPosition<yFactor>(yAxis);
+  return bilinear_interpolation(corners[0], corners[1], corners[2], corners[3], p, q);
+}
+
+/**
+ * @brief Check if a lookup value has the same position within its bin as a cached position.
+ * 
+ * I.e. compute_bin_position() would return \p cachedPosition, but without the division.
+ */
+template <uint16_t factor>
+static inline bool is_same_bin_position(const table3d_axis_resolution_t &axis, const uint16_t cachedPosition)
+{
+  uint16_t binMinValue = (uint16_t)axis.bin.lowerValue()*factor;
+  if (axis.lookupValue<=binMinValue) { return cachedPosition==0U; }
+  uint16_t binMaxValue = (uint16_t)axis.bin.upperValue()*factor;
+  if (axis.lookupValue>=binMaxValue) { return cachedPosition==QU1X8_ONE; }
+  uint16_t binWidth = binMaxValue-binMinValue;
+
+  uint32_t p = (uint32_t)(axis.lookupValue - binMinValue) << QU1X8_INTEGER_SHIFT;
+  uint32_t cachedMin = (uint32_t)cachedPosition*binWidth;
+  return (p>=cachedMin) && (p<(cachedMin+binWidth));
+}
+
+/** @brief Check if the cached output is still exact: the lookup moved by less than the interpolation resolution (1/256 of a bin) */
+template <uint16_t xFactor, uint16_t yFactor>
+static inline bool is_below_resolution(const table3DGetValueCache &cache,
+                    const table3d_axis_resolution_t &xAxis,
+                    const table3d_axis_resolution_t &yAxis)
+{
+  //All corners the same: the position within the bins is irrelevant
+  if( (cache.corners[0] == cache.corners[1]) && (cache.corners[0] == cache.corners[2]) && (cache.corners[0] == cache.corners[3]) ) 
+  {
+    return true;
+  }
+  return is_same_bin_position<xFactor>(xAxis, cache.lastBinPosition.x) 
+      && is_same_bin_position<yFactor>(yAxis, cache.lastBinPosition.y);
+}
+
+/**
+ * @brief Interpolate a table value from axis bins & values, via the value cache.
+ * 
+ * If the bins are unchanged since the last lookup, the cached corner values are reused. If additionally
+ * the bin positions are unchanged, the last output is returned without interpolating.
+ * 
+ * @tparam axisSize The length of an axis
+ * @tparam xFactor The x-axis conversion factor
+ * @tparam yFactor The y-axis conversion factor
+ * @tparam useCache false to bypass the cache: it is neither read nor updated
+ * @param cache The table value cache
+ * @param pValues The interpolation source values
+ * @param xAxis The x-axis bin & position
+ * @param yAxis The y-axis bin & position
+ * @return table3d_value_t 
+ */
+template <table3d_dim_t axisSize, uint16_t xFactor, uint16_t yFactor, bool useCache>
+table3d_value_t interpolate_3d_value(table3DGetValueCache &cache,
+                    const table3d_value_t *pValues,
+                    const table3d_axis_resolution_t &xAxis,
+                    const table3d_axis_resolution_t &yAxis)
+{
+  // A compile time constant: the branch not taken is discarded
+  if (!useCache)
+  {
+    table3d_value_t corners[4];
+    load_corners<axisSize>(corners, pValues, xAxis, yAxis);
+    return blend_corners<xFactor, yFactor>(corners, xAxis, yAxis);
+  }
+
+  const bool sameBins = (cache.last_lookup.x!=UINT16_MAX) 
+                      && (xAxis.bin.upperIndex==cache.lastBinMax.x) 
+                      && (yAxis.bin.upperIndex==cache.lastBinMax.y);
+  if (sameBins && is_below_resolution<xFactor, yFactor>(cache, xAxis, yAxis))
+  {
+    recordCacheResult(Table3dCacheResult::BelowResolution);
+    return cache.lastOutput;
+  }
+  if (sameBins)
+  {
+    recordCacheResult(Table3dCacheResult::SameBin);
   }
   else
   {
-    //Create some normalised position values
-    //These are essentially percentages (between 0 and 1) of where the desired value falls between the nearest bins on each axis
-    const QU1X8_t p = compute_bin_position(lookUpValues.x, xBin, xMultiplier);
-    const QU1X8_t q = compute_bin_position(lookUpValues.y, yBin, yMultiplier);
-    return bilinear_interpolation(A, B, C, D, p, q);
+    recordCacheResult(Table3dCacheResult::Miss);
+    load_corners<axisSize>(cache.corners, pValues, xAxis, yAxis);
+    cache.lastBinMax = { xAxis.bin.upperIndex, yAxis.bin.upperIndex };
+  }
+  cache.last_lookup = { xAxis.lookupValue, yAxis.lookupValue };
+  cache.lastOutput = blend_corners<xFactor, yFactor>(cache.corners, xAxis, yAxis);
+  // Not computed if the corners are all the same - but then is_below_resolution() doesn't need them
+  cache.lastBinPosition = { xAxis.binPosition, yAxis.binPosition };
+  return cache.lastOutput;
+}
+
+// One kernel per table type, with & without the cache. Unused kernels are discarded by the linker.
+#define TABLE3D_GEN_INTERPOLATE_CACHE(size, xDom, yDom, useCache) \
+  template table3d_value_t interpolate_3d_value<(size), getConversionFactor(AxisDomain::xDom), getConversionFactor(AxisDomain::yDom), (useCache)>( \
+                    table3DGetValueCache &cache, \
+                    const table3d_value_t *pValues, \
+                    const table3d_axis_resolution_t &xAxis, \
+                    const table3d_axis_resolution_t &yAxis);
+#define TABLE3D_GEN_INTERPOLATE(size, xDom, yDom) \
+  TABLE3D_GEN_INTERPOLATE_CACHE(size, xDom, yDom, true) \
+  TABLE3D_GEN_INTERPOLATE_CACHE(size, xDom, yDom, false)
+TABLE3D_GENERATOR(TABLE3D_GEN_INTERPOLATE)
+
+/// @}
+
+#if defined(UNIT_TEST)
+table3d_cache_stats_t table3dCacheStats;
+#endif
+
+/// @name Shared axis resolution
+/// @{
+
+table3d_axis_context_t tableAxisContext;
+
+static inline bool isSameAxis(const table3d_axis_context_t::slot_t &slot, 
+                              const table3d_axis_t *pAxis, const table3d_dim_t axisSize)
+{
+  return (slot.axisSize==axisSize)
+      && ((slot.pAxis==pAxis) || (memcmp(slot.pAxis, pAxis, axisSize*sizeof(table3d_axis_t))==0));
+}
+
+const table3d_axis_resolution_t* findSharedAxis(table3d_axis_context_t &context, 
+                    const table3d_axis_t *pAxis, const table3d_dim_t axisSize,
+                    const uint16_t factor, const uint16_t lookupValue)
+{
+  for (uint8_t index=0U; index<context.count; ++index)
+  {
+    const table3d_axis_context_t::slot_t &slot = context.slots[index];
+    // Check the lookup value first: it's much cheaper than comparing the axes
+    if ((slot.resolution.lookupValue==lookupValue)
+    && (slot.resolution.factor==factor)
+    && isSameAxis(slot, pAxis, axisSize))
+    {
+      context.lastUsed = index;
+      return &slot.resolution;
+    }
+  }
+  return nullptr;
+}
+
+const table3d_axis_resolution_t& addSharedAxis(table3d_axis_context_t &context, 
+                    const table3d_axis_t *pAxis, const table3d_dim_t axisSize,
+                    const table3d_axis_resolution_t &resolution)
+{
+  // Round robin replacement, skipping the slot used immediately before this one: it may
+  // hold the other axis of the table being looked up.
+  if (context.next==context.lastUsed)
+  {
+    context.next = (context.next+1U) % table3d_axis_context_t::MAX_AXES;
   }
+  context.lastUsed = context.next;
+  table3d_axis_context_t::slot_t &slot = context.slots[context.next];
+  slot.pAxis = pAxis;
+  slot.axisSize = axisSize;
+  slot.resolution = resolution;
+  context.next = (context.next+1U) % table3d_axis_context_t::MAX_AXES;
+  if (context.count<table3d_axis_context_t::MAX_AXES) { ++context.count; }
+  return slot.resolution;
 }
 
 /// @}
\ No newline at end of file
@@ -52,6 +52,12 @@ struct table3DGetValueCache {
   //Store the last input and output values, again for caching purposes
   xy_pair_t last_lookup = { UINT16_MAX, UINT16_MAX };
   table3d_value_t lastOutput;
+
+  // The 4 table values surrounding last_lookup (top left, top right, bottom left, bottom right)
+  // and the position of last_lookup within the bins. While the lookup values stay in the same 
+  // bins only the blend needs redoing; and if the bin positions are also unchanged, not even that.
+  table3d_value_t corners[4];
+  xy_pair_t lastBinPosition;
 };
 
 /** @brief Invalidate the cache by resetting the last lookup values. */
@@ -60,20 +66,170 @@ static inline void invalidate_cache(table3DGetValueCache *pCache)
     pCache->last_lookup.x = UINT16_MAX;
 }
 
+/** @brief Whether get3DTableValue() uses the value cache by default.
+ * 
+ * Off during unit testing: tests change tables without invalidating the cache.
+ */
+#if !defined(UNIT_TEST)
+static constexpr bool TABLE3D_CACHE_DEFAULT = true;
+#else
+static constexpr bool TABLE3D_CACHE_DEFAULT = false;
+#endif
+
+/** @brief How a cached 3D table lookup was satisfied */
+enum class Table3dCacheResult : uint8_t {
+  /** Same lookup values as last time */
+  Exact,
+  /** Same bins & the same positions within them (to the interpolation resolution): last output returned */
+  BelowResolution,
+  /** Same bins: the cached corner values were re-blended */
+  SameBin,
+  /** The corner values were fetched from the table */
+  Miss,
+};
+
+#if defined(UNIT_TEST)
+/** @brief Cache result counts, across all tables. Unit tests only */
+struct table3d_cache_stats_t {
+  uint32_t results[(uint8_t)Table3dCacheResult::Miss+1U] = {};
+
+  uint32_t count(Table3dCacheResult result) const { return results[(uint8_t)result]; }
+  uint32_t total(void) const {
+    return count(Table3dCacheResult::Exact) + count(Table3dCacheResult::BelowResolution)
+         + count(Table3dCacheResult::SameBin) + count(Table3dCacheResult::Miss);
+  }
+};
+extern table3d_cache_stats_t table3dCacheStats;
+#endif
+
+/// @cond
+static inline void recordCacheResult(Table3dCacheResult result)
+{
+#if defined(UNIT_TEST)
+  ++table3dCacheStats.results[(uint8_t)result];
+#else
+  (void)result;
+#endif
+}
+/// @endcond
+
 /// @cond
 // private to table3D implementation
 using table3d_bin_t = _table2d_detail::Bin<table3d_axis_t>;
 
-extern table3d_value_t interpolate_3d_value(const xy_pair_t &lookUpValues, 
-                    const table3d_dim_t &axisSize,
+/** @brief Where a lookup value falls on one table axis: the bin, plus the position within that bin. */
+struct table3d_axis_resolution_t {
+  constexpr table3d_axis_resolution_t(void)
+  : table3d_axis_resolution_t(0U, 0U, table3d_bin_t(1U, 0U, 0U))
+  {
+  }
+  constexpr table3d_axis_resolution_t(uint16_t value, uint16_t multiplier, const table3d_bin_t &axisBin)
+  : lookupValue(value)
+  , factor(multiplier)
+  , bin(axisBin)
+  {
+  }
+
+  uint16_t lookupValue;
+  uint16_t factor;
+  table3d_bin_t bin;
+  // QU1X8_t position of lookupValue within the bin. This is only needed if the 4 corner values
+  // differ, so is computed on first use (UINT16_MAX until then).
+  mutable uint16_t binPosition = UINT16_MAX;
+};
+
+// Specialised per table size, axis domains & cache use, so the row stride, axis conversion factors
+// and cache branches are resolved at compile time. Instantiated for each TABLE3D_GENERATOR table type only.
+template <table3d_dim_t axisSize, uint16_t xFactor, uint16_t yFactor, bool useCache>
+table3d_value_t interpolate_3d_value(table3DGetValueCache &cache,
                     const table3d_value_t *pValues,
-                    const table3d_bin_t &xBin,
-                    const uint16_t xMultiplier,
-                    const table3d_bin_t &yBin,
-                    const uint16_t yMultiplier);
+                    const table3d_axis_resolution_t &xAxis,
+                    const table3d_axis_resolution_t &yAxis);
 
 /// @endcond
 
+/**
+ * @brief Axis resolutions shared by all 3D tables looked up in one pass of the main loop.
+ * 
+ * Most of the tables looked up each loop (VE, spark, AFR, dwell, trims etc.) have identical RPM & load
+ * axes and are looked up with the same RPM & load values. Once one of those tables has resolved an axis,
+ * the bin search and the bin position (compute_bin_position()) are reused by any other table whose 
+ * axis is byte identical & looked up with the same value.
+ * 
+ * @note The axis *contents* are not tracked. The context must be reset (resetAxisContext()) whenever 
+ * a table axis may have changed - the main loop does this after processing comms, if the tune generation
+ * (getTuneGeneration()) has changed.
+ */
+struct table3d_axis_context_t {
+  /** @brief Maximum number of distinct axis resolutions held. Once full, the oldest is replaced. */
+  static constexpr uint8_t MAX_AXES = 6U;
+
+  /// @cond
+  struct slot_t {
+    const table3d_axis_t *pAxis = nullptr;
+    table3d_dim_t axisSize = 0U;
+    table3d_axis_resolution_t resolution;
+  };
+  slot_t slots[MAX_AXES];
+  uint8_t count = 0U;
+  uint8_t next = 0U;
+  uint8_t lastUsed = UINT8_MAX;
+  /// @endcond
+};
+
+// A table's X & Y resolutions must both survive until it has been interpolated.
+static_assert(table3d_axis_context_t::MAX_AXES>=2U, "Axis context must hold at least 2 axes");
+
+/** @brief The axis context used by the main loop. @see get3DTableValue(const TTable*, const uint16_t, const uint16_t) */
+extern table3d_axis_context_t tableAxisContext;
+
+/** @brief Discard all shared axis resolutions. */
+static inline void resetAxisContext(table3d_axis_context_t &context)
+{
+  context.count = 0U;
+  context.next = 0U;
+  context.lastUsed = UINT8_MAX;
+}
+
+/// @cond
+// private to table3D implementation
+extern const table3d_axis_resolution_t* findSharedAxis(table3d_axis_context_t &context, 
+                    const table3d_axis_t *pAxis, const table3d_dim_t axisSize,
+                    const uint16_t factor, const uint16_t lookupValue);
+extern const table3d_axis_resolution_t& addSharedAxis(table3d_axis_context_t &context, 
+                    const table3d_axis_t *pAxis, const table3d_dim_t axisSize,
+                    const table3d_axis_resolution_t &resolution);
+
+template <uint16_t factor, typename TAxis>
+static inline const table3d_axis_resolution_t& resolveSharedAxis(table3d_axis_context_t &context,
+                    const TAxis &axis,
+                    const uint16_t lookupValue,
+                    const table3d_dim_t cachedUpperIndex)
+{
+  constexpr table3d_dim_t axisSize = std::tuple_size<TAxis>::value;
+  const table3d_axis_resolution_t *pShared = findSharedAxis(context, axis.data(), axisSize, factor, lookupValue);
+  if (pShared==nullptr)
+  {
+    auto bin = _table2d_detail::findCachedBin(cachedUpperIndex, std::begin(axis), std::end(axis), (table3d_dim_t)div_round_closest_u16<factor>(lookupValue));
+    pShared = &addSharedAxis(context, axis.data(), axisSize, table3d_axis_resolution_t(lookupValue, factor, bin));
+  }
+  return *pShared;
+}
+
+template <bool useCache>
+static inline bool isCachedLookup(const struct table3DGetValueCache *pValueCache, const xy_pair_t &lookupValues)
+{
+  // Check if the lookup values are the same as the last time we looked up a value
+  // If they are, we can return the cached value
+  if (useCache && (lookupValues == pValueCache->last_lookup))
+  {
+    recordCacheResult(Table3dCacheResult::Exact);
+    return true;
+  }
+  return false;
+}
+/// @endcond
+
 /** @brief Get a value from a 3D table using the specified lookup values.
  *
  * Conceptually, a 3d table consists of a 2D table (rows & columns) and 2 axes. E.g. 6x6 table (tables are always square):
@@ -106,8 +262,14 @@ extern table3d_value_t interpolate_3d_value(const xy_pair_t &lookUpValues,
  * 1. Divide the axis *lookup value* when searching for the axis bin (no loss of fidelity, since we're comparing bin thresholds). E.g RPM of 2153/100 -> 22
  * 2. Multiply the *axis values* when interpolating the axis position (retain fidelity). E.g. bin [20,25] becomes [2000,2500] which gives a bin position of 31% (instead of 40%)
  * 
+ * @note Caching: MAP is noisy, so exact repeats of the lookup values are rare. While the lookup values 
+ * stay within the same bins the cached corner values are re-blended rather than fetched from the table; 
+ * and if the positions within the bins are unchanged to the resolution of the interpolation (1/256 of a 
+ * bin) the last output is returned as-is. Either way, the result is identical to an uncached lookup.
+ * 
  * @tparam xFactor The factor used to scale the lookup value to/from the same units as the axis values.
  * @tparam yFactor The factor for the Y axis values.
+ * @tparam useCache Use (true) or bypass (false) the value cache. 
  * @param pValueCache Pointer to the value cache structure.
  * @param values The table values.
  * @param xAxis The X axis array.
@@ -115,21 +277,17 @@ extern table3d_value_t interpolate_3d_value(const xy_pair_t &lookUpValues,
  * @param lookupValues The X axis and Y axis values to look up.
  * @return The interpolated value from the table.
  */
-template <uint16_t xFactor, uint16_t yFactor, typename TValues, typename TXAxis, typename TYAxis>
+template <uint16_t xFactor, uint16_t yFactor, bool useCache = TABLE3D_CACHE_DEFAULT, typename TValues, typename TXAxis, typename TYAxis>
 table3d_value_t get3DTableValue(struct table3DGetValueCache *pValueCache, 
                     const TValues &values,
                     const TXAxis &xAxis,
                     const TYAxis &yAxis,
                     const xy_pair_t &lookupValues) {
   
-#if !defined(UNIT_TEST) // No caching during unit testing
-  // Check if the lookup values are the same as the last time we looked up a value
-  // If they are, we can return the cached value
-  if( lookupValues == pValueCache->last_lookup)
+  if (isCachedLookup<useCache>(pValueCache, lookupValues))
   {
     return pValueCache->lastOutput;
   }
-#endif
 
   constexpr table3d_dim_t axisSize = std::tuple_size<TXAxis>::value;
 
@@ -138,18 +296,44 @@ table3d_value_t get3DTableValue(struct table3DGetValueCache *pValueCache,
   auto yBin = _table2d_detail::findCachedBin(pValueCache->lastBinMax.y, std::begin(yAxis), std::end(yAxis), (table3d_dim_t)div_round_closest_u16<yFactor>(lookupValues.y));
   
   // Interpolate based on the bin positions
-  pValueCache->lastOutput = interpolate_3d_value(lookupValues, axisSize, values.data(), xBin, xFactor, yBin, yFactor);
-  // Store the last lookup values so we can check them next time
-  pValueCache->last_lookup = lookupValues;
-  pValueCache->lastBinMax.x = xBin.upperIndex;
-  pValueCache->lastBinMax.y = yBin.upperIndex;
+  return interpolate_3d_value<axisSize, xFactor, yFactor, useCache>(*pValueCache, values.data(), 
+                              table3d_axis_resolution_t(lookupValues.x, xFactor, xBin), 
+                              table3d_axis_resolution_t(lookupValues.y, yFactor, yBin));
+}
+
+/** @brief Get a value from a 3D table, sharing axis resolutions with other tables.
+ *
+ * Identical to get3DTableValue() above, except the axis bins & bin positions are taken from 
+ * (or added to) \p context.
+ * 
+ * @param context Axis resolutions shared between tables
+ * @copydetails get3DTableValue
+ */
+template <uint16_t xFactor, uint16_t yFactor, bool useCache = TABLE3D_CACHE_DEFAULT, typename TValues, typename TXAxis, typename TYAxis>
+table3d_value_t get3DTableValue(table3d_axis_context_t &context,
+                    struct table3DGetValueCache *pValueCache, 
+                    const TValues &values,
+                    const TXAxis &xAxis,
+                    const TYAxis &yAxis,
+                    const xy_pair_t &lookupValues) {
+  
+  if (isCachedLookup<useCache>(pValueCache, lookupValues))
+  {
+    return pValueCache->lastOutput;
+  }
 
-  return pValueCache->lastOutput;
+  constexpr table3d_dim_t axisSize = std::tuple_size<TXAxis>::value;
 
+  return interpolate_3d_value<axisSize, xFactor, yFactor, useCache>(*pValueCache, values.data(), 
+                              resolveSharedAxis<xFactor>(context, xAxis, lookupValues.x, pValueCache->lastBinMax.x),
+                              resolveSharedAxis<yFactor>(context, yAxis, lookupValues.y, pValueCache->lastBinMax.y));
 }
 
-/** @brief Row and column coordinates in a 2D table */
+/** @brief Row and column coordinates in a 2D table 
+ * 
+ * @note The row is the index of the first value in the row, so can exceed the range of table3d_dim_t
+ */
 struct row_col2d {
-  table3d_dim_t row;
+  uint16_t row;
   table3d_dim_t col;
 };
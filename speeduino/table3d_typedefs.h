@@ -37,7 +37,22 @@ using table3d_axis_t = uint8_t;
     GENERATOR(6, Rpm, Load, ##__VA_ARGS__) \
     GENERATOR(4, Rpm, Load, ##__VA_ARGS__) \
     GENERATOR(8, Rpm, Load, ##__VA_ARGS__) \
-    GENERATOR(16, Rpm, Load, ##__VA_ARGS__)
+    GENERATOR(16, Rpm, Load, ##__VA_ARGS__) \
+    TABLE3D_GENERATOR_LARGE(GENERATOR, ##__VA_ARGS__)
+
+/** @brief Larger table sizes, for boards with the RAM to hold them. 
+ * 
+ * Enabled by the TABLE3D_LARGE_TABLES build flag (see platformio.ini). The flag also
+ * changes the tune layout (the VE table is 24x24), so it is a build option rather than
+ * a board property: only environments with storage for the larger tune set it.
+ */
+#if defined(TABLE3D_LARGE_TABLES)
+#define TABLE3D_GENERATOR_LARGE(GENERATOR, ...) \
+    GENERATOR(20, Rpm, Load, ##__VA_ARGS__) \
+    GENERATOR(24, Rpm, Load, ##__VA_ARGS__)
+#else
+#define TABLE3D_GENERATOR_LARGE(GENERATOR, ...)
+#endif
 
 // Each 3d table is given a distinct type based on size & axis domains
 // This encapsulates the generation of the type name
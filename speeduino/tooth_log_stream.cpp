@@ -0,0 +1,171 @@
+#include "tooth_log_stream.h"
+#include <Arduino.h>
+#include "src/utils/seqlock.hpp"
+
+static constexpr uint16_t SERIALISED_HEADER_SIZE = 5U * sizeof(uint16_t);
+static constexpr uint16_t SERIALISED_EDGE_SIZE = sizeof(uint32_t) + sizeof(uint8_t);
+
+#if defined(TOOTH_LOG_STREAM)
+
+static uint8_t* writeU16(uint8_t *pBuffer, uint16_t value)
+{
+  pBuffer[0] = lowByte(value);
+  pBuffer[1] = highByte(value);
+  return pBuffer + 2U;
+}
+
+static uint8_t* writeU32(uint8_t *pBuffer, uint32_t value)
+{
+  pBuffer = writeU16(pBuffer, (uint16_t)(value & UINT16_MAX));
+  return writeU16(pBuffer, (uint16_t)(value >> 16U));
+}
+
+static tooth_log_block_t blocks[2];
+static volatile bool blockReady[2]; // Owned by the main loop while true, by the ISRs while false
+static uint8_t fillIndex;           // ISR only: the block being filled
+static uint16_t droppedPending;     // ISR only: edges dropped since the last block started
+static uint16_t nextSequence;       // ISR only
+static volatile bool isCapturing;   // Written by the main loop, read by the ISRs
+static ToothLogSink owner = ToothLogSink::None; // Main loop only: the sink allowed to drain
+static uint8_t drainIndex;          // Main loop only: the next block to be drained
+static uint16_t drainOffset;        // Main loop only: edges of the drain block already serialised
+static uint32_t droppedTotal;       // Main loop only
+
+bool toothLogStreamBegin(ToothLogSink sink)
+{
+  if (isCapturing && (owner != sink)) { return false; }
+
+  noInterrupts();
+  for (uint8_t index = 0U; index < 2U; ++index)
+  {
+    blocks[index].count = 0U;
+    blockReady[index] = false;
+  }
+  fillIndex = 0U;
+  droppedPending = 0U;
+  nextSequence = 0U;
+  drainIndex = 0U;
+  drainOffset = 0U;
+  droppedTotal = 0U;
+  owner = sink;
+  isCapturing = sink != ToothLogSink::None;
+  interrupts();
+  return true;
+}
+
+bool toothLogStreamEnd(ToothLogSink sink)
+{
+  if (owner != sink) { return false; }
+
+  noInterrupts();
+  isCapturing = false;
+  if (!blockReady[fillIndex] && (blocks[fillIndex].count > 0U))
+  {
+    blockReady[fillIndex] = true;
+    fillIndex = fillIndex ^ 1U;
+  }
+  interrupts();
+  return true;
+}
+
+bool toothLogStreamIsCapturing(void)
+{
+  return isCapturing;
+}
+
+void toothLogStreamAppend(uint32_t time, uint8_t status)
+{
+  if (!isCapturing) { return; }
+  if (blockReady[fillIndex])
+  {
+    // Both blocks are waiting to be drained
+    if (droppedPending < UINT16_MAX) { ++droppedPending; }
+    return;
+  }
+
+  tooth_log_block_t &block = blocks[fillIndex];
+  if (block.count == 0U)
+  {
+    block.sequence = nextSequence++;
+    block.dropped = droppedPending;
+    droppedPending = 0U;
+  }
+  block.times[block.count] = time;
+  block.status[block.count] = status;
+  ++block.count;
+
+  if (block.count == TOOTH_LOG_BLOCK_SIZE)
+  {
+    blockReady[fillIndex] = true;
+    fillIndex = fillIndex ^ 1U;
+  }
+}
+
+const tooth_log_block_t* toothLogStreamNextBlock(ToothLogSink sink)
+{
+  if (owner != sink) { return nullptr; }
+  bool isReady = blockReady[drainIndex];
+  SEQLOCK_BARRIER(); // Don't read the block contents before the flag
+  return isReady ? &blocks[drainIndex] : nullptr;
+}
+
+void toothLogStreamRelease(ToothLogSink sink)
+{
+  if ( (owner == sink) && blockReady[drainIndex] )
+  {
+    droppedTotal = droppedTotal + blocks[drainIndex].dropped;
+    // The ISRs don't touch a ready block, so it can be emptied before handing it back
+    blocks[drainIndex].count = 0U;
+    SEQLOCK_BARRIER(); // The count must be cleared before the ISRs can see the block
+    blockReady[drainIndex] = false;
+    drainIndex = drainIndex ^ 1U;
+    drainOffset = 0U;
+  }
+}
+
+uint32_t toothLogStreamDropped(void)
+{
+  return droppedTotal;
+}
+
+uint16_t serialiseToothLogBlock(uint8_t *pBuffer, uint16_t bufferSize)
+{
+  if (bufferSize < SERIALISED_HEADER_SIZE) { return 0U; }
+
+  const tooth_log_block_t *pBlock = toothLogStreamNextBlock(ToothLogSink::Serial);
+  uint16_t chunkSize = 0U;
+  if (pBlock != nullptr)
+  {
+    chunkSize = pBlock->count - drainOffset;
+    uint16_t maxChunkSize = (bufferSize - SERIALISED_HEADER_SIZE) / SERIALISED_EDGE_SIZE;
+    if (chunkSize > maxChunkSize) { chunkSize = maxChunkSize; }
+  }
+
+  uint8_t *pNext = pBuffer;
+  pNext = writeU16(pNext, pBlock == nullptr ? 0U : pBlock->sequence);
+  pNext = writeU16(pNext, pBlock == nullptr ? 0U : pBlock->dropped);
+  pNext = writeU16(pNext, drainOffset);
+  pNext = writeU16(pNext, chunkSize);
+  pNext = writeU16(pNext, pBlock == nullptr ? 0U : pBlock->count);
+  for (uint16_t index = drainOffset; index < (drainOffset + chunkSize); ++index)
+  {
+    pNext = writeU32(pNext, pBlock->times[index]);
+    *pNext++ = pBlock->status[index];
+  }
+
+  drainOffset = drainOffset + chunkSize;
+  if ( (pBlock != nullptr) && (drainOffset >= pBlock->count) ) { toothLogStreamRelease(ToothLogSink::Serial); }
+
+  return (uint16_t)(pNext - pBuffer);
+}
+
+#else
+
+uint16_t serialiseToothLogBlock(uint8_t *pBuffer, uint16_t bufferSize)
+{
+  if (bufferSize < SERIALISED_HEADER_SIZE) { return 0U; }
+  for (uint16_t index = 0U; index < SERIALISED_HEADER_SIZE; ++index) { pBuffer[index] = 0U; }
+  return SERIALISED_HEADER_SIZE;
+}
+
+#endif
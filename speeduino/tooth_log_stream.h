@@ -0,0 +1,119 @@
+#pragma once
+
+/**
+ * @file
+ * @brief Continuous tooth & composite logging.
+ *
+ * The TunerStudio tooth log (@ref toothHistory) holds TOOTH_LOG_SIZE entries & stops when full, so it
+ * can only capture a short window. The stream keeps going: the logger ISRs fill one block while the main
+ * loop drains the other to the SD card (see SD_logger.cpp) or the serial port ('g' command). If
+ * the main loop falls so far behind that both blocks are full, edges are counted & dropped rather
+ * than overwriting data that hasn't been sent yet.
+ *
+ * Each block records the number of edges dropped immediately before it, so gaps in a long capture
+ * can be located exactly.
+ *
+ * The stream is started & stopped on its own (see startToothLogStream()), independently of the
+ * TunerStudio loggers. There is one set of blocks, so only one sink can own the stream at a time: a
+ * sink can't start a capture while another sink's capture is running, and only the owner can drain.
+ *
+ * Enabled by default on boards with spare RAM. On AVR it must be turned on explicitly by defining
+ * TOOTH_LOG_STREAM.
+ */
+
+#include <stdint.h>
+#include "board_definition.h"
+
+#if !defined(CORE_AVR) && !defined(TOOTH_LOG_STREAM)
+#define TOOTH_LOG_STREAM
+#endif
+
+/** @brief Number of edges per block */
+#if defined(CORE_AVR)
+static constexpr uint16_t TOOTH_LOG_BLOCK_SIZE = 32U;
+#else
+static constexpr uint16_t TOOTH_LOG_BLOCK_SIZE = 256U;
+#endif
+
+/** @brief A block of logged edges */
+struct tooth_log_block_t {
+  uint32_t times[TOOTH_LOG_BLOCK_SIZE];   ///< micros() at the edge
+  uint8_t status[TOOTH_LOG_BLOCK_SIZE];   ///< Composite log status bits, as @ref compositeLogHistory for the crank & cam 1 composite logger
+  uint16_t count;                         ///< Number of edges in the block
+  uint16_t sequence;                      ///< Block number since the stream started
+  uint16_t dropped;                       ///< Edges dropped immediately before this block (saturates)
+};
+
+/** @brief The consumers of the stream */
+enum class ToothLogSink : uint8_t {
+  None,
+  SD,     ///< The .tlg file alongside the SD card csv log
+  Serial, ///< The 'g' serial command
+};
+
+#if defined(TOOTH_LOG_STREAM)
+
+/**
+ * @brief Discard all logged data & start a new capture, drained by @p sink. Call before attaching the logger ISRs.
+ *
+ * @return false if another sink's capture is running. The stream is left untouched.
+ */
+bool toothLogStreamBegin(ToothLogSink sink);
+
+/**
+ * @brief Stop capturing & mark the partially filled block as ready, so the last few edges can be drained.
+ *
+ * Does nothing if @p sink doesn't own the stream. The owner can carry on draining until another capture begins.
+ *
+ * @return true if @p sink owns the stream
+ */
+bool toothLogStreamEnd(ToothLogSink sink);
+
+/** @brief Is a capture running? */
+bool toothLogStreamIsCapturing(void);
+
+/** @brief Log one edge. Called from the logger ISRs. Ignored unless a capture is running. */
+void toothLogStreamAppend(uint32_t time, uint8_t status);
+
+/**
+ * @brief Get the next block to be drained.
+ *
+ * @return The oldest full block, or nullptr if there is none or @p sink doesn't own the stream. Valid until toothLogStreamRelease()
+ */
+const tooth_log_block_t* toothLogStreamNextBlock(ToothLogSink sink);
+
+/** @brief Finish with the block returned by toothLogStreamNextBlock(), so the ISRs can refill it */
+void toothLogStreamRelease(ToothLogSink sink);
+
+/** @brief Total edges dropped in the blocks released so far */
+uint32_t toothLogStreamDropped(void);
+
+#else
+
+static inline bool toothLogStreamBegin(ToothLogSink) { return false; }
+static inline bool toothLogStreamEnd(ToothLogSink) { return false; }
+static inline bool toothLogStreamIsCapturing(void) { return false; }
+static inline void toothLogStreamAppend(uint32_t, uint8_t) { }
+static inline const tooth_log_block_t* toothLogStreamNextBlock(ToothLogSink) { return nullptr; }
+static inline void toothLogStreamRelease(ToothLogSink) { }
+static inline uint32_t toothLogStreamDropped(void) { return 0U; }
+
+#endif
+
+/**
+ * @brief Serialise (part of) the next block for the 'g' serial command. The block is released
+ * once all of it has been sent. Sends an empty chunk unless the serial sink owns the stream.
+ *
+ * Format (all values little endian):
+ *  - uint16_t block sequence number
+ *  - uint16_t edges dropped before the block
+ *  - uint16_t index of the first edge in this chunk
+ *  - uint16_t number of edges in this chunk (0 if no block is ready)
+ *  - uint16_t number of edges in the block
+ *  - For each edge: uint32_t time then uint8_t status
+ *
+ * @param pBuffer Destination
+ * @param bufferSize Size of @p pBuffer
+ * @return Number of bytes written
+ */
+uint16_t serialiseToothLogBlock(uint8_t *pBuffer, uint16_t bufferSize);
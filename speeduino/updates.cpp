@@ -96,9 +96,90 @@ TESTABLE_STATIC void upgradeV26toV27(void) {
   }
 }
 
+TESTABLE_STATIC void upgradeV27toV28(void) {
+  if(loadEEPROMVersion() == 27U)
+  {
+    //Per tooth fuel timing reuses the bit that was canBMWCluster, which may still be set in older tunes
+    configPage2.perToothFuel = 0;
+
+    saveAllPages();
+    saveEEPROMVersion(28);
+  }
+}
+
+#if defined(TABLE3D_LARGE_TABLES)
+/**
+ * @brief Copy an axis into a longer one, splitting the widest bins until it is full.
+ * 
+ * The original bins are all kept, so a table resampled onto the new axes interpolates to the same values.
+ */
+template <typename TSourceAxis, typename TTargetAxis>
+static void expandAxis(const TSourceAxis &source, TTargetAxis &target)
+{
+  (void)std::copy(source.begin(), source.end(), target.begin());
+  uint8_t size = (uint8_t)source.size();
+  while (size<target.size())
+  {
+    uint8_t widest = 1U;
+    for (uint8_t i = 2U; i < size; ++i)
+    {
+      if ((target[i]-target[i-1U]) > (target[widest]-target[widest-1U])) { widest = i; }
+    }
+    (void)std::copy_backward(target.begin()+widest, target.begin()+size, target.begin()+size+1U);
+    target[widest] = (table3d_axis_t)(((uint16_t)target[widest-1U] + (uint16_t)target[widest+1U]) / 2U);
+    ++size;
+  }
+}
+
+/** @brief Resample a 3D table onto a larger one. @see expandAxis */
+template <typename TSource, typename TTarget>
+static void expandTable(const TSource &source, TTarget &target)
+{
+  expandAxis(source.axisX, target.axisX);
+  expandAxis(source.axisY, target.axisY);
+  constexpr uint16_t xFactor = getConversionFactor(TSource::XDomain);
+  constexpr uint16_t yFactor = getConversionFactor(TSource::YDomain);
+  auto pValue = target.values.begin();
+  for (const auto y : target.axisY)
+  {
+    for (const auto x : target.axisX)
+    {
+      *pValue = get3DTableValue(&source, (uint16_t)(y*yFactor), (uint16_t)(x*xFactor));
+      ++pValue;
+    }
+  }
+  notifyTableChanged(target);
+  // The source table is about to go out of scope: don't leave its axes in the shared context
+  resetAxisContext(tableAxisContext);
+}
+#endif
+
+// V29 allows a 24x24 VE table (TABLE3D_LARGE_TABLES builds only). It is stored after the original 4K layout.
+TESTABLE_STATIC void upgradeV28toV29(void) {
+  if(loadEEPROMVersion() == 28U)
+  {
+#if defined(TABLE3D_LARGE_TABLES)
+    constexpr uint16_t V28_EEPROM_CONFIG1_MAP = 3U;
+
+    table3d16RpmLoad v28Table;
+    uint16_t address = loadBlock(getStorageAPI(), V28_EEPROM_CONFIG1_MAP, v28Table.values.data(), v28Table.values.data()+v28Table.values.size());
+    address = loadBlock(getStorageAPI(), address, v28Table.axisX.data(), v28Table.axisX.data()+v28Table.axisX.size());
+    (void)loadBlock(getStorageAPI(), address, v28Table.axisY.data(), v28Table.axisY.data()+v28Table.axisY.size());
+    // Y-axis is stored reversed (see savePage())
+    std::reverse(v28Table.axisY.begin(), v28Table.axisY.end());
+    invalidate_cache(&v28Table.get_value_cache);
+
+    expandTable(v28Table, fuelTable);
+
+    saveAllPages();
+#endif
+    saveEEPROMVersion(29);
+  }
+}
+
 void doUpdates(void)
 {
-  #define CURRENT_DATA_VERSION    27
+  #define CURRENT_DATA_VERSION    29
   //Only the latest update for small flash devices must be retained
    #ifndef SMALL_FLASH_MODE
 
@@ -815,7 +896,7 @@ void doUpdates(void)
 
     //Change the CAN Broadcast settings to be a selection
     //Note that 1 preference will be lost if both BMW AND VAG protocols were enabled, but that is not a likely combination.
-    if(configPage2.unused1_126_1 == true) { configPage4.CANBroadcastProtocol = CAN_BROADCAST_PROTOCOL_BMW; } //unused1_126_1 was canBMWCluster
+    if(configPage2.perToothFuel == true) { configPage4.CANBroadcastProtocol = CAN_BROADCAST_PROTOCOL_BMW; } //perToothFuel was canBMWCluster
     if(configPage2.unused1_126_2 == true) { configPage4.CANBroadcastProtocol = CAN_BROADCAST_PROTOCOL_VAG; } //unused1_126_2 was canVAGCluster
 
     //VSS max limit on launch control
@@ -850,6 +931,8 @@ void doUpdates(void)
   }
   upgradeV25toV26();
   upgradeV26toV27();
+  upgradeV27toV28();
+  upgradeV28toV29();
   //Move this #endif to only do latest updates to safe ROM space on small devices.
   #endif
 
@@ -0,0 +1,445 @@
+#pragma once
+
+/**
+ * @file
+ * @brief Synthetic trigger waveform simulator for measuring decoder accuracy.
+ *
+ * Drives a decoder (as returned by a triggerSetup_*() function) from a simulated engine. The
+ * engine follows an RPM profile (a linear ramp from one speed to another, then steady) &
+ * the edges of a trigger pattern are fired at the exact time the crank passes them. Edge
+ * times can be disturbed with random noise & by dropping teeth, to mimic a poor signal.
+ *
+ * Between every pair of edges the simulated main loop runs once, at a random point in the
+ * gap: it calls getRPM() & getCrankAngle() exactly as the firmware does & compares the
+ * results with the true crank angle & instantaneous RPM. The error distributions, sync
+ * losses & the host time spent in the ISRs are collected into a decoder_accuracy_report_t.
+ *
+ * Time is simulated: micros() is replaced with a fake that returns the simulated time, so
+ * runs are fast, repeatable & independent of the host.
+ *
+ * The trigger pins are simulated too: each edge sets the pin level before the ISR runs, so
+ * decoders that read the level (E.g. 4G63) or trigger on CHANGE see the signal they would on
+ * an engine. An edge the interrupt isn't attached to (E.g. a rising edge on a FALLING
+ * interrupt) only changes the level.
+ *
+ * @note Native only: micros() cannot be faked on a device.
+ */
+
+#if defined(NATIVE_BOARD)
+
+#include <unity.h>
+#include <stdio.h>
+#include <inttypes.h>
+#include <math.h>
+#include <chrono>
+#include <initializer_list>
+#include <SimpleArduinoFake.h>
+#include "decoder_t.h"
+#include "globals.h"
+#include "crankMaths.h"
+#include "test_utils.h"
+
+/** @brief Maximum number of edges per input in one engine cycle. Enough for a 360 tooth cam wheel */
+static constexpr uint16_t SIM_MAX_PRIMARY_EDGES = 360U;
+static constexpr uint8_t SIM_MAX_SECONDARY_EDGES = 8U;
+
+/** @brief The direction of one edge of a trigger signal */
+enum class sim_edge_t : uint8_t {
+  /** @brief Whichever edge the interrupt is attached to. Toggles the level for CHANGE */
+  Active,
+  Rising,
+  Falling,
+};
+
+/** @brief The edges a trigger wheel set generates over one engine cycle (720 crank degrees) */
+struct trigger_pattern_t {
+  uint16_t primary[SIM_MAX_PRIMARY_EDGES] = {};     ///< Crank degrees, ascending. Tooth #1 is at 0
+  sim_edge_t primaryEdge[SIM_MAX_PRIMARY_EDGES] = {};
+  uint16_t primaryCount = 0U;
+  uint16_t secondary[SIM_MAX_SECONDARY_EDGES] = {}; ///< Crank degrees, ascending
+  sim_edge_t secondaryEdge[SIM_MAX_SECONDARY_EDGES] = {};
+  uint8_t secondaryCount = 0U;
+  /** @brief The decoder can only resolve the crank angle modulo this. 360 without a cam reference */
+  uint16_t cycleDegrees = 360U;
+};
+
+/** @brief Value for the cam angle parameters when there is no cam input */
+static constexpr int16_t SIM_NO_CAM = -1;
+
+/**
+ * @brief Set the config pages to a plain setup the simulator can drive: crank speed trigger,
+ * no filter, no VVT, wasted spark, paired injection & no per tooth ignition.
+ *
+ * Call before the triggerSetup_*() function, then adjust as needed.
+ */
+static inline void setSimulatorConfig(void) {
+  configPage4.TrigSpeed = CRANK_SPEED;
+  configPage4.trigPatternSec = SEC_TRIGGER_SINGLE;
+  configPage4.triggerAngle = 0;
+  configPage4.triggerFilter = 0;
+  configPage4.StgCycles = 0;
+  configPage4.useResync = 0;
+  configPage4.sparkMode = IGN_MODE_WASTED;
+  configPage2.injLayout = INJ_PAIRED;
+  configPage2.perToothIgn = false;
+  configPage2.strokes = FOUR_STROKE;
+  configPage6.vvtEnabled = 0;
+  configPage10.vvt2Enabled = 0;
+  currentStatus.crankRPM = 400;
+}
+
+/**
+ * @brief A crank speed missing tooth wheel. E.g. 36-1
+ *
+ * @param teeth Tooth count, including the missing teeth. Must divide 360 exactly.
+ * @param missingTeeth Number of missing teeth
+ * @param camAngle Crank angle (0-719) of a single tooth cam, or SIM_NO_CAM
+ */
+static inline trigger_pattern_t missingToothPattern(uint8_t teeth, uint8_t missingTeeth, int16_t camAngle = SIM_NO_CAM) {
+  trigger_pattern_t pattern;
+  const uint16_t toothAngle = 360U / teeth;
+  for (uint16_t revolution=0U; revolution<720U; revolution = revolution + 360U) {
+    for (uint8_t tooth=0U; tooth<(teeth-missingTeeth); ++tooth) {
+      pattern.primary[pattern.primaryCount] = revolution + (tooth * toothAngle);
+      ++pattern.primaryCount;
+    }
+  }
+  if (camAngle!=SIM_NO_CAM) {
+    pattern.secondary[0] = (uint16_t)camAngle;
+    pattern.secondaryCount = 1U;
+    pattern.cycleDegrees = 720U;
+  }
+  return pattern;
+}
+
+/**
+ * @brief A crank speed even tooth wheel plus a single tooth cam
+ *
+ * @param teeth Crank tooth count. Must divide 360 exactly.
+ * @param camAngle Crank angle (0-719) of the cam tooth. The first crank tooth after it is tooth #1
+ */
+static inline trigger_pattern_t dualWheelPattern(uint8_t teeth, uint16_t camAngle) {
+  return missingToothPattern(teeth, 0U, (int16_t)camAngle);
+}
+
+/**
+ * @brief An arbitrary single wheel, with no cam input
+ *
+ * @param toothAngles Crank degrees of each tooth, ascending
+ * @param toothCount Number of teeth
+ * @param cycleDegrees 360 for a crank wheel (the pattern is repeated), 720 for a cam wheel
+ */
+static inline trigger_pattern_t toothAnglePattern(const uint16_t *toothAngles, uint16_t toothCount, uint16_t cycleDegrees) {
+  trigger_pattern_t pattern;
+  for (uint16_t revolution=0U; revolution<720U; revolution = revolution + cycleDegrees) {
+    for (uint16_t tooth=0U; tooth<toothCount; ++tooth) {
+      pattern.primary[pattern.primaryCount] = revolution + toothAngles[tooth];
+      ++pattern.primaryCount;
+    }
+  }
+  pattern.cycleDegrees = cycleDegrees;
+  return pattern;
+}
+
+/**
+ * @brief Set the tooth table decoder's wheel in the tune (config15::toothTableSlots & toothTableTeeth)
+ *
+ * A cam wheel if configPage4.TrigSpeed is CAM_SPEED, so set that first.
+ *
+ * @param slots Number of equally spaced tooth positions. Must divide the cycle exactly.
+ * @param emptySlots Positions (0 based) without a tooth. E.g. the missing tooth on a 36-1 wheel is position 35
+ * @return The matching pattern
+ */
+static inline trigger_pattern_t setToothTableWheel(uint8_t slots, std::initializer_list<uint8_t> emptySlots) {
+  configPage15.toothTableSlots = slots;
+  memset(configPage15.toothTableTeeth, 0, sizeof(configPage15.toothTableTeeth));
+  for (uint8_t slot=0U; slot<slots; ++slot) { BIT_SET(configPage15.toothTableTeeth[slot / 8U], slot % 8U); }
+  for (uint8_t slot : emptySlots) { BIT_CLEAR(configPage15.toothTableTeeth[slot / 8U], slot % 8U); }
+
+  const uint16_t cycleDegrees = (configPage4.TrigSpeed==CAM_SPEED) ? 720U : 360U;
+  uint16_t angles[SIM_MAX_PRIMARY_EDGES];
+  uint16_t teeth = 0U;
+  for (uint8_t slot=0U; slot<slots; ++slot) {
+    if (BIT_CHECK(configPage15.toothTableTeeth[slot / 8U], slot % 8U)) { angles[teeth++] = (uint16_t)((slot * cycleDegrees) / slots); }
+  }
+  return toothAnglePattern(angles, teeth, cycleDegrees);
+}
+
+/**
+ * @brief Make a signal's edges alternately rising & falling, starting with a rising edge.
+ *
+ * For signals where the decoder reads the level, rather than just counting edges
+ *
+ * @param edges trigger_pattern_t::primaryEdge or trigger_pattern_t::secondaryEdge
+ * @param count Number of edges in use
+ */
+static inline void setAlternatingEdges(sim_edge_t *edges, uint16_t count) {
+  for (uint16_t index=0U; index<count; ++index) {
+    edges[index] = (index % 2U)==0U ? sim_edge_t::Rising : sim_edge_t::Falling;
+  }
+}
+
+/** @brief How the simulated engine moves & how noisy the trigger signal is */
+struct engine_profile_t {
+  uint16_t startRpm;
+  uint16_t endRpm;          ///< Must be non-zero
+  uint32_t rampMicros;      ///< Time to move linearly from startRpm to endRpm. Steady speed thereafter
+  uint16_t cycles;          ///< Engine cycles (720°) to simulate
+  uint16_t noiseMicros;     ///< Each edge is moved randomly by up to ± this
+  uint16_t dropEdgeEvery;   ///< Drop every Nth primary edge. 0 to disable
+  uint32_t seed;
+};
+
+/** @brief Distribution of the error between the decoder & the simulated engine */
+struct sim_error_stats_t {
+  uint32_t count = 0U;
+  double minimum = 0.0;
+  double maximum = 0.0;
+  double sumAbsolute = 0.0;
+
+  void record(double error) {
+    if ((count==0U) || (error<minimum)) { minimum = error; }
+    if ((count==0U) || (error>maximum)) { maximum = error; }
+    sumAbsolute = sumAbsolute + fabs(error);
+    ++count;
+  }
+
+  double meanAbsolute(void) const { return count==0U ? 0.0 : sumAbsolute / count; }
+  double maxAbsolute(void) const { return fmax(fabs(minimum), fabs(maximum)); }
+};
+
+/** @brief Simulation results */
+struct decoder_accuracy_report_t {
+  sim_error_stats_t angle;        ///< getCrankAngle() minus the true crank angle (degrees)
+  sim_error_stats_t rpm;          ///< getRPM() minus the true instantaneous RPM
+  uint32_t samples = 0U;          ///< Main loop passes: one per edge, whether or not the edge fires an ISR
+  uint32_t primaryEdges = 0U;     ///< Primary ISR calls
+  uint32_t secondaryEdges = 0U;   ///< Secondary ISR calls
+  uint32_t unsyncedSamples = 0U;  ///< Main loop passes where the decoder did not have full sync
+  uint16_t syncLosses = 0U;       ///< Increase in currentStatus.syncLossCounter
+  uint64_t isrNanos = 0U;         ///< Host time spent in the decoder ISRs
+  uint32_t isrMaxNanos = 0U;      ///< Longest single ISR call, host time
+  uint64_t crankAngleNanos = 0U;  ///< Host time spent in getCrankAngle() (scored samples only)
+  uint32_t crankAngleCalls = 0U;
+
+  uint32_t isrNanosPerEdge(void) const {
+    uint32_t edges = primaryEdges + secondaryEdges;
+    return edges==0U ? 0U : (uint32_t)(isrNanos / edges);
+  }
+
+  uint32_t crankAngleNanosPerCall(void) const {
+    return crankAngleCalls==0U ? 0U : (uint32_t)(crankAngleNanos / crankAngleCalls);
+  }
+};
+
+/// @cond
+namespace decoder_sim_detail {
+
+/** @brief Offset of the simulated clock, so no edge is at time zero */
+static constexpr uint32_t START_MICROS = 1000000UL;
+/** @brief Main loop samples in the first few cycles are not scored: the decoder is still syncing */
+static constexpr uint16_t SETTLE_CYCLES = 2U;
+
+static uint32_t simulatedMicros = START_MICROS;
+
+/** @brief Arbitrary pin numbers, so the simulated trigger pins are valid */
+static constexpr uint8_t PRIMARY_PIN = 2U;
+static constexpr uint8_t SECONDARY_PIN = 3U;
+
+static inline uint32_t nextRandom(uint32_t &state) {
+  state ^= state << 13;
+  state ^= state >> 17;
+  state ^= state << 5;
+  return state;
+}
+
+/** @brief Uniform random value in [-1, 1] */
+static inline double randomUnit(uint32_t &state) {
+  return ((double)(nextRandom(state) % 20001U) / 10000.0) - 1.0;
+}
+
+static constexpr double rpmToDegreesPerMicro(double rpm) { return rpm * 360.0 / 60000000.0; }
+
+/** @brief Crank motion: constant acceleration for rampMicros, then constant speed */
+struct motion_t {
+  double omega0;      ///< Degrees per µS
+  double omega1;
+  double alpha;       ///< Degrees per µS²
+  double rampMicros;
+  double rampDegrees;
+
+  explicit motion_t(const engine_profile_t &profile)
+    : omega0(rpmToDegreesPerMicro(profile.startRpm))
+    , omega1(rpmToDegreesPerMicro(profile.endRpm))
+    , alpha(profile.rampMicros==0U ? 0.0 : (omega1-omega0) / profile.rampMicros)
+    , rampMicros(profile.rampMicros)
+    , rampDegrees((omega0 + omega1) * 0.5 * profile.rampMicros)
+  {
+  }
+
+  double angleAt(double time) const {
+    if (time<rampMicros) { return (omega0 * time) + (0.5 * alpha * time * time); }
+    return rampDegrees + (omega1 * (time - rampMicros));
+  }
+
+  double timeAt(double angle) const {
+    if (angle>=rampDegrees) { return rampMicros + ((angle - rampDegrees) / omega1); }
+    if (alpha==0.0) { return angle / omega0; }
+    return (sqrt((omega0 * omega0) + (2.0 * alpha * angle)) - omega0) / alpha;
+  }
+
+  double rpmAt(double time) const {
+    double omega = time<rampMicros ? omega0 + (alpha * time) : omega1;
+    return omega * 60000000.0 / 360.0;
+  }
+};
+
+/** @brief Wrap an angle error into [-cycle/2, cycle/2) */
+static inline double wrapError(double error, uint16_t cycleDegrees) {
+  double wrapped = fmod(error, (double)cycleDegrees);
+  if (wrapped<-(cycleDegrees/2.0)) { wrapped = wrapped + cycleDegrees; }
+  if (wrapped>=(cycleDegrees/2.0)) { wrapped = wrapped - cycleDegrees; }
+  return wrapped;
+}
+
+/** @brief Host time taken by a call */
+template <typename TCall>
+static inline uint64_t timeCall(TCall call) {
+  auto start = std::chrono::steady_clock::now();
+  call();
+  auto end = std::chrono::steady_clock::now();
+  return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+}
+
+/**
+ * @brief Move the pin level for an edge
+ *
+ * @return true if the edge triggers the interrupt
+ */
+static inline bool driveEdge(interrupt_t &input, sim_edge_t edge) {
+  bool isHigh;
+  if (edge==sim_edge_t::Rising) { isHigh = true; }
+  else if (edge==sim_edge_t::Falling) { isHigh = false; }
+  else if (input.edge==CHANGE) { isHigh = !input.isPinHigh(); }
+  else { isHigh = (input.edge==RISING); }
+
+  if (isHigh) { input._pin._pin.setPinHigh(); }
+  else { input._pin._pin.setPinLow(); }
+
+  return (input.edge==CHANGE) || ((input.edge==RISING)==isHigh);
+}
+
+/** @brief Simulate one edge on an input: set the pin level & run the ISR if the edge triggers it */
+static inline bool fireEdge(interrupt_t &input, sim_edge_t edge, double time, decoder_accuracy_report_t &report) {
+  simulatedMicros = START_MICROS + (uint32_t)time;
+  if (!driveEdge(input, edge)) { return false; }
+  uint64_t nanos = timeCall(input.callback);
+  report.isrNanos = report.isrNanos + nanos;
+  if (nanos>report.isrMaxNanos) { report.isrMaxNanos = (uint32_t)nanos; }
+  return true;
+}
+
+/** @brief One main loop pass: update the RPM like the firmware does, then score the decoder */
+static inline void sampleDecoder(const decoder_t &decoder, const motion_t &motion, double time, bool score,
+                                 uint16_t cycleDegrees, decoder_accuracy_report_t &report) {
+  simulatedMicros = START_MICROS + (uint32_t)time;
+  ++report.samples;
+  currentStatus.RPM = decoder.getRPM();
+  currentStatus.rotationStatus = currentStatus.RPM<currentStatus.crankRPM ? EngineRotationStatus::Cranking : EngineRotationStatus::Running;
+  if (decoder.getStatus().syncStatus!=SyncStatus::Full) {
+    ++report.unsyncedSamples;
+  } else if (score) {
+    int16_t crankAngle = 0;
+    report.crankAngleNanos = report.crankAngleNanos + timeCall([&]() { crankAngle = decoder.pGetCrankAngle(simulatedMicros); });
+    ++report.crankAngleCalls;
+    double trueAngle = motion.angleAt(time) + configPage4.triggerAngle;
+    report.angle.record(wrapError((double)crankAngle - trueAngle, cycleDegrees));
+    report.rpm.record((double)currentStatus.RPM - motion.rpmAt(time));
+  } else {
+    // Settling: not scored
+  }
+}
+
+}
+/// @endcond
+
+/**
+ * @brief Run a decoder against a simulated engine
+ *
+ * The decoder must be freshly set up (I.e. the return value of a triggerSetup_*() function) &
+ * the config pages must match the pattern. configPage4.triggerAngle is honoured.
+ *
+ * @param decoder The decoder under test
+ * @param pattern The trigger wheel(s) the decoder is configured for
+ * @param profile Engine motion & signal quality
+ * @param report Accumulates the results
+ */
+static inline void runDecoderSimulation(const decoder_t &decoder, const trigger_pattern_t &pattern,
+                                        const engine_profile_t &profile, decoder_accuracy_report_t &report) {
+  using namespace decoder_sim_detail;
+
+  When(Method(SimpleArduinoFake::getContext()._Function, micros)).AlwaysDo([]() -> unsigned long { return simulatedMicros; });
+
+  currentStatus.decoder = decoder;
+  // Both signals start low
+  currentStatus.decoder.primary._pin.setPin(PRIMARY_PIN);
+  currentStatus.decoder.primary._pin._pin.setPinLow();
+  currentStatus.decoder.secondary._pin.setPin(SECONDARY_PIN);
+  currentStatus.decoder.secondary._pin._pin.setPinLow();
+  currentStatus.RPM = 0U;
+  currentStatus.startRevolutions = 0U;
+  currentStatus.revolutionTime = 0U;
+  currentStatus.rotationStatus = EngineRotationStatus::Stopped;
+  resetAngleConverterToothTimes();
+  const uint8_t startSyncLosses = currentStatus.syncLossCounter;
+
+  const motion_t motion(profile);
+  uint32_t random = profile.seed;
+  double lastEdgeTime = 0.0;
+  uint32_t primaryEdgeIndex = 0U;
+
+  for (uint16_t cycle=0U; cycle<profile.cycles; ++cycle) {
+    uint16_t primary = 0U;
+    uint8_t secondary = 0U;
+    while ((primary<pattern.primaryCount) || (secondary<pattern.secondaryCount)) {
+      bool isPrimary = (secondary>=pattern.secondaryCount)
+                    || ((primary<pattern.primaryCount) && (pattern.primary[primary]<=pattern.secondary[secondary]));
+      sim_edge_t edge = isPrimary ? pattern.primaryEdge[primary] : pattern.secondaryEdge[secondary];
+      uint16_t edgeAngle = isPrimary ? pattern.primary[primary++] : pattern.secondary[secondary++];
+      if (isPrimary) {
+        ++primaryEdgeIndex;
+        if ((profile.dropEdgeEvery!=0U) && ((primaryEdgeIndex % profile.dropEdgeEvery)==0U)) { continue; }
+      }
+
+      double edgeTime = motion.timeAt(((double)cycle * 720.0) + edgeAngle) + (randomUnit(random) * profile.noiseMicros);
+      edgeTime = fmax(edgeTime, lastEdgeTime + 1.0);
+
+      // The main loop runs at a random point between edges
+      double sampleTime = lastEdgeTime + ((edgeTime - lastEdgeTime) * ((randomUnit(random) + 1.0) / 2.0));
+      sampleDecoder(decoder, motion, sampleTime, cycle>=SETTLE_CYCLES, pattern.cycleDegrees, report);
+
+      if (isPrimary) {
+        if (fireEdge(currentStatus.decoder.primary, edge, edgeTime, report)) { ++report.primaryEdges; }
+      } else {
+        if (fireEdge(currentStatus.decoder.secondary, edge, edgeTime, report)) { ++report.secondaryEdges; }
+      }
+      lastEdgeTime = edgeTime;
+    }
+  }
+
+  report.syncLosses = (uint8_t)(currentStatus.syncLossCounter - startSyncLosses);
+}
+
+/** @brief Print the report */
+static inline void reportDecoderAccuracy(const char *name, const decoder_accuracy_report_t &report) {
+  char buffer[256];
+  snprintf(buffer, _countof(buffer)-1,
+          "%s: edges=%" PRIu32 "/%" PRIu32 " unsynced=%" PRIu32 " syncLoss=%" PRIu16 " isr=%" PRIu32 "ns/edge (max %" PRIu32 "ns)"
+          " angle(deg) min=%.2f max=%.2f mean|e|=%.2f rpm min=%.1f max=%.1f mean|e|=%.1f",
+          name, report.primaryEdges, report.secondaryEdges, report.unsyncedSamples, report.syncLosses, report.isrNanosPerEdge(), report.isrMaxNanos,
+          report.angle.minimum, report.angle.maximum, report.angle.meanAbsolute(),
+          report.rpm.minimum, report.rpm.maximum, report.rpm.meanAbsolute());
+  TEST_MESSAGE(buffer);
+}
+
+#endif
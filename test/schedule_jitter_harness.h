@@ -0,0 +1,247 @@
+#pragma once
+
+/**
+ * @file
+ * @brief Jitter measurement harness for the schedule state machine.
+ *
+ * Drives a FuelSchedule from a simulated engine: the crank speed wanders randomly (within
+ * realistic acceleration limits) & a simulated main loop runs at random intervals, calling
+ * setSchedule() with allowQueuedSchedule enabled exactly as setFuelChannelSchedule() does.
+ *
+ * Time is simulated, one timer tick at a time, so runs are fast & repeatable. The timer ISR
+ * is emulated with the compare semantics of the board under test: the native software timer
+ * fires while counter>=compare, hardware timers only on an exact match.
+ *
+ * For every schedule event the requested time (main loop time + delay, in µS) is compared
+ * to the tick the state machine actually moved on. Events that started from a queued
+ * (RUNNING_WITHNEXT) request are tracked separately, so queued timing regressions show up
+ * as numbers rather than just a failed assertion.
+ */
+
+#include <unity.h>
+#include <stdio.h>
+#include <inttypes.h>
+#include <type_traits>
+#include <algorithm>
+#include "scheduler.h"
+#include "test_utils.h"
+
+/** @brief Number of error histogram buckets. Bucket n holds |error| < 2^n ticks */
+static constexpr uint8_t JITTER_BUCKETS = 8U;
+
+/** @brief Distribution of the error between requested and actual event times */
+struct jitter_stats_t {
+  uint32_t count = 0U;
+  int32_t minimum = 0;     ///< µS, negative is early
+  int32_t maximum = 0;     ///< µS, positive is late
+  uint32_t sumAbsolute = 0U; ///< µS
+  uint32_t buckets[JITTER_BUCKETS] = {};
+
+  void record(int32_t errorMicros) {
+    if ((count==0U) || (errorMicros<minimum)) { minimum = errorMicros; }
+    if ((count==0U) || (errorMicros>maximum)) { maximum = errorMicros; }
+    uint32_t absError = (uint32_t)(errorMicros<0 ? -errorMicros : errorMicros);
+    sumAbsolute = sumAbsolute + absError;
+    uint32_t errorTicks = absError / ticksToMicros(1U);
+    uint8_t bucket = 0U;
+    while ((errorTicks>0U) && (bucket<(JITTER_BUCKETS-1U))) {
+      errorTicks = errorTicks >> 1U;
+      ++bucket;
+    }
+    ++buckets[bucket];
+    ++count;
+  }
+
+  uint32_t meanAbsolute(void) const { return count==0U ? 0U : sumAbsolute / count; }
+};
+
+/** @brief Jitter results for one channel */
+struct schedule_jitter_report_t {
+  jitter_stats_t start;       ///< Events started from an OFF/PENDING request
+  jitter_stats_t end;
+  jitter_stats_t queuedStart; ///< Events started from a queued (RUNNING_WITHNEXT) request
+  jitter_stats_t queuedEnd;
+  /** @brief Queued events whose requested start was before the running event ended, so could not start on time */
+  jitter_stats_t overlappedStart;
+  uint16_t requests = 0U;
+  uint16_t queued = 0U;       ///< Requests that were queued behind a running event
+  uint16_t rejected = 0U;     ///< Requests setSchedule() ignored
+};
+
+/** @brief Simulation settings */
+struct schedule_jitter_params_t {
+  uint32_t seed;
+  uint16_t loops;           ///< Number of simulated main loop passes
+  uint16_t channelDegrees;  ///< Injector open angle offset for this channel
+  uint16_t minRpm;
+  uint16_t maxRpm;
+  uint8_t maxDutyPercent;   ///< Upper bound of the random injector duty cycle
+};
+
+/// @cond
+namespace jitter_detail {
+
+using raw_counter_t = std::remove_reference<Schedule::counter_t>::type;
+using raw_compare_t = std::remove_reference<Schedule::compare_t>::type;
+
+static inline uint32_t nextRandom(uint32_t &state) {
+  state ^= state << 13;
+  state ^= state >> 17;
+  state ^= state << 5;
+  return state;
+}
+
+static inline uint32_t randomBetween(uint32_t &state, uint32_t low, uint32_t high) {
+  return low + (nextRandom(state) % ((high - low) + 1U));
+}
+
+static inline bool isCompareMatch(COMPARE_TYPE counter, COMPARE_TYPE compare) {
+#if defined(NATIVE_BOARD)
+  return counter>=compare;
+#else
+  return counter==compare;
+#endif
+}
+
+static void noopCallback(void) { /* Transitions are observed via the schedule status */ }
+
+static constexpr uint16_t CYCLE_DEGREES = 720U;
+static constexpr uint32_t MILLIDEGREES_PER_CYCLE = CYCLE_DEGREES * 1000UL;
+
+enum class event_source_t : uint8_t { Direct, Queued, Overlapped };
+
+/** @brief What the harness expects the schedule to do next */
+struct expectation_t {
+  uint32_t startMicros = 0U;
+  uint16_t pw = 0U;
+  event_source_t source = event_source_t::Direct;
+};
+
+static inline jitter_stats_t* startStats(schedule_jitter_report_t &report, event_source_t source) {
+  return source==event_source_t::Direct ? &report.start 
+      : source==event_source_t::Queued ? &report.queuedStart : &report.overlappedStart;
+}
+
+static inline jitter_stats_t* endStats(schedule_jitter_report_t &report, event_source_t source) {
+  // Overlapped events are late to start, so must be late to finish: nothing more to learn
+  return source==event_source_t::Direct ? &report.end 
+      : source==event_source_t::Queued ? &report.queuedEnd : nullptr;
+}
+
+}
+/// @endcond
+
+/**
+ * @brief Run one channel through the simulation
+ *
+ * @param params Simulation settings. The same seed gives the same crank motion on every channel.
+ * @param report Accumulates the results
+ */
+static inline void runScheduleJitter(const schedule_jitter_params_t &params, schedule_jitter_report_t &report) {
+  using namespace jitter_detail;
+
+  raw_counter_t counter = { 0U };
+  raw_compare_t compare = { 0U };
+  FuelSchedule schedule(counter, compare);
+  setCallbacks(schedule, noopCallback, noopCallback);
+
+  const uint32_t tickMicros = ticksToMicros(1U);
+  uint32_t random = params.seed;
+  uint32_t nowMicros = 0U;
+  uint32_t lastTick = 0U;
+  uint32_t angleMillidegrees = 0U;
+  uint32_t rpm = params.minRpm;
+  uint32_t targetRpm = params.minRpm;
+
+  expectation_t pending;
+  expectation_t next;
+  expectation_t running;
+
+  for (uint16_t loop=0U; loop<params.loops; ++loop) {
+    // Advance the engine. Speed moves towards a random target at up to ~10000 rpm/s
+    uint32_t stepMicros = randomBetween(random, 200U, 2000U);
+    if (rpm==targetRpm) { targetRpm = randomBetween(random, params.minRpm, params.maxRpm); }
+    uint32_t maxRpmStep = (stepMicros / 100U) + 1U;
+    if (rpm<targetRpm) { rpm = rpm + (std::min)(maxRpmStep, targetRpm-rpm); }
+    else { rpm = rpm - (std::min)(maxRpmStep, rpm-targetRpm); }
+    angleMillidegrees = (angleMillidegrees + ((rpm * 6U * stepMicros) / 1000U)) % MILLIDEGREES_PER_CYCLE;
+    nowMicros = nowMicros + stepMicros;
+
+    // Step the timer to now, emulating the compare ISR
+    uint32_t nowTick = nowMicros / tickMicros;
+    for (uint32_t tick=lastTick+1U; tick<=nowTick; ++tick) {
+      counter = (COMPARE_TYPE)tick;
+      if (isCompareMatch((COMPARE_TYPE)tick, (COMPARE_TYPE)compare)) {
+        ScheduleStatus before = schedule._status;
+        moveToNextState(schedule);
+        ScheduleStatus after = schedule._status;
+        int32_t tickTime = (int32_t)(tick * tickMicros);
+        if ((before==PENDING) && (after==RUNNING)) {
+          running = pending;
+          startStats(report, running.source)->record(tickTime - (int32_t)running.startMicros);
+        } else if ((before==RUNNING) || (before==RUNNING_WITHNEXT)) {
+          jitter_stats_t *pEndStats = endStats(report, running.source);
+          if (pEndStats!=nullptr) { pEndStats->record(tickTime - (int32_t)(running.startMicros + running.pw)); }
+          if (after==PENDING) {
+            pending = next;
+            if ((int32_t)(pending.startMicros - (uint32_t)tickTime) < 0) { pending.source = event_source_t::Overlapped; }
+          }
+        } else {
+          // OFF: nothing to do
+        }
+      }
+    }
+    lastTick = nowTick;
+    counter = (COMPARE_TYPE)nowTick;
+
+    // Main loop: same calculation as calculateInjectorTimeout()
+    uint32_t cycleMicros = (60000000UL / rpm) * 2U;
+    constexpr uint32_t MAX_PW = 25000U;
+    uint16_t pw = (uint16_t)(std::min)((cycleMicros / 100U) * randomBetween(random, 5U, params.maxDutyPercent), MAX_PW);
+    int16_t delta = (int16_t)params.channelDegrees - (int16_t)(angleMillidegrees / 1000U);
+    if (delta<0) {
+      if (schedule._status==PENDING) { continue; }
+      delta = delta + (int16_t)CYCLE_DEGREES;
+    }
+    uint32_t delay = ((uint32_t)delta * cycleMicros) / CYCLE_DEGREES;
+    if (delay==0U) { continue; }
+
+    ScheduleStatus before = schedule._status;
+    setSchedule(schedule, delay, pw, true);
+    ScheduleStatus after = schedule._status;
+    ++report.requests;
+    uint32_t requestedStart = nowMicros + delay;
+    if (after==PENDING) {
+      pending = expectation_t { requestedStart, pw, event_source_t::Direct };
+    } else if (after==RUNNING_WITHNEXT) {
+      next = expectation_t { requestedStart, pw, event_source_t::Queued };
+      if (before!=RUNNING_WITHNEXT) { ++report.queued; }
+    } else {
+      ++report.rejected;
+    }
+  }
+}
+
+/** @brief Print one line summarising a distribution */
+static inline void reportJitterStats(const char *name, uint8_t channel, const jitter_stats_t &stats) {
+  char buffer[200];
+  snprintf(buffer, _countof(buffer)-1,
+          "Jitter ch%" PRIu8 " %s: n=%" PRIu32 " min=%" PRId32 "us max=%" PRId32 "us mean|e|=%" PRIu32 "us hist(ticks <1,<2,<4..)=[%" PRIu32 ",%" PRIu32 ",%" PRIu32 ",%" PRIu32 ",%" PRIu32 ",%" PRIu32 ",%" PRIu32 ",%" PRIu32 "]",
+          channel, name, stats.count, stats.minimum, stats.maximum, stats.meanAbsolute(),
+          stats.buckets[0], stats.buckets[1], stats.buckets[2], stats.buckets[3],
+          stats.buckets[4], stats.buckets[5], stats.buckets[6], stats.buckets[7]);
+  TEST_MESSAGE(buffer);
+}
+
+/** @brief Print the full jitter report for one channel */
+static inline void reportScheduleJitter(uint8_t channel, const schedule_jitter_report_t &report) {
+  char buffer[128];
+  snprintf(buffer, _countof(buffer)-1, "Jitter ch%" PRIu8 ": requests=%" PRIu16 " queued=%" PRIu16 " rejected=%" PRIu16,
+          channel, report.requests, report.queued, report.rejected);
+  TEST_MESSAGE(buffer);
+  reportJitterStats("start", channel, report.start);
+  reportJitterStats("end", channel, report.end);
+  reportJitterStats("queued start", channel, report.queuedStart);
+  reportJitterStats("queued end", channel, report.queuedEnd);
+  reportJitterStats("overlapped start", channel, report.overlappedStart);
+}
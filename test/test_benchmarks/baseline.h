@@ -0,0 +1,79 @@
+#pragma once
+
+/**
+ * @file
+ * @brief Stored benchmark baselines.
+ *
+ * Costs are relative to the calibration kernel (permille) so they are reasonably
+ * portable between machines of the same architecture. A value of zero means
+ * "no baseline recorded": the stage is reported but never flagged.
+ *
+ * To update: run the native_benchmark environment & copy the "relative" figures
+ * from the Benchmark lines in the test output. Host timings are noisy, so record the
+ * slowest of several runs (rounded up to 2 significant figures).
+ *
+ * The AVR figures have not been recorded yet: they need a run of the
+ * megaatmega2560_sim_unittest environment.
+ */
+
+#include <stdint.h>
+
+#if defined(__AVR__)
+static constexpr uint32_t BASELINE_GET3DTABLEVALUE = 0U;
+static constexpr uint32_t BASELINE_GET3DTABLEVALUE_5_TABLES = 0U;
+static constexpr uint32_t BASELINE_GET3DTABLEVALUE_5_TABLES_SHARED = 0U;
+static constexpr uint32_t BASELINE_GET3DTABLEVALUE_5_TABLES_BATCHED = 0U;
+static constexpr uint32_t BASELINE_TABLE3D_8X8 = 0U;
+static constexpr uint32_t BASELINE_TABLE3D_16X16 = 0U;
+static constexpr uint32_t BASELINE_TABLE3D_20X20 = 0U;
+static constexpr uint32_t BASELINE_TABLE3D_24X24 = 0U;
+static constexpr uint32_t BASELINE_TABLE3D_TRACE_UNCACHED = 0U;
+static constexpr uint32_t BASELINE_TABLE3D_TRACE_CACHED = 0U;
+static constexpr uint32_t BASELINE_TABLE2D_SEARCH_LOWER_BOUND = 0U;
+static constexpr uint32_t BASELINE_TABLE2D_SEARCH_BINARY = 0U;
+static constexpr uint32_t BASELINE_TABLE2D_SEARCH_DIRECT = 0U;
+static constexpr uint32_t BASELINE_CORRECTIONSFUEL = 0U;
+static constexpr uint32_t BASELINE_CALCPRIMARYPULSEWIDTH = 0U;
+static constexpr uint32_t BASELINE_COMPUTEPULSEWIDTHS = 0U;
+static constexpr uint32_t BASELINE_CORRECTIONSIGN = 0U;
+static constexpr uint32_t BASELINE_COMPUTEDWELL = 0U;
+static constexpr uint32_t BASELINE_SETFUELCHANNELSCHEDULES = 0U;
+static constexpr uint32_t BASELINE_LOOP_PIPELINE = 0U;
+static constexpr uint32_t BASELINE_SETANGLECONVERTERREVOLUTIONTIME = 0U;
+static constexpr uint32_t BASELINE_ANGLETOTIMERTICKS = 0U;
+static constexpr uint32_t BASELINE_ANGLETOTIME = 0U;
+static constexpr uint32_t BASELINE_TIMETOANGLE = 0U;
+static constexpr uint32_t BASELINE_TRIGGER_ISR_36_1 = 0U;
+static constexpr uint32_t BASELINE_TRIGGER_ISR_60_2 = 0U;
+static constexpr uint32_t BASELINE_TRIGGER_ISR_DUAL_WHEEL_24 = 0U;
+static constexpr uint32_t BASELINE_TRIGGER_ISR_TOOTH_TABLE_36_1 = 0U;
+#else
+static constexpr uint32_t BASELINE_GET3DTABLEVALUE = 27000U;
+static constexpr uint32_t BASELINE_GET3DTABLEVALUE_5_TABLES = 160000U;
+static constexpr uint32_t BASELINE_GET3DTABLEVALUE_5_TABLES_SHARED = 170000U;
+static constexpr uint32_t BASELINE_GET3DTABLEVALUE_5_TABLES_BATCHED = 200000U;
+static constexpr uint32_t BASELINE_TABLE3D_8X8 = 29000U;
+static constexpr uint32_t BASELINE_TABLE3D_16X16 = 29000U;
+static constexpr uint32_t BASELINE_TABLE3D_20X20 = 29000U;
+static constexpr uint32_t BASELINE_TABLE3D_24X24 = 29000U;
+static constexpr uint32_t BASELINE_TABLE3D_TRACE_UNCACHED = 48000U;
+static constexpr uint32_t BASELINE_TABLE3D_TRACE_CACHED = 50000U;
+static constexpr uint32_t BASELINE_TABLE2D_SEARCH_LOWER_BOUND = 7700U;
+static constexpr uint32_t BASELINE_TABLE2D_SEARCH_BINARY = 8400U;
+static constexpr uint32_t BASELINE_TABLE2D_SEARCH_DIRECT = 4400U;
+static constexpr uint32_t BASELINE_CORRECTIONSFUEL = 8900000U;
+static constexpr uint32_t BASELINE_CALCPRIMARYPULSEWIDTH = 9300000U;
+static constexpr uint32_t BASELINE_COMPUTEPULSEWIDTHS = 8600000U;
+static constexpr uint32_t BASELINE_CORRECTIONSIGN = 11000000U;
+static constexpr uint32_t BASELINE_COMPUTEDWELL = 8200000U;
+static constexpr uint32_t BASELINE_SETFUELCHANNELSCHEDULES = 18000000U;
+static constexpr uint32_t BASELINE_LOOP_PIPELINE = 11000000U;
+static constexpr uint32_t BASELINE_SETANGLECONVERTERREVOLUTIONTIME = 2700U;
+static constexpr uint32_t BASELINE_ANGLETOTIMERTICKS = 4000U;
+static constexpr uint32_t BASELINE_ANGLETOTIME = 4200U;
+static constexpr uint32_t BASELINE_TIMETOANGLE = 3900U;
+static constexpr uint32_t BASELINE_TRIGGER_ISR_36_1 = 42000U;
+static constexpr uint32_t BASELINE_TRIGGER_ISR_60_2 = 38000U;
+static constexpr uint32_t BASELINE_TRIGGER_ISR_DUAL_WHEEL_24 = 34000U;
+static constexpr uint32_t BASELINE_TRIGGER_ISR_TOOTH_TABLE_36_1 = 29000U;
+#endif
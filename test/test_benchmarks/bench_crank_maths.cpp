@@ -0,0 +1,132 @@
+#include <unity.h>
+#include "benchmark_support.h"
+#include "loop_trace.h"
+#include "baseline.h"
+#include "crankMaths.h"
+
+#if defined(__AVR__)
+static constexpr uint16_t ITERATIONS = 4U;
+#else
+static constexpr uint16_t ITERATIONS = 2000U;
+#endif
+
+// Prevent the optimiser discarding the results
+static volatile uint32_t resultSink;
+
+// A spread of angles, similar to the per channel deltas the schedulers convert each loop
+static constexpr uint8_t ANGLES_PER_SAMPLE = 8U;
+static inline uint16_t benchmarkAngle(uint16_t index, uint8_t channel) {
+  return (uint16_t)(((index * 11U) + (channel * 90U)) % 720U);
+}
+
+static inline void setTraceRevolutionTime(uint16_t index) {
+  setAngleConverterRevolutionTime(MICROS_PER_MIN / getTraceSample(index).rpm);
+}
+
+// setupSample is called after the revolution time is set for each sample
+template <typename TConvert>
+static benchmark_result_t runAngleConversion(TConvert convert, void (*setupSample)(uint16_t) = nullptr) {
+  benchmark_result_t result = run_benchmark(ITERATIONS, LOOP_TRACE_LENGTH, [&convert, setupSample](uint16_t index) {
+    setTraceRevolutionTime(index);
+    if (setupSample!=nullptr) { setupSample(index); }
+    uint32_t sum = 0U;
+    for (uint8_t channel=0U; channel<ANGLES_PER_SAMPLE; ++channel) {
+      sum = sum + convert(benchmarkAngle(index, channel));
+    }
+    resultSink = sum;
+  });
+  result.operations = result.operations * ANGLES_PER_SAMPLE;
+  return result;
+}
+
+static void bench_setAngleConverterRevolutionTime(void) {
+  resetAngleConverterToothTimes();
+  benchmark_result_t result = run_benchmark(ITERATIONS, LOOP_TRACE_LENGTH, [](uint16_t index) {
+    setTraceRevolutionTime(index);
+  });
+  reportBenchmark("setAngleConverterRevolutionTime", result, BASELINE_SETANGLECONVERTERREVOLUTIONTIME);
+}
+
+// The two rounded divisions per revolution time that the angle converter & the decoders getRPM() used
+// to do, before both were derived from one reciprocal: for comparison
+static void bench_revolutionTime_divisions(void) {
+  benchmark_result_t result = run_benchmark(ITERATIONS, LOOP_TRACE_LENGTH, [](uint16_t index) {
+    uint32_t revolutionTime = MICROS_PER_MIN / getTraceSample(index).rpm;
+    resultSink = fast_div_closest(MICROS_PER_MIN, revolutionTime)
+               + fast_div_closest(UINT32_C(360) << 15U, revolutionTime);
+  });
+  reportBenchmark("revolution time divisions", result, 0U);
+}
+
+// The conversion angleToTimerTicks() used before it had a ticks per degree factor: for comparison
+static void bench_angleToTime_uS_TO_TIMER_COMPARE(void) {
+  resetAngleConverterToothTimes();
+  benchmark_result_t result = runAngleConversion([](uint16_t angle) -> uint32_t {
+    return uS_TO_TIMER_COMPARE(angleToTime(angle));
+  });
+  reportBenchmark("uS_TO_TIMER_COMPARE(angleToTime)", result, 0U);
+}
+
+static void bench_angleToTimerTicks(void) {
+  resetAngleConverterToothTimes();
+  benchmark_result_t result = runAngleConversion([](uint16_t angle) -> uint32_t {
+    return angleToTimerTicks(angle);
+  });
+  reportBenchmark("angleToTimerTicks", result, BASELINE_ANGLETOTIMERTICKS);
+}
+
+// A 36 tooth wheel accelerating at the trace RPM: each tooth gap 1% shorter than the last
+static inline void setTraceToothTimes(uint16_t index) {
+  uint32_t toothGap = (MICROS_PER_MIN / getTraceSample(index).rpm) / 36U;
+  setAngleConverterToothTime(toothGap + (toothGap/100U), true);
+  setAngleConverterToothTime(toothGap, true);
+}
+
+// The per tooth cost of building the acceleration model, in the decoder ISR
+static void bench_setAngleConverterToothTime(void) {
+  setAngleConverterToothAngle(10U);
+  benchmark_result_t result = run_benchmark(ITERATIONS, LOOP_TRACE_LENGTH, [](uint16_t index) {
+    setTraceToothTimes(index);
+  });
+  result.operations = result.operations * 2U;
+  resetAngleConverterToothTimes();
+  reportBenchmark("setAngleConverterToothTime", result, 0U);
+}
+
+static void bench_angleToTimerTicks_accelerating(void) {
+  setAngleConverterToothAngle(10U);
+  benchmark_result_t result = runAngleConversion([](uint16_t angle) -> uint32_t {
+    return angleToTimerTicks(angle);
+  }, setTraceToothTimes);
+  resetAngleConverterToothTimes();
+  reportBenchmark("angleToTimerTicks accelerating", result, 0U);
+}
+
+static void bench_angleToTime(void) {
+  resetAngleConverterToothTimes();
+  benchmark_result_t result = runAngleConversion([](uint16_t angle) -> uint32_t {
+    return angleToTime(angle);
+  });
+  reportBenchmark("angleToTime", result, BASELINE_ANGLETOTIME);
+}
+
+static void bench_timeToAngle(void) {
+  resetAngleConverterToothTimes();
+  benchmark_result_t result = runAngleConversion([](uint16_t angle) -> uint32_t {
+    return timeToAngle((uint32_t)angle * 20U);
+  });
+  reportBenchmark("timeToAngle", result, BASELINE_TIMETOANGLE);
+}
+
+void benchCrankMaths(void) {
+  SET_UNITY_FILENAME() {
+    RUN_TEST_P(bench_setAngleConverterRevolutionTime);
+    RUN_TEST_P(bench_revolutionTime_divisions);
+    RUN_TEST_P(bench_angleToTime_uS_TO_TIMER_COMPARE);
+    RUN_TEST_P(bench_angleToTimerTicks);
+    RUN_TEST_P(bench_setAngleConverterToothTime);
+    RUN_TEST_P(bench_angleToTimerTicks_accelerating);
+    RUN_TEST_P(bench_angleToTime);
+    RUN_TEST_P(bench_timeToAngle);
+  }
+}
@@ -0,0 +1,259 @@
+#include <unity.h>
+#include "benchmark_support.h"
+
+#if defined(NATIVE_BOARD)
+
+#include <initializer_list>
+#include "decoders.h"
+#include "decoder_init.h"
+#include "../decoder_simulator.h"
+
+/**
+ * @file
+ * @brief The CPU cost of every decoder, as a table for choosing trigger wheels.
+ *
+ * Each decoder is built through buildDecoder() (I.e. exactly as the firmware does) & driven by the
+ * decoder simulator at steady speeds across the rev range. For each decoder the table shows:
+ *  - the percentage of main loop samples with full sync
+ *  - mean & maximum ISR time per edge
+ *  - mean getCrankAngle() time, which the main loop calls once there is sync
+ *  - the RPM at which the trigger ISRs would use DECODER_COST_ISR_LOAD_PERCENT of the CPU
+ *
+ * Three decoders have no case, as they never get full sync from power on (see
+ * DECODER_COST_EXCLUDED) & a table row would only time the unsynced code path.
+ *
+ * Times are for the machine running the benchmark, so compare decoders with each other rather
+ * than reading the maximum RPM as a limit for a particular board.
+ */
+
+#if !defined(DECODER_COST_ISR_LOAD_PERCENT)
+/** @brief ISR load used for the maximum RPM column */
+#define DECODER_COST_ISR_LOAD_PERCENT 20U
+#endif
+
+static constexpr uint16_t BENCH_RPMS[] = { 1000U, 3000U, 6000U, 9000U, 12000U };
+static constexpr uint16_t CYCLES_PER_RPM = 20U;
+
+/** @brief A wheel of evenly spaced slots, given as alternating runs of teeth & missing teeth. E.g. 36-1 is { 35, 1 } */
+static trigger_pattern_t slotWheelPattern(uint16_t slots, std::initializer_list<uint16_t> runs, uint16_t cycleDegrees = 360U) {
+  uint16_t angles[SIM_MAX_PRIMARY_EDGES];
+  uint16_t teeth = 0U;
+  uint16_t slot = 0U;
+  bool isTooth = true;
+  for (uint16_t run : runs) {
+    for (uint16_t index=0U; index<run; ++index) {
+      if (isTooth) { angles[teeth++] = (uint16_t)(((uint32_t)slot * cycleDegrees) / slots); }
+      ++slot;
+    }
+    isTooth = !isTooth;
+  }
+  return toothAnglePattern(angles, teeth, cycleDegrees);
+}
+
+/** @brief Add cam edges (crank degrees, 0-719, ascending) to a crank pattern */
+static trigger_pattern_t withCam(trigger_pattern_t pattern, std::initializer_list<uint16_t> camAngles) {
+  for (uint16_t angle : camAngles) {
+    pattern.secondary[pattern.secondaryCount++] = angle;
+  }
+  pattern.cycleDegrees = 720U;
+  return pattern;
+}
+
+/** @brief Set the config for a decoder & return the wheel(s) to drive it with */
+using decoder_cost_setup_t = trigger_pattern_t (*)(void);
+
+struct decoder_cost_case_t {
+  const char *name;
+  uint8_t decoder;            ///< DECODER_*
+  decoder_cost_setup_t setup;
+};
+
+// The wheel each decoder is designed for. Where a decoder supports several, a common one is used.
+static const decoder_cost_case_t DECODER_COST_CASES[] = {
+  { "Missing tooth", DECODER_MISSING_TOOTH, []() {
+      configPage4.triggerTeeth = 36;
+      configPage4.triggerMissingTeeth = 1;
+      return missingToothPattern(36, 1);
+    } },
+  { "Basic distrib.", DECODER_BASIC_DISTRIBUTOR, []() {
+      return slotWheelPattern(2U, { 2 });
+    } },
+  { "Dual wheel", DECODER_DUAL_WHEEL, []() {
+      configPage4.triggerTeeth = 24;
+      return dualWheelPattern(24, 710);
+    } },
+  { "GM 7X", DECODER_GM7X, []() {
+      static constexpr uint16_t ANGLES[] = { 0, 60, 70, 120, 180, 240, 300 };
+      return toothAnglePattern(ANGLES, _countof(ANGLES), 360U);
+    } },
+  { "4G63", DECODER_4G63, []() {
+      // The decoder reads the crank & cam levels: the cam must be high for the crank pulse at 285° only
+      static constexpr uint16_t ANGLES[] = { 105, 175, 285, 355, 465, 535, 645, 715 };
+      trigger_pattern_t pattern = withCam(toothAnglePattern(ANGLES, _countof(ANGLES), 720U), { 230, 400, 600, 690 });
+      setAlternatingEdges(pattern.primaryEdge, pattern.primaryCount);
+      setAlternatingEdges(pattern.secondaryEdge, pattern.secondaryCount);
+      return pattern;
+    } },
+  { "GM 24X", DECODER_24X, []() {
+      static constexpr uint16_t ANGLES[] = { 12, 18, 33, 48, 63, 78, 102, 108, 123, 138, 162, 177, 183, 198, 222, 237, 252, 258, 282, 288, 312, 327, 342, 357 };
+      return withCam(toothAnglePattern(ANGLES, _countof(ANGLES), 360U), { 5, 365 });
+    } },
+  { "Jeep 2000", DECODER_JEEP2000, []() {
+      static constexpr uint16_t ANGLES[] = { 54, 74, 94, 114, 174, 194, 214, 234, 294, 314, 334, 354 };
+      return withCam(toothAnglePattern(ANGLES, _countof(ANGLES), 360U), { 150, 510 });
+    } },
+  { "Audi 135", DECODER_AUDI135, []() {
+      return withCam(slotWheelPattern(135U, { 135 }), { 710 });
+    } },
+  { "Honda D17", DECODER_HONDA_D17, []() {
+      static constexpr uint16_t ANGLES[] = { 0, 30, 60, 90, 120, 150, 180, 210, 240, 270, 300, 330, 340 };
+      return toothAnglePattern(ANGLES, _countof(ANGLES), 360U);
+    } },
+  { "Miata 99-05", DECODER_MIATA_9905, []() {
+      static constexpr uint16_t ANGLES[] = { 100, 170, 280, 350 };
+      return withCam(toothAnglePattern(ANGLES, _countof(ANGLES), 360U), { 40, 380, 400 });
+    } },
+  { "Non-360 dual", DECODER_NON360, []() {
+      configPage4.triggerTeeth = 24;
+      configPage4.TrigAngMul = 1;
+      return dualWheelPattern(24, 710);
+    } },
+  { "Subaru 6/7", DECODER_SUBARU_67, []() {
+      static constexpr uint16_t ANGLES[] = { 83, 115, 170, 263, 295, 350 };
+      return withCam(toothAnglePattern(ANGLES, _countof(ANGLES), 360U), { 20, 50, 80, 200, 380, 410, 560 });
+    } },
+  { "Daihatsu +1", DECODER_DAIHATSU_PLUS1, []() {
+      static constexpr uint16_t ANGLES[] = { 0, 30, 180, 360, 540 };
+      return toothAnglePattern(ANGLES, _countof(ANGLES), 720U);
+    } },
+  { "Harley", DECODER_HARLEY, []() {
+      static constexpr uint16_t ANGLES[] = { 0, 157 };
+      return toothAnglePattern(ANGLES, _countof(ANGLES), 360U);
+    } },
+  { "36-2-2-2", DECODER_36_2_2_2, []() {
+      return slotWheelPattern(36U, { 13, 2, 16, 2, 1, 2 });
+    } },
+  { "36-2-1", DECODER_36_2_1, []() {
+      return slotWheelPattern(36U, { 18, 1, 15, 2 });
+    } },
+  { "DSM 420a", DECODER_420A, []() {
+      static constexpr uint16_t ANGLES[] = { 0, 20, 90, 110, 180, 200, 270, 290 };
+      return withCam(toothAnglePattern(ANGLES, _countof(ANGLES), 360U), { 100, 460, 640 });
+    } },
+  { "Weber-Marelli", DECODER_WEBER, []() {
+      configPage4.triggerTeeth = 4;
+      return withCam(slotWheelPattern(4U, { 4 }), { 300, 480 });
+    } },
+  { "Ford ST170", DECODER_ST170, []() {
+      configPage4.triggerTeeth = 36;
+      configPage4.triggerMissingTeeth = 1;
+      return withCam(missingToothPattern(36, 1), { 0, 90, 180, 360, 630 });
+    } },
+  { "DRZ400", DECODER_DRZ400, []() {
+      configPage4.triggerTeeth = 6;
+      return dualWheelPattern(6, 710);
+    } },
+  { "NGC", DECODER_NGC, []() {
+      return withCam(slotWheelPattern(36U, { 13, 2, 16, 2, 1, 2 }), { 100, 280, 460, 640 });
+    } },
+  { "Renix 44-2-2", DECODER_RENIX, []() {
+      return slotWheelPattern(44U, { 20, 2, 20, 2 });
+    } },
+  { "Rover MEMS", DECODER_ROVERMEMS, []() {
+      // Full sync needs a cam & sequential
+      configPage4.sparkMode = IGN_MODE_SEQUENTIAL;
+      return withCam(slotWheelPattern(36U, { 17, 1, 17, 1 }), { 100 });
+    } },
+  { "Suzuki K6A", DECODER_SUZUKI_K6A, []() {
+      static constexpr uint16_t ANGLES[] = { 0, 170, 240, 410, 480, 515, 650 };
+      return toothAnglePattern(ANGLES, _countof(ANGLES), 720U);
+    } },
+  { "Honda J32", DECODER_HONDA_J32, []() {
+      return slotWheelPattern(24U, { 15, 1, 7, 1 });
+    } },
+  { "Ford TFI", DECODER_FORD_TFI, []() {
+      static constexpr uint16_t ANGLES[] = { 0, 180, 360, 540 };
+      return withCam(toothAnglePattern(ANGLES, _countof(ANGLES), 720U), { 90, 270, 450, 590 });
+    } },
+  { "Tooth table 36-1", DECODER_TOOTH_TABLE, []() {
+      return setToothTableWheel(36U, { 35U });
+    } },
+};
+
+/** @brief Decoders with no case, because they can't get full sync from power on */
+static constexpr uint8_t DECODER_COST_EXCLUDED[] = {
+  // Cam sync needs secondaryToothCount to be 2 on entry to the cam ISR, but the first cam gap
+  // after a reset is measured from time zero, so the count goes straight from 1 to 3 & is never reset
+  DECODER_MAZDA_AU,
+  // The cam ISR tells the start of a window from the end with isTriggered(), which is always true
+  // on its CHANGE interrupt, so a window never ends
+  DECODER_NISSAN_360,
+  // The ISR measures the lobe width only when isTriggered() is false, which it never is on the
+  // CHANGE interrupt the decoder attaches, so the wide lobe is never found
+  DECODER_VMAX,
+};
+static_assert(_countof(DECODER_COST_CASES)+_countof(DECODER_COST_EXCLUDED)==DECODER_MAX, "Every decoder must have a benchmark case or be excluded");
+
+/** @brief The RPM at which ISRs taking nanosPerEdge use DECODER_COST_ISR_LOAD_PERCENT of the CPU */
+static uint32_t maxRpmAtIsrLoad(uint32_t nanosPerEdge, uint32_t edgesPerCycle) {
+  if ( (nanosPerEdge==0U) || (edgesPerCycle==0U) ) { return 0U; }
+  // rpm * edgesPerCycle / 120 edges per second, each taking nanosPerEdge
+  return (uint32_t)(((uint64_t)DECODER_COST_ISR_LOAD_PERCENT * 1200000000ULL) / ((uint64_t)nanosPerEdge * edgesPerCycle));
+}
+
+extern uint16_t toothCurrentCount;
+
+static void bench_decoder_cost_case(const decoder_cost_case_t &costCase) {
+  decoder_accuracy_report_t report;
+  for (uint16_t rpm : BENCH_RPMS) {
+    setSimulatorConfig();
+    configPage2.nCylinders = 4;
+    trigger_pattern_t pattern = costCase.setup();
+    // Not all decoders reset this, so start each run as if just powered on
+    toothCurrentCount = 0U;
+    runDecoderSimulation(buildDecoder(costCase.decoder), pattern, { rpm, rpm, 0U, CYCLES_PER_RPM, 0U, 0U, 1234U }, report);
+  }
+
+  TEST_ASSERT_GREATER_THAN_UINT32(0U, report.samples);
+  const uint32_t syncPercent = ((report.samples - report.unsyncedSamples) * 100U) / report.samples;
+  // ISR calls, not pattern edges: an edge the interrupt isn't attached to costs nothing
+  const uint32_t edgesPerCycle = (report.primaryEdges + report.secondaryEdges) / (CYCLES_PER_RPM * _countof(BENCH_RPMS));
+  const uint32_t isrNanos = report.isrNanosPerEdge();
+
+  char buffer[128];
+  snprintf(buffer, _countof(buffer)-1, "| %-14s | %4" PRIu32 " | %7" PRIu32 " | %7" PRIu32 " | %7" PRIu32 " | %4" PRIu32 " | %8" PRIu32 " |",
+          costCase.name, syncPercent, isrNanos, report.isrMaxNanos, report.crankAngleNanosPerCall(), edgesPerCycle,
+          maxRpmAtIsrLoad(isrNanos, edgesPerCycle));
+  TEST_MESSAGE(buffer);
+}
+
+static void bench_decoder_cost(void) {
+  char buffer[128];
+  snprintf(buffer, _countof(buffer)-1, "| %-14s | %4s | %7s | %7s | %7s | %4s | %8s |",
+          "Decoder", "Sync", "ISR ns", "ISR max", "Angle", "Edge", "RPM@");
+  TEST_MESSAGE(buffer);
+  snprintf(buffer, _countof(buffer)-1, "| %-14s | %4s | %7s | %7s | %7s | %4s | %7" PRIu32 "%% |",
+          "", "%", "/edge", "ns", "ns/call", "/cyc", (uint32_t)DECODER_COST_ISR_LOAD_PERCENT);
+  TEST_MESSAGE(buffer);
+  for (const decoder_cost_case_t &costCase : DECODER_COST_CASES) {
+    bench_decoder_cost_case(costCase);
+  }
+}
+
+#else
+
+static void bench_decoder_cost_not_applicable(void) {
+  TEST_IGNORE_MESSAGE("Decoder cost benchmark needs the decoder simulator: native only");
+}
+
+#endif
+
+void benchDecoderCost(void) {
+  SET_UNITY_FILENAME() {
+#if defined(NATIVE_BOARD)
+    RUN_TEST_P(bench_decoder_cost);
+#else
+    RUN_TEST_P(bench_decoder_cost_not_applicable);
+#endif
+  }
+}
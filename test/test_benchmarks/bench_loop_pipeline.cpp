@@ -0,0 +1,230 @@
+#include <unity.h>
+#include "benchmark_support.h"
+#include "loop_trace.h"
+#include "baseline.h"
+#include "globals.h"
+#include "corrections.h"
+#include "fuel_calcs.h"
+#include "dwell.h"
+#include "crankMaths.h"
+#include "scheduler_fuel_controller.h"
+#include "../test_schedules/channel_test_helpers.h"
+
+extern uint16_t calcPrimaryPulseWidth(uint16_t injOpenTime, const config2 &page2, const config6 &page6, const config10 &page10, const statuses &current);
+extern uint16_t setFuelChannelSchedules(uint16_t crankAngle, byte injChannelMask, uint16_t injAngle);
+
+#if defined(__AVR__)
+static constexpr uint16_t ITERATIONS = 4U;
+#else
+static constexpr uint16_t ITERATIONS = 2000U;
+#endif
+
+// Prevent the optimiser discarding the stage results
+static volatile uint32_t resultSink;
+
+static void setup_trace_sample(uint16_t index) {
+  const loop_trace_sample_t sample = getTraceSample(index);
+  currentStatus.setRpm(sample.rpm);
+  currentStatus.MAP = sample.map;
+  currentStatus.fuelLoad = sample.map;
+  currentStatus.ignLoad = sample.map;
+  currentStatus.TPS = sample.tps;
+  currentStatus.coolant = sample.coolant;
+  currentStatus.revolutionTime = MICROS_PER_MIN / sample.rpm;
+  setAngleConverterRevolutionTime(currentStatus.revolutionTime);
+}
+
+static void setup_pipeline(void) {
+  initialiseCorrections();
+  populate_benchmark_table(fuelTable, 40U);
+  populate_benchmark_table(ignitionTable, 10U);
+  populate_benchmark_table(dwellTable, 30U);
+
+  configPage2.reqFuel = 100U;
+  configPage2.injOpen = 10U;
+  configPage2.dutyLim = 90U;
+  configPage2.strokes = FOUR_STROKE;
+  configPage2.nCylinders = 4U;
+  configPage2.useDwellMap = true;
+  configPage4.dwellRun = 30U;
+  configPage4.dwellCrank = 45U;
+
+  currentStatus.rotationStatus = EngineRotationStatus::Running;
+  currentStatus.nSquirts = 1U;
+  currentStatus.corrections = 100U;
+  currentStatus.VE = 80U;
+  currentStatus.battery10 = 140U;
+  currentStatus.LOOP_TIMER = 0xFFU;
+
+  CRANK_ANGLE_MAX_INJ = 720;
+}
+
+static void set_all_fuel_schedules_off(void) {
+  RUNIF_INJCHANNEL1( { fuelSchedule1._status = ScheduleStatus::OFF; }, {});
+  RUNIF_INJCHANNEL2( { fuelSchedule2._status = ScheduleStatus::OFF; }, {});
+  RUNIF_INJCHANNEL3( { fuelSchedule3._status = ScheduleStatus::OFF; }, {});
+  RUNIF_INJCHANNEL4( { fuelSchedule4._status = ScheduleStatus::OFF; }, {});
+  RUNIF_INJCHANNEL5( { fuelSchedule5._status = ScheduleStatus::OFF; }, {});
+  RUNIF_INJCHANNEL6( { fuelSchedule6._status = ScheduleStatus::OFF; }, {});
+  RUNIF_INJCHANNEL7( { fuelSchedule7._status = ScheduleStatus::OFF; }, {});
+  RUNIF_INJCHANNEL8( { fuelSchedule8._status = ScheduleStatus::OFF; }, {});
+}
+
+static void set_all_fuel_schedules_pw(uint16_t pw) {
+  RUNIF_INJCHANNEL1( { fuelSchedule1.pw = pw; }, {});
+  RUNIF_INJCHANNEL2( { fuelSchedule2.pw = pw; }, {});
+  RUNIF_INJCHANNEL3( { fuelSchedule3.pw = pw; }, {});
+  RUNIF_INJCHANNEL4( { fuelSchedule4.pw = pw; }, {});
+  RUNIF_INJCHANNEL5( { fuelSchedule5.pw = pw; }, {});
+  RUNIF_INJCHANNEL6( { fuelSchedule6.pw = pw; }, {});
+  RUNIF_INJCHANNEL7( { fuelSchedule7.pw = pw; }, {});
+  RUNIF_INJCHANNEL8( { fuelSchedule8.pw = pw; }, {});
+}
+
+static void bench_get3DTableValue(void) {
+  setup_pipeline();
+  benchmark_result_t result = run_benchmark(ITERATIONS, LOOP_TRACE_LENGTH, [](uint16_t index) {
+    const loop_trace_sample_t sample = getTraceSample(index);
+    resultSink = get3DTableValue(&fuelTable, sample.map, sample.rpm);
+  });
+  reportBenchmark("get3DTableValue", result, BASELINE_GET3DTABLEVALUE);
+}
+
+// The 16x16 tables looked up every loop, all with the same axes
+static void setup_table_set(void) {
+  setup_pipeline();
+  populate_benchmark_table(fuelTable2, 40U);
+  populate_benchmark_table(ignitionTable2, 10U);
+  populate_benchmark_table(afrTable, 120U);
+}
+
+static void bench_get3DTableValue_5_tables(void) {
+  setup_table_set();
+  benchmark_result_t result = run_benchmark(ITERATIONS, LOOP_TRACE_LENGTH, [](uint16_t index) {
+    const loop_trace_sample_t sample = getTraceSample(index);
+    resultSink = get3DTableValue(&fuelTable, sample.map, sample.rpm)
+               + get3DTableValue(&fuelTable2, sample.map, sample.rpm)
+               + get3DTableValue(&ignitionTable, sample.map, sample.rpm)
+               + get3DTableValue(&ignitionTable2, sample.map, sample.rpm)
+               + get3DTableValue(&afrTable, sample.map, sample.rpm);
+  });
+  reportBenchmark("get3DTableValue x5", result, BASELINE_GET3DTABLEVALUE_5_TABLES);
+}
+
+static void bench_get3DTableValue_5_tables_shared(void) {
+  setup_table_set();
+  benchmark_result_t result = run_benchmark(ITERATIONS, LOOP_TRACE_LENGTH, [](uint16_t index) {
+    const loop_trace_sample_t sample = getTraceSample(index);
+    resetAxisContext(tableAxisContext);
+    resultSink = get3DTableValue(tableAxisContext, &fuelTable, sample.map, sample.rpm)
+               + get3DTableValue(tableAxisContext, &fuelTable2, sample.map, sample.rpm)
+               + get3DTableValue(tableAxisContext, &ignitionTable, sample.map, sample.rpm)
+               + get3DTableValue(tableAxisContext, &ignitionTable2, sample.map, sample.rpm)
+               + get3DTableValue(tableAxisContext, &afrTable, sample.map, sample.rpm);
+  });
+  reportBenchmark("get3DTableValue x5 shared axes", result, BASELINE_GET3DTABLEVALUE_5_TABLES_SHARED);
+}
+
+static void bench_get3DTableValue_5_tables_batched(void) {
+  setup_table_set();
+  benchmark_result_t result = run_benchmark(ITERATIONS, LOOP_TRACE_LENGTH, [](uint16_t index) {
+    const loop_trace_sample_t sample = getTraceSample(index);
+    auto values = get3DTableValues(sample.map, sample.rpm, &fuelTable, &fuelTable2, &ignitionTable, &ignitionTable2, &afrTable);
+    resultSink = values[0] + values[1] + values[2] + values[3] + values[4];
+  });
+  reportBenchmark("get3DTableValues x5 batched", result, BASELINE_GET3DTABLEVALUE_5_TABLES_BATCHED);
+}
+
+static void bench_correctionsFuel(void) {
+  setup_pipeline();
+  benchmark_result_t result = run_benchmark(ITERATIONS, LOOP_TRACE_LENGTH, [](uint16_t index) {
+    setup_trace_sample(index);
+    resultSink = correctionsFuel();
+  });
+  reportBenchmark("correctionsFuel", result, BASELINE_CORRECTIONSFUEL);
+}
+
+static void bench_calcPrimaryPulseWidth(void) {
+  setup_pipeline();
+  benchmark_result_t result = run_benchmark(ITERATIONS, LOOP_TRACE_LENGTH, [](uint16_t index) {
+    setup_trace_sample(index);
+    resultSink = calcPrimaryPulseWidth(1000U, configPage2, configPage6, configPage10, currentStatus);
+  });
+  reportBenchmark("calcPrimaryPulseWidth", result, BASELINE_CALCPRIMARYPULSEWIDTH);
+}
+
+static void bench_computePulseWidths(void) {
+  setup_pipeline();
+  benchmark_result_t result = run_benchmark(ITERATIONS, LOOP_TRACE_LENGTH, [](uint16_t index) {
+    setup_trace_sample(index);
+    resultSink = computePulseWidths(configPage2, configPage6, configPage10, currentStatus, 0U).primary;
+  });
+  reportBenchmark("computePulseWidths", result, BASELINE_COMPUTEPULSEWIDTHS);
+}
+
+static void bench_correctionsIgn(void) {
+  setup_pipeline();
+  benchmark_result_t result = run_benchmark(ITERATIONS, LOOP_TRACE_LENGTH, [](uint16_t index) {
+    setup_trace_sample(index);
+    resultSink = (uint32_t)correctionsIgn(20);
+  });
+  reportBenchmark("correctionsIgn", result, BASELINE_CORRECTIONSIGN);
+}
+
+static void bench_computeDwell(void) {
+  setup_pipeline();
+  benchmark_result_t result = run_benchmark(ITERATIONS, LOOP_TRACE_LENGTH, [](uint16_t index) {
+    setup_trace_sample(index);
+    resultSink = computeDwell(currentStatus, configPage2, configPage4, get3DTableValue(&dwellTable, currentStatus.ignLoad, currentStatus.RPM));
+  });
+  reportBenchmark("computeDwell", result, BASELINE_COMPUTEDWELL);
+}
+
+static void bench_setFuelChannelSchedules(void) {
+  setup_pipeline();
+  stopFuelSchedulers();
+  set_all_fuel_schedules_pw(3000U);
+  benchmark_result_t result = run_benchmark(ITERATIONS, LOOP_TRACE_LENGTH, [](uint16_t index) {
+    setup_trace_sample(index);
+    set_all_fuel_schedules_off();
+    resultSink = setFuelChannelSchedules((uint16_t)((index * 11U) % 720U), 0xFFU, 355U);
+  });
+  set_all_fuel_schedules_off();
+  reportBenchmark("setFuelChannelSchedules", result, BASELINE_SETFUELCHANNELSCHEDULES);
+}
+
+// All of the above, in main loop order
+static void bench_loop_pipeline(void) {
+  setup_pipeline();
+  stopFuelSchedulers();
+  benchmark_result_t result = run_benchmark(ITERATIONS, LOOP_TRACE_LENGTH, [](uint16_t index) {
+    setup_trace_sample(index);
+    currentStatus.VE = (byte)get3DTableValue(&fuelTable, currentStatus.fuelLoad, currentStatus.RPM);
+    auto ignitionValues = get3DTableValues(currentStatus.ignLoad, currentStatus.RPM, &ignitionTable, &dwellTable);
+    currentStatus.advance = correctionsIgn((int8_t)ignitionValues[0]);
+    currentStatus.corrections = correctionsFuel();
+    pulseWidths pulse_widths = computePulseWidths(configPage2, configPage6, configPage10, currentStatus, 0U);
+    currentStatus.dwell = computeDwell(currentStatus, configPage2, configPage4, ignitionValues[1]);
+    set_all_fuel_schedules_off();
+    set_all_fuel_schedules_pw(pulse_widths.primary);
+    resultSink = setFuelChannelSchedules((uint16_t)((index * 11U) % 720U), 0xFFU, 355U);
+  });
+  set_all_fuel_schedules_off();
+  reportBenchmark("loop pipeline", result, BASELINE_LOOP_PIPELINE);
+}
+
+void benchLoopPipeline(void) {
+  SET_UNITY_FILENAME() {
+    RUN_TEST_P(bench_get3DTableValue);
+    RUN_TEST_P(bench_get3DTableValue_5_tables);
+    RUN_TEST_P(bench_get3DTableValue_5_tables_shared);
+    RUN_TEST_P(bench_get3DTableValue_5_tables_batched);
+    RUN_TEST_P(bench_correctionsFuel);
+    RUN_TEST_P(bench_calcPrimaryPulseWidth);
+    RUN_TEST_P(bench_computePulseWidths);
+    RUN_TEST_P(bench_correctionsIgn);
+    RUN_TEST_P(bench_computeDwell);
+    RUN_TEST_P(bench_setFuelChannelSchedules);
+    RUN_TEST_P(bench_loop_pipeline);
+  }
+}
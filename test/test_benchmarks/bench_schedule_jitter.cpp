@@ -0,0 +1,55 @@
+#include <unity.h>
+#include "benchmark_support.h"
+#include "../schedule_jitter_harness.h"
+
+#if defined(__AVR__)
+static constexpr uint16_t LOOPS = 2000U;
+#else
+static constexpr uint16_t LOOPS = 40000U;
+#endif
+
+static constexpr uint8_t CHANNELS = 4U;
+
+// Anything later than one tick after the requested time is the scheduler's fault, not quantisation
+static void checkJitterLimit(const char *name, uint8_t channel, const jitter_stats_t &stats) {
+  constexpr int32_t LIMIT = (int32_t)ticksToMicros(1U);
+  if (stats.maximum>LIMIT) {
+    char buffer[96];
+    snprintf(buffer, _countof(buffer)-1, "REGRESSION jitter ch%" PRIu8 " %s: max %" PRId32 "us > limit %" PRId32 "us", channel, name, stats.maximum, LIMIT);
+    TEST_MESSAGE(buffer);
+#if defined(BENCHMARK_ENFORCE_BASELINE)
+    TEST_FAIL_MESSAGE(buffer);
+#endif
+  }
+}
+
+// The jitter figures are in simulated time, so unlike the other benchmarks they
+// are exact & repeatable: the limits below are absolute, not relative to a baseline.
+static void bench_schedule_jitter(uint16_t minRpm, uint16_t maxRpm, uint8_t maxDutyPercent) {
+  for (uint8_t channel=0U; channel<CHANNELS; ++channel) {
+    schedule_jitter_params_t params = { 0x9E3779B9UL, LOOPS, (uint16_t)(channel * (720U/CHANNELS)), minRpm, maxRpm, maxDutyPercent };
+    schedule_jitter_report_t report;
+    runScheduleJitter(params, report);
+    reportScheduleJitter(channel+1U, report);
+    checkJitterLimit("start", channel+1U, report.start);
+    checkJitterLimit("end", channel+1U, report.end);
+    checkJitterLimit("queued start", channel+1U, report.queuedStart);
+    checkJitterLimit("queued end", channel+1U, report.queuedEnd);
+  }
+}
+
+static void bench_schedule_jitter_cruise(void) {
+  bench_schedule_jitter(1500U, 4500U, 50U);
+}
+
+static void bench_schedule_jitter_high_load(void) {
+  // High duty cycles & RPM: maximises the time spent RUNNING, so most requests are queued
+  bench_schedule_jitter(3000U, 7000U, 90U);
+}
+
+void benchScheduleJitter(void) {
+  SET_UNITY_FILENAME() {
+    RUN_TEST_P(bench_schedule_jitter_cruise);
+    RUN_TEST_P(bench_schedule_jitter_high_load);
+  }
+}
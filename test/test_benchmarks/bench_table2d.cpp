@@ -0,0 +1,61 @@
+#include <unity.h>
+#include "benchmark_support.h"
+#include "baseline.h"
+#include "table2d.h"
+
+#if defined(__AVR__)
+static constexpr uint16_t ITERATIONS = 4U;
+#else
+static constexpr uint16_t ITERATIONS = 2000U;
+#endif
+
+// Prevent the optimiser discarding the searches
+static volatile uint32_t resultSink;
+
+// Same as the CLT & IAT calibration tables: 32 evenly spaced ADC values
+static uint16_t calibrationAxis[32];
+
+static void setup_calibration_axis(void) {
+  for (uint8_t index=0; index<_countof(calibrationAxis); ++index) {
+    calibrationAxis[index] = index*33U;
+  }
+}
+
+// A scattered sweep of the ADC range, so the search is never the same twice in a row
+static inline uint16_t getAdcSample(uint16_t index) {
+  return (uint16_t)((index * 379U) % 1024U);
+}
+
+static constexpr uint16_t ADC_SAMPLES = 1024U;
+
+static void bench_table2d_search_lower_bound(void) {
+  setup_calibration_axis();
+  benchmark_result_t result = run_benchmark(ITERATIONS, ADC_SAMPLES, [](uint16_t index) {
+    resultSink = _table2d_detail::findBinUpperIndex(calibrationAxis, calibrationAxis+_countof(calibrationAxis), getAdcSample(index));
+  });
+  reportBenchmark("table2D 32 bin search: std::lower_bound", result, BASELINE_TABLE2D_SEARCH_LOWER_BOUND);
+}
+
+static void bench_table2d_search_binary(void) {
+  setup_calibration_axis();
+  benchmark_result_t result = run_benchmark(ITERATIONS, ADC_SAMPLES, [](uint16_t index) {
+    resultSink = _table2d_detail::searchBinUpperIndex<32U, uint16_t, _table2d_detail::BinSearch::Binary>(calibrationAxis, getAdcSample(index));
+  });
+  reportBenchmark("table2D 32 bin search: branchless binary", result, BASELINE_TABLE2D_SEARCH_BINARY);
+}
+
+static void bench_table2d_search_direct(void) {
+  setup_calibration_axis();
+  benchmark_result_t result = run_benchmark(ITERATIONS, ADC_SAMPLES, [](uint16_t index) {
+    resultSink = _table2d_detail::searchBinUpperIndex<32U, uint16_t, _table2d_detail::BinSearch::DirectIndex>(calibrationAxis, getAdcSample(index));
+  });
+  reportBenchmark("table2D 32 bin search: direct index", result, BASELINE_TABLE2D_SEARCH_DIRECT);
+}
+
+void benchTable2d(void) {
+  SET_UNITY_FILENAME() {
+    RUN_TEST_P(bench_table2d_search_lower_bound);
+    RUN_TEST_P(bench_table2d_search_binary);
+    RUN_TEST_P(bench_table2d_search_direct);
+  }
+}
@@ -0,0 +1,127 @@
+#include <unity.h>
+#include "benchmark_support.h"
+#include "loop_trace.h"
+#include "baseline.h"
+#include "table3d.h"
+
+#if defined(__AVR__)
+static constexpr uint16_t ITERATIONS = 4U;
+#else
+static constexpr uint16_t ITERATIONS = 2000U;
+#endif
+
+// Prevent the optimiser discarding the lookups
+static volatile uint32_t resultSink;
+
+// Lookup cost by table size. The axis bin search is a binary search, so the cost
+// should grow with log2(axis size) - not with the number of cells.
+template <typename TTable>
+static benchmark_result_t bench_table_size(const char *name, uint32_t baseline) {
+  static TTable table;
+  populate_benchmark_table(table, 40U);
+  benchmark_result_t result = run_benchmark(ITERATIONS, LOOP_TRACE_LENGTH, [](uint16_t index) {
+    const loop_trace_sample_t sample = getTraceSample(index);
+    resultSink = get3DTableValue(&table, sample.map, sample.rpm);
+  });
+  reportBenchmark(name, result, baseline);
+  return result;
+}
+
+static void bench_table3d_8x8(void) {
+  (void)bench_table_size<table3d8RpmLoad>("get3DTableValue 8x8", BASELINE_TABLE3D_8X8);
+}
+
+static void bench_table3d_16x16(void) {
+  (void)bench_table_size<table3d16RpmLoad>("get3DTableValue 16x16", BASELINE_TABLE3D_16X16);
+}
+
+#if defined(TABLE3D_LARGE_TABLES)
+static void bench_table3d_20x20(void) {
+  (void)bench_table_size<table3d20RpmLoad>("get3DTableValue 20x20", BASELINE_TABLE3D_20X20);
+}
+
+static void bench_table3d_24x24(void) {
+  auto small = bench_table_size<table3d16RpmLoad>("get3DTableValue 16x16", BASELINE_TABLE3D_16X16);
+  auto large = bench_table_size<table3d24RpmLoad>("get3DTableValue 24x24", BASELINE_TABLE3D_24X24);
+
+  char buffer[96];
+  snprintf(buffer, _countof(buffer)-1, "Benchmark 24x24 vs 16x16: %" PRIu32 "%%", 
+          (uint32_t)(((uint64_t)large.nanosPerOp()*100U)/(small.nanosPerOp()==0U ? 1U : small.nanosPerOp())));
+  TEST_MESSAGE(buffer);
+}
+#endif
+
+// The trace is decimated: replay it at the main loop rate by interpolating between 
+// samples, plus some sensor noise. MAP in particular is never still.
+static constexpr uint16_t LOOPS_PER_SAMPLE = 16U;
+
+static xy_pair_t getNoisyLookup(uint16_t index, uint32_t &seed) {
+  const uint16_t sampleIndex = index / LOOPS_PER_SAMPLE;
+  const loop_trace_sample_t from = getTraceSample(sampleIndex);
+  const loop_trace_sample_t to = getTraceSample(sampleIndex+1U<LOOP_TRACE_LENGTH ? sampleIndex+1U : sampleIndex);
+  const int32_t step = (int32_t)(index % LOOPS_PER_SAMPLE);
+
+  // xorshift32
+  seed ^= seed << 13U;
+  seed ^= seed >> 17U;
+  seed ^= seed << 5U;
+  // RPM +/-8, MAP +/-1kPa
+  int32_t rpm = from.rpm + ((((int32_t)to.rpm-(int32_t)from.rpm)*step)/LOOPS_PER_SAMPLE) + (int32_t)(seed % 17U) - 8;
+  int32_t map = from.map + ((((int32_t)to.map-(int32_t)from.map)*step)/LOOPS_PER_SAMPLE) + (int32_t)((seed >> 8U) % 3U) - 1;
+  return { (uint16_t)(rpm<0 ? 0 : rpm), (uint16_t)(map<0 ? 0 : map) };
+}
+
+static uint16_t percentOf(uint32_t count, uint32_t total) {
+  return total==0U ? 0U : (uint16_t)(((uint64_t)count*100U)/total);
+}
+
+template <bool useCache>
+static benchmark_result_t bench_trace_replay(const char *name, uint32_t baseline) {
+  static table3d16RpmLoad table;
+  populate_benchmark_table(table, 40U);
+  uint32_t seed = 1234U;
+  const table3d_cache_stats_t before = table3dCacheStats;
+  benchmark_result_t result = run_benchmark(ITERATIONS, LOOP_TRACE_LENGTH*LOOPS_PER_SAMPLE, [&seed](uint16_t index) {
+    const xy_pair_t lookup = getNoisyLookup(index, seed);
+    resultSink = get3DTableValue<useCache>(&table, lookup.y, lookup.x);
+  });
+  reportBenchmark(name, result, baseline);
+
+  if (useCache) {
+    uint32_t counts[4];
+    for (uint8_t index=0; index<_countof(counts); ++index) {
+      counts[index] = table3dCacheStats.results[index] - before.results[index];
+    }
+    const uint32_t total = counts[0]+counts[1]+counts[2]+counts[3];
+    char buffer[128];
+    snprintf(buffer, _countof(buffer)-1, "Benchmark %s: exact %" PRIu16 "%%, below resolution %" PRIu16 "%%, same bin %" PRIu16 "%%, miss %" PRIu16 "%%", name,
+            percentOf(counts[(uint8_t)Table3dCacheResult::Exact], total),
+            percentOf(counts[(uint8_t)Table3dCacheResult::BelowResolution], total),
+            percentOf(counts[(uint8_t)Table3dCacheResult::SameBin], total),
+            percentOf(counts[(uint8_t)Table3dCacheResult::Miss], total));
+    TEST_MESSAGE(buffer);
+  }
+  return result;
+}
+
+static void bench_table3d_cache(void) {
+  auto uncached = bench_trace_replay<false>("get3DTableValue noisy trace, uncached", BASELINE_TABLE3D_TRACE_UNCACHED);
+  auto cached = bench_trace_replay<true>("get3DTableValue noisy trace, cached", BASELINE_TABLE3D_TRACE_CACHED);
+
+  char buffer[96];
+  snprintf(buffer, _countof(buffer)-1, "Benchmark cached vs uncached: %" PRIu32 "%%", 
+          (uint32_t)(((uint64_t)cached.nanosPerOp()*100U)/(uncached.nanosPerOp()==0U ? 1U : uncached.nanosPerOp())));
+  TEST_MESSAGE(buffer);
+}
+
+void benchTable3d(void) {
+  SET_UNITY_FILENAME() {
+    RUN_TEST_P(bench_table3d_8x8);
+    RUN_TEST_P(bench_table3d_16x16);
+#if defined(TABLE3D_LARGE_TABLES)
+    RUN_TEST_P(bench_table3d_20x20);
+    RUN_TEST_P(bench_table3d_24x24);
+#endif
+    RUN_TEST_P(bench_table3d_cache);
+  }
+}
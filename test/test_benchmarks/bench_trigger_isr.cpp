@@ -0,0 +1,80 @@
+#include <unity.h>
+#include "benchmark_support.h"
+#include "baseline.h"
+
+#if defined(NATIVE_BOARD)
+
+#include "decoders.h"
+#include "../decoder_simulator.h"
+
+// Steady high speed: the ISRs run on every tooth, with full sync
+static constexpr engine_profile_t HIGH_RPM = { 7000U, 7000U, 0U, 200U, 0U, 0U, 1234U };
+
+// The trigger ISR time is measured per edge by the simulator. The maximum is what the
+// schedule compare interrupts can be held off by, so is reported alongside the mean.
+// As run_benchmark(), the fastest of the repeats is kept: each one needs a freshly set up decoder.
+template <typename TSetup>
+static void bench_trigger_isr(const char *name, TSetup setupDecoder, const trigger_pattern_t &pattern, uint32_t baseline) {
+  decoder_accuracy_report_t report;
+  runDecoderSimulation(setupDecoder(), pattern, HIGH_RPM, report);
+  for (uint8_t repeat=1U; repeat<BENCHMARK_REPEATS; ++repeat) {
+    decoder_accuracy_report_t repeatReport;
+    runDecoderSimulation(setupDecoder(), pattern, HIGH_RPM, repeatReport);
+    if (repeatReport.isrNanos<report.isrNanos) { report = repeatReport; }
+  }
+
+  benchmark_result_t result = { (uint32_t)(report.isrNanos / 1000U), report.primaryEdges + report.secondaryEdges };
+  reportBenchmark(name, result, baseline);
+
+  char buffer[96];
+  snprintf(buffer, _countof(buffer)-1, "Benchmark %s: max %" PRIu32 " ns", name, report.isrMaxNanos);
+  TEST_MESSAGE(buffer);
+}
+
+static void bench_trigger_isr_missingTooth_36_1(void) {
+  setSimulatorConfig();
+  configPage4.triggerTeeth = 36;
+  configPage4.triggerMissingTeeth = 1;
+  bench_trigger_isr("Trigger ISR 36-1", triggerSetup_missingTooth, missingToothPattern(36, 1), BASELINE_TRIGGER_ISR_36_1);
+}
+
+static void bench_trigger_isr_missingTooth_60_2(void) {
+  setSimulatorConfig();
+  configPage4.triggerTeeth = 60;
+  configPage4.triggerMissingTeeth = 2;
+  bench_trigger_isr("Trigger ISR 60-2", triggerSetup_missingTooth, missingToothPattern(60, 2), BASELINE_TRIGGER_ISR_60_2);
+}
+
+static void bench_trigger_isr_dualWheel_24(void) {
+  setSimulatorConfig();
+  configPage4.triggerTeeth = 24;
+  bench_trigger_isr("Trigger ISR dual wheel 24", triggerSetup_DualWheel, dualWheelPattern(24, 710), BASELINE_TRIGGER_ISR_DUAL_WHEEL_24);
+}
+
+// The same wheel as bench_trigger_isr_missingTooth_36_1, via the table driven decoder
+static void bench_trigger_isr_toothTable_36_1(void) {
+  setSimulatorConfig();
+  trigger_pattern_t pattern = setToothTableWheel(36U, { 35U });
+  bench_trigger_isr("Trigger ISR tooth table 36-1", triggerSetup_toothTable, pattern, BASELINE_TRIGGER_ISR_TOOTH_TABLE_36_1);
+}
+
+#else
+
+static void bench_trigger_isr_not_applicable(void) {
+  TEST_IGNORE_MESSAGE("Trigger ISR benchmark needs the decoder simulator: native only");
+}
+
+#endif
+
+void benchTriggerIsr(void) {
+  SET_UNITY_FILENAME() {
+#if defined(NATIVE_BOARD)
+    RUN_TEST_P(bench_trigger_isr_missingTooth_36_1);
+    RUN_TEST_P(bench_trigger_isr_missingTooth_60_2);
+    RUN_TEST_P(bench_trigger_isr_dualWheel_24);
+    RUN_TEST_P(bench_trigger_isr_toothTable_36_1);
+#else
+    RUN_TEST_P(bench_trigger_isr_not_applicable);
+#endif
+  }
+}
@@ -0,0 +1,54 @@
+#include "benchmark_support.h"
+
+static volatile uint32_t calibrationSink;
+
+// Long enough that the calibration time is well above the timer resolution
+#if defined(__AVR__)
+static constexpr uint16_t CALIBRATION_ITERATIONS = 64U;
+#else
+static constexpr uint16_t CALIBRATION_ITERATIONS = 4096U;
+#endif
+
+static benchmark_result_t calibrationResult = { 0U, 0U };
+
+benchmark_result_t calibrateBenchmarks(void) {
+  if (calibrationResult.operations==0U) {
+    // xorshift32: cheap, not optimised away & roughly the same mix of
+    // shifts, adds and branches as the firmware calculations.
+    uint32_t state = 2463534242UL;
+    calibrationResult = run_benchmark(CALIBRATION_ITERATIONS, 256U, [&state](uint16_t index) {
+      state ^= state << 13;
+      state ^= state >> 17;
+      state ^= state << 5;
+      calibrationSink = state + index;
+    });
+  }
+  return calibrationResult;
+}
+
+static uint32_t relativeCost(const benchmark_result_t &result) {
+  // From the raw durations: on a fast host a whole number of ns/op is too coarse
+  const benchmark_result_t &calibration = calibrateBenchmarks();
+  const uint64_t divisor = (uint64_t)result.operations * (calibration.durationMicros==0U ? 1U : calibration.durationMicros);
+  return divisor==0U ? 0U : (uint32_t)(((uint64_t)result.durationMicros * calibration.operations * 1000U) / divisor);
+}
+
+void reportBenchmark(const char *name, const benchmark_result_t &result, uint32_t baselinePermille) {
+  const uint32_t relative = relativeCost(result);
+
+  char buffer[160];
+  snprintf(buffer, _countof(buffer)-1, "Benchmark %s: %" PRIu32 " ns/op, ~%" PRIu32 " cycles/op @%" PRIu32 "MHz, relative %" PRIu32 " (baseline %" PRIu32 ")",
+          name, result.nanosPerOp(), result.cyclesPerOp(), (uint32_t)BENCHMARK_CPU_MHZ, relative, baselinePermille);
+  TEST_MESSAGE(buffer);
+
+  if (baselinePermille!=0U) {
+    const uint32_t limit = (baselinePermille * (100U + BENCHMARK_REGRESSION_TOLERANCE)) / 100U;
+    if (relative>limit) {
+      snprintf(buffer, _countof(buffer)-1, "REGRESSION %s: relative %" PRIu32 " > limit %" PRIu32, name, relative, limit);
+      TEST_MESSAGE(buffer);
+#if defined(BENCHMARK_ENFORCE_BASELINE)
+      TEST_FAIL_MESSAGE(buffer);
+#endif
+    }
+  }
+}
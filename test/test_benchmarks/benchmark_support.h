@@ -0,0 +1,119 @@
+#pragma once
+
+/**
+ * @file
+ * @brief Support code for the host side (& on target) benchmarks.
+ *
+ * Each benchmark runs a firmware stage over a recorded trace & reports:
+ *  - ns/op
+ *  - an estimated cycle count (at BENCHMARK_CPU_MHZ)
+ *  - cost relative to a fixed calibration kernel, compared to a stored baseline
+ *
+ * Absolute timings vary between machines, so the baselines are stored as relative
+ * costs (stage time / calibration kernel time, in permille). Regressions are reported
+ * always, but only fail the test if BENCHMARK_ENFORCE_BASELINE is defined (see
+ * the native_benchmark environment in platformio.ini).
+ */
+
+#include <unity.h>
+#include <stdio.h>
+#include <inttypes.h>
+#include "../test_utils.h"
+#include "../timer.hpp"
+
+#if !defined(BENCHMARK_CPU_MHZ)
+#if defined(F_CPU)
+#define BENCHMARK_CPU_MHZ (F_CPU/1000000UL)
+#else
+/** @brief Nominal host clock used to estimate cycle counts. Override with -DBENCHMARK_CPU_MHZ=... */
+#define BENCHMARK_CPU_MHZ 1000UL
+#endif
+#endif
+
+#if !defined(BENCHMARK_REGRESSION_TOLERANCE)
+/** @brief Percentage above the baseline relative cost that is treated as a regression */
+#define BENCHMARK_REGRESSION_TOLERANCE 25U
+#endif
+
+#if !defined(BENCHMARK_REPEATS)
+#if defined(__AVR__)
+#define BENCHMARK_REPEATS 1U
+#else
+/** @brief Number of times each benchmark is repeated: the fastest is reported */
+#define BENCHMARK_REPEATS 5U
+#endif
+#endif
+
+/** @brief One sample of a recorded engine trace */
+struct loop_trace_sample_t {
+  uint16_t rpm;
+  uint16_t map;   ///< kPa
+  uint8_t tps;    ///< %
+  int8_t coolant; ///< °C
+};
+
+/** @brief The result of one benchmark run */
+struct benchmark_result_t {
+  uint32_t durationMicros;
+  uint32_t operations;
+
+  uint32_t nanosPerOp(void) const {
+    return operations==0U ? 0U : (uint32_t)(((uint64_t)durationMicros * 1000ULL) / operations);
+  }
+  uint32_t cyclesPerOp(void) const {
+    return operations==0U ? 0U : (uint32_t)(((uint64_t)durationMicros * BENCHMARK_CPU_MHZ) / operations);
+  }
+};
+
+/**
+ * @brief Time a benchmark body.
+ *
+ * @param iterations Number of times to run the body over the trace
+ * @param traceLength Number of trace samples processed per iteration
+ * @param body Called once per trace sample, with the sample index
+ */
+template <typename TBody>
+static inline benchmark_result_t run_benchmark(uint16_t iterations, uint16_t traceLength, TBody body) {
+  // Keep the fastest of the repeats: on a host, anything slower was preempted
+  uint32_t fastest = UINT32_MAX;
+  for (uint8_t repeat=0; repeat<BENCHMARK_REPEATS; ++repeat) {
+    timer measure;
+    measure.start();
+    for (uint16_t loop=0; loop<iterations; ++loop) {
+      for (uint16_t index=0; index<traceLength; ++index) {
+        body(index);
+      }
+    }
+    measure.stop();
+    fastest = (std::min)(fastest, (uint32_t)measure.duration_micros());
+  }
+  return benchmark_result_t { fastest, (uint32_t)iterations * traceLength };
+}
+
+/** @brief Fill a 3D table with evenly spaced axes covering 500-9000rpm & 20-250kPa, and varied values */
+template <typename table3d_t>
+static inline void populate_benchmark_table(table3d_t &table, table3d_value_t base) {
+  const uint8_t size = (uint8_t)table.axisX.size();
+  for (uint8_t index=0; index<size; ++index) {
+    table.axisX[index] = (table3d_axis_t)((500U + (((9000U-500U)*index)/(size-1U))) / getConversionFactor(table.XDomain));
+    table.axisY[index] = (table3d_axis_t)((20U + (((250U-20U)*index)/(size-1U))) / getConversionFactor(table.YDomain));
+  }
+  uint16_t cell = 0;
+  for (auto &value : table.values) {
+    value = (table3d_value_t)(base + (cell % 97U));
+    ++cell;
+  }
+  invalidate_cache(&table.get_value_cache);
+}
+
+/** @brief Measure the calibration kernel: a fixed integer workload that all stages are normalised against */
+benchmark_result_t calibrateBenchmarks(void);
+
+/**
+ * @brief Report a benchmark result & check it against the stored baseline
+ *
+ * @param name Stage name
+ * @param result The stage timing
+ * @param baselinePermille Stored relative cost (0 if not yet recorded)
+ */
+void reportBenchmark(const char *name, const benchmark_result_t &result, uint32_t baselinePermille);
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "benchmark_support.h"
+
+// A recorded drive trace: idle, tip-in, a WOT pull to 8600rpm, overrun & then cruise.
+// Sampled once per main loop pass (decimated).
+TEST_DATA_P loop_trace_sample_t LOOP_TRACE[] = {
+  {   850,  32,   0, 82 }, {   865,  34,   0, 82 }, {   880,  32,   0, 82 }, {   850,  34,   0, 82 },
+  {   865,  32,   0, 82 }, {   880,  34,   0, 82 }, {   850,  32,   0, 82 }, {   865,  34,   0, 82 },
+  {  1500,  60,  40, 85 }, {  1729,  75,  70, 85 }, {  1958,  90, 100, 85 }, {  2187, 118, 100, 85 },
+  {  2416, 124, 100, 85 }, {  2645, 130, 100, 85 }, {  2874, 136, 100, 85 }, {  3103, 142, 100, 85 },
+  {  3332, 148, 100, 86 }, {  3561, 154, 100, 86 }, {  3790, 160, 100, 86 }, {  4019, 166, 100, 86 },
+  {  4248, 172, 100, 86 }, {  4477, 178, 100, 86 }, {  4706, 184, 100, 86 }, {  4935, 190, 100, 86 },
+  {  5164, 196, 100, 87 }, {  5393, 202, 100, 87 }, {  5622, 208, 100, 87 }, {  5851, 214, 100, 87 },
+  {  6080, 220, 100, 87 }, {  6309, 226, 100, 87 }, {  6538, 232, 100, 87 }, {  6767, 238, 100, 87 },
+  {  6996, 240, 100, 88 }, {  7225, 240, 100, 88 }, {  7454, 240, 100, 88 }, {  7683, 240, 100, 88 },
+  {  7912, 240, 100, 88 }, {  8141, 240, 100, 88 }, {  8370, 240, 100, 88 }, {  8600, 240, 100, 88 },
+  {  8600,  20,   0, 89 }, {  8150,  20,   0, 89 }, {  7700,  20,   0, 89 }, {  7250,  20,   0, 89 },
+  {  6800,  20,   0, 89 }, {  6350,  20,   0, 89 }, {  5900,  20,   0, 89 }, {  5450,  20,   0, 89 },
+  {  5000,  20,   0, 89 }, {  4550,  20,   0, 89 }, {  4100,  20,   0, 89 }, {  3650,  20,   0, 89 },
+  {  3100,  55,  18, 90 }, {  3133,  58,  19, 90 }, {  3136,  59,  20, 90 }, {  3105,  59,  18, 90 },
+  {  3069,  56,  19, 90 }, {  3061,  53,  20, 90 }, {  3088,  50,  18, 90 }, {  3126,  50,  19, 90 },
+  {  3139,  51,  20, 90 }, {  3116,  55,  18, 90 }, {  3078,  58,  19, 90 }, {  3060,  59,  20, 90 },
+};
+
+static constexpr uint16_t LOOP_TRACE_LENGTH = (uint16_t)_countof(LOOP_TRACE);
+
+static inline loop_trace_sample_t getTraceSample(uint16_t index) {
+  loop_trace_sample_t sample;
+#if defined(PROGMEM)
+  memcpy_P(&sample, &LOOP_TRACE[index], sizeof(sample));
+#else
+  sample = LOOP_TRACE[index];
+#endif
+  return sample;
+}
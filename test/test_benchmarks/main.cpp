@@ -0,0 +1,24 @@
+#include "../test_harness_device.h"
+#include "../test_harness_native.h"
+
+
+void runAllBenchmarks(void)
+{
+    extern void benchLoopPipeline(void);
+    extern void benchScheduleJitter(void);
+    extern void benchCrankMaths(void);
+    extern void benchTriggerIsr(void);
+    extern void benchDecoderCost(void);
+    extern void benchTable3d(void);
+    extern void benchTable2d(void);
+
+    benchLoopPipeline();
+    benchScheduleJitter();
+    benchCrankMaths();
+    benchTriggerIsr();
+    benchDecoderCost();
+    benchTable3d();
+    benchTable2d();
+}
+
+TEST_HARNESS(runAllBenchmarks)
@@ -1,5 +1,6 @@
 #include "decoder_init.h"
 #include "globals.h"
+#include "crankMaths.h"
 #include "../test_utils.h"
 #include "decoder_name.h"
 #include "shared.h"
@@ -84,6 +85,7 @@ static void test_getRpm_coverage(uint8_t decoderNum)
     auto decoder = buildDecoder(decoderNum);
 
     currentStatus.revolutionTime = 3333;
+    setAngleConverterRevolutionTime(currentStatus.revolutionTime); // As SetRevolutionTime() does
     currentStatus.crankRPM = 400;
     currentStatus.setRpm(currentStatus.crankRPM*3U);
     decoderStatus.syncStatus = SyncStatus::Full; 
@@ -67,6 +67,62 @@ static void test_isTriggered(void)
   TEST_ASSERT_TRUE(subject.isTriggered());
 }
 
+static void test_isr_timing_record(void)
+{
+  isr_timing_t timing;
+  TEST_ASSERT_EQUAL(0U, timing.mean());
+
+  timing.record(10U);
+  timing.record(30U);
+  timing.record(20U);
+
+  TEST_ASSERT_EQUAL(30U, timing.maximum);
+  TEST_ASSERT_EQUAL(3U, timing.count);
+  TEST_ASSERT_EQUAL(20U, timing.mean());
+
+  timing.reset();
+  TEST_ASSERT_EQUAL(0U, timing.maximum);
+  TEST_ASSERT_EQUAL(0U, timing.count);
+  TEST_ASSERT_EQUAL(0U, timing.mean());
+}
+
+static void test_isr_timing_ageing(void)
+{
+  isr_timing_t timing;
+  timing.count = UINT16_MAX;
+  timing.total = (uint32_t)UINT16_MAX * 10U;
+
+  timing.record(10U);
+
+  // Halved then incremented: no overflow & the mean is preserved
+  TEST_ASSERT_EQUAL((UINT16_MAX/2U)+1U, timing.count);
+  TEST_ASSERT_EQUAL(10U, timing.mean());
+}
+
+static void test_serialiseIsrProfile(void)
+{
+  uint8_t buffer[32];
+  decoder_t decoder = {};
+
+  TEST_ASSERT_EQUAL(0U, serialiseIsrProfile(decoder, buffer, 0U));
+
+  uint16_t length = serialiseIsrProfile(decoder, buffer, sizeof(buffer));
+#if defined(ISR_PROFILER)
+  decoder.secondary.timing.record(25U);
+  length = serialiseIsrProfile(decoder, buffer, sizeof(buffer));
+  TEST_ASSERT_EQUAL(3U, buffer[0]);
+  TEST_ASSERT_EQUAL(1U + (3U * 3U * 2U), length);
+  TEST_ASSERT_EQUAL(25U, buffer[7]); // Secondary max
+  TEST_ASSERT_EQUAL(25U, buffer[9]); // Secondary mean
+  TEST_ASSERT_EQUAL(1U, buffer[11]); // Secondary count
+
+  resetIsrProfile(decoder);
+  TEST_ASSERT_EQUAL(0U, decoder.secondary.timing.count);
+#else
+  TEST_ASSERT_EQUAL(0U, buffer[0]);
+  TEST_ASSERT_EQUAL(1U, length);
+#endif
+}
 
 void testinterrupt_t()
 {
@@ -74,5 +130,8 @@ void testinterrupt_t()
     RUN_TEST_P(test_attach_return);
     RUN_TEST_P(test_isValid);
     RUN_TEST_P(test_isTriggered);
+    RUN_TEST_P(test_isr_timing_record);
+    RUN_TEST_P(test_isr_timing_ageing);
+    RUN_TEST_P(test_serialiseIsrProfile);
   }
 }
\ No newline at end of file
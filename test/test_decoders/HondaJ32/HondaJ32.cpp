@@ -42,9 +42,24 @@ static void test_getCrankAngle(void)
   run_case(1, 15 + 18 + 10, 10);
 }
 
+static void test_getRPM_before_first_revolution(void)
+{
+  extern decoder_status_t decoderStatus;
+
+  // A stale RPM from an earlier run, E.g. before a stall
+  setAngleConverterRevolutionTime(20000);
+  auto decoder = triggerSetup_HondaJ32();
+  // Sync is gained part way through the first revolution, before its time is known
+  decoderStatus.syncStatus = SyncStatus::Full;
+  currentStatus.revolutionTime = 0;
+
+  TEST_ASSERT_EQUAL_UINT16(0U, decoder.getRPM());
+}
+
 void testHondaJ32(void)
 {
   SET_UNITY_FILENAME() {
     RUN_TEST_P(test_getCrankAngle);
+    RUN_TEST_P(test_getRPM_before_first_revolution);
   }
 }
\ No newline at end of file
@@ -37,6 +37,8 @@ void runAllTests(void)
     extern void testHarley(void);
     extern void testHondaD17(void);
     extern void testNon360(void);
+    extern void testToothTable(void);
+    extern void testDecoderAccuracy(void);
 
     testMissingTooth();
     testDualWheel();
@@ -63,6 +65,8 @@ void runAllTests(void)
     testHarley();
     testHondaD17();
     testNon360();
+    testToothTable();
+    testDecoderAccuracy();
 }
 
 TEST_HARNESS(runAllTests)
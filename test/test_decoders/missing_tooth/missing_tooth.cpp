@@ -4,6 +4,8 @@
 #include "scheduler.h"
 #include "../../test_utils.h"
 #include "scheduler_ignition_controller.h"
+#include "src/decoders/decoder_shared.h"
+
 
 static decoder_t test_setup_36_1()
 {
@@ -144,7 +146,6 @@ static void test_getCrankAngle(void)
 {
     extern decoder_status_t decoderStatus;
     extern volatile unsigned long toothLastToothTime;
-    extern volatile int toothCurrentCount;
     extern volatile bool revolutionOne;
 
     decoder_t decoder = test_setup_36_1();
@@ -157,6 +158,7 @@ static void test_getCrankAngle(void)
         decoderStatus.toothAngleIsCorrect = true;
         configPage4.triggerAngle = trigAngle;
         setAngleConverterRevolutionTime(2000);
+        publishToothEvent();
         int16_t angle = decoder.pGetCrankAngle(toothLastToothTime + delta);
         TEST_ASSERT_EQUAL(expected, angle);
     };
@@ -180,11 +182,72 @@ static void test_getCrankAngle(void)
     run_case(1, true, 100, 0, 360 + 0 + dt);
 }
 
+static void test_getCrankAngle_publishedTooth(void)
+{
+    extern volatile unsigned long toothLastToothTime;
+    extern volatile bool revolutionOne;
+
+    decoder_t decoder = test_setup_36_1();
+    configPage4.triggerAngle = 0;
+    setAngleConverterRevolutionTime(3600);
+
+    // Nothing published yet: the live decoder state is used
+    toothLastToothTime = 2000;
+    toothCurrentCount = 5;
+    revolutionOne = false;
+    TEST_ASSERT_EQUAL(40, decoder.pGetCrankAngle(toothLastToothTime));
+
+    // Once published, only the published state is used
+    publishToothEvent();
+    toothLastToothTime = 4000;
+    toothCurrentCount = 9;
+    revolutionOne = true;
+    TEST_ASSERT_EQUAL(40, decoder.pGetCrankAngle(2000));
+    publishToothEvent();
+    TEST_ASSERT_EQUAL(440, decoder.pGetCrankAngle(4000));
+
+    // Reset discards the published state
+    decoder.reset();
+    toothLastToothTime = 2000;
+    toothCurrentCount = 5;
+    revolutionOne = false;
+    TEST_ASSERT_EQUAL(40, decoder.pGetCrankAngle(toothLastToothTime));
+}
+
+static void test_getCrankAngle_secondaryPublishes(void)
+{
+    extern volatile unsigned long toothLastToothTime;
+    extern volatile unsigned long toothLastSecToothTime;
+    extern volatile unsigned long triggerSecFilterTime;
+    extern volatile bool revolutionOne;
+    extern void triggerSec_missingTooth(void);
+
+    decoder_t decoder = test_setup_36_1();
+    configPage4.triggerAngle = 0;
+    configPage6.vvtEnabled = 0;
+    setAngleConverterRevolutionTime(3600);
+
+    toothLastToothTime = 2000;
+    toothCurrentCount = 5;
+    revolutionOne = false;
+    publishToothEvent();
+    TEST_ASSERT_EQUAL(40, decoder.pGetCrankAngle(toothLastToothTime));
+
+    // The cam tooth resets revolutionOne: that must be visible before the next crank tooth
+    toothLastSecToothTime = 0;
+    triggerSecFilterTime = 0;
+    triggerSec_missingTooth();
+    TEST_ASSERT_TRUE(revolutionOne);
+    TEST_ASSERT_EQUAL(400, decoder.pGetCrankAngle(toothLastToothTime));
+}
+
 void testMissingTooth()
 {
     SET_UNITY_FILENAME() {
         RUN_TEST_P(test_missingtooth_newIgn_36_1);
         RUN_TEST_P(test_missingtooth_newIgn_60_2);
         RUN_TEST_P(test_getCrankAngle);
+        RUN_TEST_P(test_getCrankAngle_publishedTooth);
+        RUN_TEST_P(test_getCrankAngle_secondaryPublishes);
     }
 }
\ No newline at end of file
@@ -0,0 +1,274 @@
+#include <decoders.h>
+#include <globals.h>
+#include <unity.h>
+#include "../../test_utils.h"
+#include "../../decoder_simulator.h"
+
+#if defined(NATIVE_BOARD)
+
+static decoder_t setup_missingTooth(uint8_t teeth, uint8_t missingTeeth)
+{
+    setSimulatorConfig();
+    configPage4.triggerTeeth = teeth;
+    configPage4.triggerMissingTeeth = missingTeeth;
+    return triggerSetup_missingTooth();
+}
+
+static decoder_t setup_dualWheel(uint8_t teeth)
+{
+    setSimulatorConfig();
+    configPage4.triggerTeeth = teeth;
+    return triggerSetup_DualWheel();
+}
+
+// A 36-1 wheel
+static trigger_pattern_t setup_toothTable_36_1(void)
+{
+    setSimulatorConfig();
+    return setToothTableWheel(36U, { 35U });
+}
+
+// 2 long gaps (before 180° & 340°), only told apart by the gap after them
+static trigger_pattern_t setup_toothTable_two_gap(void)
+{
+    setSimulatorConfig();
+    return setToothTableWheel(36U, { 17U, 33U, 35U });
+}
+
+static decoder_accuracy_report_t simulate(const char *name, const decoder_t &decoder, const trigger_pattern_t &pattern, const engine_profile_t &profile)
+{
+    decoder_accuracy_report_t report;
+    runDecoderSimulation(decoder, pattern, profile, report);
+    reportDecoderAccuracy(name, report);
+    return report;
+}
+
+static void assert_error_within(float limit, const sim_error_stats_t &stats)
+{
+    TEST_ASSERT_GREATER_THAN_UINT32(0U, stats.count);
+    TEST_ASSERT_FLOAT_WITHIN(limit, 0.0f, (float)stats.minimum);
+    TEST_ASSERT_FLOAT_WITHIN(limit, 0.0f, (float)stats.maximum);
+}
+
+// Steady speed, clean signal: the only error is the integer degree resolution of getCrankAngle()
+static constexpr engine_profile_t STEADY_3000 = { 3000U, 3000U, 0U, 20U, 0U, 0U, 1234U };
+// 10000 rpm/s, then steady
+static constexpr engine_profile_t ACCELERATING = { 1000U, 6000U, 500000U, 60U, 0U, 0U, 1234U };
+static constexpr engine_profile_t DECELERATING = { 6000U, 1000U, 500000U, 40U, 0U, 0U, 1234U };
+
+static void test_accuracy_missingTooth_36_1_steady(void)
+{
+    auto report = simulate("36-1 steady", setup_missingTooth(36, 1), missingToothPattern(36, 1), STEADY_3000);
+
+    assert_error_within(1.0f, report.angle);
+    assert_error_within(1.0f, report.rpm);
+    TEST_ASSERT_EQUAL_UINT16(0U, report.syncLosses);
+}
+
+static void test_accuracy_missingTooth_60_2_steady(void)
+{
+    engine_profile_t profile = STEADY_3000;
+    profile.startRpm = profile.endRpm = 6000U;
+    auto report = simulate("60-2 steady", setup_missingTooth(60, 2), missingToothPattern(60, 2), profile);
+
+    assert_error_within(1.0f, report.angle);
+    assert_error_within(1.0f, report.rpm);
+    TEST_ASSERT_EQUAL_UINT16(0U, report.syncLosses);
+}
+
+static void test_accuracy_missingTooth_36_1_accelerating(void)
+{
+    auto report = simulate("36-1 accelerating", setup_missingTooth(36, 1), missingToothPattern(36, 1), ACCELERATING);
+
+    // The acceleration model keeps the angle tight...
+    assert_error_within(2.0f, report.angle);
+    // ...but RPM is the average over the last revolution, so lags
+    TEST_ASSERT_FLOAT_WITHIN(1.0f, 0.0f, (float)report.rpm.maximum);
+    TEST_ASSERT_LESS_THAN_FLOAT(-100.0f, (float)report.rpm.minimum);
+    TEST_ASSERT_GREATER_THAN_FLOAT(-500.0f, (float)report.rpm.minimum);
+}
+
+static void test_accuracy_missingTooth_36_1_decelerating(void)
+{
+    auto report = simulate("36-1 decelerating", setup_missingTooth(36, 1), missingToothPattern(36, 1), DECELERATING);
+
+    // Never worse than one tooth
+    assert_error_within(10.0f, report.angle);
+    TEST_ASSERT_FLOAT_WITHIN(1.0f, 0.0f, (float)report.rpm.minimum);
+    TEST_ASSERT_LESS_THAN_FLOAT(750.0f, (float)report.rpm.maximum);
+}
+
+static void test_accuracy_missingTooth_36_1_noise(void)
+{
+    engine_profile_t profile = STEADY_3000;
+    profile.noiseMicros = 20U;
+    auto report = simulate("36-1 20uS noise", setup_missingTooth(36, 1), missingToothPattern(36, 1), profile);
+
+    assert_error_within(5.0f, report.angle);
+    assert_error_within(10.0f, report.rpm);
+    TEST_ASSERT_EQUAL_UINT16(0U, report.syncLosses);
+}
+
+static void test_accuracy_missingTooth_36_1_dropped_tooth(void)
+{
+    engine_profile_t profile = STEADY_3000;
+    profile.dropEdgeEvery = 100U;
+    auto report = simulate("36-1 dropped tooth", setup_missingTooth(36, 1), missingToothPattern(36, 1), profile);
+
+    // A dropped tooth looks like an early missing tooth: the decoder must notice
+    TEST_ASSERT_GREATER_THAN_UINT16(0U, report.syncLosses);
+    TEST_ASSERT_GREATER_THAN_UINT32(0U, report.unsyncedSamples);
+}
+
+static void test_accuracy_missingTooth_36_1_cam(void)
+{
+    setSimulatorConfig();
+    configPage4.sparkMode = IGN_MODE_SEQUENTIAL;
+    configPage4.triggerTeeth = 36;
+    configPage4.triggerMissingTeeth = 1;
+    auto decoder = triggerSetup_missingTooth();
+    // Cam tooth just before tooth #1: the decoder must resolve the full 720° cycle
+    auto report = simulate("36-1 + cam", decoder, missingToothPattern(36, 1, 710), STEADY_3000);
+
+    assert_error_within(1.0f, report.angle);
+    TEST_ASSERT_EQUAL_UINT32(STEADY_3000.cycles, report.secondaryEdges);
+}
+
+static void test_accuracy_dualWheel_24_steady(void)
+{
+    auto report = simulate("Dual wheel 24 steady", setup_dualWheel(24), dualWheelPattern(24, 710), STEADY_3000);
+
+    assert_error_within(1.0f, report.angle);
+    assert_error_within(1.0f, report.rpm);
+    TEST_ASSERT_EQUAL_UINT16(0U, report.syncLosses);
+}
+
+static void test_accuracy_dualWheel_24_accelerating(void)
+{
+    auto report = simulate("Dual wheel 24 accelerating", setup_dualWheel(24), dualWheelPattern(24, 710), ACCELERATING);
+
+    assert_error_within(2.0f, report.angle);
+    TEST_ASSERT_GREATER_THAN_FLOAT(-500.0f, (float)report.rpm.minimum);
+}
+
+static void test_accuracy_triggerAngle_offset(void)
+{
+    decoder_t decoder = setup_missingTooth(36, 1);
+    configPage4.triggerAngle = 90;
+    auto report = simulate("36-1 triggerAngle 90", decoder, missingToothPattern(36, 1), STEADY_3000);
+
+    assert_error_within(1.0f, report.angle);
+}
+
+static void test_accuracy_toothTable_36_1_steady(void)
+{
+    trigger_pattern_t pattern = setup_toothTable_36_1();
+    auto report = simulate("Tooth table 36-1 steady", triggerSetup_toothTable(), pattern, STEADY_3000);
+
+    assert_error_within(1.0f, report.angle);
+    assert_error_within(1.0f, report.rpm);
+    TEST_ASSERT_EQUAL_UINT16(0U, report.syncLosses);
+}
+
+static void test_accuracy_toothTable_two_gap_accelerating(void)
+{
+    trigger_pattern_t pattern = setup_toothTable_two_gap();
+    auto report = simulate("Tooth table two gap accelerating", triggerSetup_toothTable(), pattern, ACCELERATING);
+
+    // No acceleration model: the angle error grows with the gap since the last tooth
+    assert_error_within(5.0f, report.angle);
+    TEST_ASSERT_EQUAL_UINT16(0U, report.syncLosses);
+}
+
+static void test_accuracy_toothTable_dropped_tooth(void)
+{
+    engine_profile_t profile = STEADY_3000;
+    profile.dropEdgeEvery = 100U;
+    trigger_pattern_t pattern = setup_toothTable_36_1();
+    auto report = simulate("Tooth table dropped tooth", triggerSetup_toothTable(), pattern, profile);
+
+    // A dropped tooth is a long gap where one isn't expected
+    TEST_ASSERT_GREATER_THAN_UINT16(0U, report.syncLosses);
+    TEST_ASSERT_GREATER_THAN_UINT32(0U, report.unsyncedSamples);
+}
+
+static void test_accuracy_4g63_pin_levels(void)
+{
+    setSimulatorConfig();
+    configPage2.nCylinders = 4;
+    configPage4.sparkMode = IGN_MODE_SEQUENTIAL;
+    auto decoder = triggerSetup_4G63();
+    // Sync comes from the cam level at each crank edge, not from edge timing
+    static constexpr uint16_t ANGLES[] = { 105, 175, 285, 355, 465, 535, 645, 715 };
+    trigger_pattern_t pattern = toothAnglePattern(ANGLES, _countof(ANGLES), 720U);
+    setAlternatingEdges(pattern.primaryEdge, pattern.primaryCount);
+    static constexpr uint16_t CAM_ANGLES[] = { 230, 400, 600, 690 };
+    for (uint16_t angle : CAM_ANGLES) { pattern.secondary[pattern.secondaryCount++] = angle; }
+    setAlternatingEdges(pattern.secondaryEdge, pattern.secondaryCount);
+    auto report = simulate("4G63 steady", decoder, pattern, STEADY_3000);
+
+    assert_error_within(1.0f, report.angle);
+    TEST_ASSERT_EQUAL_UINT16(0U, report.syncLosses);
+    // Only the falling cam edges fire the FALLING cam interrupt
+    TEST_ASSERT_EQUAL_UINT32(STEADY_3000.cycles * 2U, report.secondaryEdges);
+    TEST_ASSERT_EQUAL_UINT32(STEADY_3000.cycles * _countof(ANGLES), report.primaryEdges);
+}
+
+static void test_accuracy_roverMems_17_17(void)
+{
+    setSimulatorConfig();
+    configPage4.sparkMode = IGN_MODE_SEQUENTIAL;
+    auto decoder = triggerSetup_RoverMEMS();
+    decoder.reset();
+    // 36 slots: 17 teeth, gap, 17 teeth, gap. Identified by matching the last 32 teeth & gaps
+    uint16_t angles[34];
+    uint16_t teeth = 0U;
+    for (uint16_t slot=0U; slot<36U; ++slot) {
+        if ((slot!=17U) && (slot!=35U)) { angles[teeth++] = slot * 10U; }
+    }
+    trigger_pattern_t pattern = toothAnglePattern(angles, teeth, 360U);
+    pattern.secondary[0] = 100U;
+    pattern.secondaryCount = 1U;
+    pattern.cycleDegrees = 720U;
+    auto report = simulate("Rover MEMS 17-17 + cam", decoder, pattern, STEADY_3000);
+
+    // Synced within the first 2 cycles (there is one sample per edge) & kept it
+    TEST_ASSERT_LESS_THAN_UINT32(2U * ((teeth * 2U) + 1U), report.unsyncedSamples);
+    // Tooth #1 isn't at slot 0, so only check the angle error is steady
+    TEST_ASSERT_GREATER_THAN_UINT32(0U, report.angle.count);
+    TEST_ASSERT_FLOAT_WITHIN(2.0f, (float)report.angle.minimum, (float)report.angle.maximum);
+}
+
+#else
+
+static void test_accuracy_not_applicable(void)
+{
+    TEST_IGNORE_MESSAGE("Decoder simulation needs a fake micros(): native only");
+}
+
+#endif
+
+void testDecoderAccuracy(void)
+{
+  SET_UNITY_FILENAME() {
+#if defined(NATIVE_BOARD)
+    RUN_TEST_P(test_accuracy_missingTooth_36_1_steady);
+    RUN_TEST_P(test_accuracy_missingTooth_60_2_steady);
+    RUN_TEST_P(test_accuracy_missingTooth_36_1_accelerating);
+    RUN_TEST_P(test_accuracy_missingTooth_36_1_decelerating);
+    RUN_TEST_P(test_accuracy_missingTooth_36_1_noise);
+    RUN_TEST_P(test_accuracy_missingTooth_36_1_dropped_tooth);
+    RUN_TEST_P(test_accuracy_missingTooth_36_1_cam);
+    RUN_TEST_P(test_accuracy_dualWheel_24_steady);
+    RUN_TEST_P(test_accuracy_dualWheel_24_accelerating);
+    RUN_TEST_P(test_accuracy_triggerAngle_offset);
+    RUN_TEST_P(test_accuracy_toothTable_36_1_steady);
+    RUN_TEST_P(test_accuracy_toothTable_two_gap_accelerating);
+    RUN_TEST_P(test_accuracy_toothTable_dropped_tooth);
+    RUN_TEST_P(test_accuracy_4g63_pin_levels);
+    RUN_TEST_P(test_accuracy_roverMems_17_17);
+#else
+    RUN_TEST_P(test_accuracy_not_applicable);
+#endif
+  }
+}
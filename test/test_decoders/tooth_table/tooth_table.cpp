@@ -0,0 +1,180 @@
+#include "decoders.h"
+#include "crankMaths.h"
+#include "../../test_utils.h"
+#include "globals.h"
+#include "decoder_t.h"
+#include <initializer_list>
+#include "src/decoders/decoder_shared.h"
+
+extern bool compileToothTable(const trigger_wheel_t &wheel);
+extern uint8_t classifyToothGap(uint32_t gap, uint32_t previousGap);
+extern volatile uint16_t triggerToothAngle;
+
+static uint8_t wheelTeeth[TOOTH_TABLE_MAX_SLOTS/8U];
+
+static trigger_wheel_t makeWheel(uint8_t slots, std::initializer_list<uint8_t> emptySlots, uint16_t cycleDegrees = 360U)
+{
+  memset(wheelTeeth, 0xFF, sizeof(wheelTeeth));
+  for (uint8_t slot : emptySlots) { BIT_CLEAR(wheelTeeth[slot / 8U], slot % 8U); }
+  return { wheelTeeth, slots, cycleDegrees };
+}
+
+// 36 positions at 10°, with 17, 33 & 35 empty: the gaps before 180° & 340° are both long,
+// so sync needs the (same length) gap after 340° as well.
+static trigger_wheel_t twoGapWheel(void)
+{
+  return makeWheel(36U, { 17U, 33U, 35U });
+}
+
+static void setTuneWheel(const trigger_wheel_t &wheel)
+{
+  configPage15.toothTableSlots = wheel.slotCount;
+  memcpy(configPage15.toothTableTeeth, wheel.teeth, sizeof(configPage15.toothTableTeeth));
+}
+
+static void test_classifyToothGap(void)
+{
+  TEST_ASSERT_EQUAL_UINT8(0U, classifyToothGap(1000U, 1000U));
+  TEST_ASSERT_EQUAL_UINT8(0U, classifyToothGap(1400U, 1000U));
+  TEST_ASSERT_EQUAL_UINT8(0U, classifyToothGap(700U, 1000U));
+  TEST_ASSERT_EQUAL_UINT8(1U, classifyToothGap(500U, 1000U));
+  TEST_ASSERT_EQUAL_UINT8(2U, classifyToothGap(2000U, 1000U));
+  TEST_ASSERT_EQUAL_UINT8(3U, classifyToothGap(3000U, 1000U));
+}
+
+static void test_compile_missingTooth(void)
+{
+  TEST_ASSERT_TRUE(compileToothTable(makeWheel(36U, { 35U })));
+  TEST_ASSERT_TRUE(compileToothTable(makeWheel(60U, { 58U, 59U })));
+  TEST_ASSERT_TRUE(compileToothTable(makeWheel(12U, { 11U })));
+  TEST_ASSERT_TRUE(compileToothTable(makeWheel(4U, { 3U })));
+  TEST_ASSERT_TRUE(compileToothTable(makeWheel(36U, { 35U }, 720U)));
+}
+
+static void test_compile_two_gaps(void)
+{
+  TEST_ASSERT_TRUE(compileToothTable(twoGapWheel()));
+}
+
+static void test_compile_no_sync_signature(void)
+{
+  // Evenly spaced: every tooth looks the same
+  TEST_ASSERT_FALSE(compileToothTable(makeWheel(36U, {})));
+
+  // 2 identical gaps, half a revolution apart
+  TEST_ASSERT_FALSE(compileToothTable(makeWheel(36U, { 17U, 35U })));
+}
+
+static void test_compile_ambiguous_gap(void)
+{
+  // 24 positions, with a tooth on every other one apart from the last 2: the 45° gaps after the 30° ones
+  // are right on the long gap threshold
+  TEST_ASSERT_FALSE(compileToothTable(makeWheel(24U, { 1U, 3U, 5U, 7U, 9U, 11U, 13U, 15U, 17U, 19U, 20U, 22U, 23U })));
+}
+
+static void test_compile_malformed(void)
+{
+  TEST_ASSERT_FALSE(compileToothTable(makeWheel(1U, {})));
+  TEST_ASSERT_FALSE(compileToothTable(makeWheel(TOOTH_TABLE_MAX_SLOTS+1U, { 0U })));
+  // Positions must be a whole number of degrees apart
+  TEST_ASSERT_FALSE(compileToothTable(makeWheel(7U, { 6U })));
+  // Too few teeth
+  TEST_ASSERT_FALSE(compileToothTable(makeWheel(4U, { 1U, 2U, 3U })));
+
+  trigger_wheel_t wheel = makeWheel(36U, { 35U });
+  wheel.teeth = nullptr;
+  TEST_ASSERT_FALSE(compileToothTable(wheel));
+}
+
+static void test_setup_from_tune(void)
+{
+  configPage4.TrigSpeed = CRANK_SPEED;
+  setTuneWheel(makeWheel(36U, { 35U }));
+  decoder_t decoder = triggerSetup_toothTable();
+  TEST_ASSERT_NOT_EQUAL(TRIGGER_EDGE_NONE, decoder.primary.edge);
+  TEST_ASSERT_EQUAL_UINT16(10U, triggerToothAngle);
+
+  // 36 positions over 720° is 20° apart
+  configPage4.TrigSpeed = CAM_SPEED;
+  decoder = triggerSetup_toothTable();
+  TEST_ASSERT_NOT_EQUAL(TRIGGER_EDGE_NONE, decoder.primary.edge);
+  TEST_ASSERT_EQUAL_UINT16(20U, triggerToothAngle);
+  configPage4.TrigSpeed = CRANK_SPEED;
+}
+
+static void assert_never_syncs(decoder_t &decoder)
+{
+  // Still attached, so the tooth logger can show the wheel
+  TEST_ASSERT_NOT_EQUAL(TRIGGER_EDGE_NONE, decoder.primary.edge);
+  for (uint8_t tooth=0U; tooth<100U; ++tooth)
+  {
+    decoder.primary.callback();
+    TEST_ASSERT_TRUE(decoder.getStatus().syncStatus==SyncStatus::None);
+  }
+}
+
+static void test_setup_invalid_wheel(void)
+{
+  setTuneWheel(makeWheel(36U, {}));
+  decoder_t decoder = triggerSetup_toothTable();
+  assert_never_syncs(decoder);
+
+  // An unconfigured tune
+  configPage15.toothTableSlots = 0U;
+  decoder = triggerSetup_toothTable();
+  assert_never_syncs(decoder);
+}
+
+static void test_getCrankAngle(void)
+{
+  extern decoder_status_t decoderStatus;
+  extern volatile unsigned long toothLastToothTime;
+  extern uint16_t toothCurrentCount;
+  extern volatile bool revolutionOne;
+
+  configPage4.TrigSpeed = CRANK_SPEED;
+  setTuneWheel(twoGapWheel());
+  auto decoder = triggerSetup_toothTable();
+
+  auto run_case = [&](uint8_t toothNum, int16_t expected, bool revOne=false, int trigAngle=0) {
+    toothLastToothTime = 2000;
+    toothCurrentCount = toothNum;
+    decoderStatus.toothAngleIsCorrect = true;
+    revolutionOne = revOne;
+    configPage4.triggerAngle = trigAngle;
+    setAngleConverterRevolutionTime(2000);
+    publishToothEvent();
+    TEST_ASSERT_EQUAL(expected, decoder.pGetCrankAngle(toothLastToothTime + 100));
+  };
+
+  // timeToAngle(100) ~= 18 deg with revolutionTime 2000
+  const int dt_add = 18;
+
+  // The tooth number is the wheel position + 1
+  run_case(1, 0 + dt_add);
+  run_case(17, 160 + dt_add);
+  run_case(19, 180 + dt_add);   // After the first gap
+  run_case(33, 320 + dt_add);
+  run_case(35, 340 + dt_add);   // After the second gap
+
+  // Second revolution
+  run_case(19, 180 + dt_add + 360, true);
+
+  // trigger angle offset
+  run_case(19, 180 + dt_add + 10, false, 10);
+}
+
+void testToothTable(void)
+{
+  SET_UNITY_FILENAME() {
+    RUN_TEST_P(test_classifyToothGap);
+    RUN_TEST_P(test_compile_missingTooth);
+    RUN_TEST_P(test_compile_two_gaps);
+    RUN_TEST_P(test_compile_no_sync_signature);
+    RUN_TEST_P(test_compile_ambiguous_gap);
+    RUN_TEST_P(test_compile_malformed);
+    RUN_TEST_P(test_setup_from_tune);
+    RUN_TEST_P(test_setup_invalid_wheel);
+    RUN_TEST_P(test_getCrankAngle);
+  }
+}
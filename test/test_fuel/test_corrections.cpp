@@ -1492,6 +1492,27 @@ static void setup_afrtarget(table3d16RpmLoad &afrLookUpTable,
   current.O2 = 75U;
 }
 
+// As the main loop: the table is only looked up if calculateAfrTarget() will use the value
+static uint8_t calculateAfrTarget(const table3d16RpmLoad &afrLookUpTable, const statuses &current, const config2 &page2, const config6 &page6) {
+  uint8_t afrTableValue = isAfrTargetTableUsed(page2, page6) ? get3DTableValue(&afrLookUpTable, current.fuelLoad, current.RPM) : 0U;
+  return calculateAfrTarget(afrTableValue, current, page2, page6);
+}
+
+static void test_corrections_afrtarget_table_used(void) {
+  config2 page2 = {};
+  config6 page6 = {};
+
+  page2.incorporateAFR = false;
+  page6.egoType = EGO_TYPE_OFF;
+  TEST_ASSERT_FALSE(isAfrTargetTableUsed(page2, page6));
+
+  page6.egoType = EGO_TYPE_WIDE;
+  TEST_ASSERT_TRUE(isAfrTargetTableUsed(page2, page6));
+
+  page2.incorporateAFR = true;
+  page6.egoType = EGO_TYPE_OFF;
+  TEST_ASSERT_TRUE(isAfrTargetTableUsed(page2, page6));
+}
 
 static void test_corrections_afrtarget_no_compute(void) {
   table3d16RpmLoad afrLookUpTable;
@@ -1548,6 +1569,7 @@ static void test_corrections_afrtarget_ego(void) {
 }
 
 static void test_corrections_afrtarget(void) {
+  RUN_TEST_P(test_corrections_afrtarget_table_used);
   RUN_TEST_P(test_corrections_afrtarget_no_compute);
   RUN_TEST_P(test_corrections_afrtarget_no_compute_egodelay);
   RUN_TEST_P(test_corrections_afrtarget_incorporteafr);
@@ -5,12 +5,11 @@
 #include "statuses.h"
 #include "globals.h"
 
-extern pulseWidths calculateSecondaryPw(uint16_t primaryPw, uint16_t pwLimit, uint16_t injOpenTime, const config2 &page2, const config10 &page10, const statuses &current);
+extern pulseWidths calculateSecondaryPw(uint16_t primaryPw, uint16_t pwLimit, uint16_t injOpenTime, uint8_t stagingSplit, const config2 &page2, const config10 &page10);
 
 struct testContext {
     config2 page2;
     config10 page10;
-    statuses current;
 };
 
 static testContext getStageContext(uint8_t mode) {
@@ -35,7 +34,7 @@ static void test_calculateSecondaryPw_disabled(void) {
     uint16_t injOpenTime = 1000;
     context.page10.stagingEnabled = false;
    
-    auto result = calculateSecondaryPw(primaryPw, pwLimit, injOpenTime, context.page2, context.page10, context.current);
+    auto result = calculateSecondaryPw(primaryPw, pwLimit, injOpenTime, 0U, context.page2, context.page10);
     
     TEST_ASSERT_EQUAL(primaryPw, result.primary);
     TEST_ASSERT_EQUAL(0, result.secondary);
@@ -49,7 +48,7 @@ static void test_calculateSecondaryPw_noprimary(void) {
     uint16_t pwLimit = 25500;
     uint16_t injOpenTime = 100;
   
-    auto result = calculateSecondaryPw(primaryPw, pwLimit, injOpenTime, context.page2, context.page10, context.current);
+    auto result = calculateSecondaryPw(primaryPw, pwLimit, injOpenTime, 0U, context.page2, context.page10);
     
     TEST_ASSERT_EQUAL(primaryPw, result.primary);
     TEST_ASSERT_EQUAL(0, result.secondary);
@@ -64,7 +63,7 @@ static void test_calculateSecondaryPw_notenoughchannels(void) {
     uint16_t injOpenTime = 1000;
     context.page2.nCylinders = INJ_CHANNELS+1;
 
-    auto result = calculateSecondaryPw(primaryPw, pwLimit, injOpenTime, context.page2, context.page10, context.current);
+    auto result = calculateSecondaryPw(primaryPw, pwLimit, injOpenTime, 0U, context.page2, context.page10);
     
     TEST_ASSERT_EQUAL(primaryPw, result.primary);
     TEST_ASSERT_EQUAL(0, result.secondary);
@@ -80,7 +79,7 @@ static void test_calculateSecondaryPw_notenoughchannels_tbody(void) {
     context.page2.nCylinders = INJ_CHANNELS;
     context.page2.injType = INJ_TYPE_TBODY;
 
-    auto result = calculateSecondaryPw(primaryPw, pwLimit, injOpenTime, context.page2, context.page10, context.current);
+    auto result = calculateSecondaryPw(primaryPw, pwLimit, injOpenTime, 0U, context.page2, context.page10);
     
     TEST_ASSERT_EQUAL(primaryPw, result.primary);
     TEST_ASSERT_EQUAL(9000, result.secondary);
@@ -94,7 +93,7 @@ static void test_calculateSecondaryPw_auto_50pct(void) {
     uint16_t pwLimit = 9000;
     uint16_t injOpenTime = 1000;
   
-    auto result = calculateSecondaryPw(primaryPw, pwLimit, injOpenTime, context.page2, context.page10, context.current);
+    auto result = calculateSecondaryPw(primaryPw, pwLimit, injOpenTime, 0U, context.page2, context.page10);
     
     TEST_ASSERT_EQUAL(pwLimit, result.primary);
     TEST_ASSERT_EQUAL(9000, result.secondary);
@@ -108,7 +107,7 @@ static void test_calculateSecondaryPw_auto_33pct(void) {
     uint16_t pwLimit = 9000;
     uint16_t injOpenTime = 0;
   
-    auto result = calculateSecondaryPw(primaryPw, pwLimit, injOpenTime, context.page2, context.page10, context.current);
+    auto result = calculateSecondaryPw(primaryPw, pwLimit, injOpenTime, 0U, context.page2, context.page10);
     
     TEST_ASSERT_EQUAL(pwLimit, result.primary);
     TEST_ASSERT_EQUAL(6000, result.secondary);
@@ -122,7 +121,7 @@ static void test_calculateSecondaryPw_auto_inactive(void) {
     uint16_t pwLimit = 9000;
     uint16_t injOpenTime = 1000;
   
-    auto result = calculateSecondaryPw(primaryPw, pwLimit, injOpenTime, context.page2, context.page10, context.current);
+    auto result = calculateSecondaryPw(primaryPw, pwLimit, injOpenTime, 0U, context.page2, context.page10);
     
     TEST_ASSERT_EQUAL(7000, result.primary);
     TEST_ASSERT_EQUAL(0, result.secondary);
@@ -131,21 +130,24 @@ static void test_calculateSecondaryPw_auto_inactive(void) {
 static void test_calculateSecondaryPw_table(uint8_t split, uint16_t expectedPrimary, uint16_t expectedSecondary) {
   auto context = getStageContext(STAGING_MODE_TABLE);
 
-  context.current.fuelLoad = 50;  
-  context.current.setRpm( 3500U);
-
-  TEST_DATA_P table3d_axis_t xAxis[] = { 900U/100U, 1600U/100U, 2500U/100U, 3500U/100U, 4700U/100U, 5900U/100U, 6750U/100U, 7000U/100U};
-  TEST_DATA_P table3d_axis_t yAxis[] = { 16U/2U,  31U/2U,   43U/2U,   52U/2U,   63U/2U,   75U/2U,   81U/2U,   103U/2U };
-  populate_table_axis_P(stagingTable.axisX, xAxis);
-  populate_table_axis_P(stagingTable.axisY, yAxis);
-  fill_table_values(stagingTable, split);
-
-  auto result = calculateSecondaryPw(1500, 1501, 0, context.page2, context.page10, context.current);
+  auto result = calculateSecondaryPw(1500, 1501, 0, split, context.page2, context.page10);
   TEST_ASSERT_INT16_WITHIN(30, expectedPrimary, result.primary);
   TEST_ASSERT_INT16_WITHIN(30, expectedSecondary, result.secondary);
 }
 
 
+static void test_isStagingTableUsed(void) {
+  auto context = getStageContext(STAGING_MODE_TABLE);
+  TEST_ASSERT_TRUE(isStagingTableUsed(context.page2, context.page10));
+
+  context.page10.stagingMode = STAGING_MODE_AUTO;
+  TEST_ASSERT_FALSE(isStagingTableUsed(context.page2, context.page10));
+
+  context.page10.stagingMode = STAGING_MODE_TABLE;
+  context.page10.stagingEnabled = false;
+  TEST_ASSERT_FALSE(isStagingTableUsed(context.page2, context.page10));
+}
+
 static void test_calculateSecondaryPw_table_split0(void) {
   test_calculateSecondaryPw_table(0, 4500, 0);
 }
@@ -177,6 +179,7 @@ void testCalculateSecondaryPw(void) {
     RUN_TEST_P(test_calculateSecondaryPw_auto_50pct);
     RUN_TEST_P(test_calculateSecondaryPw_auto_33pct);
     RUN_TEST_P(test_calculateSecondaryPw_auto_inactive);
+    RUN_TEST_P(test_isStagingTableUsed);
     RUN_TEST_P(test_calculateSecondaryPw_table_split0);
     RUN_TEST_P(test_calculateSecondaryPw_table_split33);
     RUN_TEST_P(test_calculateSecondaryPw_table_split66);
@@ -11,7 +11,7 @@
 
 // Convenience function
 static pulseWidths computePulseWidths(ComputePulseWidthsContext &context) {
-  return computePulseWidths(context.page2, context.page6, context.page10, context.current);
+  return computePulseWidths(context.page2, context.page6, context.page10, context.current, 0U);
 }
 
 static ComputePulseWidthsContext getBasicFullContext(void) {
@@ -5,9 +5,11 @@ void runAllTests(void)
 {
     extern void testPinMapping(void);
     extern void testResetControl(void);
+    extern void testLoopProfiler(void);
 
     testPinMapping();
     testResetControl();
+    testLoopProfiler();
 }
 
 TEST_HARNESS(runAllTests)
@@ -0,0 +1,143 @@
+#include <unity.h>
+#include "../test_utils.h"
+#include "loop_profiler.h"
+
+static void test_loopProfileBucket(void)
+{
+  TEST_ASSERT_EQUAL(0U, loopProfileBucket(0U));
+  TEST_ASSERT_EQUAL(0U, loopProfileBucket(1U));
+  TEST_ASSERT_EQUAL(1U, loopProfileBucket(2U));
+  TEST_ASSERT_EQUAL(1U, loopProfileBucket(3U));
+  TEST_ASSERT_EQUAL(2U, loopProfileBucket(4U));
+  TEST_ASSERT_EQUAL(9U, loopProfileBucket(1000U));
+  TEST_ASSERT_EQUAL(LOOP_PROFILE_BUCKETS-1U, loopProfileBucket(UINT16_MAX));
+}
+
+static void test_loopSectionStats_minMax(void)
+{
+  loop_section_stats_t stats;
+  stats.reset();
+
+  stats.record(100U);
+  stats.record(50U);
+  stats.record(700U);
+
+  TEST_ASSERT_EQUAL(50U, stats.minimum);
+  TEST_ASSERT_EQUAL(700U, stats.maximum);
+  TEST_ASSERT_EQUAL(3U, stats.count);
+  TEST_ASSERT_EQUAL(1U, stats.buckets[loopProfileBucket(50U)]);
+  TEST_ASSERT_EQUAL(1U, stats.buckets[loopProfileBucket(100U)]);
+  TEST_ASSERT_EQUAL(1U, stats.buckets[loopProfileBucket(700U)]);
+}
+
+static void test_loopSectionStats_percentile(void)
+{
+  loop_section_stats_t stats;
+  stats.reset();
+  TEST_ASSERT_EQUAL(0U, stats.percentile(99U));
+
+  // 99 fast loops and one slow one
+  for (uint8_t index = 0U; index < 99U; ++index)
+  {
+    stats.record(300U);
+  }
+  stats.record(5000U);
+
+  // p99 falls in the 256-511 bucket
+  TEST_ASSERT_EQUAL(511U, stats.percentile(99U));
+  // p100 is the slow loop, clamped to the maximum seen
+  TEST_ASSERT_EQUAL(5000U, stats.percentile(100U));
+
+  // A 2nd slow loop pushes p99 into the slow bucket
+  stats.record(5000U);
+  TEST_ASSERT_EQUAL(5000U, stats.percentile(99U));
+}
+
+static void test_loopSectionStats_ageing(void)
+{
+  loop_section_stats_t stats;
+  stats.reset();
+  stats.buckets[loopProfileBucket(10U)] = UINT16_MAX;
+  stats.buckets[loopProfileBucket(1000U)] = 100U;
+  stats.count = UINT16_MAX;
+
+  stats.record(10U);
+
+  // Halved then incremented: no overflow & the distribution shape is preserved
+  TEST_ASSERT_EQUAL((UINT16_MAX/2U)+1U, stats.buckets[loopProfileBucket(10U)]);
+  TEST_ASSERT_EQUAL(50U, stats.buckets[loopProfileBucket(1000U)]);
+  TEST_ASSERT_EQUAL((UINT16_MAX/2U)+1U, stats.count);
+}
+
+static void test_serialiseLoopProfile(void)
+{
+  uint8_t buffer[512];
+
+  TEST_ASSERT_EQUAL(0U, serialiseLoopProfile(buffer, LOOP_PROFILE_HEADER_SIZE + LOOP_PROFILE_SECTION_SIZE - 1U, 0U));
+
+  uint16_t length = serialiseLoopProfile(buffer, sizeof(buffer), 0U);
+#if defined(LOOP_PROFILER)
+  TEST_ASSERT_EQUAL(LOOP_SECTION_COUNT, buffer[0]);
+  TEST_ASSERT_EQUAL(0U, buffer[2]);
+  TEST_ASSERT_EQUAL(LOOP_SECTION_COUNT, buffer[3]);
+  TEST_ASSERT_EQUAL(LOOP_PROFILE_HEADER_SIZE + (LOOP_SECTION_COUNT * LOOP_PROFILE_SECTION_SIZE), length);
+#else
+  TEST_ASSERT_EQUAL(0U, buffer[0]);
+  TEST_ASSERT_EQUAL(0U, buffer[3]);
+  TEST_ASSERT_EQUAL(LOOP_PROFILE_HEADER_SIZE, length);
+#endif
+  TEST_ASSERT_EQUAL(LOOP_PROFILE_BUCKETS, buffer[1]);
+}
+
+#if defined(LOOP_PROFILER)
+static void test_serialiseLoopProfile_paged(void)
+{
+  // The AVR serial buffer, less the return code
+  constexpr uint16_t pageSize = 263U;
+  constexpr uint8_t sectionsPerPage = (pageSize - LOOP_PROFILE_HEADER_SIZE) / LOOP_PROFILE_SECTION_SIZE;
+  uint8_t buffer[pageSize];
+
+  resetLoopProfiler();
+  loopProfilerStart();
+  loopProfilerMark(LoopSection::Schedules);
+  loopProfilerEnd();
+
+  uint8_t firstSection = 0U;
+  uint8_t pages = 0U;
+  while (firstSection < LOOP_SECTION_COUNT)
+  {
+    uint16_t length = serialiseLoopProfile(buffer, sizeof(buffer), firstSection);
+    uint8_t expectedCount = (std::min)((uint8_t)(LOOP_SECTION_COUNT - firstSection), sectionsPerPage);
+    TEST_ASSERT_EQUAL(firstSection, buffer[2]);
+    TEST_ASSERT_EQUAL(expectedCount, buffer[3]);
+    TEST_ASSERT_EQUAL(LOOP_PROFILE_HEADER_SIZE + (expectedCount * LOOP_PROFILE_SECTION_SIZE), length);
+    if (((uint8_t)LoopSection::Total >= firstSection) && ((uint8_t)LoopSection::Total < firstSection + expectedCount))
+    {
+      // The count field of the total loop section
+      const uint8_t *pSection = buffer + LOOP_PROFILE_HEADER_SIZE + (((uint8_t)LoopSection::Total - firstSection) * LOOP_PROFILE_SECTION_SIZE);
+      TEST_ASSERT_EQUAL(1U, pSection[6] | (pSection[7] << 8U));
+    }
+    firstSection = firstSection + buffer[3];
+    ++pages;
+  }
+  TEST_ASSERT_EQUAL((LOOP_SECTION_COUNT + sectionsPerPage - 1U) / sectionsPerPage, pages);
+
+  // Past the end: header only
+  TEST_ASSERT_EQUAL(LOOP_PROFILE_HEADER_SIZE, serialiseLoopProfile(buffer, sizeof(buffer), LOOP_SECTION_COUNT));
+  TEST_ASSERT_EQUAL(0U, buffer[3]);
+}
+#endif
+
+void testLoopProfiler(void)
+{
+  SET_UNITY_FILENAME() {
+    RUN_TEST_P(test_loopProfileBucket);
+    RUN_TEST_P(test_loopSectionStats_minMax);
+    RUN_TEST_P(test_loopSectionStats_percentile);
+    RUN_TEST_P(test_loopSectionStats_ageing);
+    RUN_TEST_P(test_serialiseLoopProfile);
+#if defined(LOOP_PROFILER)
+    RUN_TEST_P(test_serialiseLoopProfile_paged);
+#endif
+  }
+}
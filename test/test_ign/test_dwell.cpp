@@ -5,40 +5,40 @@ static void test_computeDwell_cranking(void) {
     statuses cur = {};
     config2 p2 = {};
     config4 p4 = {};
-    table3d4RpmLoad table = {};
 
     cur.rotationStatus = EngineRotationStatus::Cranking;
+    p2.useDwellMap = true;
     p4.dwellCrank = 43; // 4.3 ms stored as ms*10
 
-    TEST_ASSERT_EQUAL_UINT16(4300U, computeDwell(cur, p2, p4, table));
+    // Cranking dwell takes precedence over the map
+    TEST_ASSERT_EQUAL_UINT16(4300U, computeDwell(cur, p2, p4, 55U));
 }
 
 static void test_computeDwell_map(void) {
     statuses cur = {};
     config2 p2 = {};
     config4 p4 = {};
-    table3d4RpmLoad table = {};
 
     cur.rotationStatus = EngineRotationStatus::Running;
     p2.useDwellMap = true;
+    p4.dwellRun = 60;
 
-    // Fill the dwell table with a constant value of 55 (5.5 ms -> 5500 us)
-    fill_table_values(table, (table3d_value_t)55);
-
-    TEST_ASSERT_EQUAL_UINT16(5500U, computeDwell(cur, p2, p4, table));
+    TEST_ASSERT_TRUE(isDwellMapUsed(p2));
+    // Dwell map value of 55 (5.5 ms -> 5500 us)
+    TEST_ASSERT_EQUAL_UINT16(5500U, computeDwell(cur, p2, p4, 55U));
 }
 
 static void test_computeDwell_running(void) {
     statuses cur = {};
     config2 p2 = {};
     config4 p4 = {};
-    table3d4RpmLoad table = {};
 
     cur.rotationStatus = EngineRotationStatus::Running;
     p2.useDwellMap = false;
     p4.dwellRun = 60; // 6.0 ms -> 6000 us
 
-    TEST_ASSERT_EQUAL_UINT16(6000U, computeDwell(cur, p2, p4, table));
+    TEST_ASSERT_FALSE(isDwellMapUsed(p2));
+    TEST_ASSERT_EQUAL_UINT16(6000U, computeDwell(cur, p2, p4, 55U));
 }
 
 void testDwell(void)
@@ -7,10 +7,12 @@ void runAllTests(void)
     extern void testStatusBuilders(void);
     extern void testGetEntry(void);
     extern void testStartStop(void);
+    extern void testToothLogStream(void);
 
     testStatusBuilders();
     testGetEntry();
     testStartStop();
+    testToothLogStream();
 }
 
 TEST_HARNESS(runAllTests)
@@ -3,6 +3,7 @@
 #include "decoder_init.h"
 #include "decoders.h"
 #include "globals.h"
+#include "tooth_log_stream.h"
 
 extern decoder_status_t decoderStatus;
 
@@ -76,10 +77,52 @@ static void test_start_stop(void)
     TEST_PASS(); // Coverege only
 }
 
+#if defined(TOOTH_LOG_STREAM)
+static void test_stream_independent_of_ts_logger(void)
+{
+    configPage4.triggerTeeth = 6; // Prevent division by zero
+    configPage2.nCylinders = 4; // Needed to prevent division by zero.
+    currentStatus.initialisationComplete = true;
+    currentStatus.decoder = buildDecoder(DECODER_MISSING_TOOTH);
+    currentStatus.decoder.primary.edge = CHANGE;
+
+    TEST_ASSERT_TRUE(startToothLogStream(ToothLogSink::SD));
+    TEST_ASSERT_TRUE(toothLogStreamIsCapturing());
+    TEST_ASSERT_FALSE(startToothLogStream(ToothLogSink::Serial));
+
+    // Logged without a TunerStudio logger running
+    loggerPrimaryISR();
+    TEST_ASSERT_EQUAL(0, toothHistoryIndex);
+
+    // Starting & stopping a TunerStudio logger doesn't affect the stream
+    startCompositeLogger();
+    loggerPrimaryISR();
+    TEST_ASSERT_EQUAL(1, toothHistoryIndex);
+    stopCompositeLogger();
+    TEST_ASSERT_TRUE(toothLogStreamIsCapturing());
+    loggerPrimaryISR();
+
+    // Only the owner can stop it
+    stopToothLogStream(ToothLogSink::Serial);
+    TEST_ASSERT_TRUE(toothLogStreamIsCapturing());
+    stopToothLogStream(ToothLogSink::SD);
+    TEST_ASSERT_FALSE(toothLogStreamIsCapturing());
+    loggerPrimaryISR();
+
+    const tooth_log_block_t *pBlock = toothLogStreamNextBlock(ToothLogSink::SD);
+    TEST_ASSERT_NOT_NULL(pBlock);
+    TEST_ASSERT_EQUAL_UINT16(3U, pBlock->count);
+    toothLogStreamRelease(ToothLogSink::SD);
+}
+#endif
+
 void testStartStop(void)
 {
   SET_UNITY_FILENAME()
   {
+#if defined(TOOTH_LOG_STREAM)
+    RUN_TEST(test_stream_independent_of_ts_logger);
+#endif
     for (uint8_t decoder = 0; decoder < DECODER_MAX; ++decoder)
     {
         if (DECODER_AUDI135!=decoder
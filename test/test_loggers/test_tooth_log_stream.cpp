@@ -0,0 +1,208 @@
+#include "../test_utils.h"
+#include "tooth_log_stream.h"
+
+static constexpr uint16_t HEADER_SIZE = 10U;
+static constexpr uint16_t EDGE_SIZE = 5U;
+
+static uint16_t readU16(const uint8_t *pBuffer)
+{
+  return (uint16_t)(pBuffer[0] | (pBuffer[1] << 8U));
+}
+
+static uint32_t readU32(const uint8_t *pBuffer)
+{
+  return readU16(pBuffer) | ((uint32_t)readU16(pBuffer+2U) << 16U);
+}
+
+static void test_serialise_empty(void)
+{
+  toothLogStreamBegin(ToothLogSink::Serial);
+
+  uint8_t buffer[32];
+  (void)memset(buffer, 0xFF, sizeof(buffer));
+  TEST_ASSERT_EQUAL_UINT16(HEADER_SIZE, serialiseToothLogBlock(buffer, sizeof(buffer)));
+  TEST_ASSERT_EQUAL_UINT16(0U, readU16(buffer+6U));
+  TEST_ASSERT_EQUAL_UINT16(0U, readU16(buffer+8U));
+
+  TEST_ASSERT_EQUAL_UINT16(0U, serialiseToothLogBlock(buffer, HEADER_SIZE-1U));
+  (void)toothLogStreamEnd(ToothLogSink::Serial);
+}
+
+#if defined(TOOTH_LOG_STREAM)
+
+static void appendEdges(uint16_t count, uint32_t firstTime)
+{
+  for (uint16_t index = 0U; index < count; ++index)
+  {
+    toothLogStreamAppend(firstTime + index, (uint8_t)index);
+  }
+}
+
+static void test_fill_release(void)
+{
+  toothLogStreamBegin(ToothLogSink::Serial);
+  TEST_ASSERT_NULL(toothLogStreamNextBlock(ToothLogSink::Serial));
+
+  appendEdges(TOOTH_LOG_BLOCK_SIZE-1U, 1000U);
+  TEST_ASSERT_NULL(toothLogStreamNextBlock(ToothLogSink::Serial));
+
+  appendEdges(1U, 1000U+TOOTH_LOG_BLOCK_SIZE-1U);
+  const tooth_log_block_t *pBlock = toothLogStreamNextBlock(ToothLogSink::Serial);
+  TEST_ASSERT_NOT_NULL(pBlock);
+  TEST_ASSERT_EQUAL_UINT16(TOOTH_LOG_BLOCK_SIZE, pBlock->count);
+  TEST_ASSERT_EQUAL_UINT16(0U, pBlock->sequence);
+  TEST_ASSERT_EQUAL_UINT16(0U, pBlock->dropped);
+  TEST_ASSERT_EQUAL_UINT32(1000U, pBlock->times[0]);
+  TEST_ASSERT_EQUAL_UINT32(1000U+TOOTH_LOG_BLOCK_SIZE-1U, pBlock->times[TOOTH_LOG_BLOCK_SIZE-1U]);
+  TEST_ASSERT_EQUAL_UINT8(1U, pBlock->status[1]);
+
+  // Edges keep going into the other block while the first is drained
+  appendEdges(3U, 5000U);
+  TEST_ASSERT_EQUAL_PTR(pBlock, toothLogStreamNextBlock(ToothLogSink::Serial));
+
+  toothLogStreamRelease(ToothLogSink::Serial);
+  TEST_ASSERT_NULL(toothLogStreamNextBlock(ToothLogSink::Serial));
+  TEST_ASSERT_EQUAL_UINT32(0U, toothLogStreamDropped());
+  (void)toothLogStreamEnd(ToothLogSink::Serial);
+}
+
+static void test_drop_counting(void)
+{
+  toothLogStreamBegin(ToothLogSink::Serial);
+  appendEdges(TOOTH_LOG_BLOCK_SIZE*2U, 0U);
+  appendEdges(3U, 0U); // Both blocks full: dropped
+
+  const tooth_log_block_t *pBlock = toothLogStreamNextBlock(ToothLogSink::Serial);
+  TEST_ASSERT_EQUAL_UINT16(0U, pBlock->sequence);
+  toothLogStreamRelease(ToothLogSink::Serial);
+
+  appendEdges(1U, 12345U); // Into the block just released
+  pBlock = toothLogStreamNextBlock(ToothLogSink::Serial);
+  TEST_ASSERT_EQUAL_UINT16(1U, pBlock->sequence);
+  TEST_ASSERT_EQUAL_UINT16(0U, pBlock->dropped);
+  toothLogStreamRelease(ToothLogSink::Serial);
+
+  (void)toothLogStreamEnd(ToothLogSink::Serial);
+  pBlock = toothLogStreamNextBlock(ToothLogSink::Serial);
+  TEST_ASSERT_NOT_NULL(pBlock);
+  TEST_ASSERT_EQUAL_UINT16(2U, pBlock->sequence);
+  TEST_ASSERT_EQUAL_UINT16(3U, pBlock->dropped);
+  TEST_ASSERT_EQUAL_UINT16(1U, pBlock->count);
+  TEST_ASSERT_EQUAL_UINT32(12345U, pBlock->times[0]);
+  TEST_ASSERT_EQUAL_UINT32(0U, toothLogStreamDropped());
+  toothLogStreamRelease(ToothLogSink::Serial);
+  TEST_ASSERT_EQUAL_UINT32(3U, toothLogStreamDropped());
+
+  toothLogStreamBegin(ToothLogSink::Serial);
+  TEST_ASSERT_EQUAL_UINT32(0U, toothLogStreamDropped());
+  (void)toothLogStreamEnd(ToothLogSink::Serial);
+}
+
+static void test_flush_partial(void)
+{
+  toothLogStreamBegin(ToothLogSink::Serial);
+  (void)toothLogStreamEnd(ToothLogSink::Serial); // Nothing to flush
+  TEST_ASSERT_NULL(toothLogStreamNextBlock(ToothLogSink::Serial));
+
+  toothLogStreamBegin(ToothLogSink::Serial);
+  appendEdges(5U, 0U);
+  TEST_ASSERT_NULL(toothLogStreamNextBlock(ToothLogSink::Serial));
+  (void)toothLogStreamEnd(ToothLogSink::Serial);
+  const tooth_log_block_t *pBlock = toothLogStreamNextBlock(ToothLogSink::Serial);
+  TEST_ASSERT_NOT_NULL(pBlock);
+  TEST_ASSERT_EQUAL_UINT16(5U, pBlock->count);
+  toothLogStreamRelease(ToothLogSink::Serial);
+  TEST_ASSERT_NULL(toothLogStreamNextBlock(ToothLogSink::Serial));
+}
+
+static void test_serialise_chunks(void)
+{
+  static constexpr uint16_t CHUNK_SIZE = 10U;
+
+  toothLogStreamBegin(ToothLogSink::Serial);
+  appendEdges(TOOTH_LOG_BLOCK_SIZE, 0x01020300U);
+
+  uint8_t buffer[HEADER_SIZE + (CHUNK_SIZE*EDGE_SIZE) + EDGE_SIZE - 1U];
+  uint16_t offset = 0U;
+  while (offset < TOOTH_LOG_BLOCK_SIZE)
+  {
+    uint16_t expectedChunk = TOOTH_LOG_BLOCK_SIZE - offset < CHUNK_SIZE ? TOOTH_LOG_BLOCK_SIZE - offset : CHUNK_SIZE;
+    TEST_ASSERT_EQUAL_UINT16(HEADER_SIZE + (expectedChunk*EDGE_SIZE), serialiseToothLogBlock(buffer, sizeof(buffer)));
+    TEST_ASSERT_EQUAL_UINT16(0U, readU16(buffer));
+    TEST_ASSERT_EQUAL_UINT16(0U, readU16(buffer+2U));
+    TEST_ASSERT_EQUAL_UINT16(offset, readU16(buffer+4U));
+    TEST_ASSERT_EQUAL_UINT16(expectedChunk, readU16(buffer+6U));
+    TEST_ASSERT_EQUAL_UINT16(TOOTH_LOG_BLOCK_SIZE, readU16(buffer+8U));
+    TEST_ASSERT_EQUAL_UINT32(0x01020300U + offset, readU32(buffer+HEADER_SIZE));
+    TEST_ASSERT_EQUAL_UINT8((uint8_t)offset, buffer[HEADER_SIZE+4U]);
+    offset = offset + expectedChunk;
+  }
+
+  // Fully sent, so released
+  TEST_ASSERT_NULL(toothLogStreamNextBlock(ToothLogSink::Serial));
+  TEST_ASSERT_EQUAL_UINT16(HEADER_SIZE, serialiseToothLogBlock(buffer, sizeof(buffer)));
+  (void)toothLogStreamEnd(ToothLogSink::Serial);
+}
+
+static void test_one_sink_at_a_time(void)
+{
+  TEST_ASSERT_TRUE(toothLogStreamBegin(ToothLogSink::SD));
+  TEST_ASSERT_FALSE(toothLogStreamBegin(ToothLogSink::Serial));
+  TEST_ASSERT_TRUE(toothLogStreamIsCapturing());
+
+  appendEdges(TOOTH_LOG_BLOCK_SIZE, 0U);
+  TEST_ASSERT_NULL(toothLogStreamNextBlock(ToothLogSink::Serial));
+  const tooth_log_block_t *pBlock = toothLogStreamNextBlock(ToothLogSink::SD);
+  TEST_ASSERT_NOT_NULL(pBlock);
+
+  // The serial sink can neither drain nor release the SD sink's block...
+  uint8_t buffer[HEADER_SIZE + EDGE_SIZE];
+  TEST_ASSERT_EQUAL_UINT16(HEADER_SIZE, serialiseToothLogBlock(buffer, sizeof(buffer)));
+  toothLogStreamRelease(ToothLogSink::Serial);
+  TEST_ASSERT_EQUAL_PTR(pBlock, toothLogStreamNextBlock(ToothLogSink::SD));
+
+  // ...nor stop its capture
+  TEST_ASSERT_FALSE(toothLogStreamEnd(ToothLogSink::Serial));
+  TEST_ASSERT_TRUE(toothLogStreamIsCapturing());
+
+  TEST_ASSERT_TRUE(toothLogStreamEnd(ToothLogSink::SD));
+  TEST_ASSERT_FALSE(toothLogStreamIsCapturing());
+  // The owner can still drain after the capture stops
+  TEST_ASSERT_EQUAL_PTR(pBlock, toothLogStreamNextBlock(ToothLogSink::SD));
+
+  TEST_ASSERT_TRUE(toothLogStreamBegin(ToothLogSink::Serial));
+  TEST_ASSERT_NULL(toothLogStreamNextBlock(ToothLogSink::SD));
+  TEST_ASSERT_NULL(toothLogStreamNextBlock(ToothLogSink::Serial));
+  (void)toothLogStreamEnd(ToothLogSink::Serial);
+}
+
+static void test_append_ignored_when_stopped(void)
+{
+  toothLogStreamBegin(ToothLogSink::Serial);
+  appendEdges(3U, 0U);
+  (void)toothLogStreamEnd(ToothLogSink::Serial);
+  appendEdges(TOOTH_LOG_BLOCK_SIZE, 0U);
+
+  const tooth_log_block_t *pBlock = toothLogStreamNextBlock(ToothLogSink::Serial);
+  TEST_ASSERT_NOT_NULL(pBlock);
+  TEST_ASSERT_EQUAL_UINT16(3U, pBlock->count);
+  toothLogStreamRelease(ToothLogSink::Serial);
+  TEST_ASSERT_NULL(toothLogStreamNextBlock(ToothLogSink::Serial));
+}
+
+#endif
+
+void testToothLogStream(void)
+{
+  SET_UNITY_FILENAME() {
+    RUN_TEST_P(test_serialise_empty);
+#if defined(TOOTH_LOG_STREAM)
+    RUN_TEST_P(test_fill_release);
+    RUN_TEST_P(test_drop_counting);
+    RUN_TEST_P(test_flush_partial);
+    RUN_TEST_P(test_serialise_chunks);
+    RUN_TEST_P(test_one_sink_at_a_time);
+    RUN_TEST_P(test_append_ignored_when_stopped);
+#endif
+  }
+}
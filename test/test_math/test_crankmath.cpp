@@ -1,3 +1,4 @@
+#include <limits>
 #include "crankMaths.h"
 #include "../test_utils.h"
 
@@ -35,6 +36,23 @@ static void test_angleToTimerTicks_matches_uS_conversion(void)
     TEST_ASSERT_EQUAL(expectedTicks, angleToTimerTicks(angle));
 }
 
+static void test_angleToTimerTicks_within_one_tick_of_uS_conversion(void)
+{
+    const uint16_t rpms[] = { MIN_RPM, 500, 1000, 3000, 6000, 9000, 12000, MAX_RPM };
+    for (auto rpm : rpms)
+    {
+        setAngleConverterRevolutionTime(MICROS_PER_MIN/rpm);
+        for (uint16_t angle = 0U; angle<=720U; angle += 15U)
+        {
+            const uint32_t expectedTicks = uS_TO_TIMER_COMPARE(angleToTime(angle));
+            if (expectedTicks<(uint32_t)(std::numeric_limits<COMPARE_TYPE>::max)())
+            {
+                TEST_ASSERT_UINT32_WITHIN(1U, expectedTicks, angleToTimerTicks(angle));
+            }
+        }
+    }
+}
+
 static void test_timeToAngle_inverse_roundtrip(void)
 {
     setAngleConverterRevolutionTime(MICROS_PER_MIN/4000);
@@ -57,13 +75,165 @@ static void test_setAngleConverterRevolutionTime_revolution_values(void)
     TEST_ASSERT_UINT32_WITHIN(1U, revolutionTime * 2UL, angleToTime(720));
 }
 
+static void test_getAngleConverterRpm_matches_division(void)
+{
+    for (uint16_t rpm = MIN_RPM; rpm <= MAX_RPM; rpm = rpm + 7U)
+    {
+        const uint32_t revolutionTime = MICROS_PER_MIN / rpm;
+        setAngleConverterRevolutionTime(revolutionTime);
+        TEST_ASSERT_UINT16_WITHIN(1U, UDIV_ROUND_CLOSEST(MICROS_PER_MIN, revolutionTime, uint32_t), getAngleConverterRpm());
+    }
+
+    setAngleConverterRevolutionTime(1U);
+    TEST_ASSERT_EQUAL_UINT16(MAX_RPM, getAngleConverterRpm());
+}
+
+static void setAcceleratingToothTimes(void)
+{
+    // 4000rpm, 10° teeth, each tooth gap 10µS shorter than the last
+    setAngleConverterRevolutionTime(MICROS_PER_MIN/4000);
+    setAngleConverterToothAngle(10U);
+    setAngleConverterToothTime(430U, true);
+    setAngleConverterToothTime(420U, true);
+}
+
+static void test_angleToTime_accelerating(void)
+{
+    setAcceleratingToothTimes();
+
+    // Faster than constant speed (3750µS)
+    TEST_ASSERT_UINT32_WITHIN(5U, 3339U, angleToTime(90));
+    // Speed is constant beyond the horizon
+    TEST_ASSERT_UINT32_WITHIN(5U, 3339U+(angleToTime(180)-angleToTime(90)), angleToTime(180));
+
+    resetAngleConverterToothTimes();
+}
+
+static void test_angleToTime_decelerating(void)
+{
+    setAngleConverterRevolutionTime(MICROS_PER_MIN/4000);
+    setAngleConverterToothAngle(10U);
+    setAngleConverterToothTime(410U, true);
+    setAngleConverterToothTime(420U, true);
+
+    TEST_ASSERT_UINT32_WITHIN(5U, 4221U, angleToTime(90));
+
+    resetAngleConverterToothTimes();
+}
+
+static void test_angleToTime_acceleration_reset(void)
+{
+    setAcceleratingToothTimes();
+    resetAngleConverterToothTimes();
+    TEST_ASSERT_EQUAL_UINT32(3750U, angleToTime(90));
+
+    // A single gap isn't enough
+    setAngleConverterToothTime(420U, true);
+    TEST_ASSERT_EQUAL_UINT32(3750U, angleToTime(90));
+
+    // A missing tooth restarts the model
+    setAcceleratingToothTimes();
+    setAngleConverterToothTime(840U, false);
+    setAngleConverterToothTime(410U, true);
+    TEST_ASSERT_EQUAL_UINT32(3750U, angleToTime(90));
+
+    resetAngleConverterToothTimes();
+}
+
+static void test_angleToTime_acceleration_disabled(void)
+{
+    // E.g. a decoder without evenly spaced teeth
+    setAngleConverterRevolutionTime(MICROS_PER_MIN/4000);
+    setAngleConverterToothAngle(0U);
+    setAngleConverterToothTime(430U, true);
+    setAngleConverterToothTime(420U, true);
+    TEST_ASSERT_EQUAL_UINT32(3750U, angleToTime(90));
+
+    // Changing the tooth angle discards the gaps
+    setAcceleratingToothTimes();
+    setAngleConverterToothAngle(10U);
+    setAngleConverterToothTime(420U, true);
+    TEST_ASSERT_EQUAL_UINT32(3750U, angleToTime(90));
+
+    resetAngleConverterToothTimes();
+}
+
+static void test_angleToTime_acceleration_rejects_noise(void)
+{
+    // >25% change between teeth
+    setAcceleratingToothTimes();
+    setAngleConverterToothTime(840U, true);
+    TEST_ASSERT_EQUAL_UINT32(3750U, angleToTime(90));
+
+    resetAngleConverterToothTimes();
+}
+
+static void test_angleToTime_acceleration_stale(void)
+{
+    setAcceleratingToothTimes();
+    // Engine has slowed right down since the last tooth
+    setAngleConverterRevolutionTime(MICROS_PER_MIN/2000);
+    TEST_ASSERT_EQUAL_UINT32(7500U, angleToTime(90));
+
+    resetAngleConverterToothTimes();
+}
+
+static void assert_angleToTimerTicks_matches_angleToTime(void)
+{
+    for (uint16_t angle = 0U; angle<=720U; angle += 15U)
+    {
+        TEST_ASSERT_UINT32_WITHIN(1U, uS_TO_TIMER_COMPARE(angleToTime(angle)), angleToTimerTicks(angle));
+    }
+}
+
+static void test_angleToTimerTicks_accelerating(void)
+{
+    setAcceleratingToothTimes();
+    // Using the model
+    TEST_ASSERT_LESS_THAN_UINT32(3750U, angleToTime(90));
+    assert_angleToTimerTicks_matches_angleToTime();
+
+    // Decelerating
+    setAngleConverterToothTime(420U, true);
+    setAngleConverterToothTime(430U, true);
+    TEST_ASSERT_GREATER_THAN_UINT32(3750U, angleToTime(90));
+    assert_angleToTimerTicks_matches_angleToTime();
+
+    resetAngleConverterToothTimes();
+}
+
+static void test_timeToAngle_accelerating_roundtrip(void)
+{
+    setAcceleratingToothTimes();
+
+    const uint16_t angles[] = { 0, 1, 10, 45, 90, 180, 360, 720 };
+    for (auto angle : angles)
+    {
+        const uint32_t time = angleToTime(angle);
+        const uint16_t recoveredAngle = timeToAngle(time);
+        TEST_ASSERT_UINT16_WITHIN(1U, angle, recoveredAngle);
+    }
+
+    resetAngleConverterToothTimes();
+}
+
 void testCrankMath()
 {
   SET_UNITY_FILENAME() {
       RUN_TEST_P(test_ignitionLimits_within_range);
       RUN_TEST_P(test_injectorLimits_uint16_wrap);
       RUN_TEST_P(test_angleToTimerTicks_matches_uS_conversion);
+      RUN_TEST_P(test_angleToTimerTicks_within_one_tick_of_uS_conversion);
+      RUN_TEST_P(test_angleToTimerTicks_accelerating);
       RUN_TEST_P(test_timeToAngle_inverse_roundtrip);
       RUN_TEST_P(test_setAngleConverterRevolutionTime_revolution_values);
+      RUN_TEST_P(test_getAngleConverterRpm_matches_division);
+      RUN_TEST_P(test_angleToTime_accelerating);
+      RUN_TEST_P(test_angleToTime_decelerating);
+      RUN_TEST_P(test_angleToTime_acceleration_reset);
+      RUN_TEST_P(test_angleToTime_acceleration_disabled);
+      RUN_TEST_P(test_angleToTime_acceleration_rejects_noise);
+      RUN_TEST_P(test_angleToTime_acceleration_stale);
+      RUN_TEST_P(test_timeToAngle_accelerating_roundtrip);
   }
 }
@@ -2,8 +2,8 @@
 #include "crankMaths.h"
 #include "decoders.h"
 #include "../test_utils.h"
+#include "src/decoders/decoder_shared.h"
 
-extern void SetRevolutionTime(uint32_t revTime);
 
 struct crankmaths_rev_testdata {
   uint16_t rpm;
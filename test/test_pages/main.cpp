@@ -5,9 +5,11 @@ void runAllPageTests(void)
 {
     extern void testPage(void);
     extern void testPageCrc(void);
+    extern void testPageGeneration(void);
 
     testPage();
     testPageCrc();
+    testPageGeneration();
 }
 
 TEST_HARNESS(runAllPageTests)
@@ -86,6 +86,10 @@ static void test_getEntityValue_table(void)
     test_getEntityValue_tableT<table3d6RpmLoad>();
     test_getEntityValue_tableT<table3d8RpmLoad>();
     test_getEntityValue_tableT<table3d16RpmLoad>();
+#if defined(TABLE3D_LARGE_TABLES)
+    test_getEntityValue_tableT<table3d20RpmLoad>();
+    test_getEntityValue_tableT<table3d24RpmLoad>();
+#endif
 }
 
 static void set_entity_values(entity_t &entity, uint16_t from, uint16_t to, char value)
@@ -168,6 +172,10 @@ static void test_setEntityValue_table(void)
     test_setEntityValue_tableT<table3d6RpmLoad>();
     test_setEntityValue_tableT<table3d8RpmLoad>();
     test_setEntityValue_tableT<table3d16RpmLoad>();
+#if defined(TABLE3D_LARGE_TABLES)
+    test_setEntityValue_tableT<table3d20RpmLoad>();
+    test_setEntityValue_tableT<table3d24RpmLoad>();
+#endif
 }
 
 static void assert_getPageValue(uint8_t page, uint16_t offset)
@@ -231,7 +239,11 @@ static uint16_t sumEntitySizes(uint8_t pageNum)
 static void test_sumEntity_matches_pageSize(void)
 {
     // Page sizes as defined in the .ini file
+#if defined(TABLE3D_LARGE_TABLES)
+    constexpr uint16_t ini_page_sizes[] = { 0, 128, 624, 288, 128, 288, 128, 240, 384, 192, 192, 288, 192, 128, 288, 256 };
+#else
     constexpr uint16_t ini_page_sizes[] = { 0, 128, 288, 288, 128, 288, 128, 240, 384, 192, 192, 288, 192, 128, 288, 256 };
+#endif
 
     for (uint8_t pageNum=MIN_PAGE_NUM; pageNum<MAX_PAGE_NUM; ++pageNum)
     {
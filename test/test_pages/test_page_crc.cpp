@@ -22,8 +22,87 @@ static void test_calculatePageCRC32(void)
     TEST_ASSERT_EQUAL_UINT32(0xD2F67FBE, calculatePageCRC32(wmiMapPage));
 }
 
+extern bool isPageCRC32Cached(uint8_t pageNum);
+
+static void test_getPageCRC32_matches_calculatePageCRC32(void)
+{
+    for (uint8_t page=MIN_PAGE_NUM; page<MAX_PAGE_NUM; ++page)
+    {
+        setPageValues_Incremental(page, (char)page);
+        TEST_ASSERT_EQUAL_UINT32(calculatePageCRC32(page), getPageCRC32(page));
+        TEST_ASSERT_TRUE(isPageCRC32Cached(page));
+    }
+}
+
+static void test_getPageCRC32_write_invalidates_page(void)
+{
+    setPageValues_Incremental(wmiMapPage, 'X');
+    setPageValues_Incremental(veMapPage, 'X');
+    (void)getPageCRC32(wmiMapPage);
+    (void)getPageCRC32(veMapPage);
+
+    // Same value: still cached
+    setPageValue(wmiMapPage, 3U, getPageValue(wmiMapPage, 3U));
+    TEST_ASSERT_TRUE(isPageCRC32Cached(wmiMapPage));
+
+    setPageValue(wmiMapPage, 3U, getPageValue(wmiMapPage, 3U)+1U);
+    TEST_ASSERT_FALSE(isPageCRC32Cached(wmiMapPage));
+    TEST_ASSERT_TRUE(isPageCRC32Cached(veMapPage));
+    TEST_ASSERT_EQUAL_UINT32(calculatePageCRC32(wmiMapPage), getPageCRC32(wmiMapPage));
+}
+
+static void updateUntilCached(uint8_t pageNum)
+{
+    // Each update processes a bounded chunk: a page takes many calls
+    uint16_t calls = 0U;
+    while (!isPageCRC32Cached(pageNum) && (calls<1000U))
+    {
+        updatePageCRC32Cache();
+        ++calls;
+    }
+    TEST_ASSERT_GREATER_THAN_UINT16(1U, calls);
+    TEST_ASSERT_TRUE(isPageCRC32Cached(pageNum));
+}
+
+static void test_updatePageCRC32Cache_incremental(void)
+{
+    for (uint8_t page=MIN_PAGE_NUM; page<MAX_PAGE_NUM; ++page)
+    {
+        (void)getPageCRC32(page);
+    }
+
+    setPageValues_Incremental(boostvvtPage2, 'Y');
+    updateUntilCached(boostvvtPage2);
+    TEST_ASSERT_EQUAL_UINT32(calculatePageCRC32(boostvvtPage2), getPageCRC32(boostvvtPage2));
+}
+
+static void test_updatePageCRC32Cache_page_changed_midway(void)
+{
+    for (uint8_t page=MIN_PAGE_NUM; page<MAX_PAGE_NUM; ++page)
+    {
+        (void)getPageCRC32(page);
+    }
+
+    setPageValues_Incremental(veMapPage, 'Z');
+    updatePageCRC32Cache();
+    setPageValue(veMapPage, 0U, getPageValue(veMapPage, 0U)+1U);
+    setPageValue(veMapPage, getPageSize(veMapPage)-1U, getPageValue(veMapPage, getPageSize(veMapPage)-1U)+1U);
+    updateUntilCached(veMapPage);
+    TEST_ASSERT_EQUAL_UINT32(calculatePageCRC32(veMapPage), getPageCRC32(veMapPage));
+
+    // Asking for a page part way through the background update finishes it
+    setPageValues_Incremental(veMapPage, 'W');
+    updatePageCRC32Cache();
+    TEST_ASSERT_FALSE(isPageCRC32Cached(veMapPage));
+    TEST_ASSERT_EQUAL_UINT32(calculatePageCRC32(veMapPage), getPageCRC32(veMapPage));
+}
+
 void testPageCrc(void) {
     SET_UNITY_FILENAME() {
         RUN_TEST(test_calculatePageCRC32);
+        RUN_TEST(test_getPageCRC32_matches_calculatePageCRC32);
+        RUN_TEST(test_getPageCRC32_write_invalidates_page);
+        RUN_TEST(test_updatePageCRC32Cache_incremental);
+        RUN_TEST(test_updatePageCRC32Cache_page_changed_midway);
     }
 }
\ No newline at end of file
@@ -0,0 +1,97 @@
+#include <unity.h>
+#include "pages.h"
+#include "globals.h"
+#include "../test_utils.h"
+
+// Offset of the first x-axis value on the VE page
+static constexpr uint16_t VE_PAGE_XAXIS = 16U*16U;
+
+static void test_setPageValue_change_increments_generations(void)
+{
+    const generation_t pageGen = getPageGeneration(veMapPage);
+    const generation_t otherPageGen = getPageGeneration(ignMapPage);
+    const generation_t tuneGen = getTuneGeneration();
+    const generation_t tableGen = fuelTable.generation;
+
+    TEST_ASSERT_TRUE(setPageValue(veMapPage, 0U, getPageValue(veMapPage, 0U)+1U));
+
+    TEST_ASSERT_NOT_EQUAL(pageGen, getPageGeneration(veMapPage));
+    TEST_ASSERT_NOT_EQUAL(tuneGen, getTuneGeneration());
+    TEST_ASSERT_NOT_EQUAL(tableGen, fuelTable.generation);
+    TEST_ASSERT_EQUAL_UINT16(otherPageGen, getPageGeneration(ignMapPage));
+}
+
+static void test_setPageValue_axis_change_invalidates_cache(void)
+{
+    const generation_t tableGen = fuelTable.generation;
+    fuelTable.get_value_cache.last_lookup.x = 1234U;
+
+    TEST_ASSERT_TRUE(setPageValue(veMapPage, VE_PAGE_XAXIS, getPageValue(veMapPage, VE_PAGE_XAXIS)+1U));
+
+    TEST_ASSERT_NOT_EQUAL(tableGen, fuelTable.generation);
+    TEST_ASSERT_EQUAL_UINT16(UINT16_MAX, fuelTable.get_value_cache.last_lookup.x);
+}
+
+static void test_setPageValue_same_value_keeps_generations(void)
+{
+    const generation_t pageGen = getPageGeneration(veMapPage);
+    const generation_t tuneGen = getTuneGeneration();
+    const generation_t tableGen = fuelTable.generation;
+    fuelTable.get_value_cache.last_lookup.x = 1234U;
+
+    TEST_ASSERT_TRUE(setPageValue(veMapPage, 0U, getPageValue(veMapPage, 0U)));
+    TEST_ASSERT_TRUE(setPageValue(veMapPage, VE_PAGE_XAXIS, getPageValue(veMapPage, VE_PAGE_XAXIS)));
+
+    TEST_ASSERT_EQUAL_UINT16(pageGen, getPageGeneration(veMapPage));
+    TEST_ASSERT_EQUAL_UINT16(tuneGen, getTuneGeneration());
+    TEST_ASSERT_EQUAL_UINT16(tableGen, fuelTable.generation);
+    // The cached lookup is still valid
+    TEST_ASSERT_EQUAL_UINT16(1234U, fuelTable.get_value_cache.last_lookup.x);
+}
+
+static void test_setPageValue_raw_change(void)
+{
+    const generation_t pageGen = getPageGeneration(veSetPage);
+    const generation_t tableGen = fuelTable.generation;
+
+    TEST_ASSERT_TRUE(setPageValue(veSetPage, 0U, getPageValue(veSetPage, 0U)+1U));
+
+    TEST_ASSERT_NOT_EQUAL(pageGen, getPageGeneration(veSetPage));
+    TEST_ASSERT_EQUAL_UINT16(tableGen, fuelTable.generation);
+}
+
+static void test_notifyAllPagesChanged(void)
+{
+    generation_t pageGens[MAX_PAGE_NUM];
+    for (uint8_t page=MIN_PAGE_NUM; page<MAX_PAGE_NUM; ++page)
+    {
+        pageGens[page] = getPageGeneration(page);
+    }
+
+    notifyAllPagesChanged();
+
+    for (uint8_t page=MIN_PAGE_NUM; page<MAX_PAGE_NUM; ++page)
+    {
+        TEST_ASSERT_NOT_EQUAL(pageGens[page], getPageGeneration(page));
+    }
+}
+
+static void test_invalid_page(void)
+{
+    const generation_t tuneGen = getTuneGeneration();
+
+    notifyPageChanged(MAX_PAGE_NUM);
+    TEST_ASSERT_EQUAL_UINT16(tuneGen, getTuneGeneration());
+    TEST_ASSERT_EQUAL_UINT16(0U, getPageGeneration(MAX_PAGE_NUM));
+}
+
+void testPageGeneration(void) {
+    SET_UNITY_FILENAME() {
+        RUN_TEST(test_setPageValue_change_increments_generations);
+        RUN_TEST(test_setPageValue_axis_change_invalidates_cache);
+        RUN_TEST(test_setPageValue_same_value_keeps_generations);
+        RUN_TEST(test_setPageValue_raw_change);
+        RUN_TEST(test_notifyAllPagesChanged);
+        RUN_TEST(test_invalid_page);
+    }
+}
@@ -7,10 +7,12 @@ void runAllScheduleCalcTests(void)
   extern void test_calc_ign_timeout();
   extern void test_calc_inj_timeout();
   extern void test_adjust_crank_angle();
+  extern void test_per_tooth_fuel();
 
   test_calc_ign_timeout();
   test_calc_inj_timeout();
   test_adjust_crank_angle();
+  test_per_tooth_fuel();
 }
 
 TEST_HARNESS(runAllScheduleCalcTests)
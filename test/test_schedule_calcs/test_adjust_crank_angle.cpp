@@ -103,6 +103,96 @@ void test_adjust_crank_angle_running_negative_angle()
   TEST_ASSERT_EQUAL(100, subject.schedule._compare);
 }
 
+struct fuel_test_subject_t
+{
+  raw_counter_t counterReg = {101};
+  raw_compare_t compareReg = {100};
+  FuelSchedule schedule;
+  statuses current;
+  fuel_test_subject_t() : schedule(counterReg, compareReg) { }
+#if defined(NATIVE_BOARD)
+  fuel_test_subject_t(const fuel_test_subject_t &other) 
+  : fuel_test_subject_t() 
+  { 
+    counterReg.store(other.counterReg.load());
+    compareReg.store(other.compareReg.load());
+  }
+#endif
+};
+
+static fuel_test_subject_t setupFuelSubject() {
+  setAngleConverterRevolutionTime(6000000UL);
+  return fuel_test_subject_t();
+}
+
+void test_adjust_crank_angle_fuel_pending_below_minrevolutions()
+{
+  auto subject = setupFuelSubject();
+  subject.schedule._status = PENDING;
+  subject.current.startRevolutions = 0;
+  subject.schedule.openAngle = 359;
+
+  // Should do nothing.
+  adjustCrankAngle(subject.current, subject.schedule, 180);
+  TEST_ASSERT_EQUAL(100, subject.schedule._compare);
+  TEST_ASSERT_EQUAL(101, subject.schedule._counter);
+}
+
+void test_adjust_crank_angle_fuel_pending_above_minrevolutions()
+{
+  auto subject = setupFuelSubject();
+  subject.schedule._status = PENDING;  
+  subject.current.startRevolutions = 2000;
+
+  constexpr int16_t newCrankAngle = 180;
+  constexpr uint16_t openAngle = 359;
+  subject.schedule.openAngle = openAngle;
+
+  adjustCrankAngle(subject.current, subject.schedule, newCrankAngle);
+  TEST_ASSERT_EQUAL(101, subject.schedule._counter);
+  TEST_ASSERT_EQUAL(subject.schedule._counter+uS_TO_TIMER_COMPARE(angleToTime(openAngle-newCrankAngle)), subject.schedule._compare);
+}
+
+void test_adjust_crank_angle_fuel_pending_wrapped_angle()
+{
+  auto subject = setupFuelSubject();
+  subject.schedule._status = PENDING;  
+  subject.current.startRevolutions = 2000;
+
+  // Injector opens 5° after the end of the injection cycle
+  constexpr int16_t newCrankAngle = -10;
+  constexpr uint16_t openAngle = 5;
+  subject.schedule.openAngle = openAngle;
+
+  adjustCrankAngle(subject.current, subject.schedule, newCrankAngle);
+  TEST_ASSERT_EQUAL(subject.schedule._counter+uS_TO_TIMER_COMPARE(angleToTime(openAngle-newCrankAngle)), subject.schedule._compare);
+}
+
+void test_adjust_crank_angle_fuel_pending_negative_angle()
+{
+  auto subject = setupFuelSubject();
+  subject.schedule._status = PENDING;  
+  subject.current.startRevolutions = 2000;
+  subject.schedule.openAngle = 100;
+
+  adjustCrankAngle(subject.current, subject.schedule, 180);
+  TEST_ASSERT_EQUAL(101, subject.schedule._counter);
+  TEST_ASSERT_EQUAL(100, subject.schedule._compare);
+}
+
+void test_adjust_crank_angle_fuel_running()
+{
+  auto subject = setupFuelSubject();
+  subject.schedule._status = RUNNING;
+  subject.current.startRevolutions = 2000;
+  subject.schedule.openAngle = 359;
+
+  // Injector is open: pulse width must not change
+  adjustCrankAngle(subject.current, subject.schedule, 180);
+  TEST_ASSERT_EQUAL(101, subject.schedule._counter);
+  TEST_ASSERT_EQUAL(100, subject.schedule._compare);
+}
+
 void test_adjust_crank_angle()
 {
   SET_UNITY_FILENAME() {
@@ -112,5 +202,10 @@ void test_adjust_crank_angle()
     RUN_TEST(test_adjust_crank_angle_pending_above_minrevolutions_negative_angle);
     RUN_TEST(test_adjust_crank_angle_running);
     RUN_TEST(test_adjust_crank_angle_running_negative_angle);
+    RUN_TEST(test_adjust_crank_angle_fuel_pending_below_minrevolutions);
+    RUN_TEST(test_adjust_crank_angle_fuel_pending_above_minrevolutions);
+    RUN_TEST(test_adjust_crank_angle_fuel_pending_wrapped_angle);
+    RUN_TEST(test_adjust_crank_angle_fuel_pending_negative_angle);
+    RUN_TEST(test_adjust_crank_angle_fuel_running);
   }
 }
\ No newline at end of file
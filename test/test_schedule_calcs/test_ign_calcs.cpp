@@ -6,12 +6,12 @@
 #include "decoders.h"
 #include "../test_utils.h"
 #include "globals.h"
+#include "src/decoders/decoder_shared.h"
 
 #if !defined(_countof)
 #define _countof(x) (sizeof(x) / sizeof (x[0]))
 #endif
 
-extern void SetRevolutionTime(uint32_t revTime);
 extern uint32_t _calculateIgnitionTimeout(const IgnitionSchedule &schedule, int16_t crankAngle);
 extern void calculateIgnitionAngles(IgnitionSchedule &schedule, uint16_t dwellAngle, int8_t advance);
 extern void calculateIgnitionTrailingRotary(IgnitionSchedule &leading, uint16_t dwellAngle, int16_t rotarySplitDegrees, IgnitionSchedule &trailing);
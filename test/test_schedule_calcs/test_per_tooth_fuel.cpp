@@ -0,0 +1,174 @@
+#include <unity.h>
+#include "globals.h"
+#include "scheduler.h"
+#include "scheduler_fuel_controller.h"
+#include "crankMaths.h"
+#include "src/decoders/decoder_shared.h"
+#include "../test_utils.h"
+
+static constexpr uint16_t TOOTH_ANGLE = 10U;
+static constexpr uint16_t ORIGINAL_COMPARE = 100U;
+
+static void setupPerToothFuel(void)
+{
+  stopFuelSchedulers();
+  setAngleConverterRevolutionTime(6000000UL);
+  CRANK_ANGLE_MAX_INJ = 720;
+  CRANK_ANGLE_MAX_IGN = 720;
+  triggerToothAngle = TOOTH_ANGLE;
+  currentStatus.startRevolutions = 2000;
+  currentStatus.setRpm(1000U);
+  fixedCrankingOverride = 0;
+  configPage2.perToothIgn = false;
+  configPage2.perToothFuel = true;
+  for (auto &tooth : ignitionEndTeeth) { tooth = 0U; }
+
+  fuelSchedule1.reset();
+  fuelSchedule1._status = PENDING;
+  fuelSchedule1._compare = ORIGINAL_COMPARE;
+  fuelSchedule1.openAngle = 100U;
+#if INJ_CHANNELS >= 2
+  fuelSchedule2.reset();
+  fuelSchedule2._status = PENDING;
+  fuelSchedule2._compare = ORIGINAL_COMPARE;
+  fuelSchedule2.openAngle = 280U;
+#endif
+}
+
+static void assert_reanchored(const FuelSchedule &schedule, uint16_t delta)
+{
+  TEST_ASSERT_EQUAL_UINT32(schedule._counter + angleToTimerTicks(delta), schedule._compare);
+}
+
+static void assert_untouched(const FuelSchedule &schedule)
+{
+  TEST_ASSERT_EQUAL_UINT32(ORIGINAL_COMPARE, schedule._compare);
+}
+
+static void test_per_tooth_fuel_selects_channel_within_one_tooth(void)
+{
+  setupPerToothFuel();
+
+  checkPerToothFuelTiming(275);
+
+  assert_untouched(fuelSchedule1);
+#if INJ_CHANNELS >= 2
+  assert_reanchored(fuelSchedule2, 5U);
+#endif
+}
+
+static void test_per_tooth_fuel_exactly_one_tooth_ahead(void)
+{
+  setupPerToothFuel();
+
+  checkPerToothFuelTiming(100 - TOOTH_ANGLE);
+
+  assert_reanchored(fuelSchedule1, TOOTH_ANGLE);
+}
+
+static void test_per_tooth_fuel_more_than_one_tooth_ahead(void)
+{
+  setupPerToothFuel();
+
+  checkPerToothFuelTiming(100 - TOOTH_ANGLE - 1);
+
+  assert_untouched(fuelSchedule1);
+}
+
+static void test_per_tooth_fuel_open_angle_passed(void)
+{
+  setupPerToothFuel();
+
+  // Already at the open angle or past it: that is a whole cycle away, not within a tooth
+  checkPerToothFuelTiming(100);
+  assert_untouched(fuelSchedule1);
+  checkPerToothFuelTiming(101);
+  assert_untouched(fuelSchedule1);
+}
+
+static void test_per_tooth_fuel_wraps_open_angle(void)
+{
+  setupPerToothFuel();
+  fuelSchedule1.openAngle = 3U;
+
+  // Crank angle is at the end of the cycle, the injector opens just after the start of the next one
+  checkPerToothFuelTiming(715);
+
+  assert_reanchored(fuelSchedule1, 8U);
+}
+
+static void test_per_tooth_fuel_wraps_crank_angle_above_max(void)
+{
+  setupPerToothFuel();
+
+  checkPerToothFuelTiming(720 + 95);
+
+  assert_reanchored(fuelSchedule1, 5U);
+}
+
+static void test_per_tooth_fuel_wraps_negative_crank_angle(void)
+{
+  setupPerToothFuel();
+  fuelSchedule1.openAngle = 2U;
+
+  checkPerToothFuelTiming(-4);
+
+  assert_reanchored(fuelSchedule1, 6U);
+}
+
+static void test_per_tooth_fuel_inj_cycle_longer_than_ign(void)
+{
+  setupPerToothFuel();
+  // E.g. sequential fuel with wasted spark
+  CRANK_ANGLE_MAX_IGN = 360;
+
+  checkPerToothFuelTiming(95);
+
+  assert_untouched(fuelSchedule1);
+}
+
+static void test_per_tooth_timing_fuel_option_off(void)
+{
+  setupPerToothFuel();
+  configPage2.perToothIgn = true;
+  configPage2.perToothFuel = false;
+
+  checkPerToothTiming(95, 1U);
+
+  assert_untouched(fuelSchedule1);
+}
+
+static void test_per_tooth_timing_fuel_only(void)
+{
+  setupPerToothFuel();
+
+  TEST_ASSERT_TRUE(isPerToothTimingEnabled());
+  checkPerToothTiming(95, 1U);
+
+  assert_reanchored(fuelSchedule1, 5U);
+}
+
+static void test_per_tooth_timing_both_options_off(void)
+{
+  setupPerToothFuel();
+  configPage2.perToothFuel = false;
+
+  TEST_ASSERT_FALSE(isPerToothTimingEnabled());
+}
+
+void test_per_tooth_fuel(void)
+{
+  SET_UNITY_FILENAME() {
+    RUN_TEST(test_per_tooth_fuel_selects_channel_within_one_tooth);
+    RUN_TEST(test_per_tooth_fuel_exactly_one_tooth_ahead);
+    RUN_TEST(test_per_tooth_fuel_more_than_one_tooth_ahead);
+    RUN_TEST(test_per_tooth_fuel_open_angle_passed);
+    RUN_TEST(test_per_tooth_fuel_wraps_open_angle);
+    RUN_TEST(test_per_tooth_fuel_wraps_crank_angle_above_max);
+    RUN_TEST(test_per_tooth_fuel_wraps_negative_crank_angle);
+    RUN_TEST(test_per_tooth_fuel_inj_cycle_longer_than_ign);
+    RUN_TEST(test_per_tooth_timing_fuel_option_off);
+    RUN_TEST(test_per_tooth_timing_fuel_only);
+    RUN_TEST(test_per_tooth_timing_both_options_off);
+  }
+}
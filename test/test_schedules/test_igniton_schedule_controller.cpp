@@ -5,8 +5,8 @@
 #include "../fake_decoder_status.h"
 #include "scheduledIO_ign.h"
 #include "decoder_builder.h"
+#include "src/decoders/decoder_shared.h"
 
-extern void SetRevolutionTime(uint32_t revTime);
 extern void changeIgnitionToFullSequential(const config2 &page2, statuses &current);
 extern void changeIgnitionToHalfSync(const config2 &page2, statuses &current);
 extern bool isAnyIgnScheduleRunning(void);
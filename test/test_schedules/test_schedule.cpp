@@ -155,6 +155,57 @@ static void test_schedule_RUNNING_to_RUNNINGWITHNEXT_Disallow(void) {
   TEST_ASSERT_EQUAL(0, schedule._nextStartCompare);
 }
 
+static void test_scheduleBatch_skips_invalid_requests(void) {
+  raw_counter_t counter = { INITIAL_COUNTER };
+  raw_compare_t compare = {0};
+  Schedule schedule(counter, compare);
+  schedule_batch_t<3U> batch;
+
+  TEST_ASSERT_FALSE(addToScheduleBatch(batch, schedule, 0U, DURATION, true));
+  TEST_ASSERT_FALSE(addToScheduleBatch(batch, schedule, MAX_TIMER_PERIOD, DURATION, true));
+  TEST_ASSERT_FALSE(addToScheduleBatch(batch, schedule, TIMEOUT, 0U, true));
+  TEST_ASSERT_EQUAL(0U, batch.count);
+
+  commitScheduleBatch(batch);
+  TEST_ASSERT_EQUAL(OFF, schedule._status);
+}
+
+static void test_scheduleBatch_capacity(void) {
+  raw_counter_t counter = { INITIAL_COUNTER };
+  raw_compare_t compare = {0};
+  Schedule schedule(counter, compare);
+  schedule_batch_t<1U> batch;
+
+  TEST_ASSERT_TRUE(addToScheduleBatch(batch, schedule, TIMEOUT, DURATION, true));
+  TEST_ASSERT_FALSE(addToScheduleBatch(batch, schedule, TIMEOUT, DURATION, true));
+  TEST_ASSERT_EQUAL(1U, batch.count);
+}
+
+static void test_scheduleBatch_commit_matches_setSchedule(void) {
+  raw_counter_t counter = { INITIAL_COUNTER };
+  raw_compare_t compare1 = {0};
+  raw_compare_t compare2 = {0};
+  Schedule pending(counter, compare1);
+  Schedule running(counter, compare2);
+  running._status = RUNNING;
+  schedule_batch_t<2U> batch;
+
+  TEST_ASSERT_TRUE(addToScheduleBatch(batch, pending, TIMEOUT, DURATION, true));
+  TEST_ASSERT_TRUE(addToScheduleBatch(batch, running, TIMEOUT+77U, DURATION+33U, true));
+  // Nothing changes until the batch is committed
+  TEST_ASSERT_EQUAL(OFF, pending._status);
+  TEST_ASSERT_EQUAL(RUNNING, running._status);
+
+  commitScheduleBatch(batch);
+  TEST_ASSERT_EQUAL(0U, batch.count);
+  TEST_ASSERT_EQUAL(PENDING, pending._status);
+  TEST_ASSERT_EQUAL(uS_TO_TIMER_COMPARE(DURATION), pending._duration);
+  TEST_ASSERT_EQUAL(INITIAL_COUNTER + uS_TO_TIMER_COMPARE(TIMEOUT), pending._compare);
+  TEST_ASSERT_EQUAL(RUNNING_WITHNEXT, running._status);
+  TEST_ASSERT_EQUAL(uS_TO_TIMER_COMPARE(DURATION+33U), running._duration);
+  TEST_ASSERT_EQUAL(INITIAL_COUNTER + uS_TO_TIMER_COMPARE(TIMEOUT+77U), running._nextStartCompare);
+}
+
 void test_schedule(void)
 {
   SET_UNITY_FILENAME() {
@@ -167,5 +218,8 @@ void test_schedule(void)
     RUN_TEST_P(test_schedule_RUNNING_to_RUNNINGWITHNEXT);
     RUN_TEST_P(test_schedule_RUNNINGWITHNEXT_to_RUNNINGWITHNEXT);
     RUN_TEST_P(test_schedule_RUNNING_to_RUNNINGWITHNEXT_Disallow);
+    RUN_TEST_P(test_scheduleBatch_skips_invalid_requests);
+    RUN_TEST_P(test_scheduleBatch_capacity);
+    RUN_TEST_P(test_scheduleBatch_commit_matches_setSchedule);
   }
 }
@@ -6,10 +6,18 @@
 #include "storage.h"
 #include "maths.h"
 #include "units.h"
+#include "load_source.h"
 
 TEST_DATA_P table3d_axis_t tempXAxis[] = {500U/100U, 700U/100U, 900U/100U, 1200U/100U, 1600U/100U, 2000U/100U, 2500U/100U, 3100U/100U, 3500U/100U, 4100U/100U, 4700U/100U, 5300U/100U, 5900U/100U, 6500U/100U, 6750U/100U, 7000U/100U};
 TEST_DATA_P table3d_axis_t tempYAxis[] = {16U/2U, 26U/2U, 30U/2U, 36U/2U, 40U/2U, 46U/2U, 50U/2U, 56U/2U, 60U/2U, 66U/2U, 70U/2U, 76U/2U, 86U/2U, 90U/2U, 96U/2U, 100U/2U};
 
+// As the main loop: the table is only looked up if it's active
+static void calculateSecondarySpark(const config2 &page2, const config10 &page10, const table3d16RpmLoad &lookupTable, statuses &current) {
+    current.secondSparkTableActive = isSecondarySparkTableActive(page2, page10, current);
+    table3d_value_t spark2 = current.secondSparkTableActive ? get3DTableValue(&lookupTable, getLoad(page10.spark2Algorithm, current), current.RPM) : 0U;
+    calculateSecondarySpark(page10, spark2, current);
+}
+
 static void __attribute__((noinline)) assert_2nd_spark_is_off(const statuses &current, int8_t expectedAdvance) {
     TEST_ASSERT_FALSE(current.secondSparkTableActive);
     TEST_ASSERT_EQUAL(expectedAdvance, current.advance1);
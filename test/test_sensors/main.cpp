@@ -7,10 +7,12 @@ void runAllSensorTests(void)
     extern void test_fastMap10Bit(void);
     extern void test_map_sampling(void);
     extern void test_baro(void);
+    extern void test_calibration_lut(void);
 
     test_fastMap10Bit();
     test_map_sampling();
     test_baro();
+    test_calibration_lut();
 }
 
 TEST_HARNESS(runAllSensorTests)
@@ -0,0 +1,88 @@
+#include "../test_utils.h"
+#include "sensors.h"
+
+#if defined(SENSOR_CALIBRATION_LUT)
+
+extern uint8_t getCalibratedValue(SensorCalibrationTable sensor, uint16_t adc);
+
+// A falling, non-linear curve with the bins TS uploads for the temperature sensors
+static void fillCalibrationTable(table2D_u16_u8_32 &table, uint8_t offset)
+{
+  for (uint8_t x=0U; x<table.size(); ++x)
+  {
+    table.axis[x] = x * 33U;
+    table.values[x] = (uint8_t)(offset + (((31U-x)*(31U-x))/4U));
+  }
+}
+
+static void assert_lut_matches_table(SensorCalibrationTable sensor, table2D_u16_u8_32 &table)
+{
+  for (uint16_t adc=0U; adc<1024U; ++adc)
+  {
+    TEST_ASSERT_EQUAL_UINT8(table2D_getValue(&table, adc), getCalibratedValue(sensor, adc));
+  }
+}
+
+static void test_calibration_lut_matches_table(void)
+{
+  fillCalibrationTable(cltCalibrationTable, 10U);
+  fillCalibrationTable(iatCalibrationTable, 20U);
+  fillCalibrationTable(o2CalibrationTable, 30U);
+  refreshCalibrationLut(SensorCalibrationTable::CoolantSensor, 1U);
+  refreshCalibrationLut(SensorCalibrationTable::IntakeAirTempSensor, 2U);
+  refreshCalibrationLut(SensorCalibrationTable::O2Sensor, 3U);
+
+  assert_lut_matches_table(SensorCalibrationTable::CoolantSensor, cltCalibrationTable);
+  assert_lut_matches_table(SensorCalibrationTable::IntakeAirTempSensor, iatCalibrationTable);
+  assert_lut_matches_table(SensorCalibrationTable::O2Sensor, o2CalibrationTable);
+}
+
+static void test_calibration_lut_rebuilt_on_crc_change(void)
+{
+  fillCalibrationTable(cltCalibrationTable, 10U);
+  refreshCalibrationLut(SensorCalibrationTable::CoolantSensor, 1234U);
+  const uint8_t original = getCalibratedValue(SensorCalibrationTable::CoolantSensor, 500U);
+
+  // Same CRC: the curve is assumed unchanged, so the lookup table isn't rebuilt
+  fillCalibrationTable(cltCalibrationTable, 50U);
+  refreshCalibrationLut(SensorCalibrationTable::CoolantSensor, 1234U);
+  TEST_ASSERT_EQUAL_UINT8(original, getCalibratedValue(SensorCalibrationTable::CoolantSensor, 500U));
+
+  refreshCalibrationLut(SensorCalibrationTable::CoolantSensor, 4321U);
+  TEST_ASSERT_EQUAL_UINT8(original+40U, getCalibratedValue(SensorCalibrationTable::CoolantSensor, 500U));
+  assert_lut_matches_table(SensorCalibrationTable::CoolantSensor, cltCalibrationTable);
+}
+
+static void test_calibration_lut_out_of_range_adc(void)
+{
+  fillCalibrationTable(iatCalibrationTable, 20U);
+  refreshCalibrationLut(SensorCalibrationTable::IntakeAirTempSensor, 5678U);
+
+  // Beyond 10-bits: falls back to the curve (which clamps to the last value)
+  const uint16_t adc = 4095U;
+  TEST_ASSERT_EQUAL_UINT8(table2D_getValue(&iatCalibrationTable, adc), getCalibratedValue(SensorCalibrationTable::IntakeAirTempSensor, adc));
+  TEST_ASSERT_EQUAL_UINT8(20U, getCalibratedValue(SensorCalibrationTable::IntakeAirTempSensor, adc));
+}
+
+#else
+
+static void test_calibration_lut_not_applicable(void)
+{
+  TEST_IGNORE_MESSAGE("Calibration lookup tables are not enabled on this board");
+}
+
+#endif
+
+void test_calibration_lut(void)
+{
+  SET_UNITY_FILENAME()
+  {
+#if defined(SENSOR_CALIBRATION_LUT)
+    RUN_TEST(test_calibration_lut_matches_table);
+    RUN_TEST(test_calibration_lut_rebuilt_on_crc_change);
+    RUN_TEST(test_calibration_lut_out_of_range_adc);
+#else
+    RUN_TEST(test_calibration_lut_not_applicable);
+#endif
+  }
+}
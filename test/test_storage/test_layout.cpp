@@ -44,6 +44,18 @@ static void assert_nocalibration_overlap(const block &newBlock, uint8_t idxCurrB
     assert_nocalibration_overlap(newBlock, idxCurrBlock, SensorCalibrationTable::O2Sensor);
 }
 
+// Large tables are stored after the 4K layout. 7905 bytes is the smallest storage of the
+// environments that build with TABLE3D_LARGE_TABLES (SPI flash EEPROM emulation)
+static void assert_large_table_block(const block &newBlock) {
+#if defined(TABLE3D_LARGE_TABLES)
+    constexpr uint16_t LARGE_TABLE_STORAGE_SIZE = 7905U;
+    TEST_ASSERT_LESS_OR_EQUAL(LARGE_TABLE_STORAGE_SIZE, newBlock.start+newBlock.length);
+#else
+    UNUSED(newBlock);
+    TEST_FAIL_MESSAGE("EEPROM storage: entity is outside the 4K layout");
+#endif
+}
+
 static bool inline overlaps(const block &a, const block &b) {
     return  isInRangeExclusive(a.start, a.start+a.length-1, b.start);
             isInRangeExclusive(a.start, a.start+a.length, b.start+b.length);
@@ -65,7 +77,11 @@ static uint8_t test_no_overlap_page(uint8_t pageNum, block blocks[], size_t leng
 
         block newBlock = { getEntityStartAddress(iter), iter.entity.size };
         TEST_ASSERT_GREATER_THAN(0, newBlock.start);
-        TEST_ASSERT_LESS_THAN(MAX_PAGE_ADDRESS, newBlock.start+newBlock.length);
+        if (newBlock.start>STORAGE_SIZE) {
+            assert_large_table_block(newBlock);
+        } else {
+            TEST_ASSERT_LESS_THAN(MAX_PAGE_ADDRESS, newBlock.start+newBlock.length);
+        }
         assert_nocalibration_overlap(newBlock, idxCurrBlock);
         uint8_t overlapBlock = find_overlap(blocks, idxCurrBlock, newBlock);
         if (overlapBlock!=idxCurrBlock) {
@@ -6,9 +6,11 @@
 #include "sensors.h"
 #include "updates.h"
 #include "pages.h"
+#include "globals.h"
 
 extern void updateTableU16toU8(table2D_u16_u8_32 &targetTable, uint16_t u16EEpromBinAddress);
 extern void upgradeV25toV26(void);
+extern void upgradeV28toV29(void);
 
 static void assert_2dTable(table2D_u16_u8_32 &testSubject, uint16_t newAxis, uint8_t newValue)
 {
@@ -95,6 +97,92 @@ static void test_upgradeV25toV26_negative(void)
     TEST_ASSERT_EQUAL(0, oneByteEeprom.writeCount);
 }
 
+// =========================== upgradeV28toV29 ==========
+
+static byte memoryEeprom[8192];
+static byte memoryRead(uint16_t address) { return memoryEeprom[address]; }
+static void memoryWrite(uint16_t address, byte value) { memoryEeprom[address] = value; }
+static uint16_t memoryLength(void) { return sizeof(memoryEeprom); }
+static uint16_t memoryMaxWriteBlockSize(const statuses &) { return UINT16_MAX; }
+
+static constexpr uint16_t V28_EEPROM_CONFIG1_MAP = 3U;
+static constexpr uint8_t V28_SIZE = 16U;
+
+static uint8_t v28XAxis(uint8_t index) { return (uint8_t)(5U + index + (index*index)/2U); }
+static uint8_t v28YAxis(uint8_t index) { return (uint8_t)(10U + index*6U); }
+static uint8_t v28Value(uint8_t xIndex, uint8_t yIndex) { return (uint8_t)(20U + xIndex*4U + yIndex*8U); }
+
+// Store a 16x16 VE table in the V28 layout: values, X-axis then reversed Y-axis
+static void setup_v28_eeprom(uint8_t version)
+{
+    memset(memoryEeprom, 0, sizeof(memoryEeprom));
+    memoryEeprom[0] = version;
+    uint16_t address = V28_EEPROM_CONFIG1_MAP;
+    for (uint8_t y = 0; y < V28_SIZE; ++y) {
+        for (uint8_t x = 0; x < V28_SIZE; ++x) {
+            memoryEeprom[address++] = v28Value(x, y);
+        }
+    }
+    for (uint8_t x = 0; x < V28_SIZE; ++x) {
+        memoryEeprom[address++] = v28XAxis(x);
+    }
+    for (uint8_t y = V28_SIZE; y > 0U; --y) {
+        memoryEeprom[address++] = v28YAxis(y-1U);
+    }
+    setStorageAPI({ .read = memoryRead, .write = memoryWrite, .length = memoryLength, .getMaxWriteBlockSize = memoryMaxWriteBlockSize });
+}
+
+#if defined(TABLE3D_LARGE_TABLES)
+template <typename TAxis>
+static uint8_t find_bin(const TAxis &axis, uint8_t value)
+{
+    uint8_t index = 0U;
+    while ((index<axis.size()) && (axis[index]!=value)) {
+        ++index;
+    }
+    TEST_ASSERT_LESS_THAN(axis.size(), index);
+    return index;
+}
+#endif
+
+static void test_upgradeV28toV29(void)
+{
+    setup_v28_eeprom(28U);
+    fill_table_values(fuelTable, 0U);
+
+    upgradeV28toV29();
+
+    TEST_ASSERT_EQUAL_UINT8(29U, memoryEeprom[0]);
+#if defined(TABLE3D_LARGE_TABLES)
+    // Axes are still in order & every V28 bin is kept, so the V28 values are unchanged
+    for (uint8_t i = 1U; i < fuelTable.axisX.size(); ++i) {
+        TEST_ASSERT_LESS_OR_EQUAL_UINT8(fuelTable.axisX[i], fuelTable.axisX[i-1U]);
+        TEST_ASSERT_LESS_OR_EQUAL_UINT8(fuelTable.axisY[i], fuelTable.axisY[i-1U]);
+    }
+    for (uint8_t y = 0; y < V28_SIZE; ++y) {
+        const uint8_t yIndex = find_bin(fuelTable.axisY, v28YAxis(y));
+        for (uint8_t x = 0; x < V28_SIZE; ++x) {
+            const uint8_t xIndex = find_bin(fuelTable.axisX, v28XAxis(x));
+            TEST_ASSERT_EQUAL_UINT8(v28Value(x, y), fuelTable.values[(yIndex*fuelTable.axisX.size())+xIndex]);
+        }
+    }
+    // The new table has been saved after the 4K layout
+    TEST_ASSERT_EQUAL_UINT8(fuelTable.values[0], memoryEeprom[0x1000]);
+    TEST_ASSERT_EQUAL_UINT8(fuelTable.values[fuelTable.values.size()-1U], memoryEeprom[0x1000+fuelTable.values.size()-1U]);
+#endif
+}
+
+static void test_upgradeV28toV29_negative(void)
+{
+    setup_v28_eeprom(27U);
+    fill_table_values(fuelTable, 0U);
+
+    upgradeV28toV29();
+
+    TEST_ASSERT_EQUAL_UINT8(27U, memoryEeprom[0]);
+    TEST_ASSERT_EACH_EQUAL_UINT8(0U, fuelTable.values.data(), fuelTable.values.size());
+}
+
 // =========================== multiplyTableValue / divideTableValue ==========
 //
 // These walk the entire page-as-bytes (including non-table fields). Pages 1
@@ -139,6 +227,8 @@ void test_update(void) {
         RUN_TEST(test_updateTableU16toU8); 
         RUN_TEST(test_upgradeV25toV26_positive);  
         RUN_TEST(test_upgradeV25toV26_negative); 
+        RUN_TEST(test_upgradeV28toV29);
+        RUN_TEST(test_upgradeV28toV29_negative);
         RUN_TEST(test_multiplyTableValue_scales_each_byte);
         RUN_TEST(test_divideTableValue_scales_each_byte);
   }
@@ -7,10 +7,14 @@ void runAllTableTests(void)
     extern void testTables(void);
     extern void testTable2d(void);
     extern void test3DTableUtils(void);
+    extern void testTableAxisContext(void);
+    extern void testTable3dCache(void);
 
     testTables();
     testTable2d();
     test3DTableUtils();
+    testTableAxisContext();
+    testTable3dCache();
 }
 
 TEST_HARNESS(runAllTableTests)
@@ -4,22 +4,26 @@
 
 table3d8RpmLoad getDummyTable(void);
 
-static inline uint16_t getXMin(const table3d8RpmLoad &table)
+template <typename TTable>
+static inline uint16_t getXMin(const TTable &table)
 {
     return table.axisX.front()*getConversionFactor(table.XDomain);
 }
 
-static inline uint16_t getXMax(const table3d8RpmLoad &table)
+template <typename TTable>
+static inline uint16_t getXMax(const TTable &table)
 {
     return table.axisX.back()*getConversionFactor(table.XDomain);
 }
 
-static inline uint16_t getYMin(const table3d8RpmLoad &table)
+template <typename TTable>
+static inline uint16_t getYMin(const TTable &table)
 {
     return table.axisY.front()*getConversionFactor(table.YDomain);
 }
 
-static inline uint16_t getYMax(const table3d8RpmLoad &table)
+template <typename TTable>
+static inline uint16_t getYMax(const TTable &table)
 {
     return table.axisY.back()*getConversionFactor(table.YDomain);
 }
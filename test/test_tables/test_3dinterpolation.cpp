@@ -218,6 +218,57 @@ static void test_tableLookup_NoInterp(void)
   TEST_ASSERT_EQUAL(11U, tempVE);
 }
 
+#if defined(TABLE3D_LARGE_TABLES)
+// A table where value = 5*(row+column), so interpolated values are easy to predict.
+// X axis is 300rpm, 600rpm...; Y axis is 10kPa, 20kPa...
+template <typename TTable>
+static void populate_linear_table(TTable &table)
+{
+  const uint8_t size = (uint8_t)table.axisX.size();
+  for (uint8_t index=0; index<size; ++index)
+  {
+    table.axisX[index] = (table3d_axis_t)((index+1U)*3U);
+    table.axisY[index] = (table3d_axis_t)((index+1U)*5U);
+  }
+  for (uint8_t row=0; row<size; ++row)
+  {
+    for (uint8_t col=0; col<size; ++col)
+    {
+      table.values[(row*size)+col] = (table3d_value_t)(5U*(row+col));
+    }
+  }
+  invalidate_cache(&table.get_value_cache);
+}
+
+template <typename TTable>
+static void test_tableLookup_large(void)
+{
+  TTable testTable;
+  populate_linear_table(testTable);
+  const uint8_t last = (uint8_t)(testTable.axisX.size()-1U);
+
+  // Top right corner: the value index is beyond the range of table3d_dim_t
+  TEST_ASSERT_EQUAL(5U*(last+last), get3DTableValue(&testTable, getYMax(testTable), getXMax(testTable)));
+  TEST_ASSERT_EQUAL(5U*(last+last), get3DTableValue(&testTable, getYMax(testTable)+10U, getXMax(testTable)+100U));
+  TEST_ASSERT_EQUAL(5U*(last+0U), get3DTableValue(&testTable, getYMax(testTable), getXMin(testTable)));
+
+  // Mid way between the last 2 bins on both axes
+  uint16_t rpm = ((testTable.axisX[last-1U]+testTable.axisX[last])*getConversionFactor(testTable.XDomain))/2U;
+  uint16_t load = ((testTable.axisY[last-1U]+testTable.axisY[last])*getConversionFactor(testTable.YDomain))/2U;
+  TEST_ASSERT_INT_WITHIN(1, 5U*((2U*last)-1U), get3DTableValue(&testTable, load, rpm));
+}
+
+static void test_tableLookup_20x20(void)
+{
+  test_tableLookup_large<table3d20RpmLoad>();
+}
+
+static void test_tableLookup_24x24(void)
+{
+  test_tableLookup_large<table3d24RpmLoad>();
+}
+#endif
+
 void testTables()
 {
   SET_UNITY_FILENAME() {
@@ -235,5 +286,9 @@ void testTables()
   RUN_TEST(test_bilinear_interpolation);
   RUN_TEST(test_all_incrementing);
   RUN_TEST(test_tableLookup_NoInterp);
+#if defined(TABLE3D_LARGE_TABLES)
+  RUN_TEST(test_tableLookup_20x20);
+  RUN_TEST(test_tableLookup_24x24);
+#endif
   }  
 }
\ No newline at end of file
@@ -0,0 +1,142 @@
+#include <unity.h>
+#include <stdio.h>
+#include <inttypes.h>
+#include "table3d.h"
+#include "../test_utils.h"
+#include "table3d_test_support.h"
+
+// A sweep of lookups covering the whole table, including off-axis values
+static void assert_matches_unshared(table3d_axis_context_t &context, const table3d8RpmLoad &table)
+{
+  for (uint16_t rpm=getXMin(table)-100U; rpm<=getXMax(table)+100U; rpm+=123U)
+  {
+    for (uint16_t load=getYMin(table)-5U; load<=getYMax(table)+5U; load+=7U)
+    {
+      resetAxisContext(context);
+      // Prime the context with the same axes via a different table
+      table3d8RpmLoad other = table;
+      (void)get3DTableValue(context, &other, load, rpm);
+
+      char msg[32];
+      snprintf(msg, _countof(msg)-1, "RPM %" PRIu16 ", load %" PRIu16, rpm, load);
+      TEST_ASSERT_EQUAL_MESSAGE(get3DTableValue(&table, load, rpm), get3DTableValue(context, &table, load, rpm), msg);
+    }
+  }
+}
+
+static void test_shared_axes_same_result(void)
+{
+  table3d_axis_context_t context;
+  assert_matches_unshared(context, getDummyTable());
+}
+
+static void test_identical_axes_are_shared(void)
+{
+  table3d_axis_context_t context;
+  table3d8RpmLoad tableA = getDummyTable();
+  table3d8RpmLoad tableB = getDummyTable();
+
+  (void)get3DTableValue(context, &tableA, 53, 2250);
+  TEST_ASSERT_EQUAL_UINT8(2U, context.count);
+  // Different table, byte identical axes
+  (void)get3DTableValue(context, &tableB, 53, 2250);
+  TEST_ASSERT_EQUAL_UINT8(2U, context.count);
+  // Same table again
+  (void)get3DTableValue(context, &tableA, 53, 2250);
+  TEST_ASSERT_EQUAL_UINT8(2U, context.count);
+}
+
+static void test_different_lookup_not_shared(void)
+{
+  table3d_axis_context_t context;
+  table3d8RpmLoad tableA = getDummyTable();
+  table3d8RpmLoad tableB = getDummyTable();
+
+  (void)get3DTableValue(context, &tableA, 53, 2250);
+  // Same RPM, different load (E.g. fuelLoad vs ignLoad)
+  (void)get3DTableValue(context, &tableB, 60, 2250);
+  TEST_ASSERT_EQUAL_UINT8(3U, context.count);
+}
+
+static void test_different_axes_not_shared(void)
+{
+  table3d_axis_context_t context;
+  table3d8RpmLoad tableA = getDummyTable();
+  table3d8RpmLoad tableB = getDummyTable();
+  ++tableB.axisX[3];
+
+  (void)get3DTableValue(context, &tableA, 53, 2250);
+  TEST_ASSERT_EQUAL(get3DTableValue(&tableB, 53, 2250), get3DTableValue(context, &tableB, 53, 2250));
+  TEST_ASSERT_EQUAL_UINT8(3U, context.count);
+}
+
+static void test_context_full(void)
+{
+  table3d_axis_context_t context;
+  table3d8RpmLoad table = getDummyTable();
+
+  // More distinct lookups than the context can hold: the oldest are replaced
+  for (uint16_t load=30U; load<30U+(table3d_axis_context_t::MAX_AXES*3U); ++load)
+  {
+    TEST_ASSERT_EQUAL(get3DTableValue(&table, load, 2250), get3DTableValue(context, &table, load, 2250));
+  }
+  TEST_ASSERT_EQUAL_UINT8(table3d_axis_context_t::MAX_AXES, context.count);
+}
+
+static void test_reset_context(void)
+{
+  table3d_axis_context_t context;
+  table3d8RpmLoad table = getDummyTable();
+
+  (void)get3DTableValue(context, &table, 53, 2250);
+  resetAxisContext(context);
+  TEST_ASSERT_EQUAL_UINT8(0U, context.count);
+
+  // Axis edited, then the context reset: the new axis must be used
+  table.axisX[2] = table.axisX[2] + 1U;
+  TEST_ASSERT_EQUAL(get3DTableValue(&table, 53, 2250), get3DTableValue(context, &table, 53, 2250));
+}
+
+static void test_batched_matches_single(void)
+{
+  table3d8RpmLoad tableA = getDummyTable();
+  table3d8RpmLoad tableB = getDummyTable();
+  for (auto &value : tableB.values) { value = value/2U; }
+  table3d8RpmLoad tableC = getDummyTable();
+  ++tableC.axisY[3];
+
+  auto values = get3DTableValues(53, 2250, &tableA, &tableB, &tableC);
+  TEST_ASSERT_EQUAL_UINT(3U, values.size());
+  TEST_ASSERT_EQUAL(get3DTableValue(&tableA, 53, 2250), values[0]);
+  TEST_ASSERT_EQUAL(get3DTableValue(&tableB, 53, 2250), values[1]);
+  TEST_ASSERT_EQUAL(get3DTableValue(&tableC, 53, 2250), values[2]);
+}
+
+static void test_batched_updates_value_cache(void)
+{
+  table3d8RpmLoad tableA = getDummyTable();
+  table3d8RpmLoad tableB = getDummyTable();
+  invalidate_cache(&tableA.get_value_cache);
+  invalidate_cache(&tableB.get_value_cache);
+
+  auto values = get3DTableValues<true>(53, 2250, &tableA, &tableB);
+  // A later single lookup with the same values is a cache hit
+  table3d_cache_stats_t before = table3dCacheStats;
+  TEST_ASSERT_EQUAL(values[1], get3DTableValue<true>(&tableB, 53, 2250));
+  TEST_ASSERT_EQUAL_UINT32(1U, table3dCacheStats.count(Table3dCacheResult::Exact)-before.count(Table3dCacheResult::Exact));
+}
+
+void testTableAxisContext(void)
+{
+  SET_UNITY_FILENAME() {
+
+    RUN_TEST_P(test_shared_axes_same_result);
+    RUN_TEST_P(test_identical_axes_are_shared);
+    RUN_TEST_P(test_different_lookup_not_shared);
+    RUN_TEST_P(test_different_axes_not_shared);
+    RUN_TEST_P(test_context_full);
+    RUN_TEST_P(test_reset_context);
+    RUN_TEST_P(test_batched_matches_single);
+    RUN_TEST_P(test_batched_updates_value_cache);
+  }
+}
@@ -0,0 +1,139 @@
+#include <unity.h>
+#include <stdio.h>
+#include <inttypes.h>
+#include "table3d.h"
+#include "../test_utils.h"
+#include "table3d_test_support.h"
+
+static uint32_t nextRandom(uint32_t &state)
+{
+  // xorshift32
+  state ^= state << 13U;
+  state ^= state >> 17U;
+  state ^= state << 5U;
+  return state;
+}
+
+static uint16_t randomWalk(uint32_t &state, uint16_t value, uint16_t step, uint16_t minimum, uint16_t maximum)
+{
+  int32_t next = (int32_t)value + (int32_t)(nextRandom(state) % ((2U*step)+1U)) - (int32_t)step;
+  if (next<(int32_t)minimum) { return minimum; }
+  if (next>(int32_t)maximum) { return maximum; }
+  return (uint16_t)next;
+}
+
+static uint32_t resultCount(const table3d_cache_stats_t &before, Table3dCacheResult result)
+{
+  return table3dCacheStats.count(result) - before.count(result);
+}
+
+// Noisy, slowly changing lookups (E.g. a MAP signal): the cached result must be
+// identical to the uncached result
+static void assert_cached_matches_uncached(table3d8RpmLoad &table)
+{
+  table3d8RpmLoad cached = table;
+  invalidate_cache(&cached.get_value_cache);
+
+  uint32_t seed = 1234U;
+  uint16_t rpm = getXMin(table);
+  uint16_t load = getYMin(table);
+  for (uint16_t i=0; i<20000U; ++i)
+  {
+    rpm = randomWalk(seed, rpm, 50U, getXMin(table)-100U, getXMax(table)+100U);
+    load = randomWalk(seed, load, 2U, getYMin(table)-5U, getYMax(table)+5U);
+
+    char msg[32];
+    snprintf(msg, _countof(msg)-1, "RPM %" PRIu16 ", load %" PRIu16, rpm, load);
+    TEST_ASSERT_EQUAL_MESSAGE(get3DTableValue<false>(&table, load, rpm), get3DTableValue<true>(&cached, load, rpm), msg);
+  }
+}
+
+static void test_cached_matches_uncached(void)
+{
+  table3d8RpmLoad table = getDummyTable();
+  assert_cached_matches_uncached(table);
+}
+
+static void test_cached_matches_uncached_steep(void)
+{
+  // Alternating min/max values: as steep as a table can be
+  table3d8RpmLoad table = getDummyTable();
+  for (uint8_t i=0; i<table.values.size(); ++i)
+  {
+    table.values[i] = ((i + (i/table.axisX.size())) % 2U)==0U ? 0U : 255U;
+  }
+  assert_cached_matches_uncached(table);
+}
+
+static void test_exact_repeat(void)
+{
+  table3d8RpmLoad table = getDummyTable();
+  invalidate_cache(&table.get_value_cache);
+
+  table3d_cache_stats_t before = table3dCacheStats;
+  table3d_value_t value = get3DTableValue<true>(&table, 53, 2250);
+  TEST_ASSERT_EQUAL_UINT32(1U, resultCount(before, Table3dCacheResult::Miss));
+  TEST_ASSERT_EQUAL(value, get3DTableValue<true>(&table, 53, 2250));
+  TEST_ASSERT_EQUAL_UINT32(1U, resultCount(before, Table3dCacheResult::Exact));
+}
+
+static void test_flat_bin_below_resolution(void)
+{
+  table3d8RpmLoad table = getDummyTable();
+  table.values.fill(100U);
+  invalidate_cache(&table.get_value_cache);
+
+  (void)get3DTableValue<true>(&table, 53, 2250);
+  table3d_cache_stats_t before = table3dCacheStats;
+  // Corners are all the same: any move within the bin can't change the output
+  TEST_ASSERT_EQUAL(100U, get3DTableValue<true>(&table, 54, 2300));
+  TEST_ASSERT_EQUAL_UINT32(1U, resultCount(before, Table3dCacheResult::BelowResolution));
+}
+
+static void test_same_bin_reuses_corners(void)
+{
+  table3d8RpmLoad table = getDummyTable();
+  invalidate_cache(&table.get_value_cache);
+
+  (void)get3DTableValue<true>(&table, 53, 2250);
+  const table3d_value_t corners[4] = { table.get_value_cache.corners[0], table.get_value_cache.corners[1],
+                                      table.get_value_cache.corners[2], table.get_value_cache.corners[3] };
+
+  // Change every value *without* invalidating
+  for (auto &value : table.values) { value = value/2U; }
+
+  table3d_cache_stats_t before = table3dCacheStats;
+  // Still in the same bins, but too far to skip the blend: the stale corners are used
+  (void)get3DTableValue<true>(&table, 53, 2400);
+  TEST_ASSERT_EQUAL_UINT32(1U, resultCount(before, Table3dCacheResult::SameBin));
+  TEST_ASSERT_EQUAL_UINT8_ARRAY(corners, table.get_value_cache.corners, 4);
+
+  // Invalidating picks up the changed values
+  invalidate_cache(&table.get_value_cache);
+  TEST_ASSERT_EQUAL(get3DTableValue<false>(&table, 53, 2400), get3DTableValue<true>(&table, 53, 2400));
+  TEST_ASSERT_EQUAL_UINT32(1U, resultCount(before, Table3dCacheResult::Miss));
+}
+
+static void test_bin_change_misses(void)
+{
+  table3d8RpmLoad table = getDummyTable();
+  invalidate_cache(&table.get_value_cache);
+
+  (void)get3DTableValue<true>(&table, 53, 2250);
+  table3d_cache_stats_t before = table3dCacheStats;
+  TEST_ASSERT_EQUAL(get3DTableValue<false>(&table, 53, getXMax(table)), get3DTableValue<true>(&table, 53, getXMax(table)));
+  TEST_ASSERT_EQUAL_UINT32(1U, resultCount(before, Table3dCacheResult::Miss));
+}
+
+void testTable3dCache(void)
+{
+  SET_UNITY_FILENAME() {
+
+    RUN_TEST_P(test_cached_matches_uncached);
+    RUN_TEST_P(test_cached_matches_uncached_steep);
+    RUN_TEST_P(test_exact_repeat);
+    RUN_TEST_P(test_flat_bin_below_resolution);
+    RUN_TEST_P(test_same_bin_reuses_corners);
+    RUN_TEST_P(test_bin_change_misses);
+  }
+}
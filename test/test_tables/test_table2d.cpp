@@ -232,6 +232,57 @@ static void test_findBin(void) {
     APPLY_TEST_TO_ALL_TYPES(test_findBin, "");
 }
 
+template <_table2d_detail::BinSearch strategy, typename axis_t, uint8_t sizeT>
+static void assert_searchBin(axis_t (&pAxisBin)[sizeT], int32_t lookUp)
+{
+    // Skip lookups that the axis type can't represent
+    if ((lookUp<(int32_t)(std::numeric_limits<axis_t>::min)()) || (lookUp>(int32_t)(std::numeric_limits<axis_t>::max)())) { return; }
+
+    char szMsg[64];
+    snprintf(szMsg, _countof(szMsg)-1, "Strategy %" PRIu8 ", lookup %" PRId32, (uint8_t)strategy, lookUp);
+    TEST_ASSERT_EQUAL_MESSAGE(_table2d_detail::findBinUpperIndex(pAxisBin, pAxisBin+sizeT, (axis_t)lookUp), 
+                            (_table2d_detail::searchBinUpperIndex<sizeT, axis_t, strategy>(pAxisBin, (axis_t)lookUp)), 
+                            szMsg);
+}
+
+template <_table2d_detail::BinSearch strategy, typename axis_t, uint8_t sizeT>
+static void assert_searchBin_all_bins(axis_t (&pAxisBin)[sizeT])
+{
+    // Either side of every bin edge, plus the midpoints
+    for (uint8_t i=0; i<sizeT; ++i) {
+        assert_searchBin<strategy>(pAxisBin, (int32_t)pAxisBin[i]-1);
+        assert_searchBin<strategy>(pAxisBin, (int32_t)pAxisBin[i]);
+        assert_searchBin<strategy>(pAxisBin, (int32_t)pAxisBin[i]+1);
+        if (i>0U) {
+            assert_searchBin<strategy>(pAxisBin, ((int32_t)pAxisBin[i-1]+(int32_t)pAxisBin[i])/2);
+        }
+    }
+}
+
+template <typename axis_t, typename value_t, uint8_t sizeT>
+static void test_searchBin(axis_t (&pAxisBin)[sizeT], value_t (&)[sizeT])
+{
+    assert_searchBin_all_bins<_table2d_detail::BinSearch::Linear>(pAxisBin);
+    assert_searchBin_all_bins<_table2d_detail::BinSearch::Binary>(pAxisBin);
+    assert_searchBin_all_bins<_table2d_detail::BinSearch::DirectIndex>(pAxisBin);
+}
+
+static void test_searchBin(void) {
+    APPLY_TEST_TO_ALL_TYPES(test_searchBin, "");
+}
+
+static void test_searchBin_evenly_spaced(void) {
+    // Same as the CLT & IAT calibration axes
+    uint16_t axis[32];
+    for (uint8_t i=0; i<_countof(axis); ++i) {
+        axis[i] = i*33U;
+    }
+    for (int32_t lookUp=0; lookUp<=1024; ++lookUp) {
+        assert_searchBin<_table2d_detail::BinSearch::DirectIndex>(axis, lookUp);
+        assert_searchBin<_table2d_detail::BinSearch::Binary>(axis, lookUp);
+    }
+}
+
 template <typename axis_t, typename value_t, uint8_t sizeT>
 static void test_table2d_all_decrementing(axis_t (&pAxisBin)[sizeT], value_t (&pCurve)[sizeT])
 {
@@ -287,6 +338,8 @@ void testTable2d()
     test_getValue_bin_edges();
     test_withinBin();
     test_findBin();
+    test_searchBin();
+    RUN_TEST(test_searchBin_evenly_spaced);
     RUN_TEST(test_lookup_perf);
   }
 }
\ No newline at end of file
@@ -5,8 +5,10 @@
 void runAllTests(void)
 {
     extern void testStaticFor(void);
+    extern void testSeqlock(void);
 
     testStaticFor();
+    testSeqlock();
 }
 
 TEST_HARNESS(runAllTests)
@@ -0,0 +1,84 @@
+#include "../test_utils.h"
+#include "src/utils/seqlock.hpp"
+
+static void test_seqlock_initial_value(void)
+{
+    Seqlock<uint32_t> snapshot;
+
+    TEST_ASSERT_EQUAL_UINT32(0U, snapshot.read());
+    TEST_ASSERT_EQUAL_UINT8(0U, snapshot.sequence());
+}
+
+static void test_seqlock_write_read(void)
+{
+    Seqlock<uint32_t> snapshot;
+
+    snapshot.write(1234U);
+    TEST_ASSERT_EQUAL_UINT32(1234U, snapshot.read());
+    TEST_ASSERT_EQUAL_UINT8(2U, snapshot.sequence());
+
+    // Reading doesn't change anything
+    TEST_ASSERT_EQUAL_UINT32(1234U, snapshot.read());
+    TEST_ASSERT_EQUAL_UINT8(2U, snapshot.sequence());
+}
+
+static void test_seqlock_sequence_wraps(void)
+{
+    Seqlock<uint16_t> snapshot;
+
+    // More writes than the sequence can count
+    for (uint16_t value=0U; value<300U; ++value)
+    {
+        snapshot.write(value);
+        TEST_ASSERT_EQUAL_UINT16(value, snapshot.read());
+    }
+    TEST_ASSERT_EQUAL_UINT8((uint8_t)600U, snapshot.sequence());
+}
+
+// Simulates the writer interrupting a reader part way through copying the value
+struct interrupted_value_t
+{
+    uint16_t value;
+
+    interrupted_value_t &operator=(const interrupted_value_t &other)
+    {
+        value = other.value;
+        if (pInterrupt!=nullptr)
+        {
+            Seqlock<interrupted_value_t> *pSnapshot = pInterrupt;
+            pInterrupt = nullptr;
+            pSnapshot->write(interrupted_value_t{ interruptValue });
+        }
+        return *this;
+    }
+
+    static Seqlock<interrupted_value_t> *pInterrupt;
+    static uint16_t interruptValue;
+};
+Seqlock<interrupted_value_t> *interrupted_value_t::pInterrupt = nullptr;
+uint16_t interrupted_value_t::interruptValue = 0U;
+
+static void test_seqlock_read_retries_after_write(void)
+{
+    Seqlock<interrupted_value_t> snapshot;
+    snapshot.write(interrupted_value_t{ 1U });
+
+    interrupted_value_t::interruptValue = 2U;
+    interrupted_value_t::pInterrupt = &snapshot;
+    interrupted_value_t value = snapshot.read();
+
+    // The first copy was discarded & the value written during it was read instead
+    TEST_ASSERT_NULL(interrupted_value_t::pInterrupt);
+    TEST_ASSERT_EQUAL_UINT16(2U, value.value);
+}
+
+void testSeqlock(void)
+{
+  SET_UNITY_FILENAME()
+  {
+    RUN_TEST_P(test_seqlock_initial_value);
+    RUN_TEST_P(test_seqlock_write_read);
+    RUN_TEST_P(test_seqlock_sequence_wraps);
+    RUN_TEST_P(test_seqlock_read_retries_after_write);
+  }
+}